@@ -0,0 +1,79 @@
+#ifndef __SOCKET_PROTOCOL_H_
+#define __SOCKET_PROTOCOL_H_
+
+//
+// Binary protocol spoken by `fifo --socket`: a persistent alternative to the
+// named pipe for small, frequent batches.
+//
+// Everything travels in frames: a `frame_header` followed by `size` bytes of
+// payload. Integers and doubles are in host byte order, as the server only
+// listens on a Unix domain socket. A client may send any number of frames
+// without waiting for replies (pipelining); the server answers batches in the
+// order it received them, one RESULT (or ERROR) frame per QUERIES frame.
+//
+//  - CONFIG: the JSON search configuration (cf. json_config.h). It applies to
+//    every later batch on the same connection; the default is used until one
+//    is sent.
+//  - EDGES: `edge_record`s perturbing the graph for every later batch (and
+//    every connection).
+//  - QUERIES: `sn_id_t` (origin, destination) pairs. Each QUERIES frame is
+//    one batch.
+//  - RESULT: one `result_header` then, per query and in input order, the
+//    cost of the path found (warthog::COST_MAX if none).
+//  - ERROR: a message; the server closes the connection after sending it.
+//
+#include "constants.h"
+
+#include <cstdint>
+
+namespace socket_protocol
+{
+
+enum frame_type : uint32_t
+{
+    CONFIG = 1,
+    EDGES = 2,
+    QUERIES = 3,
+    RESULT = 4,
+    ERROR = 5
+};
+
+// Frames larger than this are rejected.
+const uint32_t MAX_FRAME_SIZE = 1u << 30;
+
+struct frame_header
+{
+    uint32_t size;              // payload bytes, excluding this header
+    uint32_t type;              // a frame_type
+};
+
+struct edge_record
+{
+    uint32_t head;
+    uint32_t tail;
+    double weight;
+};
+
+// Same fields, in the same order, as the CSV written to the output FIFO.
+struct result_header
+{
+    uint64_t n_expanded;
+    uint64_t n_touched;
+    uint64_t n_reopen;
+    uint64_t n_surplus;
+    uint64_t n_heap_ops;
+    uint64_t plen;
+    uint64_t finished;
+    double t_read;              // ns spent decoding the batch
+    double t_astar;             // ns spent in search, summed over queries
+    double t_search;            // ns to process the batch
+    uint64_t n_results;         // number of costs that follow
+};
+
+static_assert(sizeof(frame_header) == 8, "frame_header must be packed");
+static_assert(sizeof(edge_record) == 16, "edge_record must be packed");
+static_assert(sizeof(result_header) == 88, "result_header must be packed");
+
+}
+
+#endif // __SOCKET_PROTOCOL_H_
@@ -1,15 +1,18 @@
 #include "cfg.h"
 #include "bch_expansion_policy.h"
+#include "cch.h"
 #include "dimacs_parser.h"
 #include "graph.h"
 #include "lazy_graph_contraction.h"
 #include "xy_graph.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
 int verbose=false;
 int verify=false;
+int customizable=false;
 int has_input=0;
 warthog::util::cfg cfg;
 
@@ -24,7 +27,11 @@ help()
     << "\t--input [xy graph file]\n"
 	<< "\t--verbose (optional; prints debugging info when compiled with debug symbols)\n"
 	<< "\t--verify (optional; verify lazy priorities before contraction.\n"
-    << "\t          slow but can produce less shortcut edges)\n";
+    << "\t          slow but can produce less shortcut edges)\n"
+    << "\t--threads [num] (optional; contract independent sets of nodes\n"
+    << "\t          in parallel. the order does not depend on [num])\n"
+    << "\t--cch (optional; contract in a nested dissection order, without\n"
+    << "\t          witness searches, then customise. cf. contraction/cch.h)\n";
 }
 
 void
@@ -49,9 +56,30 @@ contract_graph()
         return;
     }
 
+    if(customizable)
+    {
+        // the order and the arcs depend only on the structure of the graph
+        std::vector<uint32_t> order;
+        warthog::ch::nested_dissection_order(chd.g_, order);
+        warthog::ch::customizable_ch cch(chd.g_, order);
+
+        outfile = xy_file + ".ch";
+        std::cerr << "saving contracted graph to file " << outfile << std::endl;
+        std::ofstream ofs(outfile.c_str());
+        ofs << *cch.get_ch_data();
+        ofs.close();
+        std::cerr << "all done!\n";
+        return;
+    }
+
     // create a new contraction hierarchy with dynamic node ordering
     warthog::ch::lazy_graph_contraction contractor;
     contractor.set_verbose(verbose);
+    std::string threads = cfg.get_param_value("threads");
+    if(threads != "")
+    {
+        contractor.set_num_threads(std::max(std::stoi(threads), 1));
+    }
     contractor.contract(&chd, verify);
 
 
@@ -73,7 +101,9 @@ int main(int argc, char** argv)
 	{
 		{"verbose", no_argument, &verbose, 1},
 		{"verify", no_argument, &verify, 1},
+		{"cch", no_argument, &customizable, 1},
 		{"input",  required_argument, &has_input, 1},
+		{"threads",  required_argument, 0, 1},
 		{0,  0, 0, 0}
 	};
 	cfg.parse_args(argc, argv, "abc:d:", valid_args);
@@ -0,0 +1,184 @@
+// programs/cpd_bench.cpp
+//
+// Microbenchmark for the run lookups of CPD oracles (cf. find_run in
+// cpd/cpd.h). Samples random (row, column) lookups from a real CPD and
+// times, for rows of different lengths, the generic binary search that
+// get_move used to call and each of the specialised searches.
+//
+// usage: cpd_bench --input [xy graph] [cpd file] [--num lookups] [--seed]
+//
+
+#include "binary.h"
+#include "cfg.h"
+#include "cpd.h"
+#include "graph_oracle.h"
+#include "timer.h"
+#include "xy_graph.h"
+
+#include "getopt.h"
+
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+struct lookup
+{
+    const warthog::cpd::rle_run32* row_;
+    uint32_t size_;
+    uint32_t index_;
+};
+
+typedef std::function<bool(uint32_t&)> t_find_fn;
+
+// the search get_move used before find_run
+uint32_t
+generic_find_run(uint32_t index, const warthog::cpd::rle_run32* row,
+                 uint32_t size)
+{
+    t_find_fn find_target = [&index, row](uint32_t mid)
+    {
+        return index < row[mid].get_index();
+    };
+
+    return warthog::util::binary_find_first<uint32_t, t_find_fn>(
+            0, size, find_target);
+}
+
+typedef uint32_t (*t_search_fn)(
+        uint32_t, const warthog::cpd::rle_run32*, uint32_t);
+
+// time @param fn over @param lookups; returns ns per lookup. the sum of
+// the moves found is returned in @param checksum so that the compiler
+// cannot elide the searches.
+double
+time_search(t_search_fn fn, std::vector<lookup>& lookups, uint64_t& checksum)
+{
+    warthog::timer t;
+    checksum = 0;
+    t.start();
+    for(lookup& l : lookups)
+    {
+        checksum += l.row_[fn(l.index_, l.row_, l.size_)].get_move();
+    }
+    t.stop();
+    return t.elapsed_time_nano() / (double)lookups.size();
+}
+
+int
+main(int argc, char** argv)
+{
+    warthog::util::param valid_args[] =
+    {
+        {"input", required_argument, 0, 1},
+        {"num", required_argument, 0, 1},
+        {"seed", required_argument, 0, 1},
+        {0, 0, 0, 0}
+    };
+
+    warthog::util::cfg cfg;
+    cfg.parse_args(argc, argv, valid_args);
+
+    std::string xy_filename = cfg.get_param_value("input");
+    std::string cpd_filename = cfg.get_param_value("input");
+    std::string s_num = cfg.get_param_value("num");
+    std::string s_seed = cfg.get_param_value("seed");
+
+    if(xy_filename == "")
+    {
+        std::cerr << "parameter is missing: --input [xy graph] [cpd file]\n";
+        return EXIT_FAILURE;
+    }
+    if(cpd_filename == "") { cpd_filename = xy_filename + ".cpd"; }
+    uint32_t num = s_num == "" ? 1000000 : std::stoi(s_num);
+    uint32_t seed = s_seed == "" ? 42 : std::stoi(s_seed);
+
+    warthog::graph::xy_graph g;
+    std::ifstream ifs(xy_filename);
+    ifs >> g;
+    ifs.close();
+
+    // the lookups are the same for every type of run-length encoded CPD;
+    // streamed CPDs of any such type can be read as forward ones
+    warthog::cpd::graph_oracle oracle(&g);
+    ifs.open(cpd_filename);
+    if(!ifs.is_open())
+    {
+        std::cerr << "Could not find CPD file '" << cpd_filename << "'\n";
+        return EXIT_FAILURE;
+    }
+    if(!oracle.load_flat(cpd_filename.c_str())) { ifs >> oracle; }
+    ifs.close();
+
+    // bucket b holds lookups in rows of (2^(b-1), 2^b] runs
+    const uint32_t num_buckets = 12;
+    std::vector<std::vector<lookup>> buckets(num_buckets);
+    std::vector<lookup> all;
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> pick_row(
+            0, (uint32_t)oracle.get_num_rows() - 1);
+    std::uniform_int_distribution<uint32_t> pick_col(
+            0, oracle.get_num_nodes() - 1);
+    for(uint32_t i = 0; i < num; i++)
+    {
+        lookup l;
+        l.row_ = oracle.get_runs(pick_row(rng), l.size_);
+        if(l.size_ == 0) { continue; }
+        l.index_ = pick_col(rng);
+
+        uint32_t b = 0;
+        while(b < num_buckets - 1 && (1u << b) < l.size_) { b++; }
+        buckets.at(b).push_back(l);
+        all.push_back(l);
+    }
+
+    // every search must find the same run
+    for(lookup& l : all)
+    {
+        uint32_t expected = generic_find_run(l.index_, l.row_, l.size_);
+        if(warthog::cpd::scan_runs(l.index_, l.row_, l.size_) != expected ||
+           warthog::cpd::bisect_runs(l.index_, l.row_, l.size_) != expected ||
+           warthog::cpd::find_run(l.index_, l.row_, l.size_) != expected)
+        {
+            std::cerr << "err; searches disagree on column " << l.index_
+                << " of a row with " << l.size_ << " runs\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+#ifdef __AVX2__
+    std::cout << "# scan_runs uses AVX2\n";
+#endif
+    std::cout << "# ns per lookup over " << all.size() << " lookups; "
+        << "find_run scans rows of at most "
+        << warthog::cpd::CPD_SCAN_MAX_RUNS << " runs\n";
+    std::cout << "runs\tlookups\tgeneric\tscan\tbisect\tfind_run\n";
+    std::cout << std::fixed << std::setprecision(2);
+
+    uint64_t sum_generic, sum_scan, sum_bisect, sum_find;
+    for(uint32_t b = 0; b <= num_buckets; b++)
+    {
+        std::vector<lookup>& lookups = b < num_buckets ? buckets.at(b) : all;
+        if(lookups.size() == 0) { continue; }
+
+        if(b == num_buckets) { std::cout << "all"; }
+        else if(b == num_buckets - 1)
+        { std::cout << ">" << (1u << (b - 1)); }
+        else { std::cout << "<=" << (1u << b); }
+
+        double generic = time_search(generic_find_run, lookups, sum_generic);
+        double scan = time_search(warthog::cpd::scan_runs, lookups, sum_scan);
+        double bisect =
+            time_search(warthog::cpd::bisect_runs, lookups, sum_bisect);
+        double find = time_search(warthog::cpd::find_run, lookups, sum_find);
+        assert(sum_generic == sum_scan && sum_scan == sum_bisect &&
+               sum_bisect == sum_find);
+
+        std::cout << "\t" << lookups.size() << "\t" << generic << "\t"
+            << scan << "\t" << bisect << "\t" << find << "\n";
+    }
+
+    return EXIT_SUCCESS;
+}
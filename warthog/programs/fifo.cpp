@@ -3,9 +3,17 @@
 // Run warthog reading from a FIFO (kernel-level file descriptor). This allows
 // to interface with any other program able to output querysets to the FIFO.
 //
+// With `--socket [path]` the program instead listens on a Unix domain socket
+// and keeps clients connected between batches; see 'extra/socket_protocol.h'.
+// Clients share one server thread: batches run one at a time, each using
+// every search thread, so a client sending a large batch delays the others.
+// A client that stops reading its results is disconnected after
+// SOCKET_SEND_TIMEOUT seconds rather than blocking the server.
+//
 // TODO There's a lot of duplicate code between here and 'programs/roadhog.cpp',
 // mainly loading code. Find a way to DRY up?
 //
+#include <algorithm>
 #include <cstdlib>
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,17 +22,25 @@
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <poll.h>
 #include <unistd.h>
 #include <getopt.h>
 #include <csignal>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <omp.h>
 #include <json.hpp>
 
 #include "bch_expansion_policy.h"
 #include "bch_search.h"
+#include "cch.h"
 #include "cfg.h"
 #include "ch_data.h"
 #include "cpd_extractions.h"
@@ -35,6 +51,7 @@
 #include "json_config.h"
 #include "log.h"
 #include "noop_search.h"
+#include "socket_protocol.h"
 #include "solution.h"
 #include "timer.h"
 #include "xy_graph.h"
@@ -44,8 +61,16 @@ typedef warthog::sn_id_t t_query;
 
 // Defaults
 std::string fifo = "/tmp/warthog.fifo";
+// Serve requests on a Unix domain socket at `fifo` rather than a named pipe
+bool use_socket = false;
+// Whether `fifo` was created by this process, and is removed on exit
+bool fifo_created = false;
+// Seconds a socket client has to accept its results
+const int SOCKET_SEND_TIMEOUT = 5;
 std::vector<warthog::search*> algos;
 warthog::util::cfg cfg;
+// The hierarchy re-customised after each batch of perturbations (--alg cch)
+warthog::ch::customizable_ch* cch = nullptr;
 
 //
 // - Functions
@@ -55,7 +80,7 @@ signalHandler(int signum)
 {
     warning(true, "Interrupt signal", signum, "received.");
 
-    remove(fifo.c_str());
+    if (fifo_created) { remove(fifo.c_str()); }
 
     exit(signum);
 }
@@ -102,6 +127,18 @@ read_graph_and_diff(warthog::graph::xy_graph& g)
     return xy_filename;
 }
 
+// Apply the perturbations to the graph, and to the hierarchy over it if any
+void
+perturb(warthog::graph::xy_graph* g,
+        std::vector<std::pair<uint32_t, warthog::graph::edge>>& edges)
+{
+    g->perturb(edges);
+    if (cch != nullptr && !edges.empty())
+    {
+        cch->customize();
+    }
+}
+
 template<warthog::cpd::symbol S>
 void
 read_oracle(std::string xy_filename, warthog::cpd::graph_oracle_base<S>& oracle)
@@ -117,7 +154,8 @@ read_oracle(std::string xy_filename, warthog::cpd::graph_oracle_base<S>& oracle)
     ifs.open(cpd_filename);
     if(ifs.is_open())
     {
-        ifs >> oracle;
+        // flat CPDs are mapped rather than read
+        if(!oracle.load_flat(cpd_filename.c_str())) { ifs >> oracle; }
         ifs.close();
     }
     else
@@ -149,32 +187,89 @@ conf_oracle(warthog::cpd::graph_oracle_base<S>& oracle)
     }
 }
 
+// Queries handed out to a thread at a time; small enough that an expensive
+// query does not hold up the rest of a batch.
+const size_t CHUNK_SIZE = 8;
+
 /**
- * The search function does a bunch of statistics out of the search. It takes a
- * configration object, an output pipe and a list of queries and processes them.
+ * The queries initially assigned to one thread, by index into the request
+ * vector. The owner takes chunks from the front while idle threads steal
+ * chunks from the back. Queries are never added once the batch starts, so a
+ * thread that finds every deque empty is done.
+ */
+struct alignas(64) work_deque
+{
+    std::mutex lock;
+    std::vector<size_t> items;
+    size_t head = 0;
+    size_t tail = 0;
+
+    // Claim up to CHUNK_SIZE queries, as positions [first, last) in `items`.
+    bool
+    take(bool from_back, size_t& first, size_t& last)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (head == tail) { return false; }
+
+        size_t n = std::min(CHUNK_SIZE, tail - head);
+        if (from_back)
+        {
+            tail -= n;
+            first = tail;
+        }
+        else
+        {
+            first = head;
+            head += n;
+        }
+        last = first + n;
+        return true;
+    }
+};
+
+/**
+ * Per-query statistics; threads write to disjoint slots and the totals are
+ * summed in input order, so the output does not depend on the schedule.
+ */
+struct query_stats
+{
+    unsigned int n_expanded;
+    unsigned int n_touched;
+    unsigned int n_reopen;
+    unsigned int n_surplus;
+    unsigned int n_heap_ops;
+    unsigned int plen;
+    bool finished;
+    double t_astar;
+    double cost;
+};
+
+/**
+ * Process a list of queries and gather statistics: totals go in `res` and the
+ * cost of each path in `costs`, in input order.
+ *
+ * Queries are first split between threads, either in contiguous ranges or, if
+ * `thread_alloc` is set, by target (so that a thread keeps hitting the same CPD
+ * rows). Threads that run out of work then steal chunks from the others.
  */
 void
-run_search(conf_fn& apply_conf, config& conf, const std::string& fifo_out,
-           const std::vector<t_query> &reqs, double t_read,
-           warthog::graph::xy_graph* g)
+search_batch(conf_fn& apply_conf, config& conf,
+             const std::vector<t_query> &reqs, warthog::graph::xy_graph* g,
+             socket_protocol::result_header& res, std::vector<double>& costs)
 {
     assert(reqs.size() % 2 == 0);
     size_t n_results = reqs.size() / 2;
-    // Statistics
-    unsigned int n_expanded = 0;
-    unsigned int n_touched = 0;
-    unsigned int n_reopen = 0;
-    unsigned int n_surplus = 0;
-    unsigned int n_heap_ops = 0;
-    unsigned int plen = 0;
-    unsigned int finished = 0;
-    double t_astar = 0;
+    res = socket_protocol::result_header();
+    res.n_results = n_results;
+    costs.resize(n_results);
 
 #ifdef SINGLE_THREADED
     unsigned int threads = 1;
 #else
     unsigned int threads = conf.threads;
 #endif
+    // one search object per thread
+    threads = std::max(1u, std::min(threads, (unsigned int)algos.size()));
 
     warthog::timer t;
     user(conf.verbose, "Preparing to process", n_results, "queries using",
@@ -182,12 +277,34 @@ run_search(conf_fn& apply_conf, config& conf, const std::string& fifo_out,
 
     t.start();
 
-#pragma omp parallel num_threads(threads)                               \
-    reduction(+ : t_astar, n_expanded, n_touched, n_reopen, \
-              n_surplus, n_heap_ops, plen, finished)
+    // Initial allocation of queries to threads
+    std::unique_ptr<work_deque[]> deques(new work_deque[threads]);
+    for (size_t id = 0; id < n_results; id++)
+    {
+        size_t owner;
+        if (conf.thread_alloc)
+        {
+            owner = reqs.at(id * 2 + 1) % threads;
+        }
+        else
+        {
+            owner = id * threads / n_results;
+        }
+        deques[owner].items.push_back(id);
+    }
+    for (unsigned int i = 0; i < threads; i++)
+    {
+        deques[i].tail = deques[i].items.size();
+    }
+
+    std::vector<query_stats> stats(n_results);
+    std::vector<size_t> processed(threads, 0);
+    std::vector<size_t> steals(threads, 0);
+    std::vector<double> busy_us(threads, 0);
+
+#pragma omp parallel num_threads(threads)
     {
         // Parallel data
-        unsigned int thread_count = omp_get_num_threads();
         unsigned int thread_id = omp_get_thread_num();
 
         warthog::timer t_thread;
@@ -196,19 +313,6 @@ run_search(conf_fn& apply_conf, config& conf, const std::string& fifo_out,
 
         apply_conf(alg, conf);
 
-        size_t from = 0;
-        size_t to = n_results;
-
-        if (!conf.thread_alloc)
-        {
-            // Instead of bothering with manual conversion (think 'ceil()'), we
-            // use the magic of "usual arithmetic" to achieve the right from/to
-            // values.
-            size_t step = n_results * thread_id;
-            from = step / thread_count;
-            to = (step + n_results) / thread_count;
-        }
-
         if (conf.no_cache && g != nullptr)
         {
             // Mini-hack: perturbing no edges will still increment the graph
@@ -218,48 +322,101 @@ run_search(conf_fn& apply_conf, config& conf, const std::string& fifo_out,
         }
 
         t_thread.start();
-        // Iterate over the *requests* then convert to ids ({o,d} pair)
-        for (auto id = from; id < to; id += 1)
+        while (true)
         {
-            size_t i = id * 2;
-            warthog::sn_id_t start_id = reqs.at(i);
-            warthog::sn_id_t target_id = reqs.at(i + 1);
-
-            // Allocate targets to threads.
-            //
-            // TODO Better thread alloc?
-            //
-            // TODO If we have `oracle.mod == thread_count` then only one core
-            // will work.
-            if (conf.thread_alloc && target_id % thread_count != thread_id)
-            { continue; }
-
-            // Actual search
-            warthog::problem_instance pi(start_id, target_id, conf.debug);
-            alg->get_path(pi, sol);
-
-            // Update stasts
-            t_astar += sol.time_elapsed_nano_;
-            n_expanded += sol.nodes_expanded_;
-            n_touched += sol.nodes_touched_;
-            n_heap_ops += sol.heap_ops_;
-            n_reopen += sol.nodes_reopen_;
-            n_surplus += sol.nodes_surplus_;
-            plen += sol.path_.size();
-            finished += sol.path_.back() == target_id;
+            size_t first, last;
+            work_deque* src = &deques[thread_id];
+
+            // Own work first, then steal from the other threads (including
+            // any the runtime did not start).
+            if (!src->take(false, first, last))
+            {
+                src = nullptr;
+                for (unsigned int k = 1; k < threads; k++)
+                {
+                    work_deque* victim = &deques[(thread_id + k) % threads];
+                    if (victim->take(true, first, last))
+                    {
+                        src = victim;
+                        steals.at(thread_id) += 1;
+                        break;
+                    }
+                }
+                if (src == nullptr) { break; }
+            }
+
+            // Iterate over the *requests* then convert to ids ({o,d} pair)
+            for (size_t pos = first; pos < last; pos++)
+            {
+                size_t id = src->items.at(pos);
+                warthog::sn_id_t start_id = reqs.at(id * 2);
+                warthog::sn_id_t target_id = reqs.at(id * 2 + 1);
+
+                // Actual search
+                warthog::problem_instance pi(start_id, target_id, conf.debug);
+                alg->get_path(pi, sol);
+
+                // Update stats
+                query_stats& st = stats.at(id);
+                st.t_astar = sol.time_elapsed_nano_;
+                st.n_expanded = sol.nodes_expanded_;
+                st.n_touched = sol.nodes_touched_;
+                st.n_heap_ops = sol.heap_ops_;
+                st.n_reopen = sol.nodes_reopen_;
+                st.n_surplus = sol.nodes_surplus_;
+                st.plen = sol.path_.size();
+                st.finished =
+                    !sol.path_.empty() && sol.path_.back() == target_id;
+                st.cost = sol.sum_of_edge_costs_;
+            }
+            processed.at(thread_id) += last - first;
         }
 
         t_thread.stop();
-
-#pragma omp critical
-        trace(conf.verbose, "[", thread_id, "] Processed", to - from,
-              "trips in", t_thread.elapsed_time_micro(), "us.");
+        busy_us.at(thread_id) = t_thread.elapsed_time_micro();
     }
 
     t.stop();
 
+    for (size_t id = 0; id < n_results; id++)
+    {
+        const query_stats& st = stats.at(id);
+        res.t_astar += st.t_astar;
+        res.n_expanded += st.n_expanded;
+        res.n_touched += st.n_touched;
+        res.n_heap_ops += st.n_heap_ops;
+        res.n_reopen += st.n_reopen;
+        res.n_surplus += st.n_surplus;
+        res.plen += st.plen;
+        res.finished += st.finished;
+        costs.at(id) = st.cost;
+    }
+    res.t_search = t.elapsed_time_nano();
+
+    // Threads that ran out of work early sat idle until the batch was done.
+    for (unsigned int i = 0; i < threads; i++)
+    {
+        trace(conf.verbose, "[", i, "] Processed", processed.at(i),
+              "trips in", busy_us.at(i), "us; stole", steals.at(i),
+              "chunks; idle", t.elapsed_time_micro() - busy_us.at(i), "us.");
+    }
+
     user(conf.verbose, "Processed", n_results, "in", t.elapsed_time_micro(),
          "us");
+}
+
+/**
+ * The search function does a bunch of statistics out of the search. It takes a
+ * configration object, an output pipe and a list of queries and processes them.
+ */
+void
+run_search(conf_fn& apply_conf, config& conf, const std::string& fifo_out,
+           const std::vector<t_query> &reqs, double t_read,
+           warthog::graph::xy_graph* g)
+{
+    socket_protocol::result_header res;
+    std::vector<double> costs;
+    search_batch(apply_conf, conf, reqs, g, res, costs);
 
     std::streambuf* buf;
     std::ofstream of;
@@ -276,11 +433,11 @@ run_search(conf_fn& apply_conf, config& conf, const std::string& fifo_out,
     std::ostream out(buf);
 
     debug(conf.verbose, "Spawned a writer on", fifo_out);
-    out << n_expanded << "," << n_touched << ","
-        << n_reopen << "," << n_surplus << "," 
-        << n_heap_ops << "," << plen << ","
-        << finished << "," << t_read << "," << t_astar << ","
-        << t.elapsed_time_nano() << std::endl;
+    out << res.n_expanded << "," << res.n_touched << ","
+        << res.n_reopen << "," << res.n_surplus << "," 
+        << res.n_heap_ops << "," << res.plen << ","
+        << res.finished << "," << t_read << "," << res.t_astar << ","
+        << res.t_search << std::endl;
 
     if (fifo_out != "-") { of.close(); }
 }
@@ -368,7 +525,7 @@ reader(conf_fn& apply_conf, warthog::graph::xy_graph* g)
 
         if (diff != "-" && g != nullptr)
         {
-            fd.open(queries);
+            fd.open(diff);
             if (!fd.good())
             {
                 warning("Could not open", diff);
@@ -393,7 +550,7 @@ reader(conf_fn& apply_conf, warthog::graph::xy_graph* g)
             }
             fd.close();
 
-            g->perturb(edges);
+            perturb(g, edges);
         }
         t.stop();
 
@@ -417,6 +574,286 @@ reader(conf_fn& apply_conf, warthog::graph::xy_graph* g)
     }
 }
 
+/**
+ * A client of the socket server: the bytes received but not yet processed, and
+ * the configuration applied to its batches.
+ */
+struct connection
+{
+    int fd;
+    std::vector<char> buf;
+    config conf;
+};
+
+/**
+ * Send a frame, retrying on partial writes. Returns false if the client has
+ * gone away.
+ */
+bool
+send_frame(int fd, uint32_t type, const std::vector<char>& payload)
+{
+    socket_protocol::frame_header hdr = {(uint32_t)payload.size(), type};
+    std::vector<char> out(sizeof(hdr) + payload.size());
+    memcpy(out.data(), &hdr, sizeof(hdr));
+    if (!payload.empty())
+    {
+        memcpy(out.data() + sizeof(hdr), payload.data(), payload.size());
+    }
+
+    size_t sent = 0;
+    while (sent < out.size())
+    {
+        ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        sent += n;
+    }
+
+    return true;
+}
+
+bool
+send_error(int fd, const std::string& msg)
+{
+    warning(true, "Closing connection", fd, ":", msg);
+    send_frame(fd, socket_protocol::ERROR,
+               std::vector<char>(msg.begin(), msg.end()));
+    return false;
+}
+
+/**
+ * Handle one frame from a client. Returns false if the connection should be
+ * closed.
+ */
+bool
+handle_frame(conf_fn& apply_conf, connection& c, uint32_t type,
+             const char* payload, uint32_t size, warthog::graph::xy_graph* g)
+{
+    switch (type)
+    {
+    case socket_protocol::CONFIG:
+    {
+        std::istringstream iss(std::string(payload, size));
+        try
+        {
+            iss >> c.conf;
+            sanitise_conf(c.conf);
+        }
+        catch (std::exception& e)
+        {
+            return send_error(c.fd, e.what());
+        }
+        trace(c.conf.verbose, c.conf);
+        return true;
+    }
+
+    case socket_protocol::EDGES:
+    {
+        size_t n = size / sizeof(socket_protocol::edge_record);
+        if (size % sizeof(socket_protocol::edge_record) != 0)
+        {
+            return send_error(c.fd, "malformed EDGES frame");
+        }
+        if (g == nullptr)
+        {
+            return send_error(c.fd, "this algorithm does not take perturbations");
+        }
+
+        std::vector<std::pair<uint32_t, warthog::graph::edge>> edges(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            socket_protocol::edge_record e;
+            memcpy(&e, payload + i * sizeof(e), sizeof(e));
+            edges.at(i) = {e.head, warthog::graph::edge(e.tail, e.weight)};
+        }
+        perturb(g, edges);
+        debug(c.conf.verbose, "Applied", n, "perturbations");
+        return true;
+    }
+
+    case socket_protocol::QUERIES:
+    {
+        warthog::timer t;
+        t.start();
+        if (size % (2 * sizeof(t_query)) != 0)
+        {
+            return send_error(c.fd, "malformed QUERIES frame");
+        }
+        std::vector<t_query> lines(size / sizeof(t_query));
+        if (size > 0) { memcpy(lines.data(), payload, size); }
+        t.stop();
+
+        socket_protocol::result_header res;
+        std::vector<double> costs;
+        search_batch(apply_conf, c.conf, lines, g, res, costs);
+        res.t_read = t.elapsed_time_nano();
+
+        std::vector<char> out(sizeof(res) + costs.size() * sizeof(double));
+        memcpy(out.data(), &res, sizeof(res));
+        if (!costs.empty())
+        {
+            memcpy(out.data() + sizeof(res), costs.data(),
+                   costs.size() * sizeof(double));
+        }
+        return send_frame(c.fd, socket_protocol::RESULT, out);
+    }
+
+    default:
+        return send_error(c.fd, "unknown frame type " + std::to_string(type));
+    }
+}
+
+/**
+ * Process every complete frame buffered for a client, in order.
+ */
+bool
+process_frames(conf_fn& apply_conf, connection& c, warthog::graph::xy_graph* g)
+{
+    size_t pos = 0;
+    bool open = true;
+    while (open && c.buf.size() - pos >= sizeof(socket_protocol::frame_header))
+    {
+        socket_protocol::frame_header hdr;
+        memcpy(&hdr, c.buf.data() + pos, sizeof(hdr));
+        if (hdr.size > socket_protocol::MAX_FRAME_SIZE)
+        {
+            open = send_error(c.fd, "frame too large");
+            break;
+        }
+
+        size_t end = pos + sizeof(hdr) + hdr.size;
+        if (c.buf.size() < end) { break; }
+
+        open = handle_frame(apply_conf, c, hdr.type,
+                            c.buf.data() + pos + sizeof(hdr), hdr.size, g);
+        pos = end;
+    }
+
+    c.buf.erase(c.buf.begin(), c.buf.begin() + pos);
+    return open;
+}
+
+/**
+ * The socket server keeps clients connected between batches; see
+ * socket_protocol.h for the framing. Batches run one at a time, using every
+ * thread, in the order their last byte arrives.
+ */
+void
+socket_server(conf_fn& apply_conf, warthog::graph::xy_graph* g)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (fifo.size() >= sizeof(addr.sun_path))
+    {
+        warning(true, "Socket path too long:", fifo);
+        return;
+    }
+    strncpy(addr.sun_path, fifo.c_str(), sizeof(addr.sun_path) - 1);
+
+    // Replace a socket left by an earlier run, but nothing else
+    struct stat st;
+    if (lstat(fifo.c_str(), &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+        {
+            warning(true, "Not replacing", fifo, "as it is not a socket");
+            return;
+        }
+        unlink(fifo.c_str());
+    }
+
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (lfd < 0 || bind(lfd, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(lfd, SOMAXCONN) < 0)
+    {
+        perror("socket");
+        return;
+    }
+    fifo_created = true;
+    debug(VERBOSE, "Listening on", fifo);
+
+    std::vector<std::unique_ptr<connection>> conns;
+    std::vector<pollfd> fds;
+    std::vector<char> chunk(1 << 16);
+
+    while (true)
+    {
+        fds.clear();
+        fds.push_back({lfd, POLLIN, 0});
+        for (auto& c : conns) { fds.push_back({c->fd, POLLIN, 0}); }
+
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR) { continue; }
+            perror("poll");
+            return;
+        }
+
+        // Existing clients first; `fds` does not cover new connections yet
+        for (size_t i = 1; i < fds.size(); i++)
+        {
+            if (fds.at(i).revents == 0) { continue; }
+
+            connection& c = *conns.at(i - 1);
+            ssize_t n = read(c.fd, chunk.data(), chunk.size());
+            bool open = n > 0 || (n < 0 && errno == EINTR);
+            if (n > 0)
+            {
+                c.buf.insert(c.buf.end(), chunk.begin(), chunk.begin() + n);
+                open = process_frames(apply_conf, c, g);
+            }
+
+            if (!open)
+            {
+                debug(c.conf.verbose, "Client", c.fd, "disconnected");
+                close(c.fd);
+                c.fd = -1;
+            }
+        }
+
+        conns.erase(
+            std::remove_if(conns.begin(), conns.end(),
+                [](const std::unique_ptr<connection>& c) { return c->fd < 0; }),
+            conns.end());
+
+        if (fds.at(0).revents & POLLIN)
+        {
+            int cfd = accept(lfd, nullptr, nullptr);
+            if (cfd >= 0)
+            {
+                timeval tv = {SOCKET_SEND_TIMEOUT, 0};
+                setsockopt(cfd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+                connection* c = new connection();
+                c->fd = cfd;
+                sanitise_conf(c->conf);
+                conns.push_back(std::unique_ptr<connection>(c));
+                debug(VERBOSE, "Client", cfd, "connected");
+            }
+        }
+    }
+}
+
+/**
+ * Wait for requests on the named pipe or, with --socket, the Unix socket.
+ */
+void
+serve(conf_fn& apply_conf, warthog::graph::xy_graph* g)
+{
+    if (use_socket)
+    {
+        socket_server(apply_conf, g);
+    }
+    else
+    {
+        reader(apply_conf, g);
+    }
+}
+
 void
 run_cpd_search(warthog::graph::xy_graph &g)
 {
@@ -463,7 +900,7 @@ run_cpd_search(warthog::graph::xy_graph &g)
         alg->set_quality_cutoff(conf.fscale);
     };
 
-    reader(apply_conf, &g);
+    serve(apply_conf, &g);
 }
 
 void
@@ -513,7 +950,7 @@ run_table_search(warthog::graph::xy_graph &g)
         alg->set_quality_cutoff(conf.fscale);
     };
 
-    reader(apply_conf, &g);
+    serve(apply_conf, &g);
 }
 
 void
@@ -551,7 +988,7 @@ run_table(warthog::graph::xy_graph &g)
         alg->set_max_k_moves(conf.k_moves);
     };
 
-    reader(apply_conf, &g);
+    serve(apply_conf, &g);
 }
 
 void
@@ -578,7 +1015,8 @@ run_cpd(warthog::graph::xy_graph &g)
     ifs.open(cpd_filename);
     if(ifs.is_open())
     {
-        ifs >> oracle;
+        // flat CPDs are mapped rather than read
+        if(!oracle.load_flat(cpd_filename.c_str())) { ifs >> oracle; }
         ifs.close();
     }
     else
@@ -602,7 +1040,7 @@ run_cpd(warthog::graph::xy_graph &g)
         alg->set_max_k_moves(conf.k_moves);
     };
 
-    reader(apply_conf, &g);
+    serve(apply_conf, &g);
 }
 
 void
@@ -644,7 +1082,38 @@ run_bch()
     conf_fn apply_conf = [] (warthog::search* base, config &conf) -> void
     {};
 
-    reader(apply_conf, nullptr);
+    serve(apply_conf, nullptr);
+}
+
+void
+run_cch(warthog::graph::xy_graph &g)
+{
+    std::string xy_filename = read_graph_and_diff(g);
+    if (xy_filename == "") { return; }
+
+    std::vector<uint32_t> order;
+    warthog::ch::nested_dissection_order(&g, order);
+    cch = new warthog::ch::customizable_ch(&g, order);
+    warthog::graph::xy_graph* chg = cch->get_ch_data()->g_;
+
+    for (auto& alg: algos)
+    {
+        warthog::bch_expansion_policy* fexp =
+            new warthog::bch_expansion_policy(chg);
+        warthog::bch_expansion_policy* bexp =
+            new warthog::bch_expansion_policy(chg, true);
+        warthog::zero_heuristic* h = new warthog::zero_heuristic();
+        alg = new warthog::bch_search<
+            warthog::zero_heuristic, warthog::bch_expansion_policy>
+            (fexp, bexp, h);
+    }
+
+    user(VERBOSE, "Loaded", algos.size(), "search.");
+
+    conf_fn apply_conf = [] (warthog::search* base, config &conf) -> void
+    {};
+
+    serve(apply_conf, &g);
 }
 
 void
@@ -660,7 +1129,7 @@ run_noop()
     conf_fn apply_conf = [] (warthog::search* base, config &conf) -> void
     {};
 
-    reader(apply_conf, nullptr);
+    serve(apply_conf, nullptr);
 }
 
 
@@ -679,6 +1148,7 @@ main(int argc, char *argv[])
             // {"noheader",  no_argument, &suppress_header, 1},
             {"input", required_argument, 0, 1},
             {"fifo",  required_argument, 0, 1},
+            {"socket", required_argument, 0, 1},
             {"alg",   required_argument, 0, 1},
             {"div",   required_argument, 0, 1},
             {"mod",   required_argument, 0, 1},
@@ -718,12 +1188,24 @@ main(int argc, char *argv[])
         fifo = other;
     }
 
-    int status = mkfifo(fifo.c_str(), S_IFIFO | 0666);
-
-    if (status < 0)
+    // The socket replaces the pipe; it is created once the data is loaded.
+    // Its clients are served one batch at a time (see the top of this file).
+    other = cfg.get_param_value("socket");
+    if (other != "")
     {
-        perror("mkfifo");
-        return EXIT_FAILURE;
+        fifo = other;
+        use_socket = true;
+    }
+    else
+    {
+        int status = mkfifo(fifo.c_str(), S_IFIFO | 0666);
+
+        if (status < 0)
+        {
+            perror("mkfifo");
+            return EXIT_FAILURE;
+        }
+        fifo_created = true;
     }
 
     debug(true, "Reading from", fifo);
@@ -754,6 +1236,11 @@ main(int argc, char *argv[])
     {
         run_bch();
     }
+    else if (alg_name == "cch")
+    {
+        // Customisable CH, customised again after each perturbation
+        run_cch(g);
+    }
     else if (alg_name == "noop")
     {
         run_noop();
@@ -0,0 +1,58 @@
+// programs/grid2bin.cpp
+//
+// Converts a gridmap from the ASCII format of the Grid-based Path Planning
+// Competition to the binary format of warthog::gridmap, which is mapped
+// instead of parsed when loaded (cf. gridmap.h).
+//
+
+#include "gridmap.h"
+#include "timer.h"
+
+#include <fstream>
+#include <iostream>
+
+void
+help()
+{
+    std::cerr
+       << "Converts a grid map to the binary gridmap format of the Warthog "
+       << "Pathfinding Library\n"
+       << "\n"
+       << "Usage: ./grid2bin [map file] [output file]\n"
+       << "\nThe binary file stores the padded map as it is in memory; it is "
+       << "only readable\nby builds with the same DBWORD_BITS, or it is "
+       << "converted when loaded.\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    if(argc != 3)
+    {
+        help();
+        exit(0);
+    }
+
+    warthog::timer t;
+    t.start();
+    warthog::gridmap gm(argv[1]);
+    t.stop();
+    if(gm.is_mapped())
+    {
+        std::cerr << "err; " << argv[1] << " is already a binary gridmap\n";
+        return EXIT_FAILURE;
+    }
+    std::cerr << "parsed " << argv[1] << " in "
+        << t.elapsed_time_micro() << "us\n";
+
+    std::ofstream out(argv[2], std::ios_base::out | std::ios_base::binary);
+    if(!out.is_open())
+    {
+        std::cerr << "err; cannot open " << argv[2] << " for writing\n";
+        return EXIT_FAILURE;
+    }
+    if(!gm.write_binary(out)) { return EXIT_FAILURE; }
+    out.close();
+    std::cerr << "wrote " << argv[2] << "\n";
+    return EXIT_SUCCESS;
+}
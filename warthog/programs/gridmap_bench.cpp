@@ -0,0 +1,84 @@
+// programs/gridmap_bench.cpp
+//
+// Measures how long it takes to load gridmaps. Every map given is loaded
+// --repeat times and the mean time per load is printed, together with a
+// checksum of the traversable tiles and a sample of neighbour lookups so
+// that maps in different formats can be compared.
+//
+// usage: gridmap_bench [--repeat n] --input [map file] [map file] ...
+//
+
+#include "cfg.h"
+#include "gridmap.h"
+#include "timer.h"
+
+#include "getopt.h"
+
+#include <iomanip>
+#include <sstream>
+
+int
+main(int argc, char** argv)
+{
+    warthog::util::param valid_args[] =
+    {
+        {"input", required_argument, 0, 1},
+        {"repeat", required_argument, 0, 1},
+        {0, 0, 0, 0}
+    };
+
+    warthog::util::cfg cfg;
+    cfg.parse_args(argc, argv, valid_args);
+
+    std::string s_repeat = cfg.get_param_value("repeat");
+    uint32_t repeat = s_repeat == "" ? 10 : std::stoi(s_repeat);
+
+    std::vector<std::string> files;
+    for(std::string f = cfg.get_param_value("input"); f != "";
+            f = cfg.get_param_value("input"))
+    {
+        files.push_back(f);
+    }
+    if(files.size() == 0)
+    {
+        std::cerr << "parameter is missing: --input [map file] ...\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "map\tmapped\tus_per_load\ttraversable\tcheck\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for(std::string& f : files)
+    {
+        warthog::timer t;
+        double total_us = 0;
+        uint32_t traversable = 0;
+        uint64_t check = 0;
+        bool mapped = false;
+        for(uint32_t i = 0; i < repeat; i++)
+        {
+            t.start();
+            warthog::gridmap gm(f.c_str());
+            t.stop();
+            total_us += t.elapsed_time_micro();
+
+            // outside the timed region: touch the map so that a lazy
+            // load cannot look better than it is on first use
+            mapped = gm.is_mapped();
+            traversable = gm.get_num_traversable_tiles();
+            check = 0;
+            for(uint32_t y = 0; y < gm.header_height(); y += 7)
+            {
+                for(uint32_t x = 0; x < gm.header_width(); x += 3)
+                {
+                    uint8_t tiles[3];
+                    gm.get_neighbours(gm.to_padded_id(x, y), tiles);
+                    check = check * 31 + (tiles[0] & 7) +
+                        ((tiles[1] & 7) << 3) + ((tiles[2] & 7) << 6);
+                }
+            }
+        }
+        std::cout << f << "\t" << mapped << "\t" << total_us / repeat
+            << "\t" << traversable << "\t" << check << "\n";
+    }
+    return EXIT_SUCCESS;
+}
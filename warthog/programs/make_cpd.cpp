@@ -1,20 +1,40 @@
 /**
  * This file is used to create CPDs in an independent fashion.
+ *
+ * Rows are written to --output as they are computed. An interrupted build
+ * is continued, from the last row on disk, by running the same command with
+ * --resume. --window bounds the number of computed rows waiting for earlier
+ * ones, --checkpoint the number of seconds between flushes of the output.
+ *
+ * Given a contraction hierarchy of the graph (--ch), rows are computed from
+ * PHAST sweeps of --lanes sources each, rather than a Dijkstra search per
+ * row. Bearing CPDs are always built with Dijkstra.
  */
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <getopt.h>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <omp.h>
+#include <sstream>
+#include <unistd.h>
 #include <vector>
 
 #include "bidirectional_graph_expansion_policy.h"
 #include "cfg.h"
+#include "ch_data.h"
 #include "constants.h"
 #include "graph_oracle.h"
 #include "oracle_listener.h"
 #include "log.h"
+#include "phast.h"
 #include "xy_graph.h"
 
 std::vector<warthog::sn_id_t>
@@ -47,15 +67,76 @@ range(size_t from, size_t to, size_t node_count)
     return nodes;
 }
 
+/**
+ * Save a CPD, either streamed or in the flat (mmap-able) format.
+ */
+template<warthog::cpd::symbol S>
+int
+write_cpd(warthog::cpd::graph_oracle_base<S> &cpd, std::string cpd_filename,
+          bool flat, bool verbose)
+{
+    std::ofstream ofs(cpd_filename, std::ios::binary);
+
+    if (!ofs.good())
+    {
+        std::cerr << "Could not open CPD file " << cpd_filename << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    info(verbose, "Writing results to", cpd_filename);
+
+    if (flat)
+    {
+        if (!cpd.write_flat(ofs)) { return EXIT_FAILURE; }
+    }
+    else
+    {
+        ofs << cpd;
+    }
+
+    ofs.close();
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Convert a CPD to the flat format; or back, if the input is already flat.
+ */
+template<warthog::cpd::symbol S>
+int
+convert_cpd(warthog::graph::xy_graph &g, std::string cpd_filename,
+            std::string input_filename, bool verbose)
+{
+    warthog::cpd::graph_oracle_base<S> cpd(&g);
+    std::ifstream ifs(input_filename);
+
+    if (!ifs.good())
+    {
+        std::cerr << "Cannot open file " << input_filename << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (cpd.load_flat(input_filename.c_str()))
+    {
+        return write_cpd<S>(cpd, cpd_filename, false, verbose);
+    }
+
+    ifs >> cpd;
+    ifs.close();
+
+    return write_cpd<S>(cpd, cpd_filename, true, verbose);
+}
+
 /**
  * Rebuild a CPD given a list of file containing its parts.
  *
  * The partial CPDs must be given in the order of the nodes.
  */
+template<warthog::cpd::symbol S>
 int
 join_cpds(warthog::graph::xy_graph &g, std::string cpd_filename,
           std::vector<std::string> file_list, uint32_t seed, bool verbose,
-          uint32_t mod)
+          uint32_t mod, bool flat)
 {
     uint32_t step = 0;
     std::vector<warthog::sn_id_t> nodes;
@@ -65,8 +146,9 @@ join_cpds(warthog::graph::xy_graph &g, std::string cpd_filename,
         nodes = modulo(0, mod, g.get_num_nodes());
     }
 
-    // Here, the type of the oracle does not matter.
-    warthog::cpd::graph_oracle cpd(&g);
+    // The type of the oracle only matters to the flat format, which
+    // records it.
+    warthog::cpd::graph_oracle_base<S> cpd(&g);
     cpd.clear();                // Need to reset fm_
     cpd.compute_dfs_preorder(seed);
     // convert the column order into a map: from vertex id to its ordered index
@@ -74,7 +156,7 @@ join_cpds(warthog::graph::xy_graph &g, std::string cpd_filename,
 
     for (auto name: file_list)
     {
-        warthog::cpd::graph_oracle part(&g);
+        warthog::cpd::graph_oracle_base<S> part(&g);
         std::ifstream ifs(name);
 
         if (!ifs.good())
@@ -102,30 +184,92 @@ join_cpds(warthog::graph::xy_graph &g, std::string cpd_filename,
         step++;
     }
 
-    std::ofstream ofs(cpd_filename);
+    return write_cpd<S>(cpd, cpd_filename, flat, verbose);
+}
 
-    if (!ofs.good())
+/**
+ * Join or convert CPDs of type S; whichever was asked for.
+ */
+template<warthog::cpd::symbol S>
+int
+rebuild_cpd(warthog::graph::xy_graph &g, std::string cpd_filename,
+            std::vector<std::string> file_list, std::string convert_filename,
+            uint32_t seed, bool verbose, uint32_t mod, bool flat)
+{
+    if (convert_filename != "")
     {
-        std::cerr << "Could not open CPD file " << cpd_filename << std::endl;
-        return EXIT_FAILURE;
+        return convert_cpd<S>(g, cpd_filename, convert_filename, verbose);
     }
 
-    info(verbose, "Writing results to", cpd_filename);
-    ofs << cpd;
-    ofs.close();
+    return join_cpds<S>(g, cpd_filename, file_list, seed, verbose, mod, flat);
+}
 
-    return EXIT_SUCCESS;
+/**
+ * Count the complete rows of the (possibly truncated) streamed CPD
+ * @param cpd_filename. Its head, i.e. the graph size and node order, must
+ * match @param head. @param end is set to the offset past the last complete
+ * row. Returns -1 if the file is missing or belongs to another build.
+ */
+int64_t
+count_streamed_rows(std::string cpd_filename, const std::string &head,
+                    uint64_t &end)
+{
+    std::ifstream ifs(cpd_filename, std::ios::binary);
+
+    if (!ifs.good()) { return -1; }
+
+    ifs.seekg(0, std::ios::end);
+    uint64_t size = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+
+    if (size < head.size()) { return -1; }
+
+    std::string file_head(head.size(), '\0');
+    ifs.read(&file_head[0], head.size());
+
+    if (file_head != head) { return -1; }
+
+    // every row we write holds at least one run
+    int64_t rows = 0;
+    end = head.size();
+    while (end + 4 <= size)
+    {
+        uint32_t num_runs;
+        ifs.read((char*)(&num_runs), 4);
+        uint64_t next = end + 4 + sizeof(warthog::cpd::rle_run32) * num_runs;
+
+        if (num_runs == 0 || next > size) { break; }
+
+        ifs.seekg(next, std::ios::beg);
+        end = next;
+        rows++;
+    }
+
+    return rows;
 }
 
+/**
+ * Compute the rows of @param nodes and stream them to @param cpd_filename.
+ *
+ * Sources are handed out to threads one at a time, in order. A finished row
+ * is held in a reorder buffer of @param window slots until every row before
+ * it is written, so at most @param window rows are ever in memory. The file
+ * is flushed every @param checkpoint seconds; it then holds every row up to
+ * the oldest unfinished one, which is where a build run with @param resume
+ * picks up after an interruption.
+ *
+ * With @param ph, each thread takes @param lanes sources at a time and
+ * computes their rows with one PHAST sweep on its own copy of @param ph.
+ */
 template<warthog::cpd::symbol S>
 int
 make_cpd(warthog::graph::xy_graph &g, warthog::cpd::graph_oracle_base<S> &cpd,
          std::vector<warthog::cpd::oracle_listener*> &listeners,
          std::string cpd_filename, std::vector<warthog::sn_id_t> &nodes,
-         bool reverse, uint32_t seed, bool verbose=false)
+         bool reverse, uint32_t seed, bool verbose=false, bool flat=false,
+         bool resume=false, uint32_t window=256, uint32_t checkpoint=60,
+         warthog::ch::phast* ph=nullptr, uint32_t lanes=1)
 {
-    unsigned char pct_done = 0;
-    uint32_t nprocessed = 0;
     size_t node_count = nodes.size();
 
     warthog::timer t;
@@ -134,19 +278,88 @@ make_cpd(warthog::graph::xy_graph &g, warthog::cpd::graph_oracle_base<S> &cpd,
     info(verbose, "Computing node ordering.");
     cpd.compute_dfs_preorder(seed);
 
-    info(verbose, "Computing Dijkstra labels.");
+    // A flat CPD needs every row before it can be written; we stream the
+    // rows to a side file and convert it at the end.
+    std::string stream_filename = cpd_filename;
+
+    if (flat) { stream_filename += ".stream"; }
+
+    // The file holds the column order as a map from vertex id to its ordered
+    // index, but the rows are built from the order itself.
+    std::ostringstream head;
+    cpd.value_index_swap_array();
+    cpd.write_order(head);
+    cpd.value_index_swap_array();
+
+    size_t done = 0;
+
+    if (resume)
+    {
+        uint64_t end;
+        int64_t rows = count_streamed_rows(stream_filename, head.str(), end);
+
+        if (rows < 0 || (size_t)rows > node_count)
+        {
+            std::cerr << "Cannot resume from " << stream_filename
+                      << "; it is missing or was built from other parameters"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // drop whatever was written of the first unfinished row
+        if (truncate(stream_filename.c_str(), end) != 0)
+        {
+            std::cerr << "Could not truncate " << stream_filename << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        done = rows;
+        std::cerr << "resuming after " << done << " rows" << std::endl;
+    }
+
+    std::ofstream ofs(stream_filename,
+        std::ios::binary | (resume ? std::ios::app : std::ios::trunc));
+
+    if (!ofs.good())
+    {
+        std::cerr << "Could not open CPD file " << stream_filename
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!resume)
+    {
+        ofs << head.str();
+    }
+
+    info(verbose, (ph ? "Computing PHAST labels."
+                      : "Computing Dijkstra labels."));
 
+    // every row of a batch must fit in the window
+    size_t batch = ph ? lanes : 1;
+    window = std::max<uint32_t>(window, batch);
+
+    unsigned char pct_done = node_count ? done * 100 / node_count : 100;
     std::cerr << "progress: [";
     for(uint32_t i = 0; i < 100; i++) { std::cerr <<" "; }
     std::cerr << "]\rprogress: [";
+    for(uint32_t i = 0; i < pct_done; i++) { std::cerr << "="; }
+
+    // The thread with the oldest unwritten row never waits for room: every
+    // row before it is written, hence it falls within the window.
+    std::vector<char> finished(window, 0);
+    std::atomic<size_t> next(done);
+    size_t written = done;
+    std::mutex mutex;
+    std::condition_variable room;
+    std::chrono::steady_clock::time_point last_flush =
+        std::chrono::steady_clock::now();
 
     #ifndef SINGLE_THREADED
     #pragma omp parallel
     #endif
     {
-        int thread_count = omp_get_num_threads();
         int thread_id = omp_get_thread_num();
-        size_t start_id = thread_id;
         warthog::sn_id_t source_id;
 
         std::vector<warthog::cpd::fm_coll> s_row(g.get_num_nodes());
@@ -165,50 +378,105 @@ make_cpd(warthog::graph::xy_graph &g, warthog::cpd::graph_oracle_base<S> &cpd,
         listeners.at(thread_id)->set_run(&source_id, &s_row);
         dijk.set_listener(listeners.at(thread_id));
 
-        while (start_id < node_count)
+        // each thread sweeps with its own distances
+        std::unique_ptr<warthog::ch::phast> sweeper;
+        std::vector<uint32_t> sources;
+        std::vector<std::vector<warthog::cost_t>> dist;
+        std::vector<std::vector<warthog::cpd::fm_coll>> rows;
+
+        if (ph) { sweeper.reset(new warthog::ch::phast(*ph)); }
+
+        while (true)
         {
-            source_id = nodes.at(start_id);
-            cpd.compute_row(source_id, &dijk, s_row);
-            // We increment the start_id by the number of threads to *jump* to
-            // that id in the vector.
-            start_id += thread_count;
-            #pragma omp critical
+            size_t i = next.fetch_add(batch);
+
+            if (i >= node_count) { break; }
+
+            size_t end = std::min(i + batch, node_count);
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                room.wait(lock, [&] { return end <= written + window; });
+            }
+
+            if (sweeper)
+            {
+                sources.assign(nodes.begin() + i, nodes.begin() + end);
+                cpd.compute_rows(sources, sweeper.get(), dist, rows);
+            }
+            else
+            {
+                source_id = nodes.at(i);
+                cpd.compute_row(source_id, &dijk, s_row);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t j = i; j < end; j++)
             {
-                nprocessed++;
+                finished.at(j % window) = 1;
+            }
+
+            // write every row that is now next in line
+            while (written < node_count && finished.at(written % window))
+            {
+                finished.at(written % window) = 0;
+                cpd.flush_row(ofs, nodes.at(written));
+                written++;
 
-                if ((nprocessed * 100 / node_count) > pct_done)
+                if ((written * 100 / node_count) > pct_done)
                 {
                     std::cerr << "=";
                     pct_done++;
                 }
             }
+
+            std::chrono::steady_clock::time_point now =
+                std::chrono::steady_clock::now();
+            if (now - last_flush > std::chrono::seconds(checkpoint))
+            {
+                ofs.flush();
+                last_flush = now;
+            }
+
+            room.notify_all();
         }
     }
 
     std::cerr << std::endl;
-    // convert the column order into a map: from vertex id to its ordered index
-    cpd.value_index_swap_array();
+    ofs.close();
+
+    for (auto l : listeners)
+    {
+        delete l;
+    }
 
     t.stop();
     info(verbose, "total preproc time (seconds):", t.elapsed_time_sec());
 
-    std::ofstream ofs(cpd_filename);
-
-    if (!ofs.good())
+    if (!ofs)
     {
-        std::cerr << "Could not open CPD file " << cpd_filename << std::endl;
+        std::cerr << "Error while writing " << stream_filename << std::endl;
         return EXIT_FAILURE;
     }
 
-    info(verbose, "Writing results to", cpd_filename);
-    ofs << cpd;
-    ofs.close();
+    std::cerr << "wrote to disk " << written << " rows." << std::endl;
 
-    for (auto l : listeners)
+    if (flat)
     {
-        delete l;
+        std::ifstream ifs(stream_filename, std::ios::binary);
+        ifs >> cpd;
+        ifs.close();
+
+        int ret = write_cpd<S>(cpd, cpd_filename, true, verbose);
+
+        if (ret == EXIT_SUCCESS) { std::remove(stream_filename.c_str()); }
+
+        return ret;
     }
 
+    // convert the column order into a map: from vertex id to its ordered index
+    cpd.value_index_swap_array();
+
     return EXIT_SUCCESS;
 }
 
@@ -216,6 +484,8 @@ int
 main(int argc, char *argv[])
 {
     int verbose = 0;
+    int flat = 0;
+    int resume = 0;
     warthog::util::param valid_args[] =
     {
         {"from", required_argument, 0, 1},
@@ -229,6 +499,13 @@ main(int argc, char *argv[])
         {"seed", required_argument, 0, 1},
         {"type", required_argument, 0, 1},
         {"nice", required_argument, 0, 1},
+        {"convert", required_argument, 0, 1},
+        {"flat", no_argument, &flat, 1},
+        {"resume", no_argument, &resume, 1},
+        {"window", required_argument, 0, 1},
+        {"checkpoint", required_argument, 0, 1},
+        {"ch", required_argument, 0, 1},
+        {"lanes", required_argument, 0, 1},
         {"verbose", no_argument, &verbose, 1},
         {0, 0, 0, 0}
     };
@@ -240,7 +517,18 @@ main(int argc, char *argv[])
     bool reverse;
     warthog::cpd::symbol cpd_type;
 
-    cfg.get_param_value("nice")
+    std::string s_nice = cfg.get_param_value("nice");
+
+    if (s_nice != "")
+    {
+        // nice(2) may legitimately return -1
+        errno = 0;
+        if (nice(std::stoi(s_nice)) == -1 && errno != 0)
+        {
+            std::cerr << "Could not change the priority to " << s_nice
+                      << std::endl;
+        }
+    }
 
     if (type == "" || type == "fwd" || type == "forward")
     {
@@ -438,7 +726,9 @@ main(int argc, char *argv[])
         seed = ((uint32_t)rand() % (uint32_t)g.get_num_nodes());
     }
 
-    if (cfg.get_num_values("join") > 0)
+    std::string convert_filename = cfg.get_param_value("convert");
+
+    if (cfg.get_num_values("join") > 0 || convert_filename != "")
     {
         std::vector<std::string> names;
         std::string part;
@@ -451,7 +741,29 @@ main(int argc, char *argv[])
             names.push_back(part);
         }
 
-        return join_cpds(g, cpd_filename, names, seed, verbose, mod);
+        switch (cpd_type)
+        {
+            case warthog::cpd::REVERSE:
+                return rebuild_cpd<warthog::cpd::REVERSE>(
+                    g, cpd_filename, names, convert_filename, seed, verbose,
+                    mod, flat);
+            case warthog::cpd::BEARING:
+                return rebuild_cpd<warthog::cpd::BEARING>(
+                    g, cpd_filename, names, convert_filename, seed, verbose,
+                    mod, flat);
+            case warthog::cpd::TABLE:
+                return rebuild_cpd<warthog::cpd::TABLE>(
+                    g, cpd_filename, names, convert_filename, seed, verbose,
+                    mod, flat);
+            case warthog::cpd::REV_TABLE:
+                return rebuild_cpd<warthog::cpd::REV_TABLE>(
+                    g, cpd_filename, names, convert_filename, seed, verbose,
+                    mod, flat);
+            default:
+                return rebuild_cpd<warthog::cpd::FORWARD>(
+                    g, cpd_filename, names, convert_filename, seed, verbose,
+                    mod, flat);
+        }
     }
     else
     {
@@ -461,6 +773,70 @@ main(int argc, char *argv[])
         size_t nthreads = omp_get_max_threads();
         #endif
         std::cerr << "num_threads=" <<  nthreads << std::endl;
+
+        // rows held in memory, waiting for the rows before them
+        std::string s_window = cfg.get_param_value("window");
+        uint32_t window = 64 * nthreads;
+
+        if (s_window != "")
+        {
+            window = std::max(std::stoi(s_window), 1);
+        }
+
+        // seconds between flushes of the output
+        std::string s_checkpoint = cfg.get_param_value("checkpoint");
+        uint32_t checkpoint = 60;
+
+        if (s_checkpoint != "")
+        {
+            checkpoint = std::stoi(s_checkpoint);
+        }
+
+        // sources per PHAST sweep
+        std::string s_lanes = cfg.get_param_value("lanes");
+        uint32_t lanes = 8;
+
+        if (s_lanes != "")
+        {
+            lanes = std::min<uint32_t>(std::max(std::stoi(s_lanes), 1),
+                                       warthog::ch::phast::MAX_LANES);
+        }
+
+        std::unique_ptr<warthog::ch::phast> ph;
+        std::string ch_filename = cfg.get_param_value("ch");
+
+        if (ch_filename != "" && cpd_type == warthog::cpd::BEARING)
+        {
+            std::cerr << "Bearing CPDs cannot be built from --ch; "
+                      << "using Dijkstra" << std::endl;
+        }
+        else if (ch_filename != "")
+        {
+            warthog::ch::ch_data chd;
+            chd.type_ = warthog::ch::UP_ONLY;
+            std::ifstream ifs_ch(ch_filename);
+
+            if (!ifs_ch.good())
+            {
+                std::cerr << "Cannot open file " << ch_filename << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            ifs_ch >> chd;
+            ifs_ch.close();
+
+            if (chd.g_->get_num_nodes() != g.get_num_nodes())
+            {
+                std::cerr << "The hierarchy in " << ch_filename << " has "
+                          << chd.g_->get_num_nodes() << " nodes, but the graph "
+                          << g.get_num_nodes() << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            ph.reset(new warthog::ch::phast(&chd, reverse));
+            std::cerr << "lanes=" << lanes << std::endl;
+        }
+
         std::vector<warthog::cpd::oracle_listener*> listeners(nthreads);
         std::vector<warthog::sn_id_t> nodes;
 
@@ -489,7 +865,8 @@ main(int argc, char *argv[])
 
                 return make_cpd<warthog::cpd::REVERSE>(
                     g, cpd, listeners, cpd_filename, nodes, reverse, seed,
-                    verbose);
+                    verbose, flat, resume, window, checkpoint, ph.get(),
+                    lanes);
             }
 
             case warthog::cpd::BEARING:
@@ -504,7 +881,7 @@ main(int argc, char *argv[])
 
                 return make_cpd<warthog::cpd::BEARING>(
                     g, cpd, listeners, cpd_filename, nodes, reverse, seed,
-                    verbose);
+                    verbose, flat, resume, window, checkpoint);
             }
 
             case warthog::cpd::TABLE:
@@ -519,7 +896,8 @@ main(int argc, char *argv[])
 
                 return make_cpd<warthog::cpd::TABLE>(
                     g, cpd, listeners, cpd_filename, nodes, reverse, seed,
-                    verbose);
+                    verbose, flat, resume, window, checkpoint, ph.get(),
+                    lanes);
             }
 
             case warthog::cpd::REV_TABLE:
@@ -534,7 +912,8 @@ main(int argc, char *argv[])
 
                 return make_cpd<warthog::cpd::REV_TABLE>(
                     g, cpd, listeners, cpd_filename, nodes, reverse, seed,
-                    verbose);
+                    verbose, flat, resume, window, checkpoint, ph.get(),
+                    lanes);
             }
 
             // case warthog::cpd::FORWARD:
@@ -550,7 +929,8 @@ main(int argc, char *argv[])
 
                 return make_cpd<warthog::cpd::FORWARD>(
                     g, cpd, listeners, cpd_filename, nodes, reverse, seed,
-                    verbose);
+                    verbose, flat, resume, window, checkpoint, ph.get(),
+                    lanes);
             }
         }
     }
@@ -17,6 +17,7 @@
 #include "bidirectional_graph_expansion_policy.h"
 #include "bidirectional_search.h"
 #include "cfg.h"
+#include "cch.h"
 #include "constants.h"
 #include "contraction.h"
 #include "cpd_extractions.h"
@@ -25,13 +26,18 @@
 #include "depth_first_search.h"
 #include "dimacs_parser.h"
 #include "euclidean_heuristic.h"
+#include "landmark_heuristic.h"
 #include "fch_bb_expansion_policy.h"
 #include "fch_expansion_policy.h"
 #include "flexible_astar.h"
 #include "graph_expansion_policy.h"
 #include "graph_oracle.h"
+#include "graph_reorder.h"
 #include "cpd_graph_expansion_policy.h"
+#include "csr_graph.h"
 #include "lazy_graph_contraction.h"
+#include "multi_target_heuristic.h"
+#include "query_engine.h"
 #include "xy_graph.h"
 #include "solution.h"
 #include "timer.h"
@@ -59,6 +65,16 @@ int suppress_header = 0;
 
 long nruns = 1;
 
+// number of worker threads; > 1 solves instances with a query_engine
+uint32_t threads = 1;
+
+// search a csr_graph copy of the input graph? (default: no)
+int use_csr = 0;
+
+// renumber the nodes of the input graph before searching (default: no)
+std::string reorder_name = "";
+warthog::graph::reorder_type reorder = warthog::graph::REORDER_NONE;
+
 void
 help()
 {
@@ -79,10 +95,24 @@ help()
     << "\t--problem [ ss or p2p problem file (required) ]\n"
     << "\t--verbose (print debug info; omitting this param means no)\n"
     << "\t--nruns [int (repeats per instance; default=" << nruns << ")]\n"
+    << "\t--threads [int (solve instances in parallel; default=" << threads << ")]\n"
+    << "\t(supported by dijkstra, astar and fch)\n"
+    << "\t--csr (search a compact read-only copy of the input graph, cached\n"
+    << "\tas [input].csr; supported by dijkstra, astar, bi-dijkstra,\n"
+    << "\tbi-astar, bch, cpd, rev-cpd, table and rev-table)\n"
+    << "\t--reorder [dfs|bfs|hilbert|level] (renumber the nodes of the input\n"
+    << "\tgraph for locality; problem files keep using the input ids.\n"
+    << "\tsupported by dijkstra, astar, bi-dijkstra, bi-astar and bch;\n"
+    << "\tlevel, the contraction order, by bch only)\n"
     << "\nRecognised values for --alg:\n"
-    << "\tastar, astar-bb, dijkstra, bi-astar, bi-dijkstra\n"
+    << "\tastar, astar-bb, astar-lm, dijkstra, bi-astar, bi-astar-lm, bi-dijkstra\n"
     << "\tbch, bch-astar, bch-bb, fch, fch-bb\n"
-    << "\tdfs, cpd, cpd-search\n";
+    << "\tcch (--input [xy graph] [optional diff file]; bch over a customizable\n"
+    << "\tcontraction hierarchy, customised again after the diff is applied)\n"
+    << "\tdfs, cpd, cpd-search\n"
+    << "\tdijkstra-1tm, astar-1tm (one-to-many; queries that share a source\n"
+    << "\tare answered by a single search. search metrics are reported on the\n"
+    << "\tfirst query of each batch)\n";
 }
 
 void
@@ -132,6 +162,7 @@ run_experiments( warthog::search* algo, std::string alg_name,
             << reopen / nruns << "\t"
             << surplus / nruns << "\t"
             << heap_ops / nruns << "\t"
+            << (long long)nano_time << "\t"
             << (long long)sol.sum_of_edge_costs_ << "\t"
             << (int32_t)((sol.path_.size() == 0) ? -1 : (int32_t)(sol.path_.size()-1)) << "\t"
             << parser.get_problemfile()
@@ -139,8 +170,163 @@ run_experiments( warthog::search* algo, std::string alg_name,
     }
 }
 
+// as run_experiments, but every instance is solved by the workers of
+// @param engine. results are printed in input order once all are done
 void
-run_astar(warthog::util::cfg& cfg,
+run_parallel_experiments(warthog::query_engine& engine, std::string alg_name,
+        warthog::dimacs_parser& parser, std::ostream& out)
+{
+    std::cerr << "running experiments with " << engine.num_workers()
+        << " threads\n";
+    std::cerr << "(averaging over " << nruns << " runs per instance)\n";
+
+    if(!suppress_header)
+    {
+        std::cout
+            << "id\talg\texpanded\ttouched\treopen\tsurplus\theap_ops"
+            << "\tnanos\tpcost\tplen\tmap\n";
+    }
+
+    std::vector<warthog::problem_instance> batch;
+    for(auto it = parser.experiments_begin();
+            it != parser.experiments_end();
+            it++)
+    {
+        warthog::sn_id_t target_id = it->p2p ? it->target : warthog::SN_ID_MAX;
+        batch.push_back(warthog::problem_instance(it->source, target_id, verbose));
+    }
+
+    // each run solves the whole batch; per-instance metrics are
+    // accumulated as in run_experiments
+    std::vector<warthog::solution> sols;
+    std::vector<warthog::solution> totals(batch.size());
+    std::vector<double> nano_time(batch.size(), DBL_MAX);
+    warthog::timer t;
+    t.start();
+    for(uint32_t i = 0; i < nruns; i++)
+    {
+        engine.solve(batch, sols);
+        for(uint32_t j = 0; j < sols.size(); j++)
+        {
+            warthog::solution& total = totals.at(j);
+            total.nodes_expanded_ += sols.at(j).nodes_expanded_;
+            total.nodes_reopen_ += sols.at(j).nodes_reopen_;
+            total.heap_ops_ += sols.at(j).heap_ops_;
+            total.nodes_touched_ += sols.at(j).nodes_touched_;
+            total.nodes_surplus_ += sols.at(j).nodes_surplus_;
+            nano_time.at(j) = std::min(nano_time.at(j), sols.at(j).time_elapsed_nano_);
+        }
+    }
+    t.stop();
+
+    for(uint32_t j = 0; j < sols.size(); j++)
+    {
+        warthog::solution& sol = sols.at(j);
+        warthog::solution& total = totals.at(j);
+        out
+            << j <<"\t"
+            << alg_name << "\t"
+            << total.nodes_expanded_ / nruns << "\t"
+            << total.nodes_touched_ / nruns << "\t"
+            << total.nodes_reopen_ / nruns << "\t"
+            << total.nodes_surplus_ / nruns << "\t"
+            << total.heap_ops_ / nruns << "\t"
+            << (long long)nano_time.at(j) << "\t"
+            << (long long)sol.sum_of_edge_costs_ << "\t"
+            << (int32_t)((sol.path_.size() == 0) ? -1 : (int32_t)(sol.path_.size()-1)) << "\t"
+            << parser.get_problemfile()
+            << std::endl;
+    }
+
+    std::cerr << "done in " << t.elapsed_time_micro() << "us. "
+        << "queries per thread:";
+    for(uint32_t i = 0; i < engine.num_workers(); i++)
+    {
+        std::cerr << " " << engine.get_queries(i);
+    }
+    std::cerr << "\ntotal memory: " << engine.mem() << "\n";
+}
+
+// group p2p queries by source and solve each group with a single
+// one-to-many search. results are printed in input order.
+template<class ALGO>
+void
+run_one_to_many_experiments(ALGO* algo, std::string alg_name,
+        warthog::dimacs_parser& parser, std::ostream& out)
+{
+    std::cerr << "running one-to-many experiments\n";
+
+    if(!suppress_header)
+    {
+        std::cout
+            << "id\talg\texpanded\ttouched\treopen\tsurplus\theap_ops"
+            << "\tnanos\tpcost\tplen\tmap\n";
+    }
+
+    std::vector<warthog::dimacs_parser::experiment> exps(
+            parser.experiments_begin(), parser.experiments_end());
+    std::vector<warthog::sn_id_t> sources;
+    std::unordered_map<warthog::sn_id_t, std::vector<uint32_t>> batches;
+    for(uint32_t i = 0; i < exps.size(); i++)
+    {
+        if(!exps.at(i).p2p)
+        {
+            std::cerr << "err; one-to-many search requires p2p instances\n";
+            return;
+        }
+
+        std::vector<uint32_t>& batch = batches[exps.at(i).source];
+        if(batch.empty()) { sources.push_back(exps.at(i).source); }
+        batch.push_back(i);
+    }
+
+    std::vector<warthog::solution> results(exps.size());
+    std::vector<warthog::solution> sols;
+    std::vector<warthog::sn_id_t> targets;
+    for(warthog::sn_id_t source : sources)
+    {
+        std::vector<uint32_t>& batch = batches[source];
+        targets.clear();
+        for(uint32_t i : batch) { targets.push_back(exps.at(i).target); }
+
+        warthog::problem_instance pi(source, warthog::SN_ID_MAX, verbose);
+        algo->get_paths(pi, targets, sols);
+
+        for(uint32_t j = 0; j < batch.size(); j++)
+        {
+            warthog::solution& sol = results.at(batch.at(j));
+            sol = sols.at(j);
+            if(j > 0)
+            {
+                // the search effort is attributed to the first query
+                sol.nodes_expanded_ = sol.nodes_touched_ = 0;
+                sol.nodes_reopen_ = sol.nodes_surplus_ = sol.heap_ops_ = 0;
+                sol.time_elapsed_nano_ = 0;
+            }
+        }
+    }
+
+    for(uint32_t i = 0; i < results.size(); i++)
+    {
+        warthog::solution& sol = results.at(i);
+        out
+            << i <<"\t"
+            << alg_name << "\t"
+            << sol.nodes_expanded_ << "\t"
+            << sol.nodes_touched_ << "\t"
+            << sol.nodes_reopen_ << "\t"
+            << sol.nodes_surplus_ << "\t"
+            << sol.heap_ops_ << "\t"
+            << (long long)sol.time_elapsed_nano_ << "\t"
+            << (long long)sol.sum_of_edge_costs_ << "\t"
+            << (int32_t)((sol.path_.size() == 0) ? -1 : (int32_t)(sol.path_.size()-1)) << "\t"
+            << parser.get_problemfile()
+            << std::endl;
+    }
+}
+
+void
+run_dijkstra_1tm(warthog::util::cfg& cfg,
     warthog::dimacs_parser& parser, std::string alg_name)
 {
     std::string xy_filename = cfg.get_param_value("input");
@@ -151,22 +337,213 @@ run_astar(warthog::util::cfg& cfg,
     }
 
     warthog::graph::xy_graph g;
-    std::ifstream ifs(xy_filename);
-    ifs >> g;
+    g.load(xy_filename.c_str());
 
     warthog::simple_graph_expansion_policy expander(&g);
-    warthog::euclidean_heuristic h(&g);
+    warthog::zero_heuristic h;
     warthog::pqueue_min open;
 
     warthog::flexible_astar<
-        warthog::euclidean_heuristic,
+        warthog::zero_heuristic,
+        warthog::simple_graph_expansion_policy,
+        warthog::pqueue_min>
+            alg(&h, &expander, &open);
+
+    run_one_to_many_experiments(&alg, alg_name, parser, std::cout);
+}
+
+void
+run_astar_1tm(warthog::util::cfg& cfg,
+    warthog::dimacs_parser& parser, std::string alg_name)
+{
+    std::string xy_filename = cfg.get_param_value("input");
+    if(xy_filename == "")
+    {
+        std::cerr << "parameter is missing: --input [xy-graph file]\n";
+        return;
+    }
+
+    warthog::graph::xy_graph g;
+    g.load(xy_filename.c_str());
+
+    warthog::simple_graph_expansion_policy expander(&g);
+    warthog::euclidean_heuristic eh(&g);
+    warthog::multi_target_heuristic<warthog::euclidean_heuristic> h(&eh);
+    warthog::pqueue_min open;
+
+    warthog::flexible_astar<
+        warthog::multi_target_heuristic<warthog::euclidean_heuristic>,
         warthog::simple_graph_expansion_policy,
         warthog::pqueue_min>
             alg(&h, &expander, &open);
 
+    run_one_to_many_experiments(&alg, alg_name, parser, std::cout);
+}
+
+// the order given by --reorder for the nodes of @param g; @param level is
+// the level of each node, for graphs that are contraction hierarchies
+void
+compute_order(warthog::graph::xy_graph& g, std::vector<uint32_t>& order,
+        const std::vector<uint32_t>* level = 0)
+{
+    switch(reorder)
+    {
+        case warthog::graph::REORDER_DFS:
+            warthog::graph::dfs_order(&g, order);
+            break;
+        case warthog::graph::REORDER_BFS:
+            warthog::graph::bfs_order(&g, order);
+            break;
+        case warthog::graph::REORDER_HILBERT:
+            warthog::graph::hilbert_order(&g, order);
+            break;
+        default:
+            assert(level);
+            warthog::graph::level_order(*level, order);
+            break;
+    }
+}
+
+// renumber the nodes of @param g in the order given by --reorder
+void
+reorder_graph(warthog::graph::xy_graph& g)
+{
+    if(reorder == warthog::graph::REORDER_NONE) { return; }
+
+    warthog::timer t;
+    t.start();
+    std::vector<uint32_t> order;
+    compute_order(g, order);
+    g.reorder(order);
+    t.stop();
+    std::cerr << "reordered graph (" << reorder_name << "). time "
+        << t.elapsed_time_sec() << "s\n";
+}
+
+// as reorder_graph, for a contraction hierarchy
+void
+reorder_ch(warthog::ch::ch_data& chd)
+{
+    if(reorder == warthog::graph::REORDER_NONE) { return; }
+
+    warthog::timer t;
+    t.start();
+    std::vector<uint32_t> order;
+    compute_order(*chd.g_, order, chd.level_);
+    warthog::ch::reorder(&chd, order);
+    t.stop();
+    std::cerr << "reordered hierarchy (" << reorder_name << "). time "
+        << t.elapsed_time_sec() << "s\n";
+}
+
+// map the csr graph cached as [@param input].csr or, if there is none
+// built from the current input (with incoming edges, when @param incoming
+// is set), build one with @param build_csr and cache it. graphs that are
+// reordered are cached as [@param input].[order].csr
+std::unique_ptr<warthog::graph::csr_graph>
+load_csr(std::string input, bool incoming,
+        std::function<warthog::graph::csr_graph*()> build_csr)
+{
+    uint64_t stamp = warthog::graph::csr_graph::file_stamp(input.c_str());
+    if(stamp == 0)
+    {
+        std::cerr << "err; cannot open input file " << input << "\n";
+        return nullptr;
+    }
+
+    std::string csr_filename = input +
+        (reorder == warthog::graph::REORDER_NONE ? "" : "." + reorder_name) +
+        ".csr";
+    std::unique_ptr<warthog::graph::csr_graph> csr(
+            new warthog::graph::csr_graph());
+    if(csr->load(csr_filename.c_str(), stamp) &&
+       (!incoming || csr->has_incoming()))
+    {
+        return csr;
+    }
+
+    csr.reset(build_csr());
+    csr->save(csr_filename.c_str(), stamp);
+    return csr;
+}
+
+// as load_csr, for an input that is an xy-graph
+std::unique_ptr<warthog::graph::csr_graph>
+load_csr(std::string xy_filename, bool incoming)
+{
+    return load_csr(xy_filename, incoming,
+            [&xy_filename, incoming]() -> warthog::graph::csr_graph*
+            {
+                warthog::graph::xy_graph g(0, "", incoming);
+                g.load(xy_filename.c_str());
+                reorder_graph(g);
+                return new warthog::graph::csr_graph(g);
+            });
+}
+
+template<class G>
+void
+run_astar(G& g, warthog::dimacs_parser& parser, std::string alg_name)
+{
+    typedef warthog::graph_expansion_policy<warthog::dummy_filter, G>
+        expander_t;
+    typedef warthog::euclidean_heuristic_base<G> heuristic_t;
+
+    if(threads > 1)
+    {
+        warthog::query_engine engine(threads,
+            [&g](uint32_t id) -> warthog::search*
+            {
+                return new warthog::astar_worker<
+                    heuristic_t,
+                    expander_t,
+                    warthog::pqueue_min>(
+                        new heuristic_t(&g),
+                        new expander_t(&g),
+                        new warthog::pqueue_min());
+            });
+        run_parallel_experiments(engine, alg_name, parser, std::cout);
+        return;
+    }
+
+    expander_t expander(&g);
+    heuristic_t h(&g);
+    warthog::pqueue_min open;
+
+    warthog::flexible_astar<
+        heuristic_t,
+        expander_t,
+        warthog::pqueue_min>
+            alg(&h, &expander, &open);
+
     run_experiments(&alg, alg_name, parser, std::cout);
 }
 
+void
+run_astar(warthog::util::cfg& cfg,
+    warthog::dimacs_parser& parser, std::string alg_name)
+{
+    std::string xy_filename = cfg.get_param_value("input");
+    if(xy_filename == "")
+    {
+        std::cerr << "parameter is missing: --input [xy-graph file]\n";
+        return;
+    }
+
+    if(use_csr)
+    {
+        std::unique_ptr<warthog::graph::csr_graph> csr =
+            load_csr(xy_filename, false);
+        if(csr) { run_astar(*csr, parser, alg_name); }
+        return;
+    }
+
+    warthog::graph::xy_graph g;
+    g.load(xy_filename.c_str());
+    reorder_graph(g);
+    run_astar(g, parser, alg_name);
+}
+
 void
 run_astar_bb(warthog::util::cfg& cfg,
     warthog::dimacs_parser& parser, std::string alg_name)
@@ -179,14 +556,12 @@ run_astar_bb(warthog::util::cfg& cfg,
     }
 
     warthog::graph::xy_graph g;
-    std::ifstream ifs(xy_filename);
-    ifs >> g;
-    ifs.close();
+    g.load(xy_filename.c_str());
 
     warthog::label::bb_labelling lab(&g);
     std::string label_filename = xy_filename + ".label.bb";
 
-    ifs.open(label_filename.c_str());
+    std::ifstream ifs(label_filename.c_str());
     if(ifs.is_open())
     {
         ifs >> lab;
@@ -231,34 +606,129 @@ run_astar_bb(warthog::util::cfg& cfg,
     run_experiments(&alg, alg_name, parser, std::cout);
 }
 
+// landmark heuristics for the graph in @param xy_filename, loaded from
+// [xy-graph file].lm if there is a valid one, else computed and saved there
 void
-run_dijkstra(warthog::util::cfg& cfg,
-    warthog::dimacs_parser& parser, std::string alg_name )
+load_landmarks(warthog::landmark_heuristic& h, std::string xy_filename)
+{
+    std::string lm_filename = xy_filename + ".lm";
+    if(!h.load(lm_filename.c_str()))
+    {
+        h.precompute(16);
+        h.save(lm_filename.c_str());
+    }
+}
+
+void
+run_astar_lm(warthog::util::cfg& cfg,
+    warthog::dimacs_parser& parser, std::string alg_name)
 {
-    // load up the graph
     std::string xy_filename = cfg.get_param_value("input");
     if(xy_filename == "")
     {
-        std::cerr << "err; require --input [xy-graph file]\n";
+        std::cerr << "parameter is missing: --input [xy-graph file]\n";
         return;
     }
+
     warthog::graph::xy_graph g;
-    std::ifstream ifs(xy_filename);
-    ifs >> g;
+    g.load(xy_filename.c_str());
+
+    warthog::landmark_heuristic h(&g);
+    load_landmarks(h, xy_filename);
 
     warthog::simple_graph_expansion_policy expander(&g);
+    warthog::pqueue_min open;
+
+    warthog::flexible_astar<
+        warthog::landmark_heuristic,
+        warthog::simple_graph_expansion_policy,
+        warthog::pqueue_min>
+            alg(&h, &expander, &open);
+
+    run_experiments(&alg, alg_name, parser, std::cout);
+}
+
+template<class G>
+void
+run_dijkstra(G& g, warthog::dimacs_parser& parser, std::string alg_name)
+{
+    typedef warthog::graph_expansion_policy<warthog::dummy_filter, G>
+        expander_t;
+
+    if(threads > 1)
+    {
+        warthog::query_engine engine(threads,
+            [&g](uint32_t id) -> warthog::search*
+            {
+                return new warthog::astar_worker<
+                    warthog::zero_heuristic,
+                    expander_t,
+                    warthog::pqueue<warthog::cmp_less_search_node_f_only,
+                        warthog::min_q>>(
+                        new warthog::zero_heuristic(),
+                        new expander_t(&g),
+                        new warthog::pqueue<
+                            warthog::cmp_less_search_node_f_only,
+                            warthog::min_q>());
+            });
+        run_parallel_experiments(engine, alg_name, parser, std::cout);
+        return;
+    }
+
+    expander_t expander(&g);
     warthog::zero_heuristic h;
     warthog::pqueue<warthog::cmp_less_search_node_f_only, warthog::min_q> open;
 
     warthog::flexible_astar<
         warthog::zero_heuristic,
-        warthog::simple_graph_expansion_policy,
+        expander_t,
         warthog::pqueue<warthog::cmp_less_search_node_f_only, warthog::min_q>>
             alg(&h, &expander, &open);
 
     run_experiments(&alg, alg_name, parser, std::cout);
 }
 
+void
+run_dijkstra(warthog::util::cfg& cfg,
+    warthog::dimacs_parser& parser, std::string alg_name )
+{
+    // load up the graph
+    std::string xy_filename = cfg.get_param_value("input");
+    if(xy_filename == "")
+    {
+        std::cerr << "err; require --input [xy-graph file]\n";
+        return;
+    }
+
+    if(use_csr)
+    {
+        std::unique_ptr<warthog::graph::csr_graph> csr =
+            load_csr(xy_filename, false);
+        if(csr) { run_dijkstra(*csr, parser, alg_name); }
+        return;
+    }
+
+    warthog::graph::xy_graph g;
+    g.load(xy_filename.c_str());
+    reorder_graph(g);
+    run_dijkstra(g, parser, alg_name);
+}
+
+template<class H, class G>
+void
+run_bi_search(G& g, H& h,
+        warthog::dimacs_parser& parser, std::string alg_name)
+{
+    typedef warthog::bidirectional_expander<warthog::apriori_filter, G>
+        expander_t;
+
+    expander_t fexp(&g, false);
+    expander_t bexp(&g, true);
+    warthog::bidirectional_search<H, expander_t> alg(&fexp, &bexp, &h);
+
+    run_experiments(&alg, alg_name, parser, std::cout);
+}
+
 void
 run_bi_astar( warthog::util::cfg& cfg,
         warthog::dimacs_parser& parser, std::string alg_name)
@@ -270,17 +740,48 @@ run_bi_astar( warthog::util::cfg& cfg,
         return;
     }
 
+    if(use_csr)
+    {
+        std::unique_ptr<warthog::graph::csr_graph> csr =
+            load_csr(xy_filename, true);
+        if(!csr) { return; }
+        warthog::csr_euclidean_heuristic h(csr.get());
+        run_bi_search(*csr, h, parser, alg_name);
+        return;
+    }
+
     warthog::graph::xy_graph g;
-    std::ifstream ifs(xy_filename);
-    ifs >> g;
-    ifs.close();
+    g.load(xy_filename.c_str());
+    reorder_graph(g);
+
+    warthog::euclidean_heuristic h(&g);
+    run_bi_search(g, h, parser, alg_name);
+}
+
+void
+run_bi_astar_lm( warthog::util::cfg& cfg,
+        warthog::dimacs_parser& parser, std::string alg_name)
+{
+    std::string xy_filename = cfg.get_param_value("input");
+    if(xy_filename == "")
+    {
+        std::cerr << "parameter is missing: --input [xy-graph file]\n";
+        return;
+    }
+
+    warthog::graph::xy_graph g(0, "", true);
+    g.load(xy_filename.c_str());
 
     warthog::bidirectional_graph_expansion_policy fexp(&g, false);
     warthog::bidirectional_graph_expansion_policy bexp(&g, true);
 
-    warthog::euclidean_heuristic h(&g);
+    // the backward search needs bounds on distances from the start
+    warthog::landmark_heuristic h(&g);
+    load_landmarks(h, xy_filename);
+    h.set_symmetric(true);
+
     warthog::bidirectional_search<
-        warthog::euclidean_heuristic,
+        warthog::landmark_heuristic,
         warthog::bidirectional_graph_expansion_policy>
             alg(&fexp, &bexp, &h);
 
@@ -298,24 +799,38 @@ run_bi_dijkstra( warthog::util::cfg& cfg,
         return;
     }
 
+    warthog::zero_heuristic h;
+    if(use_csr)
+    {
+        std::unique_ptr<warthog::graph::csr_graph> csr =
+            load_csr(xy_filename, true);
+        if(csr) { run_bi_search(*csr, h, parser, alg_name); }
+        return;
+    }
+
     warthog::graph::xy_graph g(0, "", true);
-    std::ifstream ifs(xy_filename);
-    ifs >> g;
-    ifs.close();
+    g.load(xy_filename.c_str());
+    reorder_graph(g);
+
+    run_bi_search(g, h, parser, alg_name);
+}
 
-    warthog::bidirectional_graph_expansion_policy fexp(&g, false);
-    warthog::bidirectional_graph_expansion_policy bexp(&g, true);
 
+template<class G>
+void
+run_bch(G& g, warthog::dimacs_parser& parser, std::string alg_name)
+{
+    warthog::bch_expansion_policy_base<G> fexp(&g);
+    warthog::bch_expansion_policy_base<G> bexp(&g, true);
     warthog::zero_heuristic h;
-    warthog::bidirectional_search<
+    warthog::bch_search<
         warthog::zero_heuristic,
-        warthog::bidirectional_graph_expansion_policy>
+        warthog::bch_expansion_policy_base<G>>
             alg(&fexp, &bexp, &h);
 
     run_experiments(&alg, alg_name, parser, std::cout);
 }
 
-
 void
 run_bch(warthog::util::cfg& cfg,
         warthog::dimacs_parser& parser, std::string alg_name)
@@ -327,6 +842,22 @@ run_bch(warthog::util::cfg& cfg,
         return;
     }
 
+    if(use_csr)
+    {
+        std::unique_ptr<warthog::graph::csr_graph> csr = load_csr(
+            chd_file, true, [&chd_file]() -> warthog::graph::csr_graph*
+            {
+                warthog::ch::ch_data chd;
+                chd.type_ = warthog::ch::UP_ONLY;
+                std::ifstream ifs(chd_file.c_str());
+                ifs >> chd;
+                reorder_ch(chd);
+                return new warthog::graph::csr_graph(*chd.g_);
+            });
+        if(csr) { run_bch(*csr, parser, alg_name); }
+        return;
+    }
+
     warthog::ch::ch_data chd;
     chd.type_ = warthog::ch::UP_ONLY;
     std::ifstream ifs(chd_file.c_str());
@@ -338,16 +869,53 @@ run_bch(warthog::util::cfg& cfg,
 
     ifs >> chd;
     ifs.close();
+    reorder_ch(chd);
+    run_bch(*chd.g_, parser, alg_name);
+}
 
-    warthog::bch_expansion_policy fexp(chd.g_);
-    warthog::bch_expansion_policy bexp (chd.g_, true);
-    warthog::zero_heuristic h;
-    warthog::bch_search<
-        warthog::zero_heuristic,
-        warthog::bch_expansion_policy>
-            alg(&fexp, &bexp, &h);
+void
+run_cch(warthog::util::cfg& cfg,
+        warthog::dimacs_parser& parser, std::string alg_name)
+{
+    std::string xy_filename = cfg.get_param_value("input");
+    if(xy_filename == "")
+    {
+        std::cerr << "parameter is missing: --input graph.xy [graph.xy.diff]\n";
+        return;
+    }
 
-    run_experiments(&alg, alg_name, parser, std::cout);
+    warthog::graph::xy_graph g;
+    if(!g.load(xy_filename.c_str()))
+    {
+        std::cerr << "Could not open xy-graph: " << xy_filename << std::endl;
+        return;
+    }
+
+    warthog::timer t;
+    t.start();
+    std::vector<uint32_t> order;
+    warthog::ch::nested_dissection_order(&g, order);
+    t.stop();
+    std::cerr << "nested dissection order computed; time "
+        << t.elapsed_time_sec() << " (s)" << std::endl;
+    warthog::ch::customizable_ch cch(&g, order);
+
+    // the queries are answered for the perturbed weights
+    std::string diff_filename = cfg.get_param_value("input");
+    if(diff_filename != "")
+    {
+        std::ifstream ifs(diff_filename);
+        if(!ifs.good())
+        {
+            std::cerr <<
+                "Could not open diff-graph: " << diff_filename << std::endl;
+            return;
+        }
+        g.perturb(ifs);
+        cch.customize();
+    }
+
+    run_bch(*cch.get_ch_data()->g_, parser, alg_name);
 }
 
 void
@@ -424,6 +992,7 @@ run_bch_backwards_only(warthog::util::cfg& cfg, warthog::dimacs_parser& parser,
             << reopen / nruns << "\t"
             << surplus / nruns << "\t"
             << heap_ops / nruns << "\t"
+            << (long long)nano_time << "\t"
             << (long long)sol.sum_of_edge_costs_ << "\t"
             << (int32_t)((sol.path_.size() == 0) ? -1 : (int32_t)(sol.path_.size()-1)) << "\t"
             << parser.get_problemfile()
@@ -594,6 +1163,24 @@ run_fch(warthog::util::cfg& cfg, warthog::dimacs_parser& parser,
     ifs >> chd;
     ifs.close();
 
+    // the contraction hierarchy is shared by all workers
+    if(threads > 1)
+    {
+        warthog::query_engine engine(threads,
+            [&chd](uint32_t id) -> warthog::search*
+            {
+                return new warthog::astar_worker<
+                    warthog::euclidean_heuristic,
+                    warthog::fch_expansion_policy,
+                    warthog::pqueue_min>(
+                        new warthog::euclidean_heuristic(chd.g_),
+                        new warthog::fch_expansion_policy(&chd),
+                        new warthog::pqueue_min());
+            });
+        run_parallel_experiments(engine, alg_name, parser, std::cout);
+        return;
+    }
+
     warthog::fch_expansion_policy fexp(&chd);
     warthog::euclidean_heuristic h(chd.g_);
     warthog::pqueue_min open;
@@ -772,16 +1359,12 @@ run_cpd_search(warthog::util::cfg& cfg,
         return;
     }
 
-    ifs.open(xy_filename);
-    if (!ifs.good())
+    if(!g.load(xy_filename.c_str()))
     {
         std::cerr << "Could not open xy-graph: " << xy_filename << std::endl;
         return;
     }
 
-    ifs >> g;
-    ifs.close();
-
     // Check if we have a second parameter in the --input
     std::string diff_filename = cfg.get_param_value("input");
     if (diff_filename == "")
@@ -811,7 +1394,8 @@ run_cpd_search(warthog::util::cfg& cfg,
     ifs.open(cpd_filename);
     if(ifs.is_open())
     {
-        ifs >> oracle;
+        // flat CPDs are mapped rather than read
+        if(!oracle.load_flat(cpd_filename.c_str())) { ifs >> oracle; }
         ifs.close();
     }
     else
@@ -888,12 +1472,24 @@ run_cpd(warthog::util::cfg& cfg,
     }
 
 
+    // moves are edge indexes, which the csr graph keeps; the oracle does
+    // not need a graph of its own
     warthog::graph::xy_graph g;
-    std::ifstream ifs(xy_filename);
-    ifs >> g;
-    ifs.close();
+    std::unique_ptr<warthog::graph::csr_graph> csr;
+    std::unique_ptr<warthog::cpd::graph_oracle_base<SYM>> oracle;
+    std::ifstream ifs;
+    if(use_csr)
+    {
+        csr = load_csr(xy_filename, false);
+        if(!csr) { return; }
+        oracle.reset(new warthog::cpd::graph_oracle_base<SYM>());
+    }
+    else
+    {
+        g.load(xy_filename.c_str());
+        oracle.reset(new warthog::cpd::graph_oracle_base<SYM>(&g));
+    }
 
-    warthog::cpd::graph_oracle_base<SYM> oracle(&g);
     std::string cpd_filename = cfg.get_param_value("input");
     if(cpd_filename == "")
     {
@@ -903,7 +1499,8 @@ run_cpd(warthog::util::cfg& cfg,
     ifs.open(cpd_filename);
     if(ifs.is_open())
     {
-        ifs >> oracle;
+        // flat CPDs are mapped rather than read
+        if(!oracle->load_flat(cpd_filename.c_str())) { ifs >> *oracle; }
         ifs.close();
     }
     else
@@ -912,7 +1509,22 @@ run_cpd(warthog::util::cfg& cfg,
         return;
     }
 
-    warthog::cpd_extractions_base<SYM> cpd_extract(&g, &oracle);
+    if(use_csr)
+    {
+        if(oracle->get_num_nodes() != csr->get_num_nodes())
+        {
+            std::cerr << "err; CPD has " << oracle->get_num_nodes()
+                << " nodes but the graph has " << csr->get_num_nodes()
+                << "\n";
+            return;
+        }
+        warthog::cpd_extractions_base<SYM, warthog::graph::csr_graph>
+            cpd_extract(csr.get(), oracle.get());
+        run_experiments(&cpd_extract, alg_name, parser, std::cout);
+        return;
+    }
+
+    warthog::cpd_extractions_base<SYM> cpd_extract(&g, oracle.get());
 
     run_experiments(&cpd_extract, alg_name, parser, std::cout);
 }
@@ -929,10 +1541,7 @@ run_dfs(warthog::util::cfg& cfg,
     }
 
     warthog::graph::xy_graph g;
-
-    std::ifstream ifs(xy_filename);
-    ifs >> g;
-    ifs.close();
+    g.load(xy_filename.c_str());
 
     warthog::simple_graph_expansion_policy expander(&g);
     warthog::zero_heuristic h;
@@ -959,10 +1568,7 @@ run_cpd_dfs(warthog::util::cfg& cfg,
     }
 
     warthog::graph::xy_graph g;
-
-    std::ifstream ifs(xy_filename);
-    ifs >> g;
-    ifs.close();
+    g.load(xy_filename.c_str());
 
     warthog::cpd::graph_oracle oracle(&g);
     std::string cpd_filename = cfg.get_param_value("input");
@@ -971,10 +1577,11 @@ run_cpd_dfs(warthog::util::cfg& cfg,
         cpd_filename = xy_filename + ".cpd";
     }
 
-    ifs.open(cpd_filename);
+    std::ifstream ifs(cpd_filename);
     if(ifs.is_open())
     {
-        ifs >> oracle;
+        // flat CPDs are mapped rather than read
+        if(!oracle.load_flat(cpd_filename.c_str())) { ifs >> oracle; }
     }
     else
     {
@@ -1000,6 +1607,7 @@ run_dimacs(warthog::util::cfg& cfg)
 {
     std::string alg_name = cfg.get_param_value("alg");
     std::string par_nruns = cfg.get_param_value("nruns");
+    std::string par_threads = cfg.get_param_value("threads");
     std::string problemfile = cfg.get_param_value("problem");
 
     if((alg_name == ""))
@@ -1020,6 +1628,47 @@ run_dimacs(warthog::util::cfg& cfg)
        nruns = strtol(par_nruns.c_str(), &end, 10);
     }
 
+    if(par_threads != "")
+    {
+        threads = (uint32_t)strtol(par_threads.c_str(), 0, 10);
+        if(threads > 1 && alg_name != "dijkstra" && alg_name != "astar" &&
+           alg_name != "fch")
+        {
+            std::cerr << "err; --threads is not supported by "
+                << alg_name << "\n";
+            return;
+        }
+    }
+
+    if(use_csr && alg_name != "dijkstra" && alg_name != "astar" &&
+       alg_name != "bi-dijkstra" && alg_name != "bi-astar" &&
+       alg_name != "bch" && alg_name != "cpd" && alg_name != "rev-cpd" &&
+       alg_name != "table" && alg_name != "rev-table")
+    {
+        std::cerr << "err; --csr is not supported by " << alg_name << "\n";
+        return;
+    }
+
+    reorder_name = cfg.get_param_value("reorder");
+    if(reorder_name != "" && reorder_name != "none")
+    {
+        reorder = warthog::graph::parse_reorder_type(reorder_name);
+        if(reorder == warthog::graph::REORDER_NONE)
+        {
+            std::cerr << "err; unknown order " << reorder_name << "\n";
+            return;
+        }
+        if((alg_name != "dijkstra" && alg_name != "astar" &&
+            alg_name != "bi-dijkstra" && alg_name != "bi-astar" &&
+            alg_name != "bch") ||
+           (reorder == warthog::graph::REORDER_LEVEL && alg_name != "bch"))
+        {
+            std::cerr << "err; --reorder " << reorder_name
+                << " is not supported by " << alg_name << "\n";
+            return;
+        }
+    }
+
     warthog::dimacs_parser parser;
     parser.load_instance(problemfile.c_str());
     if(parser.num_experiments() == 0)
@@ -1036,6 +1685,14 @@ run_dimacs(warthog::util::cfg& cfg)
     {
         run_astar(cfg, parser, alg_name);
     }
+    else if(alg_name == "dijkstra-1tm")
+    {
+        run_dijkstra_1tm(cfg, parser, alg_name);
+    }
+    else if(alg_name == "astar-1tm")
+    {
+        run_astar_1tm(cfg, parser, alg_name);
+    }
     else if(alg_name == "astar-bb")
     {
         run_astar_bb(cfg, parser, alg_name);
@@ -1048,10 +1705,22 @@ run_dimacs(warthog::util::cfg& cfg)
     {
         run_bi_astar(cfg, parser, alg_name);
     }
+    else if(alg_name == "astar-lm")
+    {
+        run_astar_lm(cfg, parser, alg_name);
+    }
+    else if(alg_name == "bi-astar-lm")
+    {
+        run_bi_astar_lm(cfg, parser, alg_name);
+    }
     else if(alg_name == "bch")
     {
         run_bch(cfg, parser, alg_name);
     }
+    else if(alg_name == "cch")
+    {
+        run_cch(cfg, parser, alg_name);
+    }
     else if(alg_name == "bchb")
     {
         run_bch_backwards_only(cfg, parser, alg_name);
@@ -1123,10 +1792,13 @@ main(int argc, char** argv)
     {
         {"alg",  required_argument, 0, 1},
         {"nruns",  required_argument, 0, 1},
+        {"threads",  required_argument, 0, 1},
         {"help", no_argument, &print_help, 1},
         {"checkopt",  no_argument, &checkopt, 1},
         {"verbose",  no_argument, &verbose, 1},
         {"noheader",  no_argument, &suppress_header, 1},
+        {"csr",  no_argument, &use_csr, 1},
+        {"reorder",  required_argument, 0, 1},
         {"input",  required_argument, 0, 1},
         {"problem",  required_argument, 0, 1},
         {"fscale", required_argument, 0, 1},
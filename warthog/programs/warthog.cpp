@@ -17,20 +17,33 @@
 #include "four_connected_jps_locator.h"
 #include "greedy_depth_first_search.h"
 #include "gridmap.h"
+#include "grid_bb_labelling.h"
 #include "gridmap_expansion_policy.h"
+#include "jps.h"
 #include "jps_expansion_policy.h"
 #include "jps2_expansion_policy.h"
 #include "jps2plus_expansion_policy.h"
 #include "jps4c_expansion_policy.h"
+#include "jpsplus_bb_expansion_policy.h"
 #include "jpsplus_expansion_policy.h"
 #include "ll_expansion_policy.h"
 #include "manhattan_heuristic.h"
 #include "octile_heuristic.h"
+#include "query_engine.h"
+#include "radix_queue.h"
 #include "scenario_manager.h"
 #include "timer.h"
 #include "labelled_gridmap.h"
+#include "landmark_heuristic.h"
 #include "sipp_expansion_policy.h"
+#include "subgoal_graph.h"
+#include "subgoal_graph_expansion_policy.h"
+#include "tiled_gridmap.h"
+#include "tiled_gridmap_expansion_policy.h"
+#include "tiled_heuristic.h"
 #include "vl_gridmap_expansion_policy.h"
+#include "vl_jps_expansion_policy.h"
+#include "vl_offline_jump_point_locator.h"
 #include "zero_heuristic.h"
 
 #include "getopt.h"
@@ -50,6 +63,10 @@ int checkopt = 0;
 int verbose = 0;
 // display program help on startup
 int print_help = 0;
+// use a radix queue instead of a binary heap for the open list
+int radix = 0;
+// number of worker threads; > 1 solves instances with a query_engine
+uint32_t threads = 1;
 
 void
 help()
@@ -66,10 +83,15 @@ help()
     << "\t--map [map file] (optional; specify this to override map values in scen file) \n"
 	<< "\t--checkopt (optional; compare solution costs against values in the scen file)\n"
 	<< "\t--verbose (optional; prints debugging info when compiled with debug symbols)\n"
+	<< "\t--radix (optional; astar, astar4c, astar_tiled, sg and jps* except jps_wgm use a radix queue as the open list)\n"
+	<< "\t--threads [int] (optional; solve instances in parallel. supported by dijkstra,\n"
+	<< "\t\tastar, astar4c, astar_tiled, jps, jps2 and jps4c. default=1)\n"
+	<< "\t--jump-width [32|64|256] (optional; tiles scanned at a time by the straight\n"
+	<< "\t\tjumps of jps and jps2. 256 needs AVX2 and suits open maps. default=64)\n"
     << "Invoking the program this way solves all instances in [scen file] with algorithm [alg]\n"
     << "Currently recognised values for [alg]:\n"
-    << "\tcbs_ll, cbs_ll_w, dijkstra, astar, astar_wgm, astar4c, sipp\n"
-    << "\tsssp, jps, jps2, jps+, jps2+, jps, jps4c\n"
+    << "\tcbs_ll, cbs_ll_w, dijkstra, astar, astar_wgm, astar4c, astar_tiled, astar_lm, sipp\n"
+    << "\tsssp, jps, jps2, jps+, jps+bb, jps2+, jps, jps4c, jps_wgm, jps+_wgm, sg\n"
     << "\tdfs, gdfs\n\n"
     << ""
     << "The following are valid parameters for GENERATING instances:\n"
@@ -108,6 +130,25 @@ check_optimality(warthog::solution& sol, warthog::experiment* exp)
     return true;
 }
 
+void
+write_result(uint32_t i, std::string& alg_name, warthog::solution& sol,
+        warthog::scenario_manager& scenmgr, std::ostream& out)
+{
+		out
+            << i<<"\t" 
+            << alg_name << "\t" 
+            << sol.nodes_expanded_ << "\t" 
+            << sol.nodes_touched_ << "\t"
+            << sol.nodes_reopen_ << "\t"
+            << sol.nodes_surplus_ << "\t"
+            << sol.heap_ops_ << "\t"
+            << sol.time_elapsed_nano_ << "\t"
+            << sol.sum_of_edge_costs_ << "\t" 
+            << (sol.path_.size()-1) << "\t" 
+            << scenmgr.last_file_loaded() 
+            << std::endl;
+}
+
 void
 run_experiments(warthog::search* algo, std::string alg_name,
         warthog::scenario_manager& scenmgr, bool verbose, bool checkopt,
@@ -126,25 +167,108 @@ run_experiments(warthog::search* algo, std::string alg_name,
         warthog::solution sol;
 
         algo->get_path(pi, sol);
-
-		out
-            << i<<"\t" 
-            << alg_name << "\t" 
-            << sol.nodes_expanded_ << "\t" 
-            << sol.nodes_touched_ << "\t"
-            << sol.nodes_reopen_ << "\t"
-            << sol.nodes_surplus_ << "\t"
-            << sol.heap_ops_ << "\t"
-            << sol.time_elapsed_nano_ << "\t"
-            << sol.sum_of_edge_costs_ << "\t" 
-            << (sol.path_.size()-1) << "\t" 
-            << scenmgr.last_file_loaded() 
-            << std::endl;
+        write_result(i, alg_name, sol, scenmgr, out);
 
         if(checkopt) { check_optimality(sol, exp); }
 	}
 }
 
+// as run_experiments, but every instance is solved by the workers of
+// @param engine. results are printed in scenario order once all are done
+void
+run_parallel_experiments(warthog::query_engine& engine, std::string alg_name,
+        warthog::scenario_manager& scenmgr, bool verbose, bool checkopt,
+        std::ostream& out)
+{
+    std::vector<warthog::problem_instance> batch;
+	for(unsigned int i=0; i < scenmgr.num_experiments(); i++)
+	{
+		warthog::experiment* exp = scenmgr.get_experiment(i);
+		uint32_t startid = exp->starty() * exp->mapwidth() + exp->startx();
+		uint32_t goalid = exp->goaly() * exp->mapwidth() + exp->goalx();
+        batch.push_back(warthog::problem_instance(startid, goalid, verbose));
+    }
+
+    warthog::timer t;
+    t.start();
+    std::vector<warthog::solution> sols;
+    engine.solve(batch, sols);
+    t.stop();
+
+	std::cout 
+        << "id\talg\texpanded\ttouched\treopen\tsurplus\theapops"
+        << "\tnanos\tpcost\tplen\tmap\n";
+	for(unsigned int i=0; i < sols.size(); i++)
+	{
+        write_result(i, alg_name, sols.at(i), scenmgr, out);
+        if(checkopt) { check_optimality(sols.at(i), scenmgr.get_experiment(i)); }
+	}
+
+    std::cerr << "solved " << sols.size() << " instances with "
+        << engine.num_workers() << " threads in "
+        << t.elapsed_time_micro() << "us. queries per thread:";
+    for(uint32_t i = 0; i < engine.num_workers(); i++)
+    {
+        std::cerr << " " << engine.get_queries(i);
+    }
+    std::cerr << "\n";
+}
+
+
+// solve every instance with flexible_astar. the open list is a binary
+// heap or, if --radix is set, a radix queue
+template<class H, class E>
+void
+run_flexible_astar(H& heuristic, E& expander,
+        warthog::scenario_manager& scenmgr, std::string alg_name)
+{
+    if(radix)
+    {
+        warthog::radix_queue open;
+        warthog::flexible_astar<H, E, warthog::radix_queue>
+            astar(&heuristic, &expander, &open);
+
+        run_experiments(&astar, alg_name, scenmgr,
+                verbose, checkopt, std::cout);
+        std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+        return;
+    }
+
+    warthog::pqueue_min open;
+    warthog::flexible_astar<H, E, warthog::pqueue_min>
+        astar(&heuristic, &expander, &open);
+
+    run_experiments(&astar, alg_name, scenmgr,
+            verbose, checkopt, std::cout);
+    std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+}
+
+// solve every instance with --threads copies of flexible_astar. each
+// worker has its own copy of @param heuristic and its own expander, built
+// from @param args; the map the expanders point to is shared
+template<class E, class H, class... ARGS>
+void
+run_parallel_astar(H& heuristic, warthog::scenario_manager& scenmgr,
+        std::string alg_name, ARGS... args)
+{
+    warthog::query_engine engine(threads,
+        [&heuristic, args...](uint32_t id) -> warthog::search*
+        {
+            if(radix)
+            {
+                return new warthog::astar_worker<H, E, warthog::radix_queue>(
+                        new H(heuristic), new E(args...),
+                        new warthog::radix_queue());
+            }
+            return new warthog::astar_worker<H, E, warthog::pqueue_min>(
+                    new H(heuristic), new E(args...),
+                    new warthog::pqueue_min());
+        });
+
+    run_parallel_experiments(engine, alg_name, scenmgr,
+            verbose, checkopt, std::cout);
+    std::cerr << "done. total memory: "<< engine.mem() + scenmgr.mem() << "\n";
+}
 
 void
 run_jpsplus(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
@@ -152,18 +276,40 @@ run_jpsplus(warthog::scenario_manager& scenmgr, std::string mapname, std::string
     warthog::gridmap map(mapname.c_str());
 	warthog::jpsplus_expansion_policy expander(&map);
 	warthog::octile_heuristic heuristic(map.width(), map.height());
-    warthog::pqueue_min open;
 
-	warthog::flexible_astar<
-		warthog::octile_heuristic,
-	   	warthog::jpsplus_expansion_policy,
-        warthog::pqueue_min> 
-            astar(&heuristic, &expander, &open);
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
+}
 
-    run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
+void
+run_jpsplus_bb(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::gridmap map(mapname.c_str());
+    warthog::label::grid_bb_labelling lab(&map);
+    std::string label_filename = mapname + ".label.gbb";
 
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+    std::ifstream ifs(label_filename.c_str(),
+            std::ios_base::in|std::ios_base::binary);
+    if(ifs.is_open()) { ifs >> lab; }
+    if(!ifs.is_open() || !ifs.good())
+    {
+        lab.precompute();
+
+        std::cerr << "saving precompute data to "
+            << label_filename << "...\n";
+        std::ofstream ofs(label_filename,
+                std::ios_base::out|std::ios_base::binary);
+        ofs << lab;
+        if(!ofs.good())
+        {
+            std::cerr << "\nerror trying to write to file "
+                << label_filename << std::endl;
+        }
+    }
+
+	warthog::jpsplus_bb_expansion_policy expander(&lab);
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
 }
 
 void
@@ -172,112 +318,147 @@ run_jps2plus(warthog::scenario_manager& scenmgr, std::string mapname, std::strin
     warthog::gridmap map(mapname.c_str());
 	warthog::jps2plus_expansion_policy expander(&map);
 	warthog::octile_heuristic heuristic(map.width(), map.height());
-    warthog::pqueue_min open;
 
-	warthog::flexible_astar<
-		warthog::octile_heuristic,
-	   	warthog::jps2plus_expansion_policy,
-        warthog::pqueue_min> astar(&heuristic, &expander, &open);
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
+}
 
-    run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
+void
+run_sg(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::gridmap map(mapname.c_str());
+    warthog::subgoal_graph sg(&map);
+	warthog::subgoal_graph_expansion_policy expander(&sg);
+	warthog::octile_heuristic heuristic(map.width(), map.height());
 
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
 }
 
 void
 run_jps2(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
     warthog::gridmap map(mapname.c_str());
-	warthog::jps2_expansion_policy expander(&map);
 	warthog::octile_heuristic heuristic(map.width(), map.height());
-    warthog::pqueue_min open;
+    if(threads > 1)
+    {
+        run_parallel_astar<warthog::jps2_expansion_policy>(
+                heuristic, scenmgr, alg_name, &map);
+        return;
+    }
 
-	warthog::flexible_astar<
-		warthog::octile_heuristic,
-	   	warthog::jps2_expansion_policy,
-        warthog::pqueue_min> 
-            astar(&heuristic, &expander, &open);
+	warthog::jps2_expansion_policy expander(&map);
 
-    run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
 }
 
 void
 run_jps(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
     warthog::gridmap map(mapname.c_str());
-	warthog::jps_expansion_policy expander(&map);
 	warthog::octile_heuristic heuristic(map.width(), map.height());
-    warthog::pqueue_min open;
+    if(threads > 1)
+    {
+        run_parallel_astar<warthog::jps_expansion_policy>(
+                heuristic, scenmgr, alg_name, &map);
+        return;
+    }
 
-	warthog::flexible_astar<
-		warthog::octile_heuristic,
-	   	warthog::jps_expansion_policy,
-        warthog::pqueue_min> 
-            astar(&heuristic, &expander, &open);
+	warthog::jps_expansion_policy expander(&map);
 
-    run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
 }
 
 void
 run_jps4c(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
     warthog::gridmap map(mapname.c_str());
-	warthog::jps4c_expansion_policy expander(&map);
 	warthog::manhattan_heuristic heuristic(map.width(), map.height());
-    warthog::pqueue_min open;
+    if(threads > 1)
+    {
+        run_parallel_astar<warthog::jps4c_expansion_policy>(
+                heuristic, scenmgr, alg_name, &map);
+        return;
+    }
 
-	warthog::flexible_astar<
-		warthog::manhattan_heuristic,
-	   	warthog::jps4c_expansion_policy,
-        warthog::pqueue_min> 
-            astar(&heuristic, &expander, &open);
+	warthog::jps4c_expansion_policy expander(&map);
 
-    run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
 }
 
 void
 run_astar(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
     warthog::gridmap map(mapname.c_str());
-	warthog::gridmap_expansion_policy expander(&map);
 	warthog::octile_heuristic heuristic(map.width(), map.height());
-    warthog::pqueue_min open;
+    if(threads > 1)
+    {
+        run_parallel_astar<warthog::gridmap_expansion_policy>(
+                heuristic, scenmgr, alg_name, &map);
+        return;
+    }
 
-	warthog::flexible_astar<
-		warthog::octile_heuristic,
-	   	warthog::gridmap_expansion_policy, 
-        warthog::pqueue_min> 
+	warthog::gridmap_expansion_policy expander(&map);
+
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
+}
+
+// A* with landmark heuristics; the tables are saved as [map file].lm
+void
+run_astar_lm(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::gridmap map(mapname.c_str());
+    warthog::landmark_heuristic heuristic(&map);
+    std::string lm_filename = mapname + ".lm";
+    if(!heuristic.load(lm_filename.c_str()))
+    {
+        heuristic.precompute(16);
+        heuristic.save(lm_filename.c_str());
+    }
+
+	warthog::gridmap_expansion_policy expander(&map);
+    warthog::pqueue_min open;
+    warthog::flexible_astar<
+        warthog::landmark_heuristic,
+        warthog::gridmap_expansion_policy,
+        warthog::pqueue_min>
             astar(&heuristic, &expander, &open);
 
-    run_experiments(&astar, alg_name, scenmgr, 
+    run_experiments(&astar, alg_name, scenmgr,
             verbose, checkopt, std::cout);
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+    std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
 }
 
 void
 run_astar4c(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
     warthog::gridmap map(mapname.c_str());
-	warthog::gridmap_expansion_policy expander(&map, true);
 	warthog::manhattan_heuristic heuristic(map.width(), map.height());
-    warthog::pqueue_min open;
+    if(threads > 1)
+    {
+        run_parallel_astar<warthog::gridmap_expansion_policy>(
+                heuristic, scenmgr, alg_name, &map, true);
+        return;
+    }
 
-	warthog::flexible_astar<
-		warthog::manhattan_heuristic,
-	   	warthog::gridmap_expansion_policy, 
-        warthog::pqueue_min> 
-            astar(&heuristic, &expander, &open);
+	warthog::gridmap_expansion_policy expander(&map, true);
 
-    run_experiments(&astar, alg_name, scenmgr, 
-            verbose, checkopt, std::cout);
-	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
+}
+
+void
+run_tiled_astar(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::tiled_gridmap map(mapname.c_str());
+    warthog::tiled_heuristic<warthog::octile_heuristic> heuristic(&map);
+    if(threads > 1)
+    {
+        run_parallel_astar<warthog::tiled_gridmap_expansion_policy>(
+                heuristic, scenmgr, alg_name, &map);
+        return;
+    }
+
+    warthog::tiled_gridmap_expansion_policy expander(&map);
+
+    run_flexible_astar(heuristic, expander, scenmgr, alg_name);
 }
 
 void
@@ -378,6 +559,14 @@ void
 run_dijkstra(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
     warthog::gridmap map(mapname.c_str());
+    if(threads > 1)
+    {
+        warthog::zero_heuristic heuristic;
+        run_parallel_astar<warthog::gridmap_expansion_policy>(
+                heuristic, scenmgr, alg_name, &map);
+        return;
+    }
+
 	warthog::gridmap_expansion_policy expander(&map);
 	warthog::zero_heuristic heuristic;
     warthog::pqueue_min open;
@@ -417,6 +606,53 @@ run_wgm_astar(warthog::scenario_manager& scenmgr, std::string mapname, std::stri
 	std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
 }
 
+void
+run_jps_wgm(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::vl_gridmap map(mapname.c_str());
+	warthog::vl_jps_expansion_policy<warthog::vl_jump_point_locator>
+        expander(&map);
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+    warthog::pqueue_min open;
+
+    // as for astar_wgm
+    heuristic.set_hscale('.');
+
+	warthog::flexible_astar<
+		warthog::octile_heuristic,
+	   	warthog::vl_jps_expansion_policy<warthog::vl_jump_point_locator>,
+        warthog::pqueue_min> 
+            astar(&heuristic, &expander, &open);
+
+    run_experiments(&astar, alg_name, scenmgr, 
+            verbose, checkopt, std::cout);
+    std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+}
+
+void
+run_jpsplus_wgm(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
+{
+    warthog::vl_gridmap map(mapname.c_str());
+	warthog::vl_jps_expansion_policy<warthog::vl_offline_jump_point_locator>
+        expander(&map);
+	warthog::octile_heuristic heuristic(map.width(), map.height());
+    warthog::pqueue_min open;
+
+    // as for astar_wgm
+    heuristic.set_hscale('.');
+
+	warthog::flexible_astar<
+		warthog::octile_heuristic,
+	   	warthog::vl_jps_expansion_policy
+            <warthog::vl_offline_jump_point_locator>,
+        warthog::pqueue_min> 
+            astar(&heuristic, &expander, &open);
+
+    run_experiments(&astar, alg_name, scenmgr, 
+            verbose, checkopt, std::cout);
+    std::cerr << "done. total memory: "<< astar.mem() + scenmgr.mem() << "\n";
+}
+
 void
 run_wgm_sssp(warthog::scenario_manager& scenmgr, std::string mapname, std::string alg_name)
 {
@@ -506,6 +742,9 @@ main(int argc, char** argv)
 		{"help", no_argument, &print_help, 1},
 		{"checkopt",  no_argument, &checkopt, 1},
 		{"verbose",  no_argument, &verbose, 1},
+		{"radix",  no_argument, &radix, 1},
+		{"threads",  required_argument, 0, 1},
+		{"jump-width",  required_argument, 0, 1},
 		{0,  0, 0, 0}
 	};
 
@@ -522,6 +761,8 @@ main(int argc, char** argv)
     std::string alg = cfg.get_param_value("alg");
     std::string gen = cfg.get_param_value("gen");
     std::string mapname = cfg.get_param_value("map");
+    std::string par_threads = cfg.get_param_value("threads");
+    std::string jump_width = cfg.get_param_value("jump-width");
 
 	if(gen != "")
 	{
@@ -539,6 +780,33 @@ main(int argc, char** argv)
 		exit(0);
 	}
 
+    if(jump_width != "")
+    {
+        warthog::jps::set_jump_width(
+                (uint32_t)strtol(jump_width.c_str(), 0, 10));
+    }
+
+    if(par_threads != "")
+    {
+        threads = (uint32_t)strtol(par_threads.c_str(), 0, 10);
+        if(threads > 1 && alg != "dijkstra" && alg != "astar" &&
+           alg != "astar4c" && alg != "jps" && alg != "jps2" && alg != "jps4c")
+        {
+            std::cerr << "err; --threads is not supported by " << alg << "\n";
+            exit(0);
+        }
+    }
+
+    // the radix queue cannot break ties by reservations (cbs_ll) or
+    // order the keys of the other algorithms
+    if(radix && alg != "astar" && alg != "astar4c" && alg != "astar_tiled" &&
+       alg != "sg" && alg != "jps" && alg != "jps2" && alg != "jps4c" &&
+       alg != "jps+" && alg != "jps2+" && alg != "jps+bb")
+    {
+        std::cerr << "err; --radix is not supported by " << alg << "\n";
+        exit(0);
+    }
+
     // load up the instances
 	warthog::scenario_manager scenmgr;
 	scenmgr.load_scenario(sfile.c_str());
@@ -559,6 +827,11 @@ main(int argc, char** argv)
         run_jpsplus(scenmgr, mapname, alg);
     }
 
+    else if(alg == "jps+bb")
+    {
+        run_jpsplus_bb(scenmgr, mapname, alg);
+    }
+
     else if(alg == "jps2")
     {
         run_jps2(scenmgr, mapname, alg);
@@ -569,6 +842,11 @@ main(int argc, char** argv)
         run_jps2plus(scenmgr, mapname, alg);
     }
 
+    else if(alg == "sg")
+    {
+        run_sg(scenmgr, mapname, alg);
+    }
+
     else if(alg == "jps")
     {
         run_jps(scenmgr, mapname, alg);
@@ -587,10 +865,18 @@ main(int argc, char** argv)
     {
         run_astar(scenmgr, mapname, alg); 
     }
+    else if(alg == "astar_lm")
+    {
+        run_astar_lm(scenmgr, mapname, alg); 
+    }
     else if(alg == "astar4c")
     {
         run_astar4c(scenmgr, mapname, alg); 
     }
+    else if(alg == "astar_tiled")
+    {
+        run_tiled_astar(scenmgr, mapname, alg);
+    }
 
     else if(alg == "cbs_ll")
     {
@@ -610,6 +896,16 @@ main(int argc, char** argv)
         run_wgm_astar(scenmgr, mapname, alg); 
     }
 
+    else if(alg == "jps_wgm")
+    {
+        run_jps_wgm(scenmgr, mapname, alg); 
+    }
+
+    else if(alg == "jps+_wgm")
+    {
+        run_jpsplus_wgm(scenmgr, mapname, alg); 
+    }
+
     else if(alg == "sssp")
     {
         run_sssp(scenmgr, mapname, alg);
@@ -0,0 +1,57 @@
+#!/bin/bash
+# Compares the node expansion throughput of warthog binaries over every
+# scenario in a directory (e.g. the GPPC sets in gppc/*/scenarios). Useful
+# for before/after comparisons of builds with different flags, e.g.
+# `make fast DBWORD_BITS=64`.
+#
+# For each binary and algorithm, prints the total number of expansions, the
+# total search time (as reported by warthog) and expansions per second.
+
+function help
+{
+	echo "Syntax: $0 \"[scenario dir]\" \"[algorithms]\" [warthog binary]..."
+	echo "Example: $0 \"../gppc/gppc-2014/scenarios\" \"astar jps jps2\" \\"
+	echo "    ./build/fast/bin/warthog /tmp/w64/build/fast/bin/warthog"
+}
+
+if [ $# -lt 3 ]
+then
+	help
+	exit 1
+fi
+
+scendir=$1
+algs=$2
+shift 2
+
+tmp=`mktemp`
+trap "rm -f $tmp" EXIT
+
+printf "%-40s %-8s %12s %12s %14s\n" binary alg expanded seconds "exp/sec"
+for bin in "$@"
+do
+	for alg in $algs
+	do
+		total=0
+		nanos=0
+		for sfile in $scendir/*.map.scen
+		do
+			# the map path inside GPPC scenario files is not where the map
+			# is kept; point each instance at the map next to the scenario
+			awk -v m=${sfile%.scen} 'BEGIN { OFS = "\t" } 
+				NR == 1 { print; next } { $2 = m; print }' $sfile > $tmp
+			out=$($bin --alg $alg --scen $tmp 2>/dev/null)
+			if [ "$?" -ne "0" ]
+			then
+				echo "Failed while executing: $bin --alg $alg --scen $sfile"
+				exit 1
+			fi
+			read e n <<< $(echo "$out" | \
+				awk 'NR > 1 { e += $3; n += $8 } END { printf "%d %d", e, n }')
+			total=$((total + e))
+			nanos=$((nanos + n))
+		done
+		awk -v b=$bin -v a=$alg -v e=$total -v n=$nanos 'BEGIN {
+			printf "%-40s %-8s %12d %12.3f %14.0f\n", b, a, e, n/1e9, e/(n/1e9) }'
+	done
+done
@@ -4,6 +4,8 @@
 // contraction/bch_expansion_policy.h
 //
 // An expansion policy for contraction hierarchies. 
+// The graph can be an xy_graph or any other type with the same
+// adjacency interface (e.g. a csr_graph).
 //
 // For more details see:
 // [Geisbergerger, Sanders, Schultes and Delling. 
@@ -17,29 +19,82 @@
 
 #include "contraction.h"
 #include "expansion_policy.h"
+#include "problem_instance.h"
+#include "search_node.h"
 #include "xy_graph.h"
 
 #include <vector>
 
 namespace warthog{
 
-class problem_instance;
-class search_node;
-
-class bch_expansion_policy : public  expansion_policy
+template<class G>
+class bch_expansion_policy_base : public  expansion_policy
 {
     public:
         // @param g: the input contracted graph
         // @param backward: when true successors are generated by following 
         // incoming arcs rather than outgoing arcs (default is outgoing)
-        bch_expansion_policy(warthog::graph::xy_graph* g, 
-                bool backward=false);
+        bch_expansion_policy_base(G* g, bool backward=false)
+            : expansion_policy(g->get_num_nodes())
+        {
+            g_ = g;
+            backward_ = backward;
+
+            if(backward_)
+            {
+                fn_begin_iter_ = &bch_expansion_policy_base::get_bwd_begin_iter;
+                fn_end_iter_ = &bch_expansion_policy_base::get_bwd_end_iter;
+
+                fn_rev_end_iter_ = &bch_expansion_policy_base::get_fwd_end_iter;
+                fn_rev_begin_iter_ = 
+                    &bch_expansion_policy_base::get_fwd_begin_iter;
+            }
+            else
+            {
+                fn_begin_iter_ = &bch_expansion_policy_base::get_fwd_begin_iter;
+                fn_end_iter_ = &bch_expansion_policy_base::get_fwd_end_iter;
+
+                fn_rev_begin_iter_ = 
+                    &bch_expansion_policy_base::get_bwd_begin_iter;
+                fn_rev_end_iter_ = &bch_expansion_policy_base::get_bwd_end_iter;
+            }
+        }
 
         virtual 
-        ~bch_expansion_policy() { }
+        ~bch_expansion_policy_base() { }
 
 		virtual void 
-		expand(warthog::search_node*, warthog::problem_instance*);
+		expand(warthog::search_node* current, warthog::problem_instance*)
+        {
+            reset();
+            uint32_t current_id = (uint32_t)current->get_id();
+            edge_iter begin, end;
+
+            // stall-on-demand
+            begin = (this->*fn_rev_begin_iter_)(current_id);
+            end = (this->*fn_rev_end_iter_)(current_id);
+            for(edge_iter it = begin; it != end; it++)
+            {
+                const typename G::edge_type& e = *it;
+                assert(e.node_id_ < g_->get_num_nodes());
+                warthog::search_node* next = this->generate(e.node_id_);
+                if(next->get_search_number() == current->get_search_number() &&
+                        current->get_g() > (next->get_g() + e.wt_))
+                {
+                    return; // stall
+                }
+            }
+
+            // OK, node doesn't need stalling; generate successors as usual
+            begin = (this->*fn_begin_iter_)(current_id);
+            end = (this->*fn_end_iter_)(current_id);
+            for(edge_iter it = begin; it != end; it++)
+            {
+                const typename G::edge_type& e = *it;
+                assert(e.node_id_ < g_->get_num_nodes());
+                this->add_neighbour(this->generate(e.node_id_), e.wt_);
+            }
+        }
 
         virtual void
         get_xy(warthog::sn_id_t node_id, int32_t& x, int32_t& y)
@@ -51,23 +106,40 @@ class bch_expansion_policy : public  expansion_policy
         get_num_nodes() { return g_->get_num_nodes(); }
 
         virtual warthog::search_node* 
-        generate_start_node(warthog::problem_instance* pi);
+        generate_start_node(warthog::problem_instance* pi)
+        {
+            uint32_t s_graph_id = g_->to_graph_id((uint32_t)pi->start_id_);
+            if(s_graph_id == warthog::INF32) { return 0; }
+            return generate(s_graph_id);
+        }
 
         virtual warthog::search_node*
-        generate_target_node(warthog::problem_instance* pi);
+        generate_target_node(warthog::problem_instance* pi)
+        {
+            uint32_t t_graph_id = g_->to_graph_id((uint32_t)pi->target_id_);
+            if(t_graph_id == warthog::INF32) { return 0; }
+            return generate(t_graph_id);
+        }
 
         virtual size_t
-        mem();
+        mem()
+        {
+            return 
+                expansion_policy::mem() + 
+                sizeof(this);
+        }
 
     private:
+        typedef typename G::edge_iter edge_iter;
+
         bool backward_;
-        warthog::graph::xy_graph* g_;
+        G* g_;
 
         // we use function pointers to optimise away a 
         // branching instruction when fetching successors
-        typedef warthog::graph::edge_iter
-                (warthog::bch_expansion_policy::*chep_get_iter_fn) 
-                (warthog::graph::node* n);
+        typedef edge_iter
+                (bch_expansion_policy_base::*chep_get_iter_fn) 
+                (uint32_t id);
         
         // pointers to the neighbours in the direction of the search
         chep_get_iter_fn fn_begin_iter_;
@@ -77,23 +149,25 @@ class bch_expansion_policy : public  expansion_policy
         chep_get_iter_fn fn_rev_begin_iter_;
         chep_get_iter_fn fn_rev_end_iter_;
 
-        inline warthog::graph::edge_iter
-        get_fwd_begin_iter(warthog::graph::node* n) 
-        { return n->outgoing_begin(); }
+        inline edge_iter
+        get_fwd_begin_iter(uint32_t id) 
+        { return g_->outgoing_begin(id); }
 
-        inline warthog::graph::edge_iter
-        get_fwd_end_iter(warthog::graph::node* n) 
-        { return n->outgoing_end(); }
+        inline edge_iter
+        get_fwd_end_iter(uint32_t id) 
+        { return g_->outgoing_end(id); }
 
-        inline warthog::graph::edge_iter
-        get_bwd_begin_iter(warthog::graph::node* n) 
-        { return n->incoming_begin(); }
+        inline edge_iter
+        get_bwd_begin_iter(uint32_t id) 
+        { return g_->incoming_begin(id); }
 
-        inline warthog::graph::edge_iter
-        get_bwd_end_iter(warthog::graph::node* n) 
-        { return n->incoming_end(); }
+        inline edge_iter
+        get_bwd_end_iter(uint32_t id) 
+        { return g_->incoming_end(id); }
 };
 
+typedef bch_expansion_policy_base<warthog::graph::xy_graph> 
+        bch_expansion_policy;
+
 }
 #endif
-
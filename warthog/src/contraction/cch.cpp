@@ -0,0 +1,812 @@
+#include "cch.h"
+#include "constants.h"
+#include "helpers.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+
+// cells smaller than this are split at a median, which is much cheaper
+// than a flow and, on road networks, about as good
+const size_t MIN_FLOW_CELL = 1024;
+
+// the undirected structure of the input graph and the bookkeeping shared
+// by every step of the dissection
+struct dissection
+{
+    std::vector<uint32_t> adj_begin_;
+    std::vector<uint32_t> adj_;
+    std::vector<int64_t> xy_;
+    std::vector<uint32_t> stamp_;
+    uint32_t next_stamp_;
+    std::vector<uint32_t>* order_;
+
+    // the cell being split, with local ids: its edges, the flow through
+    // each edge (from the lower id to the higher) and through each node,
+    // and the terminals (1 for sources, 2 for sinks). every node has a
+    // capacity of one, so that the minimum cut is a vertex separator
+    std::vector<uint32_t> local_;
+    std::vector<uint32_t> cell_begin_;
+    std::vector<uint32_t> cell_adj_;
+    std::vector<uint32_t> cell_edge_;
+    std::vector<int32_t> edge_flow_;
+    std::vector<uint8_t> node_flow_;
+    std::vector<uint8_t> side_;
+
+    // the search for augmenting paths runs over two states per node,
+    // entering (2 * id) and leaving (2 * id + 1) the node
+    std::vector<uint32_t> visit_;
+    std::vector<uint32_t> dist_;
+    std::vector<uint32_t> arc_pos_;
+    std::vector<uint32_t> queue_;
+    std::vector<uint32_t> stack_;
+    std::vector<uint32_t> stack_edge_;
+    std::vector<uint32_t> seeds_;
+    uint32_t visit_stamp_;
+
+    // the position of @param id along the direction @param dir
+    inline int64_t
+    key(uint32_t dir, uint32_t id)
+    {
+        int64_t x = xy_[id*2];
+        int64_t y = xy_[id*2+1];
+        switch(dir)
+        {
+            case 0: return x;
+            case 1: return y;
+            case 2: return x + y;
+            default: return x - y;
+        }
+    }
+
+    // the flow from local node @param from to its neighbour @param to
+    // along the edge @param e
+    inline int32_t
+    flow(uint32_t from, uint32_t to, uint32_t e)
+    {
+        return from < to ? edge_flow_[e] : -edge_flow_[e];
+    }
+
+    void
+    load_cell(const std::vector<uint32_t>& cell)
+    {
+        uint32_t n = (uint32_t)cell.size();
+        uint32_t in_cell = next_stamp_++;
+        for(uint32_t i = 0; i < n; i++)
+        {
+            stamp_[cell[i]] = in_cell;
+            local_[cell[i]] = i;
+        }
+
+        cell_begin_.assign(n + 1, 0);
+        for(uint32_t i = 0; i < n; i++)
+        {
+            for(uint32_t k = adj_begin_[cell[i]]; k < adj_begin_[cell[i]+1]; k++)
+            {
+                if(stamp_[adj_[k]] == in_cell) { cell_begin_[i+1]++; }
+            }
+        }
+        for(uint32_t i = 0; i < n; i++) { cell_begin_[i+1] += cell_begin_[i]; }
+
+        std::vector<uint32_t> pos(cell_begin_.begin(), cell_begin_.end() - 1);
+        cell_adj_.resize(cell_begin_[n]);
+        cell_edge_.resize(cell_begin_[n]);
+        uint32_t num_edges = 0;
+        for(uint32_t i = 0; i < n; i++)
+        {
+            for(uint32_t k = adj_begin_[cell[i]]; k < adj_begin_[cell[i]+1]; k++)
+            {
+                if(stamp_[adj_[k]] != in_cell) { continue; }
+                uint32_t j = local_[adj_[k]];
+                if(j < i) { continue; }
+                cell_adj_[pos[i]] = j;
+                cell_edge_[pos[i]++] = num_edges;
+                cell_adj_[pos[j]] = i;
+                cell_edge_[pos[j]++] = num_edges++;
+            }
+        }
+        edge_flow_.resize(num_edges);
+    }
+
+    // the number of arcs out of the search state @param s. no flow enters
+    // a node that none crosses, so only its own arc leaves its entry
+    inline uint32_t
+    num_arcs(uint32_t s)
+    {
+        uint32_t v = s >> 1;
+        uint32_t deg = cell_begin_[v+1] - cell_begin_[v];
+        if(s & 1) { return deg + node_flow_[v]; }
+        return node_flow_[v] ? deg : 1;
+    }
+
+    // the @param idx-th arc out of the search state @param s, if it has
+    // room for more flow; INF32 otherwise. @param e is set to its edge
+    inline uint32_t
+    residual_arc(uint32_t s, uint32_t idx, uint32_t& e)
+    {
+        uint32_t v = s >> 1;
+        e = warthog::INF32;
+        if(s & 1)
+        {
+            // leave along any edge; edges have no capacity limit. or push
+            // back the flow that crosses the node
+            if(idx == cell_begin_[v+1] - cell_begin_[v]) { return v * 2; }
+            uint32_t k = cell_begin_[v] + idx;
+            e = cell_edge_[k];
+            return side_[cell_adj_[k]] == 3 ? warthog::INF32 : cell_adj_[k] * 2;
+        }
+
+        // cross the node, or push back the flow that enters it
+        if(!node_flow_[v]) { return v * 2 + 1; }
+        uint32_t k = cell_begin_[v] + idx;
+        e = cell_edge_[k];
+        uint32_t u = cell_adj_[k];
+        return flow(u, v, e) > 0 ? u * 2 + 1 : warthog::INF32;
+    }
+
+    // label the states reachable from the sources with their distance.
+    // @return true if a sink can be left
+    bool
+    bfs()
+    {
+        visit_stamp_++;
+        queue_.clear();
+        for(uint32_t source : seeds_)
+        {
+            uint32_t s = source * 2;
+            visit_[s] = visit_stamp_;
+            dist_[s] = 0;
+            queue_.push_back(s);
+        }
+
+        uint32_t sink_dist = warthog::INF32;
+        for(size_t h = 0; h < queue_.size(); h++)
+        {
+            uint32_t s = queue_[h];
+            if(dist_[s] >= sink_dist) { break; }
+            uint32_t arcs = num_arcs(s);
+            for(uint32_t idx = 0; idx < arcs; idx++)
+            {
+                uint32_t e;
+                uint32_t t = residual_arc(s, idx, e);
+                if(t == warthog::INF32 || visit_[t] == visit_stamp_)
+                {
+                    continue;
+                }
+                visit_[t] = visit_stamp_;
+                dist_[t] = dist_[s] + 1;
+                queue_.push_back(t);
+                if((t & 1) && side_[t >> 1] == 2) { sink_dist = dist_[t]; }
+            }
+        }
+        return sink_dist != warthog::INF32;
+    }
+
+    // send one unit of flow along the path on the stack
+    void
+    augment()
+    {
+        for(size_t i = 1; i < stack_.size(); i++)
+        {
+            uint32_t a = stack_[i-1] >> 1;
+            uint32_t b = stack_[i] >> 1;
+            if(a == b) { node_flow_[a] = stack_[i] & 1; }
+            else { edge_flow_[stack_edge_[i]] += a < b ? 1 : -1; }
+        }
+    }
+
+    // split the loaded @param cell with a minimum vertex separator between
+    // the first and the last quarter of its nodes along the direction
+    // @param dir (cf. Inertial Flow). @return false, leaving the split
+    // undefined, once the separator reaches @param bound nodes
+    bool
+    flow_cut(const std::vector<uint32_t>& cell, uint32_t dir, size_t bound,
+            std::vector<uint32_t>& left, std::vector<uint32_t>& right,
+            std::vector<uint32_t>& sep)
+    {
+        uint32_t n = (uint32_t)cell.size();
+        uint32_t num_terminals = std::max<uint32_t>(1, n / 4);
+        std::vector<uint32_t> by_key(n);
+        for(uint32_t i = 0; i < n; i++) { by_key[i] = i; }
+        auto less = [this, dir, &cell](uint32_t a, uint32_t b)
+        {
+            int64_t ka = key(dir, cell[a]), kb = key(dir, cell[b]);
+            return ka < kb || (ka == kb && cell[a] < cell[b]);
+        };
+        std::nth_element(by_key.begin(), by_key.begin() + num_terminals,
+                by_key.end(), less);
+        std::nth_element(by_key.begin() + num_terminals,
+                by_key.end() - num_terminals, by_key.end(), less);
+
+        side_.assign(n, 0);
+        for(uint32_t i = 0; i < num_terminals; i++)
+        {
+            side_[by_key[i]] = 1;
+            side_[by_key[n - 1 - i]] = 2;
+        }
+
+        // paths from the sources leave through those on the boundary;
+        // the others (3) are left out of the search
+        seeds_.clear();
+        for(uint32_t i = 0; i < num_terminals; i++)
+        {
+            uint32_t v = by_key[i];
+            side_[v] = 3;
+            for(uint32_t k = cell_begin_[v]; k < cell_begin_[v+1]; k++)
+            {
+                if(side_[cell_adj_[k]] == 0 || side_[cell_adj_[k]] == 2)
+                {
+                    side_[v] = 1;
+                    seeds_.push_back(v);
+                    break;
+                }
+            }
+        }
+        node_flow_.assign(n, 0);
+        std::fill(edge_flow_.begin(), edge_flow_.end(), 0);
+        visit_.assign(2 * n, 0);
+        dist_.resize(2 * n);
+        visit_stamp_ = 0;
+
+        // Dinic's algorithm: each phase finds a blocking flow along the
+        // shortest augmenting paths
+        size_t total = 0;
+        while(true)
+        {
+            if(!bfs()) { break; }
+
+            arc_pos_.assign(2 * n, 0);
+            for(uint32_t source : seeds_)
+            {
+                stack_.assign(1, source * 2);
+                stack_edge_.assign(1, warthog::INF32);
+                while(!stack_.empty())
+                {
+                    uint32_t s = stack_.back();
+                    if((s & 1) && side_[s >> 1] == 2)
+                    {
+                        augment();
+                        if(++total >= bound) { return false; }
+                        stack_.resize(1);
+                        stack_edge_.resize(1);
+                        continue;
+                    }
+
+                    uint32_t t = warthog::INF32, e = warthog::INF32;
+                    for( ; arc_pos_[s] < num_arcs(s); arc_pos_[s]++)
+                    {
+                        t = residual_arc(s, arc_pos_[s], e);
+                        if(t != warthog::INF32 &&
+                           visit_[t] == visit_stamp_ &&
+                           dist_[t] == dist_[s] + 1) { break; }
+                        t = warthog::INF32;
+                    }
+
+                    if(t != warthog::INF32)
+                    {
+                        stack_.push_back(t);
+                        stack_edge_.push_back(e);
+                        continue;
+                    }
+
+                    // a dead end for the rest of the phase
+                    dist_[s] = warthog::INF32;
+                    stack_.pop_back();
+                    stack_edge_.pop_back();
+                    if(!stack_.empty()) { arc_pos_[stack_.back()]++; }
+                }
+            }
+        }
+
+        // the nodes reachable from the sources are on the left; those
+        // that can be entered but not left are the separator
+        left.clear();
+        right.clear();
+        sep.clear();
+        for(uint32_t i = 0; i < n; i++)
+        {
+            if(side_[i] == 3 || visit_[i*2+1] == visit_stamp_)
+            {
+                left.push_back(cell[i]);
+            }
+            else if(visit_[i*2] == visit_stamp_) { sep.push_back(cell[i]); }
+            else { right.push_back(cell[i]); }
+        }
+        return true;
+    }
+
+    // split @param cell at the median along the direction @param dir;
+    // the first half of @param cell goes left. @param sep is set to the
+    // smaller of the boundaries of the two halves
+    void
+    median_boundary(std::vector<uint32_t>& cell, uint32_t dir,
+            std::vector<uint32_t>& sep)
+    {
+        size_t mid = cell.size() / 2;
+        std::nth_element(cell.begin(), cell.begin() + mid, cell.end(),
+            [this, dir](uint32_t a, uint32_t b)
+            {
+                int64_t ka = key(dir, a), kb = key(dir, b);
+                return ka < kb || (ka == kb && a < b);
+            });
+
+        uint32_t lo = next_stamp_++;
+        uint32_t hi = next_stamp_++;
+        for(size_t i = 0; i < cell.size(); i++)
+        {
+            stamp_[cell[i]] = i < mid ? lo : hi;
+        }
+
+        sep.clear();
+        for(uint32_t side = 0; side < 2; side++)
+        {
+            size_t first = side ? mid : 0;
+            size_t last = side ? cell.size() : mid;
+            uint32_t other = side ? lo : hi;
+            std::vector<uint32_t> boundary;
+            for(size_t i = first; i < last; i++)
+            {
+                for(uint32_t k = adj_begin_[cell[i]];
+                        k < adj_begin_[cell[i]+1]; k++)
+                {
+                    if(stamp_[adj_[k]] == other)
+                    {
+                        boundary.push_back(cell[i]);
+                        break;
+                    }
+                }
+            }
+            if(side == 0 || boundary.size() < sep.size()) { sep.swap(boundary); }
+        }
+    }
+
+    // split @param cell in two at the median of the direction that gives
+    // the smallest separator; for cells too small to have quarters
+    void
+    median_cut(std::vector<uint32_t>& cell, std::vector<uint32_t>& left,
+            std::vector<uint32_t>& right, std::vector<uint32_t>& sep)
+    {
+        size_t mid = cell.size() / 2;
+        std::vector<uint32_t> best, boundary;
+        for(uint32_t dir = 0; dir < 4; dir++)
+        {
+            median_boundary(cell, dir, boundary);
+            if(best.empty() || boundary.size() < sep.size())
+            {
+                best = cell;
+                sep.swap(boundary);
+            }
+        }
+
+        uint32_t in_sep = next_stamp_++;
+        for(uint32_t id : sep) { stamp_[id] = in_sep; }
+        left.clear();
+        right.clear();
+        for(size_t i = 0; i < best.size(); i++)
+        {
+            if(stamp_[best[i]] == in_sep) { continue; }
+            (i < mid ? left : right).push_back(best[i]);
+        }
+    }
+
+    void
+    dissect(std::vector<uint32_t>& cell)
+    {
+        if(cell.size() <= 1)
+        {
+            order_->insert(order_->end(), cell.begin(), cell.end());
+            return;
+        }
+
+        std::vector<uint32_t> left, right, sep;
+        if(cell.size() < MIN_FLOW_CELL)
+        {
+            median_cut(cell, left, right, sep);
+        }
+        else
+        {
+            // try the directions from the one with the smallest median
+            // boundary, so that its separator bounds the flow of the rest
+            std::vector<std::pair<size_t, uint32_t>> dirs;
+            for(uint32_t dir = 0; dir < 4; dir++)
+            {
+                median_boundary(cell, dir, sep);
+                dirs.push_back({sep.size(), dir});
+            }
+            std::sort(dirs.begin(), dirs.end());
+
+            // keep the direction with the smallest separator
+            load_cell(cell);
+            std::vector<uint32_t> l, r, s;
+            size_t best = SIZE_MAX;
+            for(const std::pair<size_t, uint32_t>& dir : dirs)
+            {
+                if(!flow_cut(cell, dir.second, best, l, r, s)) { continue; }
+                best = s.size();
+                left.swap(l);
+                right.swap(r);
+                sep.swap(s);
+            }
+        }
+        std::vector<uint32_t>().swap(cell);
+
+        dissect(left);
+        dissect(right);
+        order_->insert(order_->end(), sep.begin(), sep.end());
+    }
+};
+
+}
+
+void
+warthog::ch::nested_dissection_order(warthog::graph::xy_graph* g,
+        std::vector<uint32_t>& order)
+{
+    uint32_t num_nodes = g->get_num_nodes();
+    dissection d;
+    d.next_stamp_ = 1;
+    d.order_ = &order;
+    d.stamp_.resize(num_nodes, 0);
+    d.local_.resize(num_nodes, 0);
+    d.xy_.resize(num_nodes * 2);
+    d.adj_begin_.resize(num_nodes + 1, 0);
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        int32_t x, y;
+        g->get_xy(i, x, y);
+        d.xy_[i*2] = x;
+        d.xy_[i*2+1] = y;
+        for(warthog::graph::edge_iter it = g->outgoing_begin(i);
+                it != g->outgoing_end(i); it++)
+        {
+            if(it->node_id_ == i) { continue; }
+            d.adj_begin_[i+1]++;
+            d.adj_begin_[it->node_id_+1]++;
+        }
+    }
+
+    // every edge in both directions, then duplicates removed
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        d.adj_begin_[i+1] += d.adj_begin_[i];
+    }
+    std::vector<uint32_t> pos(d.adj_begin_.begin(), d.adj_begin_.end() - 1);
+    d.adj_.resize(d.adj_begin_[num_nodes]);
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        for(warthog::graph::edge_iter it = g->outgoing_begin(i);
+                it != g->outgoing_end(i); it++)
+        {
+            if(it->node_id_ == i) { continue; }
+            d.adj_[pos[i]++] = it->node_id_;
+            d.adj_[pos[it->node_id_]++] = i;
+        }
+    }
+    uint32_t num_adj = 0;
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        uint32_t* first = d.adj_.data() + d.adj_begin_[i];
+        uint32_t* last = d.adj_.data() + d.adj_begin_[i+1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        d.adj_begin_[i] = num_adj;
+        for(uint32_t* it = first; it != last; it++) { d.adj_[num_adj++] = *it; }
+    }
+    d.adj_begin_[num_nodes] = num_adj;
+
+    std::vector<uint32_t> cell(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++) { cell[i] = i; }
+    order.clear();
+    order.reserve(num_nodes);
+    d.dissect(cell);
+    assert(order.size() == num_nodes);
+}
+
+warthog::ch::customizable_ch::customizable_ch(
+        warthog::graph::xy_graph* g, const std::vector<uint32_t>& order)
+    : g_(g), chd_(true), order_(order)
+{
+    #ifdef SINGLE_THREADED
+    num_threads_ = 1;
+    #else
+    num_threads_ = std::max<uint32_t>(1, std::thread::hardware_concurrency());
+    #endif
+
+    warthog::timer mytimer;
+    mytimer.start();
+    uint32_t num_nodes = g_->get_num_nodes();
+    assert(order_.size() == num_nodes);
+    rank_.resize(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++) { rank_[order_[i]] = i; }
+
+    // contract in rank order: the higher neighbours of each node become
+    // neighbours of the lowest of them (its parent in the elimination tree)
+    std::vector<std::vector<uint32_t>> up(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        for(warthog::graph::edge_iter it = g_->outgoing_begin(i);
+                it != g_->outgoing_end(i); it++)
+        {
+            uint32_t r1 = rank_[i], r2 = rank_[it->node_id_];
+            if(r1 == r2) { continue; }
+            up[std::min(r1, r2)].push_back(std::max(r1, r2));
+        }
+    }
+
+    std::vector<uint32_t> height(num_nodes, 0);
+    up_begin_.resize(num_nodes + 1);
+    for(uint32_t r = 0; r < num_nodes; r++)
+    {
+        std::vector<uint32_t>& mine = up[r];
+        std::sort(mine.begin(), mine.end());
+        mine.erase(std::unique(mine.begin(), mine.end()), mine.end());
+        up_begin_[r] = (uint32_t)head_.size();
+        head_.insert(head_.end(), mine.begin(), mine.end());
+        if(!mine.empty())
+        {
+            uint32_t parent = mine.front();
+            up[parent].insert(up[parent].end(), mine.begin() + 1, mine.end());
+            height[parent] = std::max(height[parent], height[r] + 1);
+        }
+        std::vector<uint32_t>().swap(mine);
+    }
+    up_begin_[num_nodes] = (uint32_t)head_.size();
+
+    // the arcs into each rank, from the lowest tail up
+    down_begin_.resize(num_nodes + 1, 0);
+    for(uint32_t head : head_) { down_begin_[head+1]++; }
+    for(uint32_t r = 0; r < num_nodes; r++)
+    {
+        down_begin_[r+1] += down_begin_[r];
+    }
+    std::vector<uint32_t> pos(down_begin_.begin(), down_begin_.end() - 1);
+    down_arc_.resize(head_.size());
+    down_tail_.resize(head_.size());
+    for(uint32_t r = 0; r < num_nodes; r++)
+    {
+        for(uint32_t a = up_begin_[r]; a < up_begin_[r+1]; a++)
+        {
+            uint32_t k = pos[head_[a]]++;
+            down_arc_[k] = a;
+            down_tail_[k] = r;
+        }
+    }
+
+    uint32_t max_height = 0;
+    for(uint32_t h : height) { max_height = std::max(max_height, h); }
+    height_begin_.resize(max_height + 2, 0);
+    for(uint32_t h : height) { height_begin_[h+1]++; }
+    for(uint32_t h = 0; h <= max_height; h++)
+    {
+        height_begin_[h+1] += height_begin_[h];
+    }
+    pos.assign(height_begin_.begin(), height_begin_.end() - 1);
+    by_height_.resize(num_nodes);
+    for(uint32_t r = 0; r < num_nodes; r++) { by_height_[pos[height[r]]++] = r; }
+
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        for(warthog::graph::edge_iter it = g_->outgoing_begin(i);
+                it != g_->outgoing_end(i); it++)
+        {
+            uint32_t r1 = rank_[i], r2 = rank_[it->node_id_];
+            if(r1 == r2) { input_arc_.push_back(warthog::INF32); }
+            else if(r1 < r2) { input_arc_.push_back(find_arc(r1, r2) * 2); }
+            else { input_arc_.push_back(find_arc(r2, r1) * 2 + 1); }
+        }
+    }
+
+    // every arc is stored once, in the same order as head_, and keeps its
+    // place; customising only rewrites the weights
+    chd_.type_ = warthog::ch::UP_ONLY;
+    chd_.g_->set_filename(g_->get_filename());
+    chd_.g_->grow(num_nodes);
+    chd_.level_->resize(num_nodes);
+    chd_.up_degree_->resize(num_nodes, 0);
+    for(uint32_t r = 0; r < num_nodes; r++)
+    {
+        uint32_t id = order_[r];
+        int32_t x, y;
+        g_->get_xy(id, x, y);
+        chd_.g_->set_xy(id, x, y);
+        chd_.level_->at(id) = r;
+
+        uint32_t degree = up_begin_[r+1] - up_begin_[r];
+        if(degree > warthog::graph::ECAP_MAX)
+        {
+            std::cerr << "err; node " << id << " has " << degree
+                << " arcs in the cch. too many. oh well. keep going.\n";
+            degree = warthog::graph::ECAP_MAX;
+        }
+        warthog::graph::node* n = chd_.g_->get_node(id);
+        n->capacity((warthog::graph::ECAP_T)degree,
+                (warthog::graph::ECAP_T)degree);
+        for(uint32_t a = up_begin_[r]; a < up_begin_[r] + degree; a++)
+        {
+            warthog::graph::edge e(order_[head_[a]], warthog::INF32);
+            n->add_outgoing(e);
+            n->add_incoming(e);
+        }
+        chd_.up_degree_->at(id) = degree;
+    }
+
+    mytimer.stop();
+    std::cerr << "cch built; nodes " << num_nodes << " arcs " << head_.size()
+        << " elimination tree height " << max_height + 1
+        << " time " << mytimer.elapsed_time_sec() << " (s)" << std::endl;
+
+    customize();
+}
+
+uint32_t
+warthog::ch::customizable_ch::find_arc(uint32_t tail, uint32_t head)
+{
+    const uint32_t* first = head_.data() + up_begin_[tail];
+    const uint32_t* last = head_.data() + up_begin_[tail+1];
+    const uint32_t* it = std::lower_bound(first, last, head);
+    assert(it != last && *it == head);
+    return (uint32_t)(it - head_.data());
+}
+
+void
+warthog::ch::customizable_ch::customize()
+{
+    warthog::timer mytimer;
+    mytimer.start();
+
+    fwd_.assign(head_.size(), warthog::INF32);
+    bwd_.assign(head_.size(), warthog::INF32);
+    uint32_t e = 0;
+    for(uint32_t i = 0; i < g_->get_num_nodes(); i++)
+    {
+        for(warthog::graph::edge_iter it = g_->outgoing_begin(i);
+                it != g_->outgoing_end(i); it++)
+        {
+            assert(e < input_arc_.size());
+            uint32_t a = input_arc_[e++];
+            if(a == warthog::INF32) { continue; }
+            warthog::graph::edge_cost_t& wt = (a & 1) ? bwd_[a>>1] : fwd_[a>>1];
+            wt = std::min(wt, it->wt_);
+        }
+    }
+    assert(e == input_arc_.size());
+
+    // each thread customises, or writes the weights of, a block of
+    // consecutive nodes of the current level
+    struct shared_data
+    {
+        warthog::ch::customizable_ch* cch_;
+        const uint32_t* level_;
+        uint32_t size_;
+        std::vector<std::vector<uint32_t>>* slots_;
+    };
+
+    void*(*customize_fn)(void*) = [] (void* args_in) -> void*
+    {
+        warthog::helpers::thread_params* par =
+            (warthog::helpers::thread_params*) args_in;
+        shared_data* shared = (shared_data*) par->shared_;
+        warthog::ch::customizable_ch* cch = shared->cch_;
+
+        std::vector<uint32_t>& slot = shared->slots_->at(par->thread_id_);
+        if(slot.empty()) { slot.resize(cch->g_->get_num_nodes()); }
+        uint64_t size = shared->size_;
+        uint32_t first = (uint32_t)(size * par->thread_id_ / par->max_threads_);
+        uint32_t last = 
+            (uint32_t)(size * (par->thread_id_+1) / par->max_threads_);
+        for(uint32_t i = first; i < last; i++)
+        {
+            cch->customize_node(shared->level_[i], slot);
+            par->nprocessed_++;
+        }
+        return 0;
+    };
+
+    void*(*weights_fn)(void*) = [] (void* args_in) -> void*
+    {
+        warthog::helpers::thread_params* par =
+            (warthog::helpers::thread_params*) args_in;
+        shared_data* shared = (shared_data*) par->shared_;
+
+        uint64_t size = shared->size_;
+        uint32_t first = (uint32_t)(size * par->thread_id_ / par->max_threads_);
+        uint32_t last = 
+            (uint32_t)(size * (par->thread_id_+1) / par->max_threads_);
+        for(uint32_t r = first; r < last; r++)
+        {
+            shared->cch_->write_weights(r);
+            par->nprocessed_++;
+        }
+        return 0;
+    };
+
+    std::vector<std::vector<uint32_t>> slots(num_threads_);
+    shared_data shared;
+    shared.cch_ = this;
+    shared.slots_ = &slots;
+    for(uint32_t h = 0; h + 1 < height_begin_.size(); h++)
+    {
+        shared.level_ = by_height_.data() + height_begin_[h];
+        shared.size_ = height_begin_[h+1] - height_begin_[h];
+
+        // small levels (the top of the elimination tree) are not worth a
+        // thread
+        if(num_threads_ == 1 || shared.size_ <= 256)
+        {
+            if(slots[0].empty()) { slots[0].resize(g_->get_num_nodes()); }
+            for(uint32_t i = 0; i < shared.size_; i++)
+            {
+                customize_node(shared.level_[i], slots[0]);
+            }
+            continue;
+        }
+        warthog::helpers::parallel_compute(customize_fn, &shared,
+                shared.size_, num_threads_, false);
+    }
+
+    shared.size_ = g_->get_num_nodes();
+    warthog::helpers::parallel_compute(weights_fn, &shared,
+            shared.size_, num_threads_, false);
+
+    mytimer.stop();
+    std::cerr << "cch customised; arcs " << head_.size()
+        << " time " << mytimer.elapsed_time_sec() << " (s)" << std::endl;
+}
+
+void
+warthog::ch::customizable_ch::customize_node(
+        uint32_t u, std::vector<uint32_t>& slot)
+{
+    for(uint32_t a = up_begin_[u]; a < up_begin_[u+1]; a++)
+    {
+        slot[head_[a]] = a;
+    }
+
+    // each lower triangle (v, u, w) offers the paths u, v, w and w, v, u.
+    // the higher neighbours of v above u are all neighbours of u
+    for(uint32_t k = down_begin_[u]; k < down_begin_[u+1]; k++)
+    {
+        uint32_t vu = down_arc_[k];
+        warthog::graph::edge_cost_t v_to_u = fwd_[vu];
+        warthog::graph::edge_cost_t u_to_v = bwd_[vu];
+        for(uint32_t vw = vu + 1; vw < up_begin_[down_tail_[k]+1]; vw++)
+        {
+            uint32_t uw = slot[head_[vw]];
+            assert(uw >= up_begin_[u] && uw < up_begin_[u+1] &&
+                   head_[uw] == head_[vw]);
+            fwd_[uw] = std::min(fwd_[uw], u_to_v + fwd_[vw]);
+            bwd_[uw] = std::min(bwd_[uw], bwd_[vw] + v_to_u);
+        }
+    }
+}
+
+void
+warthog::ch::customizable_ch::write_weights(uint32_t u)
+{
+    warthog::graph::node* n = chd_.g_->get_node(order_[u]);
+    warthog::graph::edge_iter out = n->outgoing_begin();
+    warthog::graph::edge_iter in = n->incoming_begin();
+    for(uint32_t i = 0; i < n->out_degree(); i++)
+    {
+        out[i].wt_ = fwd_[up_begin_[u] + i];
+        in[i].wt_ = bwd_[up_begin_[u] + i];
+    }
+}
+
+size_t
+warthog::ch::customizable_ch::mem()
+{
+    return
+        chd_.mem() +
+        sizeof(uint32_t) * (order_.size() + rank_.size() +
+            up_begin_.size() + head_.size() + down_begin_.size() +
+            down_arc_.size() + down_tail_.size() + height_begin_.size() +
+            by_height_.size() + input_arc_.size()) +
+        sizeof(warthog::graph::edge_cost_t) * (fwd_.size() + bwd_.size()) +
+        sizeof(*this);
+}
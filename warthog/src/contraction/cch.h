@@ -0,0 +1,136 @@
+#ifndef WARTHOG_CH_CCH_H
+#define WARTHOG_CH_CCH_H
+
+// contraction/cch.h
+//
+// A customizable contraction hierarchy (CCH) splits the preprocessing of a
+// contraction hierarchy in two. The first phase depends only on the
+// structure of the graph: it contracts the nodes in a nested dissection
+// order and adds every shortcut the order implies, without witness
+// searches. The second phase, the customisation, computes the weight of
+// every arc for the current edge weights of the graph. It is run again
+// whenever the weights change (e.g. after xy_graph::perturb), which is
+// much faster than contracting the graph again.
+//
+// Customisation visits the lower triangles of each arc (u, w): every node
+// v below both u and w that is adjacent to both gives the path u, v, w.
+// The arcs of u only depend on arcs of nodes below u in the elimination
+// tree, so the nodes of each level of the tree are customised in
+// parallel.
+//
+// The customised hierarchy is an UP_ONLY ch_data that keeps the node ids
+// of the input graph; bch_search answers exact queries for the new
+// weights as soon as ::customize returns. Arcs with no path in their
+// direction weigh warthog::INF32, which bch_search never expands.
+//
+// For more details see:
+// [Dibbelt, Strasser and Wagner. Customizable Contraction Hierarchies.
+// ACM Journal of Experimental Algorithmics 21(1), 2016]
+//
+
+#include "ch_data.h"
+#include "xy_graph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace warthog
+{
+
+namespace ch
+{
+
+// a contraction order for @param g that does not depend on its edge
+// weights. each cell of nodes is split by a minimum vertex separator
+// between its first and last quarter along one of four directions,
+// whichever gives the smallest separator (cf. Inertial Flow); small cells
+// are split at a median instead. the two halves are ordered recursively
+// and the separator is contracted last.
+// order[i] is the i-th node to be contracted
+void
+nested_dissection_order(warthog::graph::xy_graph* g,
+        std::vector<uint32_t>& order);
+
+class customizable_ch
+{
+    public:
+        // build the hierarchy of @param g for the contraction order
+        // @param order (cf. ::nested_dissection_order). @param g is read
+        // by every call to ::customize and must outlive this object
+        customizable_ch(warthog::graph::xy_graph* g,
+                const std::vector<uint32_t>& order);
+
+        ~customizable_ch() { }
+
+        // compute the weight of every arc of the hierarchy from the
+        // current edge weights of the input graph. the edges of the
+        // input graph must be those it had at construction
+        void
+        customize();
+
+        // the hierarchy, as of the last call to ::customize
+        warthog::ch::ch_data*
+        get_ch_data() { return &chd_; }
+
+        uint32_t
+        get_num_arcs() { return (uint32_t)head_.size(); }
+
+        void
+        set_num_threads(uint32_t num_threads)
+        { num_threads_ = std::max<uint32_t>(num_threads, 1); }
+
+        uint32_t
+        get_num_threads() { return num_threads_; }
+
+        size_t
+        mem();
+
+    private:
+        warthog::graph::xy_graph* g_;
+        warthog::ch::ch_data chd_;
+        uint32_t num_threads_;
+
+        // the hierarchy is stored by rank (== position in the order)
+        std::vector<uint32_t> order_;
+        std::vector<uint32_t> rank_;
+
+        // the arcs of each rank to higher ranks, sorted by head, and their
+        // weights: fwd_ going up, bwd_ coming down
+        std::vector<uint32_t> up_begin_;
+        std::vector<uint32_t> head_;
+        std::vector<warthog::graph::edge_cost_t> fwd_;
+        std::vector<warthog::graph::edge_cost_t> bwd_;
+
+        // the arcs of each rank from lower ranks
+        std::vector<uint32_t> down_begin_;
+        std::vector<uint32_t> down_arc_;
+        std::vector<uint32_t> down_tail_;
+
+        // the ranks, grouped by their height in the elimination tree
+        std::vector<uint32_t> height_begin_;
+        std::vector<uint32_t> by_height_;
+
+        // the arc of each outgoing edge of g_, in order, times two; plus
+        // one when the edge goes down. INF32 for loops
+        std::vector<uint32_t> input_arc_;
+
+        // the arc from rank @param tail to the higher rank @param head
+        uint32_t
+        find_arc(uint32_t tail, uint32_t head);
+
+        // customise the arcs of rank @param u, using @param slot as a
+        // scratch map from heads to arcs
+        void
+        customize_node(uint32_t u, std::vector<uint32_t>& slot);
+
+        // copy the weights of the arcs of rank @param u into chd_
+        void
+        write_weights(uint32_t u);
+};
+
+}
+
+}
+
+#endif
@@ -388,3 +388,23 @@ warthog::ch::sort_successors(warthog::ch::ch_data* chd)
         #endif
     }
 }
+
+void
+warthog::ch::reorder(warthog::ch::ch_data* chd,
+        const std::vector<uint32_t>& order)
+{
+    chd->g_->reorder(order);
+
+    // some hierarchies are loaded without the up degrees
+    std::vector<uint32_t>* per_node[2] = { chd->level_, chd->up_degree_ };
+    for(std::vector<uint32_t>* values : per_node)
+    {
+        if(values->size() != order.size()) { continue; }
+        std::vector<uint32_t> permuted(order.size());
+        for(uint32_t i = 0; i < order.size(); i++)
+        {
+            permuted[i] = values->at(order[i]);
+        }
+        values->swap(permuted);
+    }
+}
@@ -118,6 +118,12 @@ unpack(uint32_t from_id,
 void
 sort_successors(warthog::ch::ch_data* chd);
 
+// renumber the nodes of a contraction hierarchy: node @param order[i] 
+// gets the id i (cf. xy_graph::reorder). the level and the up degree of 
+// each node move with it
+void
+reorder(warthog::ch::ch_data* chd, const std::vector<uint32_t>& order);
+
 // stall-on-demand as preprocessing
 // performs a k-hop search (k is a tunable parameter) from every source node 
 // in the graph and prunes any outgoing down edges of the source if they
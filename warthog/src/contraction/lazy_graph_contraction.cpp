@@ -8,25 +8,29 @@
 #include "zero_heuristic.h"
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <utility>
 
-struct shortcut_t
-{
-    uint32_t from_;
-    uint32_t to_;
-    uint32_t mid_;
-    warthog::graph::edge_cost_t cost_;
-};
+using warthog::ch::shortcut_t;
 std::vector<shortcut_t> shortcuts;
 
 bool very_verbose = false;
 bool debug=false;
 
 warthog::ch::lazy_graph_contraction::lazy_graph_contraction()
-    : verbose_(false) 
+    : verbose_(false), num_threads_(0)
 { }
 
+warthog::ch::lazy_graph_contraction::witness_state::witness_state(
+        warthog::graph::xy_graph* g)
+    : fexpander_(g, false, &c_filter_), bexpander_(g, true, &c_filter_),
+      alg_(&fexpander_, &bexpander_, &heuristic_), expansions_(0),
+      searches_(0)
+{ 
+    c_filter_.clear();
+}
+
 bool
 warthog::ch::operator<(const ch_pair& first, const ch_pair& second)
 {
@@ -44,6 +48,7 @@ warthog::ch::lazy_graph_contraction::contract(
     std::ifstream ifs(ret->g_->get_filename());
     ret->type_ = warthog::ch::ch_type::UP_DOWN;
 
+    shortcuts.clear();
     preliminaries(ret);
     if(c_pct < 100)
     { std::cerr << "partial contraction " << "(first "<<c_pct<<"% of nodes only)\n"; }
@@ -53,14 +58,17 @@ warthog::ch::lazy_graph_contraction::contract(
     //uint32_t total_nodes = (uint32_t)((ret->g_->get_num_nodes()*c_pct) / 100);
     double t_last = mytimer.get_time_micro();
 
+    if(num_threads_ > 0) { contract_in_rounds(c_pct); }
+
     //verbose_ = true;
     //very_verbose = true;
-    while(true)
+    while(num_threads_ == 0)
     {
         // contract the highest priority node  +
         // record some search effort metrics
-        uint64_t num_expansions = total_expansions_;
-        uint64_t num_searches = total_searches_;
+        witness_state& ws = *workers_.at(0);
+        uint64_t num_expansions = ws.expansions_;
+        uint64_t num_searches = ws.searches_;
         uint64_t num_lazy = total_lazy_updates_;
         mytimer.start();
 
@@ -68,18 +76,18 @@ warthog::ch::lazy_graph_contraction::contract(
         if(best_id == warthog::INF32) { break; }
 
 
-        uint32_t search_count = total_searches_;
+        uint32_t search_count = ws.searches_;
 
         if(this->verbose_)
         {
             std::cerr 
                 << "contracting " << best_id << " pri: " 
                 << hn_pool_[best_id].get_element().cval_ 
-                //<< " #searches: " << (total_searches_ - search_count)
+                //<< " #searches: " << (ws.searches_ - search_count)
                 << std::endl;
         }
 
-        contract_node(best_id, false);
+        contract_node(ws, best_id, false);
         disconnect_node(best_id);
 
         warthog::graph::node* bestnode = g_->get_node(best_id);
@@ -98,10 +106,10 @@ warthog::ch::lazy_graph_contraction::contract(
             u_filter_->remove(neighbour_id);
 
             // re-compute importance metrics
-            search_count = total_searches_;
-            uint32_t expd = total_expansions_;
+            search_count = ws.searches_;
+            uint32_t expd = ws.expansions_;
             height_[neighbour_id] = std::max(height_[neighbour_id], height_[best_id]+1);
-            int32_t cval = contract_node(neighbour_id, true);
+            int32_t cval = contract_node(ws, neighbour_id, true);
 
             total_lazy_updates_++;
 
@@ -111,8 +119,8 @@ warthog::ch::lazy_graph_contraction::contract(
                 std::cerr <<  "updating " << neighbour_id << " old_cval " 
                           << hn_pool_[neighbour_id].get_element().cval_ 
                           << " new_cval " << cval 
-                          << " expd " << (total_expansions_ - expd)
-                          //<< " #searches: " << (total_searches_ - search_count)
+                          << " expd " << (ws.expansions_ - expd)
+                          //<< " #searches: " << (ws.searches_ - search_count)
                           << std::endl;
             }
 
@@ -130,8 +138,8 @@ warthog::ch::lazy_graph_contraction::contract(
 
         mytimer.stop();
 
-        num_expansions = total_expansions_ - num_expansions;
-        num_searches = total_searches_ - num_searches;
+        num_expansions = ws.expansions_ - num_expansions;
+        num_searches = ws.searches_ - num_searches;
         num_lazy = total_lazy_updates_ - num_lazy;
 
         if((mytimer.get_time_micro() - t_last) > 1000000)
@@ -173,20 +181,20 @@ warthog::ch::lazy_graph_contraction::contract(
     // (the highest-level successor appears first)
     warthog::ch::sort_successors(ret);
 
-    // cleanup
-    postliminaries();
-
     std::cerr
         << "\ngraph, contracted. " << std::endl
         << "time "
         << ((double)(mytimer.get_time_micro() - t_begin)) / 1e6 << " (s)"
         << "; edges before " << edges_before 
         << "; edges after " << ret->g_->get_num_edges_out() << std::endl
-        << "total searches " << total_searches_ 
-        << "; total expansions (x 1e6) " << ((double)total_expansions_)/1e6 
+        << "total searches " << total_searches()
+        << "; total expansions (x 1e6) " << ((double)total_expansions())/1e6 
         << std::endl
         << "lazy updates "<< total_lazy_updates_
         << std::endl;
+
+    // cleanup
+    postliminaries();
     return true;
 }
 
@@ -198,20 +206,16 @@ warthog::ch::lazy_graph_contraction::preliminaries(warthog::ch::ch_data* chd)
     order_ = chd->level_;
     size_t sz_g = g_->get_num_nodes();
 
-    // init algorithm for witness searches
-    heuristic_ = new warthog::zero_heuristic();
-    c_filter_ = new warthog::ch::bypass_filter();
+    // init algorithm for witness searches; one per thread
     u_filter_ = new warthog::apriori_filter(g_->get_num_nodes());
-
-    fexpander_ = new warthog::bidirectional_expander<warthog::ch::bypass_filter>(
-                g_, false, c_filter_);
-    bexpander_ = new warthog::bidirectional_expander<warthog::ch::bypass_filter>(
-                g_, true, c_filter_);
-    alg_ = new bidirectional_search< 
-                 warthog::zero_heuristic,
-                 warthog::bidirectional_expander<warthog::ch::bypass_filter>>
-                     (fexpander_, bexpander_, heuristic_);
-    ws_max_expansions_ = warthog::INF32;
+    u_filter_->reset_filter();
+    for(uint32_t i = 0; i < std::max<uint32_t>(num_threads_, 1); i++)
+    {
+        workers_.push_back(std::unique_ptr<witness_state>(
+                    new witness_state(g_)));
+    }
+    // expansion limit per witness search (as recommended by RoutingKit)
+    ws_max_expansions_ = 500; 
 
     // init queue used to track contraction priorities
     heap_ = new warthog::heap<ch_pair>((uint32_t)sz_g, true);
@@ -251,34 +255,40 @@ warthog::ch::lazy_graph_contraction::preliminaries(warthog::ch::ch_data* chd)
     // create an initial ordering by performing on each node
     // a faux contraction operation
     std::cerr << "creating initial contraction order\n";
-    total_searches_ = 0;
-    total_expansions_ = 0;
     total_lazy_updates_ = 0;
 
-    double pct_counter=0;
-    for(uint32_t i = 0;
-        i < g_->get_num_nodes(); i++)
-    {
-        uint32_t exps = total_expansions_;
-        int32_t priority = contract_node(i, true);
-        hn_pool_[i] = heap_node<ch_pair>(ch_pair(i, priority));
-        heap_->push(&hn_pool_[i]);
-
-        if(this->verbose_)
-        //if(true)
+    // priorities are computed in parallel, but the heap is filled in order
+    std::vector<int32_t> priority(g_->get_num_nodes());
+    std::atomic<uint32_t> nprocessed(0);
+    std::atomic<uint32_t> pct_counter(0);
+    parallel_for(g_->get_num_nodes(), 
+        [this, &priority, &nprocessed, &pct_counter]
+        (witness_state& ws, size_t i)
         {
-            std::cerr << "node " << i << " initial_priority " << priority 
-                      << " queue_pos " << hn_pool_[i].get_index() 
-                      << " exps " << (total_expansions_ - exps) 
-                      << std::endl;
+            uint64_t exps = ws.expansions_;
+            priority[i] = contract_node(ws, (uint32_t)i, true);
 
-        }
-        else 
-        if( (i / (double)g_->get_num_nodes()) >= pct_counter)
-        {
-            std::cerr << pct_counter*100 << "%...";
-            pct_counter+=0.1;
-        }
+            if(this->verbose_ && workers_.size() == 1)
+            {
+                std::cerr << "node " << i << " initial_priority " 
+                          << priority[i]
+                          << " exps " << (ws.expansions_ - exps) 
+                          << std::endl;
+            }
+            else if(!this->verbose_ && (++nprocessed * 10) / 
+                    g_->get_num_nodes() > pct_counter) 
+            {
+                // only one thread gets to print each step
+                uint32_t pct = pct_counter;
+                if(pct_counter.compare_exchange_strong(pct, pct + 1))
+                { std::cerr << pct*10 << "%..."; }
+            }
+        });
+
+    for(uint32_t i = 0; i < g_->get_num_nodes(); i++)
+    {
+        hn_pool_[i] = heap_node<ch_pair>(ch_pair(i, priority[i]));
+        heap_->push(&hn_pool_[i]);
     }
     std::cerr << "done" << std::endl;
 }
@@ -294,23 +304,10 @@ warthog::ch::lazy_graph_contraction::postliminaries()
     delete heap_;
     heap_ = 0;
 
-    delete alg_;
-    alg_ = 0;
-
-    delete c_filter_;
-    c_filter_ = 0;
+    workers_.clear();
 
     delete u_filter_;
     u_filter_ = 0;
-    
-    delete heuristic_;
-    heuristic_ = 0;
-
-    delete fexpander_;
-    fexpander_ = 0;
-
-    delete bexpander_;
-    bexpander_ = 0;
 
 }
 
@@ -348,12 +345,12 @@ warthog::ch::lazy_graph_contraction::next(
 // NB: assumes the via-node is already marked as contracted
 // (and will thus not be expanded)
 warthog::cost_t
-warthog::ch::lazy_graph_contraction::witness_search(
+warthog::ch::lazy_graph_contraction::witness_search(witness_state& ws,
         uint32_t from_id, uint32_t to_id, warthog::cost_t via_len, bool resume)
 {
-    alg_->set_cost_cutoff(via_len);
-    alg_->set_max_expansions_cutoff(ws_max_expansions_);
-    alg_->set_time_cutoff(1);
+    ws.alg_.set_cost_cutoff(via_len);
+    ws.alg_.set_max_expansions_cutoff(ws_max_expansions_);
+    ws.alg_.set_time_cutoff(1);
     warthog::graph::xy_graph* g = this->g_;
 
     // need to specify start + target ids using the identifier
@@ -362,8 +359,8 @@ warthog::ch::lazy_graph_contraction::witness_search(
             g->to_external_id(from_id),
             g->to_external_id(to_id));
 
-    sol_.reset();
-    sol_.path_.clear();
+    ws.sol_.reset();
+    ws.sol_.path_.clear();
 
     if(very_verbose)
     {
@@ -372,11 +369,11 @@ warthog::ch::lazy_graph_contraction::witness_search(
     pi.verbose_ = very_verbose;
 
     // gogogo
-    alg_->__get_pathcost(pi, sol_, resume);
-    total_expansions_ += sol_.nodes_expanded_;
-    total_searches_++;
+    ws.alg_.__get_pathcost(pi, ws.sol_, resume);
+    ws.expansions_ += ws.sol_.nodes_expanded_;
+    ws.searches_++;
 
-    return sol_.sum_of_edge_costs_;
+    return ws.sol_.sum_of_edge_costs_;
 }
 
 // contract a node or compute its contraction priority 
@@ -385,12 +382,10 @@ warthog::ch::lazy_graph_contraction::witness_search(
 //
 // @return the contraction priority (always computed)
 int32_t
-warthog::ch::lazy_graph_contraction::contract_node( 
-        uint32_t node_id, bool metrics_only)
+warthog::ch::lazy_graph_contraction::contract_node(witness_state& ws,
+        uint32_t node_id, bool metrics_only, std::vector<shortcut_t>* pending)
 {
-    // expansion limit per witness search (as recommended by RoutingKit)
-    ws_max_expansions_ = 500; 
-    c_filter_->add(node_id);
+    ws.c_filter_.add(node_id);
 
     // the set of in/out neighbours pairs that we consider as fixed
     // (contracting adds new edges, and we don't iterate over these)
@@ -420,9 +415,9 @@ warthog::ch::lazy_graph_contraction::contract_node(
             // node is common for all outgoing nodes
             warthog::cost_t via_len = e_in.wt_ + e_out.wt_;
             warthog::cost_t cost_cutoff = e_in.wt_ + e_out.wt_;
-            uint32_t expd = total_expansions_;
-            warthog::cost_t witness_len = 
-                witness_search(e_in.node_id_, e_out.node_id_, cost_cutoff, resume);
+            uint32_t expd = ws.expansions_;
+            warthog::cost_t witness_len = witness_search(
+                    ws, e_in.node_id_, e_out.node_id_, cost_cutoff, resume);
             resume = true;
             
             if(witness_len > via_len)
@@ -432,7 +427,13 @@ warthog::ch::lazy_graph_contraction::contract_node(
                 edges_added += 1;
                 hops_added += shortcut_hops;
 
-                if(!metrics_only)
+                if(!metrics_only && pending)
+                {
+                    pending->push_back({e_in.node_id_, e_out.node_id_, 
+                            node_id, (warthog::graph::edge_cost_t)via_len,
+                            shortcut_hops});
+                }
+                else if(!metrics_only)
                 {
                     if(this->verbose_)
                     {
@@ -443,7 +444,7 @@ warthog::ch::lazy_graph_contraction::contract_node(
                             //<< " mid " << node_id 
                             << " wt " << via_len 
                             << " hops " << (e_in.label_ + e_out.label_)
-                            << " expd " << (total_expansions_ - expd)
+                            << " expd " << (ws.expansions_ - expd)
                             << std::endl;
                     }
 
@@ -465,14 +466,18 @@ warthog::ch::lazy_graph_contraction::contract_node(
                             shortcut_hops));
 
                     // also store the shortcuts separately for later
-                    shortcuts.push_back({e_in.node_id_, e_out.node_id_, node_id, via_len});
+                    shortcuts.push_back({e_in.node_id_, e_out.node_id_, 
+                            node_id, (warthog::graph::edge_cost_t)via_len,
+                            shortcut_hops});
                 }
             }
         }
     }
 
-    if(metrics_only) 
-    { c_filter_->clear(); }
+    // the node stays filtered only while it is contracted for good; the
+    // next search of this worker must not depend on what it did before
+    if(metrics_only || pending) 
+    { ws.c_filter_.clear(); }
     else
     { order_->push_back(node_id); }
 
@@ -484,7 +489,7 @@ warthog::ch::lazy_graph_contraction::contract_node(
         hops_deleted += e_in.label_;
 
         // after contraction, need to know which neighbours to update
-        if(!metrics_only)
+        if(!metrics_only && !pending)
         { u_filter_->add(e_in.node_id_); }
     }
     for(uint32_t j = 0; j < out_deg; j++)
@@ -494,7 +499,7 @@ warthog::ch::lazy_graph_contraction::contract_node(
         hops_deleted += e_out.label_;
 
         // after contraction, need to know which neighbours to update
-        if(!metrics_only)
+        if(!metrics_only && !pending)
         { u_filter_->add(e_out.node_id_); }
     }
 
@@ -511,11 +516,12 @@ warthog::ch::lazy_graph_contraction::contract_node(
 size_t
 warthog::ch::lazy_graph_contraction::mem()
 {
-    return
+    size_t retval = 
         heap_->mem() +
-        alg_->mem() +
         sizeof(*hn_pool_)*g_->get_num_nodes() +
         sizeof(this);
+    for(auto& ws : workers_) { retval += ws->alg_.mem(); }
+    return retval;
 }
 
 void
@@ -546,3 +552,242 @@ warthog::ch::lazy_graph_contraction::disconnect_node(uint32_t node_id)
     }
 }
 
+
+uint64_t
+warthog::ch::lazy_graph_contraction::total_expansions()
+{
+    uint64_t retval = 0;
+    for(auto& ws : workers_) { retval += ws->expansions_; }
+    return retval;
+}
+
+uint64_t
+warthog::ch::lazy_graph_contraction::total_searches()
+{
+    uint64_t retval = 0;
+    for(auto& ws : workers_) { retval += ws->searches_; }
+    return retval;
+}
+
+void
+warthog::ch::lazy_graph_contraction::parallel_for(size_t n,
+        std::function<void(witness_state& ws, size_t i)> fn)
+{
+    if(workers_.size() == 1 || n < 2)
+    {
+        for(size_t i = 0; i < n; i++) { fn(*workers_.at(0), i); }
+        return;
+    }
+
+    // hand out small chunks of indexes; the work per index varies a lot
+    struct shared_data
+    {
+        std::function<void(witness_state& ws, size_t i)>* fn_;
+        std::vector<std::unique_ptr<witness_state>>* workers_;
+        std::atomic<size_t> next_;
+        size_t n_;
+    };
+
+    void*(*thread_fn)(void*) = [] (void* args_in) -> void*
+    {
+        const size_t CHUNK = 16;
+        warthog::helpers::thread_params* par =
+            (warthog::helpers::thread_params*) args_in;
+        shared_data* shared = (shared_data*) par->shared_;
+        witness_state& ws = *shared->workers_->at(par->thread_id_);
+        while(true)
+        {
+            size_t first = shared->next_.fetch_add(CHUNK);
+            if(first >= shared->n_) { break; }
+            size_t last = std::min(first + CHUNK, shared->n_);
+            for(size_t i = first; i < last; i++) { (*shared->fn_)(ws, i); }
+            par->nprocessed_ += (uint32_t)(last - first);
+        }
+        return 0;
+    };
+
+    shared_data shared;
+    shared.fn_ = &fn;
+    shared.workers_ = &workers_;
+    shared.next_ = 0;
+    shared.n_ = n;
+    warthog::helpers::parallel_compute(thread_fn, &shared, (uint32_t)n,
+            (uint32_t)workers_.size(), false);
+}
+
+bool
+warthog::ch::lazy_graph_contraction::is_local_minimum(uint32_t node_id)
+{
+    // contracted nodes are disconnected from the graph; every neighbour
+    // is still waiting for contraction
+    const ch_pair& me = hn_pool_[node_id].get_element();
+    auto lower = [this, &me](uint32_t other_id)
+    {
+        const ch_pair& other = hn_pool_[other_id].get_element();
+        return other.cval_ < me.cval_ || 
+            (other.cval_ == me.cval_ && other_id < me.node_id_);
+    };
+
+    warthog::graph::node* n = g_->get_node(node_id);
+    for(uint32_t i = 0; i < n->in_degree() + n->out_degree(); i++)
+    {
+        uint32_t nei_id = i < n->in_degree() 
+            ? (n->incoming_begin() + i)->node_id_
+            : (n->outgoing_begin() + (i - n->in_degree()))->node_id_;
+        if(lower(nei_id)) { return false; }
+
+        warthog::graph::node* nei = g_->get_node(nei_id);
+        for(uint32_t j = 0; j < nei->in_degree() + nei->out_degree(); j++)
+        {
+            uint32_t nei2_id = j < nei->in_degree() 
+                ? (nei->incoming_begin() + j)->node_id_
+                : (nei->outgoing_begin() + (j - nei->in_degree()))->node_id_;
+            if(nei2_id != node_id && lower(nei2_id)) { return false; }
+        }
+    }
+    return true;
+}
+
+// Nodes selected in the same round are at least three hops apart, so no two
+// of them share a neighbour and their shortcuts never touch one another.
+// The witness searches of a round run on the graph as it was at the start
+// of the round. A witness for one selected node may thus pass through
+// another; it remains valid because, with positive edge weights, the
+// second node cannot in turn rely on a witness through the first. Each
+// contraction only sees the graph without its own shortcuts, which can
+// produce a few more shortcuts than contracting the same nodes one by one.
+void
+warthog::ch::lazy_graph_contraction::contract_in_rounds(uint32_t c_pct)
+{
+    warthog::timer mytimer;
+    double t_begin = mytimer.get_time_micro();
+    double t_last = t_begin;
+    uint32_t num_nodes = g_->get_num_nodes();
+    uint32_t rounds = 0;
+
+    std::cerr << "contracting in rounds with " << workers_.size() 
+              << " threads\n";
+
+    std::vector<uint32_t> remaining(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++) { remaining[i] = i; }
+
+    std::vector<char> selected;
+    std::vector<uint32_t> batch;
+    std::vector<std::vector<shortcut_t>> pending;
+    std::vector<uint32_t> update;
+    std::vector<int32_t> cval;
+
+    while(remaining.size() > 0)
+    {
+        // early abort; partial contraction limit reached
+        uint32_t pct = (uint32_t)(
+                (order_->size() / (warthog::cost_t)num_nodes) * 100);
+        if(pct >= c_pct)
+        {
+            std::cerr << "\npartial contraction finished "
+                      << "(processed "<< pct << "% of all nodes)";
+            break;
+        }
+
+        // pick an independent set of local minima. the node with the lowest
+        // priority always qualifies, so every round makes progress
+        selected.assign(remaining.size(), 0);
+        parallel_for(remaining.size(), 
+            [this, &selected, &remaining](witness_state& ws, size_t i)
+            { selected[i] = is_local_minimum(remaining[i]); });
+
+        batch.clear();
+        size_t kept = 0;
+        for(size_t i = 0; i < remaining.size(); i++)
+        {
+            if(selected[i]) { batch.push_back(remaining[i]); }
+            else { remaining[kept++] = remaining[i]; }
+        }
+        remaining.resize(kept);
+
+        // within a round nodes are ordered by priority then id
+        std::sort(batch.begin(), batch.end(), 
+            [this](uint32_t first, uint32_t second)
+            { 
+                int32_t c1 = hn_pool_[first].get_element().cval_;
+                int32_t c2 = hn_pool_[second].get_element().cval_;
+                return c1 < c2 || (c1 == c2 && first < second);
+            });
+
+        // find the shortcuts of each selected node; the graph is read-only
+        pending.resize(batch.size());
+        parallel_for(batch.size(),
+            [this, &batch, &pending](witness_state& ws, size_t i)
+            { 
+                pending[i].clear();
+                contract_node(ws, batch[i], false, &pending[i]); 
+            });
+
+        // merge them into the graph, in order
+        update.clear();
+        for(size_t i = 0; i < batch.size(); i++)
+        {
+            uint32_t node_id = batch[i];
+            for(shortcut_t& sc : pending[i])
+            {
+                if(this->verbose_)
+                {
+                    std::cerr 
+                        << "shortcut " << sc.from_ << ", " << sc.to_ 
+                        << " wt " << sc.cost_ << " hops " << sc.hops_ 
+                        << std::endl;
+                }
+                g_->get_node(sc.from_)->add_outgoing(
+                    warthog::graph::edge(sc.to_, sc.cost_, sc.hops_));
+                g_->get_node(sc.to_)->add_incoming(
+                    warthog::graph::edge(sc.from_, sc.cost_, sc.hops_));
+                shortcuts.push_back(sc);
+            }
+            order_->push_back(node_id);
+
+            // the neighbours need new priorities
+            warthog::graph::node* n = g_->get_node(node_id);
+            for(uint32_t j = 0; j < n->in_degree() + n->out_degree(); j++)
+            {
+                uint32_t nei_id = j < n->in_degree() 
+                    ? (n->incoming_begin() + j)->node_id_
+                    : (n->outgoing_begin() + (j - n->in_degree()))->node_id_;
+                height_[nei_id] = 
+                    std::max(height_[nei_id], height_[node_id]+1);
+                if(u_filter_->filter(nei_id)) { continue; }
+                u_filter_->add(nei_id);
+                update.push_back(nei_id);
+            }
+        }
+
+        for(uint32_t node_id : batch) { disconnect_node(node_id); }
+
+        // update the priorities of the neighbours
+        cval.resize(update.size());
+        parallel_for(update.size(), 
+            [this, &update, &cval](witness_state& ws, size_t i)
+            { cval[i] = contract_node(ws, update[i], true); });
+        for(size_t i = 0; i < update.size(); i++)
+        {
+            hn_pool_[update[i]].get_element().cval_ = cval[i];
+            u_filter_->remove(update[i]);
+        }
+        total_lazy_updates_ += update.size();
+        rounds++;
+
+        if((mytimer.get_time_micro() - t_last) > 1000000)
+        {
+            t_last = mytimer.get_time_micro();
+            std::cerr
+                << "time " << (int)((t_last - t_begin)/1000000) << "s"
+                << " prog " << order_->size()
+                << " round " << rounds
+                << " contracted " << batch.size()
+                << " #updates " << update.size()
+                << " #witness " << total_searches()
+                << std::endl;
+        }
+    }
+
+    std::cerr << "contracted in " << rounds << " rounds\n";
+}
@@ -21,6 +21,13 @@
 // The node ordering is done in a lazy manner
 // using a variety of heuristics.
 //
+// With ::set_num_threads, nodes are instead contracted in rounds. Each 
+// round selects every node whose priority is lower than that of all nodes
+// within two hops (an independent set), contracts the selected nodes
+// concurrently, each thread running its own witness searches, and then
+// merges their shortcuts into the graph. The resulting order depends only
+// on the input graph, not on the number of threads or their timing.
+//
 // For more details see:
 // [Geisbergerger, Sanders, Schultes and Delling. 
 // Contraction Hierarchies: Faster and Simpler Hierarchical 
@@ -41,6 +48,8 @@
 #include "bidirectional_search.h"
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <unordered_map>
 
 //using namespace warthog::ch;
@@ -72,6 +81,16 @@ class ch_pair
 bool
 operator<(const ch_pair& first, const ch_pair& second);
 
+// a shortcut edge, from_ -> to_, which bypasses the node mid_
+struct shortcut_t
+{
+    uint32_t from_;
+    uint32_t to_;
+    uint32_t mid_;
+    warthog::graph::edge_cost_t cost_;
+    uint32_t hops_;
+};
+
 class lazy_graph_contraction 
 {
     public:
@@ -95,38 +114,60 @@ class lazy_graph_contraction
         bool 
         get_verbose() { return verbose_; } 
 
+        // contract independent sets of nodes in parallel using 
+        // @param num_threads threads. 0 (the default) selects the
+        // sequential lazy contraction.
+        void
+        set_num_threads(uint32_t num_threads) { num_threads_ = num_threads; }
+
+        uint32_t
+        get_num_threads() { return num_threads_; }
+
         size_t
         mem();
 
     private:
+        // these objects get recycled across all witness searches;
+        // each thread has its own
+        struct witness_state
+        {
+            witness_state(warthog::graph::xy_graph* g);
+
+            warthog::zero_heuristic heuristic_;
+            warthog::ch::bypass_filter c_filter_; // track contractions
+            warthog::bidirectional_expander<warthog::ch::bypass_filter>
+                fexpander_;
+            warthog::bidirectional_expander<warthog::ch::bypass_filter>
+                bexpander_;
+            warthog::bidirectional_search<
+                warthog::zero_heuristic,
+                warthog::bidirectional_expander<warthog::ch::bypass_filter>>
+                    alg_;
+            warthog::solution sol_;
+
+            // metrics
+            uint64_t expansions_;
+            uint64_t searches_;
+        };
+
         warthog::graph::xy_graph* g_;
         std::vector<uint32_t>* order_;
         bool verbose_;
+        uint32_t num_threads_;
         std::vector<warthog::graph::edge> shortcuts_;
 
         // node order stuff
         warthog::heap<ch_pair>* heap_;
         warthog::heap_node<ch_pair>* hn_pool_;
 
-        // these objects get recycled across all witness searches
-        warthog::solution sol_;
-
         // track the height of each node in the hierarchy 
         std::vector<uint32_t> height_;
 
         uint32_t ws_max_expansions_; 
-        warthog::zero_heuristic* heuristic_;
-        warthog::bidirectional_expander<warthog::ch::bypass_filter>* fexpander_;
-        warthog::bidirectional_expander<warthog::ch::bypass_filter>* bexpander_;
-        warthog::ch::bypass_filter* c_filter_; // track contractions 
+        std::vector<std::unique_ptr<witness_state>> workers_;
         warthog::apriori_filter* u_filter_; // track neighbours updated
-        warthog::bidirectional_search<
-            warthog::zero_heuristic,
-            warthog::bidirectional_expander<warthog::ch::bypass_filter>>* alg_;
 
         // metrics
-        uint64_t total_expansions_;
-        uint64_t total_searches_;
         uint64_t total_lazy_updates_;
 
         void
@@ -138,11 +179,37 @@ class lazy_graph_contraction
         uint32_t
         next(bool verify_priorities, uint32_t c_pct);
 
+        // contract the graph one independent set at a time
+        void
+        contract_in_rounds(uint32_t c_pct);
+
+        // true if no node within two hops of @param node_id has a
+        // (priority, id) pair lower than that of @param node_id
+        bool
+        is_local_minimum(uint32_t node_id);
+
+        // run @param fn(ws, i) for every i in [0, @param n), spreading the 
+        // calls over the workers. ws is the state of the calling worker.
+        void
+        parallel_for(size_t n, 
+                std::function<void(witness_state& ws, size_t i)> fn);
+
+        uint64_t
+        total_expansions();
+
+        uint64_t
+        total_searches();
+
         double
-        witness_search(uint32_t from_id, uint32_t to_id, double via_len, bool resume);
+        witness_search(witness_state& ws, uint32_t from_id, uint32_t to_id,
+                double via_len, bool resume);
 
+        // if @param pending is not null the shortcuts of a contraction are
+        // appended there, rather than inserted into the graph, and the node
+        // is not added to the order; the caller is expected to do both.
         int32_t
-        contract_node(uint32_t node_id, bool metrics_only);
+        contract_node(witness_state& ws, uint32_t node_id, bool metrics_only,
+                std::vector<shortcut_t>* pending = 0);
 
         void
         disconnect_node(uint32_t node_id);
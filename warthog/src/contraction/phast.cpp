@@ -0,0 +1,244 @@
+#include "phast.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <numeric>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+// relax one arc of weight @param wt for every lane: dv = min(dv, du + wt)
+inline void
+relax(warthog::cost_t* dv, const warthog::cost_t* du, warthog::cost_t wt,
+        uint32_t lanes)
+{
+    uint32_t k = 0;
+#if defined(__AVX__)
+    const __m256d w4 = _mm256_set1_pd(wt);
+    for( ; k + 4 <= lanes; k += 4)
+    {
+        __m256d alt = _mm256_add_pd(_mm256_loadu_pd(du + k), w4);
+        _mm256_storeu_pd(dv + k,
+                _mm256_min_pd(alt, _mm256_loadu_pd(dv + k)));
+    }
+#elif defined(__SSE2__)
+    const __m128d w2 = _mm_set1_pd(wt);
+    for( ; k + 2 <= lanes; k += 2)
+    {
+        __m128d alt = _mm_add_pd(_mm_loadu_pd(du + k), w2);
+        _mm_storeu_pd(dv + k, _mm_min_pd(alt, _mm_loadu_pd(dv + k)));
+    }
+#endif
+    for( ; k < lanes; k++)
+    {
+        warthog::cost_t alt = du[k] + wt;
+        if(alt < dv[k]) { dv[k] = alt; }
+    }
+}
+
+}
+
+warthog::ch::phast::phast(warthog::ch::ch_data* chd, bool backward)
+    : lanes_(1)
+{
+    std::shared_ptr<hierarchy> h = std::make_shared<hierarchy>();
+    uint32_t n = chd->g_->get_num_nodes();
+    h->num_nodes_ = n;
+    h->backward_ = backward;
+
+    // the highest levels come first
+    std::vector<uint32_t> by_pos(n);
+    std::iota(by_pos.begin(), by_pos.end(), 0);
+    std::vector<uint32_t>& level = *chd->level_;
+    std::stable_sort(by_pos.begin(), by_pos.end(),
+        [&level](uint32_t a, uint32_t b)
+        { return level.at(a) > level.at(b); });
+    h->pos_.resize(n);
+    for(uint32_t p = 0; p < n; p++) { h->pos_[by_pos[p]] = p; }
+
+    // every arc as (tail, head, weight), by position and in the direction
+    // of the sweep
+    struct pos_arc { uint32_t tail_; uint32_t head_; warthog::cost_t wt_; };
+    std::vector<pos_arc> arcs;
+    auto add_arc = [&](uint32_t tail, uint32_t head, warthog::cost_t wt)
+    {
+        if(wt >= warthog::INF32) { return; }
+        if(backward) { std::swap(tail, head); }
+        if(tail == head) { return; }
+        arcs.push_back(pos_arc{h->pos_[tail], h->pos_[head], wt});
+    };
+
+    for(uint32_t id = 0; id < n; id++)
+    {
+        warthog::graph::node* node = chd->g_->get_node(id);
+        for(warthog::graph::edge_iter it = node->outgoing_begin();
+                it != node->outgoing_end(); it++)
+        {
+            add_arc(id, it->node_id_, it->wt_);
+        }
+
+        // UP_ONLY hierarchies keep their down arcs as incoming arcs
+        if(chd->type_ != warthog::ch::UP_ONLY) { continue; }
+        for(warthog::graph::edge_iter it = node->incoming_begin();
+                it != node->incoming_end(); it++)
+        {
+            add_arc(it->node_id_, id, it->wt_);
+        }
+    }
+
+    // down arcs are read by head, and each in order of the tail
+    std::sort(arcs.begin(), arcs.end(),
+        [](const pos_arc& a, const pos_arc& b)
+        {
+            return a.head_ < b.head_ ||
+                (a.head_ == b.head_ && a.tail_ < b.tail_);
+        });
+
+    h->up_begin_.assign(n + 1, 0);
+    h->down_begin_.assign(n + 1, 0);
+    for(pos_arc& a : arcs)
+    {
+        if(a.head_ < a.tail_) { h->up_begin_[a.tail_ + 1]++; }
+        else { h->down_begin_[a.head_ + 1]++; }
+    }
+    for(uint32_t p = 0; p < n; p++)
+    {
+        h->up_begin_[p + 1] += h->up_begin_[p];
+        h->down_begin_[p + 1] += h->down_begin_[p];
+    }
+
+    h->up_.resize(h->up_begin_[n]);
+    h->down_.resize(h->down_begin_[n]);
+    std::vector<uint32_t> up_next(
+            h->up_begin_.begin(), h->up_begin_.end() - 1);
+    uint32_t down_next = 0;
+    for(pos_arc& a : arcs)
+    {
+        if(a.head_ < a.tail_)
+        {
+            h->up_[up_next[a.tail_]++] = arc{a.head_, a.wt_};
+        }
+        else
+        {
+            h->down_[down_next++] = arc{a.tail_, a.wt_};
+        }
+    }
+    h_ = h;
+}
+
+void
+warthog::ch::phast::one_to_all(uint32_t source,
+        std::vector<warthog::cost_t>& dist)
+{
+    sweep(&source, 1);
+
+    dist.resize(h_->num_nodes_);
+    for(uint32_t id = 0; id < h_->num_nodes_; id++)
+    {
+        dist[id] = dist_[(size_t)h_->pos_[id] * lanes_];
+    }
+}
+
+void
+warthog::ch::phast::many_to_all(const std::vector<uint32_t>& sources,
+        std::vector<std::vector<warthog::cost_t>>& dist)
+{
+    dist.resize(sources.size());
+    for(uint32_t first = 0; first < sources.size(); first += MAX_LANES)
+    {
+        uint32_t num = std::min<uint32_t>(
+                MAX_LANES, (uint32_t)sources.size() - first);
+        sweep(sources.data() + first, num);
+
+        for(uint32_t k = 0; k < num; k++)
+        {
+            dist[first + k].resize(h_->num_nodes_);
+        }
+        for(uint32_t id = 0; id < h_->num_nodes_; id++)
+        {
+            const warthog::cost_t* d =
+                dist_.data() + (size_t)h_->pos_[id] * lanes_;
+            for(uint32_t k = 0; k < num; k++) { dist[first + k][id] = d[k]; }
+        }
+    }
+}
+
+void
+warthog::ch::phast::sweep(const uint32_t* sources, uint32_t num_sources)
+{
+    assert(num_sources > 0 && num_sources <= MAX_LANES);
+
+    // lanes are padded to whole vectors; unused lanes stay unreached
+    lanes_ = num_sources == 1 ? 1 : (num_sources + 3) & ~3u;
+    dist_.assign((size_t)h_->num_nodes_ * lanes_, warthog::COST_MAX);
+
+    for(uint32_t k = 0; k < num_sources; k++)
+    {
+        assert(sources[k] < h_->num_nodes_);
+        search_up(h_->pos_[sources[k]], k);
+    }
+
+    const uint32_t* down_begin = h_->down_begin_.data();
+    const arc* down = h_->down_.data();
+    warthog::cost_t* dist = dist_.data();
+    for(uint32_t p = 0; p < h_->num_nodes_; p++)
+    {
+        warthog::cost_t* dv = dist + (size_t)p * lanes_;
+        for(uint32_t i = down_begin[p]; i < down_begin[p + 1]; i++)
+        {
+            relax(dv, dist + (size_t)down[i].node_ * lanes_, down[i].wt_,
+                    lanes_);
+        }
+    }
+}
+
+void
+warthog::ch::phast::search_up(uint32_t source, uint32_t lane)
+{
+    typedef std::pair<warthog::cost_t, uint32_t> entry;
+    std::greater<entry> cmp;
+    warthog::cost_t* dist = dist_.data();
+
+    dist[(size_t)source * lanes_ + lane] = 0;
+    heap_.clear();
+    heap_.push_back(entry(0, source));
+    while(!heap_.empty())
+    {
+        std::pop_heap(heap_.begin(), heap_.end(), cmp);
+        entry top = heap_.back();
+        heap_.pop_back();
+        if(top.first > dist[(size_t)top.second * lanes_ + lane]) { continue; }
+
+        for(uint32_t i = h_->up_begin_[top.second];
+                i < h_->up_begin_[top.second + 1]; i++)
+        {
+            const arc& a = h_->up_[i];
+            warthog::cost_t alt = top.first + a.wt_;
+            warthog::cost_t& d = dist[(size_t)a.node_ * lanes_ + lane];
+            if(alt < d)
+            {
+                d = alt;
+                heap_.push_back(entry(alt, a.node_));
+                std::push_heap(heap_.begin(), heap_.end(), cmp);
+            }
+        }
+    }
+}
+
+size_t
+warthog::ch::phast::mem()
+{
+    return
+        sizeof(uint32_t) * (h_->pos_.size() + h_->up_begin_.size() +
+            h_->down_begin_.size()) +
+        sizeof(arc) * (h_->up_.size() + h_->down_.size()) +
+        sizeof(warthog::cost_t) * dist_.capacity() +
+        sizeof(*this);
+}
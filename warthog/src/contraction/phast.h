@@ -0,0 +1,131 @@
+#ifndef WARTHOG_CH_PHAST_H
+#define WARTHOG_CH_PHAST_H
+
+// contraction/phast.h
+//
+// PHAST computes the distance from one node to every other node of a
+// graph with a contraction hierarchy instead of a Dijkstra search. It runs
+// a Dijkstra search from the source that only follows arcs going up, then
+// visits every node once, from the highest level to the lowest: the
+// distance of a node is settled from the arcs that come down into it from
+// nodes already visited.
+//
+// The second phase does no priority queue operations and touches memory
+// in order. The hierarchy is renumbered by descending level and its down
+// arcs are grouped by head, so the sweep reads the arcs in one pass and
+// the distances of the heads in another. Several sources share a sweep:
+// their distances are stored next to each other for every node, and are
+// updated with SSE2 or AVX instructions, depending on how the library is
+// compiled. Up to MAX_LANES sources are handled per sweep; more are done
+// in batches.
+//
+// The hierarchy can be UP_ONLY or UP_DOWN. Arcs weighing warthog::INF32 or
+// more are dropped (cf. customizable_ch). In the backward direction the
+// distances are those to the source(s), from every node.
+//
+// Copies of a phast object share the renumbered hierarchy, which is
+// read-only, and have their own distance arrays; threads can each run
+// sweeps on their own copy.
+//
+// For more details see:
+// [Delling, Goldberg, Nowatzyk and Werneck. PHAST: Hardware-Accelerated
+// Shortest Path Trees. Journal of Parallel and Distributed Computing
+// 73(7), 2013]
+//
+
+#include "ch_data.h"
+#include "constants.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace warthog
+{
+
+namespace ch
+{
+
+class phast
+{
+    public:
+        // sources per sweep
+        static constexpr uint32_t MAX_LANES = 16;
+
+        // @param chd: the hierarchy; its node ids are those of the
+        // distances computed. it can be deleted once this object exists.
+        // @param backward: compute distances to the sources rather than
+        // from them
+        phast(warthog::ch::ch_data* chd, bool backward=false);
+
+        phast(const phast&) = default;
+
+        ~phast() { }
+
+        // @param dist gets the distance from @param source to every node,
+        // by node id; warthog::COST_MAX when there is none
+        void
+        one_to_all(uint32_t source, std::vector<warthog::cost_t>& dist);
+
+        // @param dist gets one distance array for each of @param sources,
+        // as ::one_to_all, computed MAX_LANES at a time
+        void
+        many_to_all(const std::vector<uint32_t>& sources,
+                std::vector<std::vector<warthog::cost_t>>& dist);
+
+        inline uint32_t
+        get_num_nodes() { return h_->num_nodes_; }
+
+        inline bool
+        is_backward() { return h_->backward_; }
+
+        size_t
+        mem();
+
+    private:
+        struct arc
+        {
+            uint32_t node_;
+            warthog::cost_t wt_;
+        };
+
+        // the hierarchy, by position: node 0 is at the highest level
+        struct hierarchy
+        {
+            uint32_t num_nodes_;
+            bool backward_;
+            std::vector<uint32_t> pos_;
+
+            // up arcs, by tail, to the head
+            std::vector<uint32_t> up_begin_;
+            std::vector<arc> up_;
+
+            // down arcs, by head, from the tail
+            std::vector<uint32_t> down_begin_;
+            std::vector<arc> down_;
+        };
+
+        std::shared_ptr<const hierarchy> h_;
+
+        // the distances of the current sweep, lanes_ per position
+        std::vector<warthog::cost_t> dist_;
+        uint32_t lanes_;
+
+        // the open list of the upward searches
+        std::vector<std::pair<warthog::cost_t, uint32_t>> heap_;
+
+        // the distances from @param sources (at most MAX_LANES) to every
+        // position, in dist_
+        void
+        sweep(const uint32_t* sources, uint32_t num_sources);
+
+        // the upward search from @param source, in lane @param lane
+        void
+        search_up(uint32_t source, uint32_t lane);
+};
+
+}
+
+}
+
+#endif
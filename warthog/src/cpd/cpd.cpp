@@ -72,6 +72,101 @@ warthog::cpd::compute_dfs_preorder(
     }
 }
 
+namespace
+{
+
+// true if a path of cost @param alt is as short as the best one, of cost
+// @param best
+inline bool
+is_tight(warthog::cost_t alt, warthog::cost_t best)
+{
+    return alt <= best + best * 1e-12;
+}
+
+}
+
+void
+warthog::cpd::forward_first_moves(
+        warthog::graph::xy_graph* g, uint32_t source,
+        const std::vector<warthog::cost_t>& dist,
+        std::vector<warthog::cpd::fm_coll>& row)
+{
+    uint32_t num_nodes = g->get_num_nodes();
+    assert(dist.size() == num_nodes);
+    row.assign(num_nodes, warthog::cpd::CPD_FM_NONE);
+
+    // count the edges on shortest paths into each node; a node's moves are
+    // final once all of them are visited (Kahn's algorithm), which needs no
+    // ordering by distance
+    std::vector<uint32_t> num_in(num_nodes, 0);
+    for(uint32_t id = 0; id < num_nodes; id++)
+    {
+        if(dist[id] == warthog::COST_MAX) { continue; }
+        row[id] = 0;
+
+        warthog::graph::node* n = g->get_node(id);
+        for(warthog::graph::edge_iter it = n->outgoing_begin();
+                it != n->outgoing_end(); it++)
+        {
+            if(it->node_id_ != id && is_tight(dist[id] + it->wt_,
+                        dist[it->node_id_]))
+            {
+                num_in[it->node_id_]++;
+            }
+        }
+    }
+
+    std::vector<uint32_t> queue;
+    queue.reserve(num_nodes);
+    queue.push_back(source);
+    for(uint32_t i = 0; i < queue.size(); i++)
+    {
+        uint32_t id = queue[i];
+        warthog::graph::node* n = g->get_node(id);
+        for(warthog::graph::edge_iter it = n->outgoing_begin();
+                it != n->outgoing_end(); it++)
+        {
+            uint32_t succ = it->node_id_;
+            if(succ == id || !is_tight(dist[id] + it->wt_, dist[succ]))
+            { continue; }
+
+            row[succ] |= id == source ?
+                (1 << (it - n->outgoing_begin())) : row[id];
+            if(--num_in[succ] == 0) { queue.push_back(succ); }
+        }
+    }
+}
+
+void
+warthog::cpd::reverse_first_moves(
+        warthog::graph::xy_graph* g, uint32_t target,
+        const std::vector<warthog::cost_t>& dist,
+        std::vector<warthog::cpd::fm_coll>& row)
+{
+    uint32_t num_nodes = g->get_num_nodes();
+    assert(dist.size() == num_nodes);
+    row.assign(num_nodes, warthog::cpd::CPD_FM_NONE);
+
+    // the moves of a node only depend on its own edges
+    for(uint32_t id = 0; id < num_nodes; id++)
+    {
+        if(id == target || dist[id] == warthog::COST_MAX) { continue; }
+
+        warthog::cpd::fm_coll moves = 0;
+        warthog::graph::node* n = g->get_node(id);
+        for(warthog::graph::edge_iter it = n->outgoing_begin();
+                it != n->outgoing_end(); it++)
+        {
+            if(dist[it->node_id_] != warthog::COST_MAX &&
+               is_tight(it->wt_ + dist[it->node_id_], dist[id]))
+            {
+                moves |= 1 << (it - n->outgoing_begin());
+            }
+        }
+        if(moves) { row[id] = moves; }
+    }
+}
+
 std::istream&
 warthog::cpd::operator>>(std::istream& in, warthog::cpd::rle_run32& the_run)
 {
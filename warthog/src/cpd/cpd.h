@@ -10,6 +10,7 @@
 #define WARTHOG_CPD_CPD_H
 
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <vector>
@@ -20,6 +21,10 @@
 #include "timer.h"
 #include "zero_heuristic.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace warthog
 {
 namespace cpd
@@ -33,10 +38,10 @@ enum clock_direction {CW, CCW};
 struct rle_run32
 {
     uint8_t 
-    get_move() { return data_ & 0xF; } 
+    get_move() const { return data_ & 0xF; } 
 
     uint32_t 
-    get_index() { return data_ >> 4; } 
+    get_index() const { return data_ >> 4; } 
 
 
     void
@@ -54,6 +59,90 @@ operator>>(std::istream& in, warthog::cpd::rle_run32& the_run);
 std::ostream&
 operator<<(std::ostream& out, warthog::cpd::rle_run32& the_run);
 
+// rows of at most this many runs are searched with ::scan_runs, longer
+// rows with ::bisect_runs. when rows are cold, as they are during path
+// extraction, the cost of a lookup is dominated by cache misses and
+// ::bisect_runs, which touches the fewest lines, is faster at every row
+// length (cf. programs/cpd_bench.cpp). the linear scan only pays off when
+// the same short rows are searched repeatedly.
+#ifndef WARTHOG_CPD_SCAN_MAX_RUNS
+#define WARTHOG_CPD_SCAN_MAX_RUNS 0
+#endif
+static const uint32_t CPD_SCAN_MAX_RUNS = WARTHOG_CPD_SCAN_MAX_RUNS;
+
+// Each of the functions below returns the position of the run, in the
+// @param size runs of @param row, that covers column @param index. That is
+// the last run that begins at or before @param index (runs are sorted and
+// the first begins at 0).
+//
+// Since a run stores (begin << 4 | move), the runs beginning at or before
+// @param index are exactly those whose data_ is <= (index << 4 | 0xF); the
+// searches compare whole words and never decode a run.
+
+// count, with no branches, the runs that begin at or before the column.
+// the loop vectorises; with AVX2 we count 8 runs per instruction.
+inline uint32_t
+scan_runs(uint32_t index, const warthog::cpd::rle_run32* row, uint32_t size)
+{
+    uint32_t key = (index << 4) | 0xF;
+    uint32_t count = 0;
+    uint32_t i = 0;
+
+#ifdef __AVX2__
+    // AVX2 has only signed comparisons; flipping the sign bit of both sides
+    // makes them order like unsigned integers
+    const __m256i bias = _mm256_set1_epi32((int32_t)0x80000000);
+    const __m256i vkey = _mm256_xor_si256(_mm256_set1_epi32((int32_t)key), bias);
+    __m256i vcount = _mm256_setzero_si256();
+    for( ; i + 8 <= size; i += 8)
+    {
+        __m256i runs = _mm256_xor_si256(
+            _mm256_loadu_si256((const __m256i*)(row + i)), bias);
+        // lanes with run > key are -1; the others 0
+        vcount = _mm256_sub_epi32(vcount, _mm256_cmpgt_epi32(runs, vkey));
+    }
+    vcount = _mm256_hadd_epi32(vcount, vcount);
+    vcount = _mm256_hadd_epi32(vcount, vcount);
+    uint32_t greater = (uint32_t)_mm256_extract_epi32(vcount, 0) +
+        (uint32_t)_mm256_extract_epi32(vcount, 4);
+    count = i - greater;
+#endif
+
+    for( ; i < size; i++)
+    {
+        count += row[i].data_ <= key;
+    }
+
+    return count - (count != 0);
+}
+
+// binary search in which every probe is a conditional move rather than a
+// branch. all rows of the same length take the same number of steps.
+inline uint32_t
+bisect_runs(uint32_t index, const warthog::cpd::rle_run32* row, uint32_t size)
+{
+    uint32_t key = (index << 4) | 0xF;
+    const warthog::cpd::rle_run32* base = row;
+    uint32_t n = size;
+
+    while(n > 1)
+    {
+        uint32_t half = n >> 1;
+        base = (base[half].data_ <= key) ? base + half : base;
+        n -= half;
+    }
+
+    return (uint32_t)(base - row);
+}
+
+// pick the faster search for the length of the row
+inline uint32_t
+find_run(uint32_t index, const warthog::cpd::rle_run32* row, uint32_t size)
+{
+    if(size <= CPD_SCAN_MAX_RUNS) { return scan_runs(index, row, size); }
+    return bisect_runs(index, row, size);
+}
+
 //  limits on the number of nodes in a graph 
 //  for which we compute a CPD
 static const uint32_t RLE_RUN32_MAX_INDEX = (UINT32_MAX >> 4);
@@ -82,6 +171,27 @@ compute_dfs_preorder(
         std::vector<uint32_t>* column_order,
         uint32_t seed=0);
 
+// the optimal first moves from @param source to every node of @param g,
+// given the distance @param dist from the source to each node
+// (warthog::COST_MAX when unreached), e.g. from warthog::ch::phast. as with
+// the oracle listeners, the moves of a node are those of every edge that
+// starts one of its shortest paths. edge weights must be positive; ties are
+// compared with a small relative tolerance, since distances summed in
+// another order can differ in their last bits
+void
+forward_first_moves(
+        warthog::graph::xy_graph* g, uint32_t source,
+        const std::vector<warthog::cost_t>& dist,
+        std::vector<warthog::cpd::fm_coll>& row);
+
+// the optimal first moves from every node of @param g to @param target,
+// given the distance @param dist from each node to the target
+void
+reverse_first_moves(
+        warthog::graph::xy_graph* g, uint32_t target,
+        const std::vector<warthog::cost_t>& dist,
+        std::vector<warthog::cpd::fm_coll>& row);
+
 }
 
 }
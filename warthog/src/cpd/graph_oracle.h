@@ -10,6 +10,15 @@
 //  Compressing Optimal Paths with Run Length Encoding.
 //  Journal of Artificial Intelligence Research (JAIR)]
 //
+// Oracles are built and streamed (operator<<, operator>>) one row at a
+// time. Alternatively, an oracle can be saved in a flat format
+// (::write_flat) and memory-mapped (::load_flat): lookups then read the
+// node order and the runs straight from the file, which needs no parsing
+// and is shared through the page cache by every process using it.
+//
+// Rows come from a Dijkstra search per source (::compute_row) or, when a
+// contraction hierarchy of the graph is available, from the distances of
+// a multi-source PHAST sweep (::compute_rows).
 //
 // @author: dharabor
 // @created: 2020-02-26
@@ -18,14 +27,19 @@
 #ifndef WARTHOG_CPD_GRAPH_ORACLE_H
 #define WARTHOG_CPD_GRAPH_ORACLE_H
 
-#include "binary.h"
 #include "constants.h"
 #include "cpd.h"
 #include "geography.h"
 #include "graph.h"
 #include "graph_expansion_policy.h"
+#include "mapped_file.h"
+#include "phast.h"
 #include "xy_graph.h"
 
+#include <cstring>
+#include <fstream>
+#include <memory>
+
 namespace warthog
 {
 
@@ -34,49 +48,77 @@ namespace cpd
 
 enum symbol {FORWARD, REVERSE, BEARING, TABLE, REV_TABLE};
 
+// layout of a flat CPD file. the header is followed by three sections, each
+// starting at a multiple of 8 bytes: the node order (num_nodes_ x uint32),
+// the row offsets (num_rows_ + 1 x uint64; row i is made of runs
+// [offsets[i], offsets[i+1])) and the runs (num_runs_ x rle_run32).
+struct flat_cpd_header
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t symbol_;
+    uint32_t num_nodes_;
+    uint32_t num_rows_;
+    uint64_t num_runs_;
+    uint64_t order_offset_;
+    uint64_t offsets_offset_;
+    uint64_t runs_offset_;
+};
+
+static const char FLAT_CPD_MAGIC[8] = {'W', 'H', 'C', 'P', 'D', 'F', 'L', 'T'};
+static const uint32_t FLAT_CPD_VERSION = 1;
+
 template<symbol T>
 class graph_oracle_base
 {
     public: 
         graph_oracle_base(warthog::graph::xy_graph* g)
-             : g_(g), div_(1), mod_(0), offset_(0)
+             : g_(g), div_(1), mod_(0), offset_(0), flat_order_(nullptr),
+               flat_offsets_(nullptr), flat_runs_(nullptr), flat_nodes_(0),
+               flat_rows_(0)
         {
             order_.resize(g_->get_num_nodes());
             fm_.resize(g_->get_num_nodes());
         }
 
-        graph_oracle_base() : g_(nullptr) { }
+        graph_oracle_base()
+             : g_(nullptr), div_(1), mod_(0), offset_(0),
+               flat_order_(nullptr), flat_offsets_(nullptr),
+               flat_runs_(nullptr), flat_nodes_(0), flat_rows_(0)
+        { }
 
         virtual ~graph_oracle_base() { }
 
         graph_oracle_base(const graph_oracle_base&) = default;
 
         bool
-        operator==(const graph_oracle_base& other)
+        operator==(graph_oracle_base& other)
         {
-            if (order_ != other.order_)
+            if (get_num_nodes() != other.get_num_nodes() ||
+                get_num_rows() != other.get_num_rows())
             {
                 return false;
             }
 
-            if (fm_.size() != other.fm_.size())
+            for (uint32_t i = 0; i < get_num_nodes(); i++)
             {
-                return false;
+                if (get_order(i) != other.get_order(i)) { return false; }
             }
 
-            for (size_t i = 0; i < fm_.size(); i++)
+            for (size_t i = 0; i < get_num_rows(); i++)
             {
-                std::vector<warthog::cpd::rle_run32> row1 = fm_.at(i);
-                std::vector<warthog::cpd::rle_run32> row2 = other.fm_.at(i);
+                uint32_t size1, size2;
+                const warthog::cpd::rle_run32* row1 = get_runs(i, size1);
+                const warthog::cpd::rle_run32* row2 = other.get_runs(i, size2);
 
-                if (row1.size() != row2.size())
+                if (size1 != size2)
                 {
                     return false;
                 }
 
-                for (size_t j = 0; j < row1.size(); j++)
+                for (size_t j = 0; j < size1; j++)
                 {
-                    if (row1.at(j).data_ != row2.at(j).data_)
+                    if (row1[j].data_ != row2[j].data_)
                     {
                         return false;
                     }
@@ -97,6 +139,196 @@ class graph_oracle_base
         {
             order_.clear();
             fm_.clear();
+            unmap();
+        }
+
+        // number of nodes in the column order
+        inline uint32_t
+        get_num_nodes()
+        { return flat_runs_ ? flat_nodes_ : (uint32_t)order_.size(); }
+
+        // number of rows; less than the number of nodes for partial CPDs
+        inline size_t
+        get_num_rows()
+        { return flat_runs_ ? flat_rows_ : fm_.size(); }
+
+        // the position of node @param node_id in the column order
+        inline uint32_t
+        get_order(warthog::sn_id_t node_id)
+        {
+            if(flat_runs_)
+            {
+                assert(node_id < flat_nodes_);
+                return flat_order_[node_id];
+            }
+            return order_.at(node_id);
+        }
+
+        // the runs of row @param row_id. their number is returned in
+        // @param num_runs
+        inline const warthog::cpd::rle_run32*
+        get_runs(size_t row_id, uint32_t& num_runs)
+        {
+            if(flat_runs_)
+            {
+                assert(row_id < flat_rows_);
+                uint64_t begin = flat_offsets_[row_id];
+                num_runs = (uint32_t)(flat_offsets_[row_id + 1] - begin);
+                return flat_runs_ + begin;
+            }
+            std::vector<warthog::cpd::rle_run32>& row = fm_.at(row_id);
+            num_runs = (uint32_t)row.size();
+            return row.data();
+        }
+
+        // @return true if the oracle is backed by a flat, mapped file
+        inline bool
+        is_flat() { return flat_runs_ != nullptr; }
+
+        // save the oracle in the flat format (cf. flat_cpd_header)
+        bool
+        write_flat(std::ostream& out)
+        {
+            warthog::timer mytimer;
+            mytimer.start();
+
+            flat_cpd_header hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            memcpy(hdr.magic_, FLAT_CPD_MAGIC, sizeof(hdr.magic_));
+            hdr.version_ = FLAT_CPD_VERSION;
+            hdr.symbol_ = T;
+            hdr.num_nodes_ = get_num_nodes();
+            hdr.num_rows_ = (uint32_t)get_num_rows();
+
+            std::vector<uint64_t> offsets(hdr.num_rows_ + 1, 0);
+            for(uint32_t row_id = 0; row_id < hdr.num_rows_; row_id++)
+            {
+                uint32_t num_runs;
+                get_runs(row_id, num_runs);
+                offsets.at(row_id + 1) = offsets.at(row_id) + num_runs;
+            }
+            hdr.num_runs_ = offsets.back();
+            hdr.order_offset_ = flat_align(sizeof(hdr));
+            hdr.offsets_offset_ = flat_align(
+                    hdr.order_offset_ + sizeof(uint32_t) * hdr.num_nodes_);
+            hdr.runs_offset_ = hdr.offsets_offset_ +
+                sizeof(uint64_t) * offsets.size();
+
+            uint64_t pos = 0;
+            const char zeros[8] = {0};
+            out.write((char*)&hdr, sizeof(hdr));
+            pos += sizeof(hdr);
+
+            out.write(zeros, hdr.order_offset_ - pos);
+            for(uint32_t i = 0; i < hdr.num_nodes_; i++)
+            {
+                uint32_t index = get_order(i);
+                out.write((char*)&index, sizeof(index));
+            }
+            pos = hdr.order_offset_ + sizeof(uint32_t) * hdr.num_nodes_;
+
+            out.write(zeros, hdr.offsets_offset_ - pos);
+            out.write((char*)offsets.data(), sizeof(uint64_t) * offsets.size());
+
+            for(uint32_t row_id = 0; row_id < hdr.num_rows_; row_id++)
+            {
+                uint32_t num_runs;
+                const warthog::cpd::rle_run32* runs = get_runs(row_id, num_runs);
+                out.write((char*)runs, sizeof(warthog::cpd::rle_run32) * num_runs);
+            }
+            mytimer.stop();
+
+            if(!out.good())
+            {
+                std::cerr << "err; while writing flat cpd\n";
+                return false;
+            }
+
+            std::cerr
+                << "wrote to disk " << hdr.num_rows_ << " rows and "
+                << hdr.num_runs_ << " runs (flat). "
+                << " time: " << (double)mytimer.elapsed_time_nano() / 1e9
+                << " s \n";
+            return true;
+        }
+
+        // map the flat CPD in @param filename. returns false, and leaves
+        // the oracle untouched, if the file is missing or is not a flat CPD
+        // of this type (e.g. a CPD in the streamed format).
+        bool
+        load_flat(const char* filename)
+        {
+            // the header says whether this is a flat CPD at all; streamed
+            // files are not mapped just to find out they are not
+            flat_cpd_header hdr;
+            std::ifstream ifs(filename,
+                    std::ios_base::in | std::ios_base::binary);
+            if(!ifs.read((char*)&hdr, sizeof(hdr)) ||
+               memcmp(hdr.magic_, FLAT_CPD_MAGIC, sizeof(hdr.magic_)) != 0)
+            { return false; }
+            ifs.close();
+
+            if(hdr.version_ != FLAT_CPD_VERSION || hdr.symbol_ != T)
+            {
+                std::cerr << "err; flat cpd " << filename << " has version "
+                    << hdr.version_ << " and type " << hdr.symbol_
+                    << "; expected " << FLAT_CPD_VERSION << " and " << T
+                    << "\n";
+                return false;
+            }
+
+            if(g_ != nullptr && hdr.num_nodes_ != g_->get_num_nodes())
+            {
+                std::cerr
+                    << "err; " << "input mismatch. cpd file says "
+                    << hdr.num_nodes_ << " nodes, but graph contains "
+                    << g_->get_num_nodes() << "\n";
+                return false;
+            }
+
+            std::shared_ptr<warthog::util::mapped_file> file =
+                std::make_shared<warthog::util::mapped_file>(filename);
+            if(!file->good() || !flat_sections_fit(hdr, file->size()))
+            {
+                std::cerr << "err; flat cpd " << filename << " is corrupt\n";
+                return false;
+            }
+
+            // every row is read without further checks, so its runs have
+            // to be in the file
+            const uint64_t* offsets =
+                (const uint64_t*)(file->data() + hdr.offsets_offset_);
+            bool good =
+                offsets[0] == 0 && offsets[hdr.num_rows_] == hdr.num_runs_;
+            for(uint32_t i = 0; good && i < hdr.num_rows_; i++)
+            {
+                good = offsets[i] <= offsets[i+1] &&
+                    offsets[i+1] - offsets[i] <= UINT32_MAX;
+            }
+            if(!good)
+            {
+                std::cerr << "err; flat cpd " << filename
+                    << " has invalid row offsets\n";
+                return false;
+            }
+
+            order_.clear();
+            order_.shrink_to_fit();
+            fm_.clear();
+            fm_.shrink_to_fit();
+
+            file_ = file;
+            flat_order_ = (const uint32_t*)(file->data() + hdr.order_offset_);
+            flat_offsets_ = offsets;
+            flat_runs_ = (const warthog::cpd::rle_run32*)(
+                    file->data() + hdr.runs_offset_);
+            flat_nodes_ = hdr.num_nodes_;
+            flat_rows_ = hdr.num_rows_;
+
+            std::cerr
+                << "mapped " << flat_rows_ << " rows and " << hdr.num_runs_
+                << " runs from " << filename << "\n";
+            return true;
         }
 
         inline void
@@ -164,6 +396,9 @@ class graph_oracle_base
                 sizeof(uint32_t) * order_.size() + 
                 sizeof(std::vector<warthog::cpd::rle_run32>) * fm_.size();
 
+            // mapped pages are shared and only resident when touched
+            if(file_) { retval += file_->size(); }
+
             for(uint32_t i = 0; i < fm_.size(); i++)
             {
                 retval += sizeof(warthog::cpd::rle_run32) * fm_.at(i).size();
@@ -178,25 +413,17 @@ class graph_oracle_base
             warthog::timer mytimer;
             mytimer.start();
 
-            // write graph size
-            uint32_t num_nodes = lab.g_->get_num_nodes();
-            out.write((char*)(&num_nodes), 4);
-
-            // write node ordering
-            assert(lab.order_.size() == num_nodes);
-            for(uint32_t i = 0; i < num_nodes; i++)
-            {
-                uint32_t n_id = lab.order_.at(i);
-                out.write((char*)(&n_id), 4);
-            }
+            lab.write_order(out);
 
             // write the runs for each row
             uint32_t row_count = 0;
             uint32_t run_count = 0;
-            for(uint32_t row_id = 0; row_id < lab.g_->get_num_nodes(); row_id++)
+            for(uint32_t row_id = 0; row_id < lab.get_num_rows(); row_id++)
             {
                 // write the number of runs
-                uint32_t num_runs = (uint32_t)lab.fm_.at(row_id).size();
+                uint32_t num_runs;
+                const warthog::cpd::rle_run32* runs =
+                    lab.get_runs(row_id, num_runs);
                 // Skip empty runs
                 if (num_runs == 0) { continue; }
 
@@ -205,7 +432,8 @@ class graph_oracle_base
 
                 for(uint32_t run = 0; run < num_runs; run++)
                 {
-                    out << lab.fm_.at(row_id).at(run);
+                    warthog::cpd::rle_run32 tmp = runs[run];
+                    out << tmp;
                     run_count++;
                     if(!out.good())
                     {
@@ -213,7 +441,7 @@ class graph_oracle_base
                         std::cerr
                             << "[debug info] "
                             << " row_id " << row_id
-                            << " run# " << lab.fm_.at(row_id).size()
+                            << " run# " << num_runs
                             << ". aborting.\n";
                         return out;
                     }
@@ -231,6 +459,40 @@ class graph_oracle_base
             return out;
         }
 
+        // write the graph size and the node ordering; the head of the
+        // streamed format (cf. operator<<)
+        void
+        write_order(std::ostream& out)
+        {
+            uint32_t num_nodes = g_->get_num_nodes();
+            out.write((char*)(&num_nodes), 4);
+
+            assert(get_num_nodes() == num_nodes);
+            for(uint32_t i = 0; i < num_nodes; i++)
+            {
+                uint32_t n_id = get_order(i);
+                out.write((char*)(&n_id), 4);
+            }
+        }
+
+        // append row @param row_id to a streamed CPD, as operator<< would,
+        // then free the memory held by the row. used to write a CPD while
+        // it is being built. returns the number of runs written.
+        uint32_t
+        flush_row(std::ostream& out, size_t row_id)
+        {
+            assert(!is_flat());
+            std::vector<warthog::cpd::rle_run32> row;
+            row.swap(fm_.at(row_id));
+
+            uint32_t num_runs = (uint32_t)row.size();
+            if(num_runs == 0) { return 0; }
+
+            out.write((char*)(&num_runs), 4);
+            for(warthog::cpd::rle_run32& run : row) { out << run; }
+            return num_runs;
+        }
+
         friend std::istream&
         operator>>(std::istream& in, graph_oracle_base& lab)
         {
@@ -251,6 +513,7 @@ class graph_oracle_base
                 return in;
             }
 
+            lab.unmap();
             lab.fm_.clear();
             lab.order_.resize(num_nodes);
 
@@ -331,9 +594,57 @@ class graph_oracle_base
             add_row(source_id, s_row);
         }
 
+        // compute and add the rows of @param sources from the distances of
+        // PHAST sweeps, which take much less time than a Dijkstra search per
+        // row (cf. ::compute_row). @param ph must be built over a hierarchy
+        // of the same graph, backward for reverse oracles. @param dist and
+        // @param rows are scratch space, one entry per source.
+        // bearing oracles are not supported
+        void
+        compute_rows(const std::vector<uint32_t>& sources,
+                     warthog::ch::phast* ph,
+                     std::vector<std::vector<warthog::cost_t>>& dist,
+                     std::vector<std::vector<warthog::cpd::fm_coll>>& rows)
+        {
+            const bool reverse = (T == REVERSE || T == REV_TABLE);
+            assert(T != BEARING);
+            assert(ph->is_backward() == reverse);
+            assert(ph->get_num_nodes() == g_->get_num_nodes());
+
+            ph->many_to_all(sources, dist);
+            rows.resize(sources.size());
+            for(uint32_t i = 0; i < sources.size(); i++)
+            {
+                if(reverse)
+                {
+                    warthog::cpd::reverse_first_moves(
+                            g_, sources[i], dist[i], rows[i]);
+                }
+                else
+                {
+                    warthog::cpd::forward_first_moves(
+                            g_, sources[i], dist[i], rows[i]);
+                }
+                add_row(sources[i], rows[i]);
+            }
+        }
+
         // TODO should only be used with reverse schemes
         std::vector<warthog::cpd::rle_run32>&
         get_row(warthog::sn_id_t target_id)
+        {
+            // rows of a mapped oracle are read-only; cf. get_runs
+            assert(!is_flat());
+            size_t row_id = get_row_id(target_id);
+            assert(row_id < fm_.size());
+
+            return fm_.at(row_id);
+        }
+
+        // the row that stores node @param target_id (cf. set_div, set_mod
+        // and set_offset)
+        inline size_t
+        get_row_id(warthog::sn_id_t target_id)
         {
             size_t row_id;
             if(div_ > 1)
@@ -353,10 +664,7 @@ class graph_oracle_base
                 row_id = target_id;
             }
 
-            assert(row_id >= 0);
-            assert(row_id < fm_.size());
-
-            return fm_.at(row_id);
+            return row_id;
         }
 
         void
@@ -384,6 +692,53 @@ class graph_oracle_base
         uint32_t div_;
         uint32_t mod_;
         uint32_t offset_;
+
+        // a flat CPD mapped by ::load_flat. the pointers below point into
+        // the mapping, which is shared by copies of the oracle; when it is
+        // set, fm_ and order_ are empty
+        std::shared_ptr<warthog::util::mapped_file> file_;
+        const uint32_t* flat_order_;
+        const uint64_t* flat_offsets_;
+        const warthog::cpd::rle_run32* flat_runs_;
+        uint32_t flat_nodes_;
+        uint32_t flat_rows_;
+
+        void
+        unmap()
+        {
+            file_.reset();
+            flat_order_ = nullptr;
+            flat_offsets_ = nullptr;
+            flat_runs_ = nullptr;
+            flat_nodes_ = flat_rows_ = 0;
+        }
+
+        static inline uint64_t
+        flat_align(uint64_t pos) { return (pos + 7) & ~(uint64_t)7; }
+
+        // whether the sections of @param hdr are aligned, in order and end
+        // within @param size bytes. sizes are compared with the space left
+        // after each offset, so that no sum can overflow.
+        static bool
+        flat_sections_fit(const flat_cpd_header& hdr, uint64_t size)
+        {
+            if(hdr.order_offset_ % 8 || hdr.offsets_offset_ % 8 ||
+               hdr.runs_offset_ % 8 ||
+               hdr.order_offset_ < sizeof(hdr) ||
+               hdr.order_offset_ > hdr.offsets_offset_ ||
+               hdr.offsets_offset_ > hdr.runs_offset_ ||
+               hdr.runs_offset_ > size)
+            { return false; }
+
+            return
+                hdr.num_nodes_ <= (hdr.offsets_offset_ - hdr.order_offset_) /
+                    sizeof(uint32_t) &&
+                (uint64_t)hdr.num_rows_ + 1 <=
+                    (hdr.runs_offset_ - hdr.offsets_offset_) /
+                    sizeof(uint64_t) &&
+                hdr.num_runs_ <= (size - hdr.runs_offset_) /
+                    sizeof(warthog::cpd::rle_run32);
+        }
 };
 
 typedef warthog::cpd::graph_oracle_base<FORWARD> graph_oracle;
@@ -398,33 +753,19 @@ void
 compute_row(uint32_t source_id, warthog::cpd::graph_oracle* cpd,
             warthog::search* dijk, std::vector<warthog::cpd::fm_coll> &s_row);
 
-typedef std::function<bool(uint32_t&)> t_find_fn;
-
-inline uint32_t
-binary_find_row(uint32_t target_index,
-                std::vector<warthog::cpd::rle_run32>& row)
-{
-    uint32_t end = (uint32_t)row.size();
-    t_find_fn find_target = [&target_index, &row](uint32_t mid)
-    {
-        return target_index < row.at(mid).get_index();
-    };
-
-    return util::binary_find_first<uint32_t, t_find_fn>(0, end, find_target);
-}
-
 template<>
 inline uint32_t
 graph_oracle_base<warthog::cpd::FORWARD>::get_move(
     warthog::sn_id_t source_id, warthog::sn_id_t target_id)
 {
-    if(fm_.at(source_id).size() == 0) { return warthog::cpd::CPD_FM_NONE; }
+    uint32_t size;
+    const warthog::cpd::rle_run32* row = get_runs(source_id, size);
+    if(size == 0) { return warthog::cpd::CPD_FM_NONE; }
 
-    std::vector<warthog::cpd::rle_run32>& row = fm_.at(source_id);
-    uint32_t target_index = order_.at(target_id);
-    uint32_t begin = binary_find_row(target_index, row);
+    uint32_t target_index = get_order(target_id);
+    uint32_t begin = warthog::cpd::find_run(target_index, row, size);
 
-    return row.at(begin).get_move();
+    return row[begin].get_move();
 }
 
 // In a reverse CPD we get the row with the target's id, and then try to find
@@ -434,13 +775,14 @@ inline uint32_t
 graph_oracle_base<warthog::cpd::REVERSE>::get_move(
     warthog::sn_id_t source_id, warthog::sn_id_t target_id)
 {
-    std::vector<warthog::cpd::rle_run32>& row = get_row(target_id);
-    if(row.size() == 0) { return warthog::cpd::CPD_FM_NONE; }
+    uint32_t size;
+    const warthog::cpd::rle_run32* row = get_runs(get_row_id(target_id), size);
+    if(size == 0) { return warthog::cpd::CPD_FM_NONE; }
 
-    uint32_t target_index = order_.at(source_id);
-    uint32_t begin = binary_find_row(target_index, row);
+    uint32_t target_index = get_order(source_id);
+    uint32_t begin = warthog::cpd::find_run(target_index, row, size);
 
-    return row.at(begin).get_move();
+    return row[begin].get_move();
 }
 
 template<>
@@ -448,13 +790,13 @@ inline uint32_t
 graph_oracle_base<warthog::cpd::BEARING>::get_move(
     warthog::sn_id_t source_id, warthog::sn_id_t target_id)
 {
+    uint32_t size;
+    const warthog::cpd::rle_run32* row = get_runs(target_id, size);
+    if(size == 0) { return warthog::cpd::CPD_FM_NONE; }
 
-    if(fm_.at(target_id).size() == 0) { return warthog::cpd::CPD_FM_NONE; }
-
-    std::vector<warthog::cpd::rle_run32>& row = fm_.at(target_id);
-    uint32_t target_index = order_.at(source_id);
-    uint32_t begin = binary_find_row(target_index, row);
-    uint8_t fm = row.at(begin).get_move();
+    uint32_t target_index = get_order(source_id);
+    uint32_t begin = warthog::cpd::find_run(target_index, row, size);
+    uint8_t fm = row[begin].get_move();
 
     // Check if we have a counter-/clock-wise wildcard
     if(fm < 2)
@@ -514,16 +856,18 @@ graph_oracle_base<warthog::cpd::BEARING>::get_move(
 
 // Finding a first move is a lookup, a mask and a shift
 inline uint32_t
-get_table_move(std::vector<warthog::cpd::rle_run32>& row, uint32_t index)
+get_table_move(const warthog::cpd::rle_run32* row, uint32_t size,
+               uint32_t index)
 {
-    if(row.size() == 0) { return warthog::cpd::CPD_FM_NONE; }
+    if(size == 0) { return warthog::cpd::CPD_FM_NONE; }
 
     uint32_t entry = index / 8; // Which 32bit int contains the information
     uint8_t shift = (index % 8) * 4; // Where in the 32bit int is the fm
     uint32_t mask = 0xF << shift;
 
     // TODO look into `bextr`
-    return (row.at(entry).data_ & mask) >> shift;
+    assert(entry < size);
+    return (row[entry].data_ & mask) >> shift;
 }
 
 template<>
@@ -531,7 +875,9 @@ inline uint32_t
 warthog::cpd::graph_oracle_base<warthog::cpd::REV_TABLE>::get_move(
     warthog::sn_id_t source_id, warthog::sn_id_t target_id)
 {
-    return get_table_move(get_row(target_id), order_.at(source_id));
+    uint32_t size;
+    const warthog::cpd::rle_run32* row = get_runs(get_row_id(target_id), size);
+    return get_table_move(row, size, get_order(source_id));
 }
 
 template<>
@@ -539,7 +885,9 @@ inline uint32_t
 warthog::cpd::graph_oracle_base<warthog::cpd::TABLE>::get_move(
     warthog::sn_id_t source_id, warthog::sn_id_t target_id)
 {
-    return get_table_move(get_row(source_id), order_.at(target_id));
+    uint32_t size;
+    const warthog::cpd::rle_run32* row = get_runs(get_row_id(source_id), size);
+    return get_table_move(row, size, get_order(target_id));
 }
 
 // For some reason, this needs to be defined in the .cpp. But we cannot do the
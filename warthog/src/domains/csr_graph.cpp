@@ -0,0 +1,254 @@
+#include "csr_graph.h"
+#include "helpers.h"
+#include "xy_graph.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <sys/stat.h>
+
+warthog::graph::csr_graph::csr_graph()
+    : num_nodes_(0), num_edges_out_(0), num_edges_in_(0)
+{
+    csr_graph_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    uint64_t offsets[NUM_ARRAYS];
+    owned_.resize(layout(hdr, offsets) / sizeof(uint64_t), 0);
+    attach(hdr, (const char*)owned_.data());
+}
+
+warthog::graph::csr_graph::csr_graph(warthog::graph::xy_graph& g)
+{
+    csr_graph_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.num_nodes_ = g.get_num_nodes();
+    hdr.num_edges_out_ = g.get_num_edges_out();
+    hdr.num_edges_in_ = g.get_num_edges_in();
+    hdr.has_incoming_ = hdr.num_edges_in_ > 0;
+    for(uint32_t i = 0; i < g.get_num_nodes() && !hdr.has_id_map_; i++)
+    {
+        hdr.has_id_map_ = g.to_external_id(i) != i;
+    }
+    for(uint32_t i = 0; i < g.get_num_nodes() && !hdr.has_labels_; i++)
+    {
+        for(warthog::graph::edge_iter it = g.outgoing_begin(i);
+                it != g.outgoing_end(i); it++)
+        {
+            if(it->label_ != 0) { hdr.has_labels_ = 1; break; }
+        }
+    }
+
+    uint64_t offsets[NUM_ARRAYS];
+    owned_.resize(layout(hdr, offsets) / sizeof(uint64_t), 0);
+    char* data = (char*)owned_.data();
+    int32_t* xy = (int32_t*)(data + offsets[0]);
+    uint32_t* out_offsets = (uint32_t*)(data + offsets[1]);
+    csr_edge* out_edges = (csr_edge*)(data + offsets[2]);
+    uint32_t* in_offsets = (uint32_t*)(data + offsets[3]);
+    csr_edge* in_edges = (csr_edge*)(data + offsets[4]);
+    uint64_t* labels = (uint64_t*)(data + offsets[5]);
+    uint32_t* ext_ids = (uint32_t*)(data + offsets[6]);
+    uint32_t* graph_ids = (uint32_t*)(data + offsets[7]);
+
+    uint32_t num_rounded = 0;
+    uint32_t out = 0, in = 0;
+    for(uint32_t i = 0; i < hdr.num_nodes_; i++)
+    {
+        g.get_xy(i, xy[i*2], xy[i*2+1]);
+        if(hdr.has_id_map_)
+        {
+            ext_ids[i] = g.to_external_id(i);
+            graph_ids[ext_ids[i]] = i;
+        }
+
+        out_offsets[i] = out;
+        for(warthog::graph::edge_iter it = g.outgoing_begin(i);
+                it != g.outgoing_end(i); it++, out++)
+        {
+            out_edges[out].node_id_ = it->node_id_;
+            out_edges[out].wt_ = (float)it->wt_;
+            if((double)out_edges[out].wt_ != it->wt_) { num_rounded++; }
+            if(hdr.has_labels_) { labels[out] = (uint64_t)it->label_; }
+        }
+
+        if(!hdr.has_incoming_) { continue; }
+        in_offsets[i] = in;
+        for(warthog::graph::edge_iter it = g.incoming_begin(i);
+                it != g.incoming_end(i); it++, in++)
+        {
+            in_edges[in].node_id_ = it->node_id_;
+            in_edges[in].wt_ = (float)it->wt_;
+            if((double)in_edges[in].wt_ != it->wt_) { num_rounded++; }
+        }
+    }
+    out_offsets[hdr.num_nodes_] = out;
+    if(hdr.has_incoming_) { in_offsets[hdr.num_nodes_] = in; }
+
+    if(num_rounded)
+    {
+        std::cerr << "warn; " << num_rounded << " edge weights rounded to "
+            << "the nearest float\n";
+    }
+    attach(hdr, data);
+}
+
+uint64_t
+warthog::graph::csr_graph::layout(
+        const csr_graph_header& hdr, uint64_t offsets[NUM_ARRAYS])
+{
+    uint64_t sizes[NUM_ARRAYS];
+    uint64_t offsets_bytes = sizeof(uint32_t) * ((uint64_t)hdr.num_nodes_ + 1);
+    sizes[0] = sizeof(int32_t) * 2 * (uint64_t)hdr.num_nodes_;
+    sizes[1] = offsets_bytes;
+    sizes[2] = sizeof(csr_edge) * (uint64_t)hdr.num_edges_out_;
+    sizes[3] = hdr.has_incoming_ ? offsets_bytes : 0;
+    sizes[4] = hdr.has_incoming_ ?
+        sizeof(csr_edge) * (uint64_t)hdr.num_edges_in_ : 0;
+    sizes[5] = hdr.has_labels_ ?
+        sizeof(uint64_t) * (uint64_t)hdr.num_edges_out_ : 0;
+    sizes[6] = hdr.has_id_map_ ?
+        sizeof(uint32_t) * (uint64_t)hdr.num_nodes_ : 0;
+    sizes[7] = sizes[6];
+
+    uint64_t size = 0;
+    for(uint32_t i = 0; i < NUM_ARRAYS; i++)
+    {
+        offsets[i] = size;
+        size += (sizes[i] + 7) & ~(uint64_t)7;
+    }
+    return size;
+}
+
+void
+warthog::graph::csr_graph::attach(
+        const csr_graph_header& hdr, const char* data)
+{
+    uint64_t offsets[NUM_ARRAYS];
+    layout(hdr, offsets);
+    num_nodes_ = hdr.num_nodes_;
+    num_edges_out_ = hdr.num_edges_out_;
+    num_edges_in_ = hdr.has_incoming_ ? hdr.num_edges_in_ : 0;
+    xy_ = (const int32_t*)(data + offsets[0]);
+    out_offsets_ = (const uint32_t*)(data + offsets[1]);
+    out_edges_ = (const csr_edge*)(data + offsets[2]);
+    in_offsets_ = hdr.has_incoming_ ?
+        (const uint32_t*)(data + offsets[3]) : nullptr;
+    in_edges_ = hdr.has_incoming_ ?
+        (const csr_edge*)(data + offsets[4]) : nullptr;
+    labels_ = hdr.has_labels_ ? (const uint64_t*)(data + offsets[5]) : nullptr;
+    ext_ids_ = hdr.has_id_map_ ?
+        (const uint32_t*)(data + offsets[6]) : nullptr;
+    graph_ids_ = hdr.has_id_map_ ?
+        (const uint32_t*)(data + offsets[7]) : nullptr;
+}
+
+bool
+warthog::graph::csr_graph::load(const char* filename, uint64_t source_stamp)
+{
+    std::cerr << "loading " << filename << "... ";
+    std::shared_ptr<warthog::util::mapped_file> file =
+        std::make_shared<warthog::util::mapped_file>(filename);
+    if(!file->good())
+    {
+        std::cerr << "no dice. oh well. keep going.\n";
+        return false;
+    }
+
+    csr_graph_header hdr;
+    if(file->size() < sizeof(hdr))
+    {
+        std::cerr << "not a csr graph; ignored.\n";
+        return false;
+    }
+    memcpy(&hdr, file->data(), sizeof(hdr));
+    if(memcmp(hdr.magic_, CSR_GRAPH_MAGIC, sizeof(hdr.magic_)) != 0 ||
+       hdr.version_ != CSR_GRAPH_VERSION)
+    {
+        std::cerr << "not a csr graph of version " << CSR_GRAPH_VERSION
+            << "; ignored.\n";
+        return false;
+    }
+
+    if(source_stamp != 0 && hdr.source_stamp_ != source_stamp)
+    {
+        std::cerr << "graph was built from another file; ignored.\n";
+        return false;
+    }
+
+    uint64_t offsets[NUM_ARRAYS];
+    const char* data = file->data() + sizeof(hdr);
+    if(hdr.size_ != layout(hdr, offsets) ||
+       sizeof(hdr) + hdr.size_ > file->size() ||
+       warthog::helpers::fnv64(data, hdr.size_) != hdr.checksum_ ||
+       ((const uint32_t*)(data + offsets[1]))[hdr.num_nodes_] !=
+            hdr.num_edges_out_ ||
+       (hdr.has_incoming_ &&
+        ((const uint32_t*)(data + offsets[3]))[hdr.num_nodes_] !=
+            hdr.num_edges_in_))
+    {
+        std::cerr << "graph is corrupt; ignored.\n";
+        return false;
+    }
+
+    file_ = file;
+    attach(hdr, data);
+    std::vector<uint64_t>().swap(owned_);
+    std::cerr << "#nodes=" << num_nodes_ << " #edges=" << num_edges_out_
+        << std::endl;
+    return true;
+}
+
+bool
+warthog::graph::csr_graph::save(const char* filename, uint64_t source_stamp)
+{
+    std::cerr << "saving to file " << filename << "; nodes=" << num_nodes_
+        << " edges=" << num_edges_out_ << std::endl;
+
+    csr_graph_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic_, CSR_GRAPH_MAGIC, sizeof(hdr.magic_));
+    hdr.version_ = CSR_GRAPH_VERSION;
+    hdr.num_nodes_ = num_nodes_;
+    hdr.num_edges_out_ = num_edges_out_;
+    hdr.num_edges_in_ = num_edges_in_;
+    hdr.has_incoming_ = has_incoming();
+    hdr.has_labels_ = has_labels();
+    hdr.has_id_map_ = ext_ids_ != nullptr;
+    hdr.source_stamp_ = source_stamp;
+
+    // the arrays are laid out the same way in memory, whether they are
+    // owned or mapped, so they are written in one piece
+    uint64_t offsets[NUM_ARRAYS];
+    hdr.size_ = layout(hdr, offsets);
+    const char* data = (const char*)xy_ - offsets[0];
+    hdr.checksum_ = warthog::helpers::fnv64(data, hdr.size_);
+
+    // write a temporary file and rename it, so that a process loading the
+    // graph never sees it half written
+    std::string tmpname = std::string(filename) + ".tmp";
+    std::ofstream out(tmpname, std::ios_base::out | std::ios_base::binary);
+    out.write((char*)&hdr, sizeof(hdr));
+    out.write(data, (std::streamsize)hdr.size_);
+    out.close();
+    if(!out.good() || rename(tmpname.c_str(), filename) != 0)
+    {
+        std::cerr << "err; cannot write csr graph to file "
+            << filename << ". oh well. try to keep going.\n";
+        remove(tmpname.c_str());
+        return false;
+    }
+    std::cerr << "csr graph saved to disk. file=" << filename << std::endl;
+    return true;
+}
+
+uint64_t
+warthog::graph::csr_graph::file_stamp(const char* filename)
+{
+    struct stat st;
+    if(stat(filename, &st) != 0) { return 0; }
+    uint64_t fields[3] = { (uint64_t)st.st_size, (uint64_t)st.st_mtim.tv_sec,
+        (uint64_t)st.st_mtim.tv_nsec };
+    return warthog::helpers::fnv64(fields, sizeof(fields));
+}
@@ -0,0 +1,216 @@
+#ifndef WARTHOG_CSR_GRAPH_H
+#define WARTHOG_CSR_GRAPH_H
+
+// csr_graph.h
+//
+// An immutable directed graph in compressed sparse rows, for searching
+// large road networks that never change once loaded. The edges of every
+// node are stored one after another in a single array and indexed by an
+// array of offsets; each edge is eight bytes, the head and a float weight,
+// which is a third of a warthog::graph::edge. Edge labels, which few
+// algorithms need, are kept in a side array and only when some edge has
+// one.
+//
+// The graph is built from an xy_graph and keeps its node ids, its external
+// ids when it was reordered, and the order of the edges of every node, so
+// first-move tables and node orders computed on the xy_graph are valid for
+// both. Incoming edges are copied too, when the xy_graph stores them.
+//
+// Search code reaches the edges of either graph through the same calls
+// (outgoing_begin(id), out_degree(id) and so on; cf. xy_graph_base), so
+// expansion policies templated on the graph type work with both.
+//
+// The graph can be saved to a file that is mapped read-only when loaded:
+// nothing is parsed or copied and the pages are shared by every process
+// using the same graph. As with the jump point database the file has a
+// versioned header and a checksum, and it records the size and the
+// modification time of the file it was built from (cf. ::file_stamp), so
+// a stale graph is not loaded.
+//
+
+#include "constants.h"
+#include "forward.h"
+#include "mapped_file.h"
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace warthog
+{
+
+namespace graph
+{
+
+struct csr_edge
+{
+    uint32_t node_id_;
+    float wt_;
+};
+
+struct csr_graph_header
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t num_nodes_;
+    uint32_t num_edges_out_;
+    uint32_t num_edges_in_;
+    uint32_t has_incoming_;
+    uint32_t has_labels_;
+    uint32_t has_id_map_;
+    uint32_t reserved_;
+    uint64_t source_stamp_;         // cf. csr_graph::file_stamp
+    uint64_t size_;                 // bytes after the header
+    uint64_t checksum_;             // helpers::fnv64 of those bytes
+};
+
+static const char CSR_GRAPH_MAGIC[8] = {'W', 'H', 'C', 'S', 'R', 'G', 'R', 'F'};
+static const uint32_t CSR_GRAPH_VERSION = 2;
+
+class csr_graph
+{
+    public:
+        typedef warthog::graph::csr_edge edge_type;
+        typedef const warthog::graph::csr_edge* edge_iter;
+
+        // an empty graph; cf. ::load
+        csr_graph();
+
+        // a copy of @param g. weights that a float cannot represent
+        // exactly are rounded, with a warning
+        csr_graph(warthog::graph::xy_graph& g);
+
+        ~csr_graph() { }
+
+        inline uint32_t
+        get_num_nodes() const { return num_nodes_; }
+
+        inline uint32_t
+        get_num_edges_out() const { return num_edges_out_; }
+
+        inline uint32_t
+        get_num_edges_in() const { return num_edges_in_; }
+
+        inline bool
+        has_incoming() const { return in_offsets_ != nullptr; }
+
+        inline bool
+        has_labels() const { return labels_ != nullptr; }
+
+        // @return true if the graph is mapped from disk
+        inline bool
+        is_mapped() const { return file_ != nullptr; }
+
+        inline void
+        get_xy(uint32_t id, int32_t& x, int32_t& y) const
+        {
+            assert(id < num_nodes_);
+            x = xy_[id*2];
+            y = xy_[id*2+1];
+        }
+
+        // cf. xy_graph::to_graph_id
+        inline uint32_t
+        to_graph_id(uint32_t ext_id) const
+        {
+            if(!graph_ids_) { return ext_id; }
+            return ext_id < num_nodes_ ? graph_ids_[ext_id] : warthog::INF32;
+        }
+
+        inline uint32_t
+        to_external_id(uint32_t in_id) const
+        { return ext_ids_ ? ext_ids_[in_id] : in_id; }
+
+        inline edge_iter
+        outgoing_begin(uint32_t id) const
+        { return out_edges_ + out_offsets_[id]; }
+
+        inline edge_iter
+        outgoing_end(uint32_t id) const
+        { return out_edges_ + out_offsets_[id+1]; }
+
+        inline uint32_t
+        out_degree(uint32_t id) const
+        { return out_offsets_[id+1] - out_offsets_[id]; }
+
+        // a graph without incoming edges has none to return
+        inline edge_iter
+        incoming_begin(uint32_t id) const
+        { return in_offsets_ ? in_edges_ + in_offsets_[id] : nullptr; }
+
+        inline edge_iter
+        incoming_end(uint32_t id) const
+        { return in_offsets_ ? in_edges_ + in_offsets_[id+1] : nullptr; }
+
+        inline uint32_t
+        in_degree(uint32_t id) const
+        { return in_offsets_ ? in_offsets_[id+1] - in_offsets_[id] : 0; }
+
+        // the label of the outgoing edge @param e, or 0 if there are no
+        // labels
+        inline uintptr_t
+        get_label(edge_iter e) const
+        { return labels_ ? (uintptr_t)labels_[e - out_edges_] : 0; }
+
+        // replace the graph with the one in @param filename; @return false
+        // (and leave the graph unchanged) if the file is not a valid graph
+        // or, when @param source_stamp is not zero, if it was built from a
+        // different file
+        bool
+        load(const char* filename, uint64_t source_stamp = 0);
+
+        bool
+        save(const char* filename, uint64_t source_stamp = 0);
+
+        // a hash of the size and the modification time of @param filename,
+        // or 0 if there is no such file
+        static uint64_t
+        file_stamp(const char* filename);
+
+        size_t
+        mem() const
+        {
+            return sizeof(*this) +
+                sizeof(uint64_t) * (owned_.capacity());
+        }
+
+    private:
+        uint32_t num_nodes_;
+        uint32_t num_edges_out_;
+        uint32_t num_edges_in_;
+
+        const int32_t* xy_;
+        const uint32_t* out_offsets_;
+        const csr_edge* out_edges_;
+        const uint32_t* in_offsets_;
+        const csr_edge* in_edges_;
+        const uint64_t* labels_;
+        const uint32_t* ext_ids_;
+        const uint32_t* graph_ids_;
+
+        // the arrays, laid out as in the file (cf. ::layout) unless mapped
+        std::vector<uint64_t> owned_;
+        std::shared_ptr<warthog::util::mapped_file> file_;
+
+        // the position of each array after the header of a graph file and
+        // in ::owned_; every array starts on an 8-byte boundary and an
+        // absent array takes no space. @return the size of all arrays
+        static const uint32_t NUM_ARRAYS = 8;
+        static uint64_t
+        layout(const csr_graph_header& hdr, uint64_t offsets[NUM_ARRAYS]);
+
+        // point the arrays into @param data, laid out as in @param hdr
+        void
+        attach(const csr_graph_header& hdr, const char* data);
+
+        csr_graph(const csr_graph& other) { }
+        csr_graph&
+        operator=(const csr_graph& other) { return *this; }
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+#include "graph_reorder.h"
+#include "xy_graph.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+
+// visits every node of @param g, in order of @param seed then of id, with
+// @param traverse; each call adds to @param order the nodes reached from a
+// new root
+template<class TRAVERSE>
+void
+visit_all(warthog::graph::xy_graph* g, std::vector<uint32_t>& order,
+        uint32_t seed, TRAVERSE traverse)
+{
+    uint32_t num_nodes = g->get_num_nodes();
+    std::vector<bool> visited(num_nodes, false);
+    order.clear();
+    order.reserve(num_nodes);
+    if(seed < num_nodes) { traverse(seed, visited); }
+    for(uint32_t root = 0; root < num_nodes; root++)
+    {
+        if(!visited[root]) { traverse(root, visited); }
+    }
+    assert(order.size() == num_nodes);
+}
+
+// the distance of (@param x, @param y) along a Hilbert curve that fills a
+// 2^16 x 2^16 grid
+uint64_t
+hilbert_index(uint32_t x, uint32_t y)
+{
+    const uint32_t n = 1 << 16;
+    uint64_t d = 0;
+    for(uint32_t s = n / 2; s > 0; s /= 2)
+    {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant
+        if(ry == 0)
+        {
+            if(rx == 1)
+            {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+}
+
+warthog::graph::reorder_type
+warthog::graph::parse_reorder_type(const std::string& name)
+{
+    if(name == "dfs") { return REORDER_DFS; }
+    if(name == "bfs") { return REORDER_BFS; }
+    if(name == "hilbert") { return REORDER_HILBERT; }
+    if(name == "level") { return REORDER_LEVEL; }
+    return REORDER_NONE;
+}
+
+void
+warthog::graph::dfs_order(warthog::graph::xy_graph* g,
+        std::vector<uint32_t>& order, uint32_t seed)
+{
+    // (node, index of the next edge to follow)
+    typedef std::pair<uint32_t, uint32_t> dfs_pair;
+    std::vector<dfs_pair> stack;
+    visit_all(g, order, seed,
+        [g, &order, &stack](uint32_t root, std::vector<bool>& visited)
+        {
+            visited[root] = true;
+            order.push_back(root);
+            stack.push_back(dfs_pair(root, 0));
+            while(stack.size())
+            {
+                dfs_pair& top = stack.back();
+                if(top.second == g->out_degree(top.first))
+                {
+                    stack.pop_back();
+                    continue;
+                }
+
+                uint32_t succ =
+                    (g->outgoing_begin(top.first) + top.second++)->node_id_;
+                if(!visited[succ])
+                {
+                    visited[succ] = true;
+                    order.push_back(succ);
+                    stack.push_back(dfs_pair(succ, 0));
+                }
+            }
+        });
+}
+
+void
+warthog::graph::bfs_order(warthog::graph::xy_graph* g,
+        std::vector<uint32_t>& order, uint32_t seed)
+{
+    // the queue is the tail of the order
+    visit_all(g, order, seed,
+        [g, &order](uint32_t root, std::vector<bool>& visited)
+        {
+            visited[root] = true;
+            order.push_back(root);
+            for(size_t head = order.size() - 1; head < order.size(); head++)
+            {
+                uint32_t id = order[head];
+                for(warthog::graph::edge_iter it = g->outgoing_begin(id);
+                        it != g->outgoing_end(id); it++)
+                {
+                    if(!visited[it->node_id_])
+                    {
+                        visited[it->node_id_] = true;
+                        order.push_back(it->node_id_);
+                    }
+                }
+            }
+        });
+}
+
+void
+warthog::graph::hilbert_order(warthog::graph::xy_graph* g,
+        std::vector<uint32_t>& order)
+{
+    uint32_t num_nodes = g->get_num_nodes();
+    order.resize(num_nodes);
+    if(num_nodes == 0) { return; }
+
+    // scale the bounding box, keeping its aspect, to the curve's grid
+    int32_t min_x = INT32_MAX, min_y = INT32_MAX;
+    int32_t max_x = INT32_MIN, max_y = INT32_MIN;
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        int32_t x, y;
+        g->get_xy(i, x, y);
+        min_x = std::min(min_x, x);
+        min_y = std::min(min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+    }
+    int64_t range = std::max((int64_t)max_x - min_x, (int64_t)max_y - min_y);
+    range = std::max(range, (int64_t)1);
+
+    std::vector<uint64_t> index(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        int32_t x, y;
+        g->get_xy(i, x, y);
+        index[i] = hilbert_index(
+                (uint32_t)(((int64_t)x - min_x) * 65535 / range),
+                (uint32_t)(((int64_t)y - min_y) * 65535 / range));
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&index](uint32_t a, uint32_t b) { return index[a] < index[b]; });
+}
+
+void
+warthog::graph::level_order(const std::vector<uint32_t>& level,
+        std::vector<uint32_t>& order)
+{
+    order.resize(level.size());
+    for(uint32_t i = 0; i < level.size(); i++) { order[i] = i; }
+    std::stable_sort(order.begin(), order.end(),
+        [&level](uint32_t a, uint32_t b) { return level[a] > level[b]; });
+}
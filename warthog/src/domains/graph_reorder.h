@@ -0,0 +1,67 @@
+#ifndef WARTHOG_GRAPH_REORDER_H
+#define WARTHOG_GRAPH_REORDER_H
+
+// graph_reorder.h
+//
+// Node orders that improve the locality of a graph: nodes that are near
+// each other in the graph, or on the plane, get nearby ids, so a search
+// touches fewer cache lines of the node pool, the coordinates and the
+// edges. Each function computes an order, i.e. a list of the ids of the
+// graph in their new sequence, for xy_graph::reorder (or ch::reorder) to
+// apply.
+//
+// Traversal orders start at @param seed and, when some nodes are not
+// reachable from there, continue from the unvisited node with the
+// smallest id.
+//
+
+#include "forward.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace warthog
+{
+
+namespace graph
+{
+
+typedef enum
+{
+    REORDER_NONE = 0,
+    REORDER_DFS = 1,
+    REORDER_BFS = 2,
+    REORDER_HILBERT = 3,
+    REORDER_LEVEL = 4
+} reorder_type;
+
+// the order named @param name (none, dfs, bfs, hilbert or level), or
+// REORDER_NONE if there is no such order
+reorder_type
+parse_reorder_type(const std::string& name);
+
+// depth-first preorder over outgoing edges
+void
+dfs_order(warthog::graph::xy_graph* g, std::vector<uint32_t>& order,
+        uint32_t seed = 0);
+
+// breadth-first order over outgoing edges
+void
+bfs_order(warthog::graph::xy_graph* g, std::vector<uint32_t>& order,
+        uint32_t seed = 0);
+
+// order of the coordinates along a Hilbert curve
+void
+hilbert_order(warthog::graph::xy_graph* g, std::vector<uint32_t>& order);
+
+// nodes by decreasing @param level (e.g. the contraction order of a CH),
+// so the top of the hierarchy, which every query visits, is contiguous
+void
+level_order(const std::vector<uint32_t>& level, std::vector<uint32_t>& order);
+
+}
+
+}
+
+#endif
@@ -1,17 +1,85 @@
 #include "gridmap.h"
 
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 
+namespace
+{
+
+// the padding of a map of @param height x @param width tiles stored in
+// dbwords of @param dbword_bits bits (cf. gridmap::init_db), and the size
+// of its binary file (cf. gridmap::write_binary).
+// @return false if the padded map does not fit 32bit ids
+bool
+padded_layout(uint32_t height, uint32_t width, uint32_t dbword_bits,
+		warthog::gridmap_file_header& layout, uint64_t& file_size)
+{
+	// we pad the edges of the map with zeroes. this eliminates the need
+	// for bounds checking when fetching the neighbours of a node. 
+	const uint64_t align = warthog::GRIDMAP_ALIGN;
+	layout.padded_rows_before_first_row_ = 3;
+	layout.padded_rows_after_last_row_ = 3;
+	uint64_t padded_height = (uint64_t)height + 6;
+
+	// extra/redundant padding bits, per row, align the map width with the
+	// dbword size (or, with 64bit dbwords, with the size of a cache line)
+	// and leave at least one padding bit at the end of each row
+	uint64_t row_bits = dbword_bits == 64 ? align * 8 : 32;
+	uint64_t padded_width = ((uint64_t)width / row_bits + 1) * row_bits;
+	if(padded_width * padded_height > UINT32_MAX) { return false; }
+
+	layout.padded_height_ = (uint32_t)padded_height;
+	layout.padded_width_ = (uint32_t)padded_width;
+	layout.dbheight_ = layout.padded_height_;
+	layout.dbwidth_ = layout.padded_width_ / dbword_bits;
+	layout.db_size_ = layout.dbwidth_ * layout.dbheight_;
+
+	// the bits start, and the file ends, on a cache line
+	uint64_t db_bytes = (uint64_t)layout.db_size_ * (dbword_bits / 8);
+	layout.db_offset_ = (sizeof(layout) + align - 1) & ~(align - 1);
+	file_size = layout.db_offset_ + ((db_bytes + align - 1) & ~(align - 1));
+	return true;
+}
+
+}
+
 warthog::gridmap::gridmap(unsigned int h, unsigned int w)
 	: header_(h, w, "octile")
 {	
+	filename_[0] = '\0';
 	this->init_db();
 }
 
+warthog::gridmap::gridmap(const warthog::gridmap& other)
+	: header_(other.header_)
+{
+	strcpy(filename_, other.filename_);
+	padded_rows_before_first_row_ = other.padded_rows_before_first_row_;
+	padded_rows_after_last_row_ = other.padded_rows_after_last_row_;
+	padded_height_ = other.padded_height_;
+	padded_width_ = other.padded_width_;
+	padding_per_row_ = other.padding_per_row_;
+	dbwidth_ = other.dbwidth_;
+	dbheight_ = other.dbheight_;
+	db_size_ = other.db_size_;
+	max_id_ = other.max_id_;
+	num_traversable_ = other.num_traversable_;
+
+	// the copy owns its tiles, even if @param other is mapped
+	size_t db_bytes = sizeof(warthog::dbword) * db_size_;
+	db_bytes = (db_bytes + warthog::GRIDMAP_ALIGN - 1) & 
+		~((size_t)warthog::GRIDMAP_ALIGN - 1);
+	this->db_ = (warthog::dbword*)aligned_alloc(
+			warthog::GRIDMAP_ALIGN, db_bytes);
+	memcpy(db_, other.db_, sizeof(warthog::dbword) * db_size_);
+}
+
 warthog::gridmap::gridmap(const char* filename)
 {
 	strcpy(filename_, filename);
+	if(load_binary(filename)) { return; }
+
 	warthog::gm_parser parser(filename);
 	this->header_ = parser.get_header();
 
@@ -43,30 +111,16 @@ warthog::gridmap::gridmap(const char* filename)
 void
 warthog::gridmap::init_db()
 {
-	// when storing the grid we pad the edges of the map with
-	// zeroes. this eliminates the need for bounds checking when
-	// fetching the neighbours of a node. 
-	this->padded_rows_before_first_row_ = 3;
-	this->padded_rows_after_last_row_ = 3;
-	this->padded_height_ = this->header_.height_ + 
-		padded_rows_after_last_row_ +
-		padded_rows_before_first_row_;
-
-	// calculate # of extra/redundant padding bits required,
-	// per row, to align map width with dbword size
-	this->padded_width_  = this->header_.width_ + 1;
-    if((padded_width_ % 32) != 0) 
-    {
-        padded_width_ = (this->header_.width_ / 32 + 1) * 32;
-    }
-	this->padding_per_row_ = this->padded_width_ - this->header_.width_;
-
-    this->dbheight_ = padded_height_;
-    this->dbwidth_ = padded_width_ >> warthog::LOG2_DBWORD_BITS;
-	this->db_size_ = this->dbwidth_ * this->dbheight_;
-
-	// create a one dimensional dbword array to store the grid
-	this->db_ = new warthog::dbword[db_size_];
+	init_layout();
+
+	// create a one dimensional dbword array to store the grid. the array
+	// starts on a cache line; so does every row, if rows are padded to
+	// whole cache lines
+	size_t db_bytes = sizeof(warthog::dbword) * db_size_;
+	db_bytes = (db_bytes + warthog::GRIDMAP_ALIGN - 1) & 
+		~((size_t)warthog::GRIDMAP_ALIGN - 1);
+	this->db_ = (warthog::dbword*)aligned_alloc(
+			warthog::GRIDMAP_ALIGN, db_bytes);
 	for(unsigned int i=0; i < db_size_; i++)
 	{
 		db_[i] = 0;
@@ -75,9 +129,157 @@ warthog::gridmap::init_db()
 	max_id_ = db_size_-1;
 }
 
+void
+warthog::gridmap::init_layout()
+{
+	warthog::gridmap_file_header layout;
+	uint64_t file_size;
+	if(!padded_layout(header_.height_, header_.width_, warthog::DBWORD_BITS,
+				layout, file_size))
+	{
+		std::cerr << "err; map of " << header_.height_ << "x" 
+			<< header_.width_ << " tiles is too big" << std::endl;
+		exit(1);
+	}
+	padded_rows_before_first_row_ = layout.padded_rows_before_first_row_;
+	padded_rows_after_last_row_ = layout.padded_rows_after_last_row_;
+	padded_height_ = layout.padded_height_;
+	padded_width_ = layout.padded_width_;
+	padding_per_row_ = padded_width_ - header_.width_;
+	dbheight_ = layout.dbheight_;
+	dbwidth_ = layout.dbwidth_;
+	db_size_ = layout.db_size_;
+	max_id_ = db_size_ - 1;
+}
+
+void
+warthog::gridmap::copy_mapped()
+{
+	size_t db_bytes = sizeof(warthog::dbword) * db_size_;
+	db_bytes = (db_bytes + warthog::GRIDMAP_ALIGN - 1) & 
+		~((size_t)warthog::GRIDMAP_ALIGN - 1);
+	warthog::dbword* db = (warthog::dbword*)aligned_alloc(
+			warthog::GRIDMAP_ALIGN, db_bytes);
+	memcpy(db, db_, sizeof(warthog::dbword) * db_size_);
+	db_ = db;
+	file_.reset();
+}
+
 warthog::gridmap::~gridmap()
 {
-	delete [] db_;
+	if(!file_) { free(db_); }
+}
+
+bool
+warthog::gridmap::load_binary(const char* filename)
+{
+	std::shared_ptr<warthog::util::mapped_file> file =
+		std::make_shared<warthog::util::mapped_file>(filename);
+	if(!file->good() || file->size() < sizeof(gridmap_file_header))
+	{ return false; }
+
+	gridmap_file_header hdr;
+	memcpy(&hdr, file->data(), sizeof(hdr));
+	if(memcmp(hdr.magic_, GRIDMAP_FILE_MAGIC, sizeof(hdr.magic_)) != 0)
+	{ return false; }
+
+	// only the dimensions of the map are taken from the header. the
+	// padding follows from them, as for a map read from text, and from
+	// the dbword size of the build that wrote the file; the rest of the
+	// header and the size of the file must agree.
+	warthog::gridmap_file_header layout;
+	uint64_t file_size = 0;
+	if(hdr.version_ != GRIDMAP_FILE_VERSION || 
+	   (hdr.dbword_bits_ != 8 && hdr.dbword_bits_ != 32 && 
+		hdr.dbword_bits_ != 64) ||
+	   hdr.type_[15] != 0 ||
+	   !padded_layout(hdr.height_, hdr.width_, hdr.dbword_bits_, 
+		   layout, file_size) ||
+	   hdr.padded_rows_before_first_row_ != 
+			layout.padded_rows_before_first_row_ ||
+	   hdr.padded_rows_after_last_row_ != 
+			layout.padded_rows_after_last_row_ ||
+	   hdr.padded_height_ != layout.padded_height_ ||
+	   hdr.padded_width_ != layout.padded_width_ ||
+	   hdr.dbwidth_ != layout.dbwidth_ ||
+	   hdr.dbheight_ != layout.dbheight_ ||
+	   hdr.db_size_ != layout.db_size_ ||
+	   hdr.db_offset_ != layout.db_offset_ ||
+	   file->size() != file_size)
+	{
+		std::cerr << "err; gridmap file " << filename << " is corrupt or "
+			<< "has an unknown version (" << hdr.version_ << ")" << std::endl;
+		exit(1);
+	}
+
+	header_ = warthog::gm_header(hdr.height_, hdr.width_, hdr.type_);
+	const uint8_t* bits = (const uint8_t*)(file->data() + hdr.db_offset_);
+
+	if(hdr.dbword_bits_ == warthog::DBWORD_BITS)
+	{
+		// same layout as in memory: use the mapped bits as they are
+		file_ = file;
+		db_ = (warthog::dbword*)bits;
+		init_layout();
+		num_traversable_ = hdr.num_traversable_;
+		return true;
+	}
+
+	// written by a build with another dbword size; the padding differs,
+	// so copy the map tile by tile
+	std::cerr << "gridmap file " << filename << " has " << hdr.dbword_bits_
+		<< "-bit dbwords; converting." << std::endl;
+	init_db();
+	for(uint32_t y = 0; y < header_.height_; y++)
+	{
+		for(uint32_t x = 0; x < header_.width_; x++)
+		{
+			uint64_t index = (uint64_t)(y + hdr.padded_rows_before_first_row_)
+				* hdr.padded_width_ + x;
+			set_label(to_padded_id(x, y), (bits[index >> 3] >> (index & 7)) & 1);
+		}
+	}
+	num_traversable_ = hdr.num_traversable_;
+	return true;
+}
+
+bool
+warthog::gridmap::write_binary(std::ostream& out)
+{
+	gridmap_file_header hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic_, GRIDMAP_FILE_MAGIC, sizeof(hdr.magic_));
+	hdr.version_ = GRIDMAP_FILE_VERSION;
+	hdr.dbword_bits_ = warthog::DBWORD_BITS;
+	hdr.height_ = header_.height_;
+	hdr.width_ = header_.width_;
+	hdr.padded_height_ = padded_height_;
+	hdr.padded_width_ = padded_width_;
+	hdr.padded_rows_before_first_row_ = padded_rows_before_first_row_;
+	hdr.padded_rows_after_last_row_ = padded_rows_after_last_row_;
+	hdr.dbwidth_ = dbwidth_;
+	hdr.dbheight_ = dbheight_;
+	hdr.db_size_ = db_size_;
+	hdr.num_traversable_ = num_traversable_;
+	strncpy(hdr.type_, header_.type_.c_str(), sizeof(hdr.type_) - 1);
+
+	// the bits start, and the file ends, on a cache line (cf. init_db)
+	const uint64_t align = warthog::GRIDMAP_ALIGN;
+	hdr.db_offset_ = (sizeof(hdr) + align - 1) & ~(align - 1);
+	uint64_t db_bytes = sizeof(warthog::dbword) * (uint64_t)db_size_;
+	uint64_t tail = ((db_bytes + align - 1) & ~(align - 1)) - db_bytes;
+
+	const char zeros[warthog::GRIDMAP_ALIGN] = {0};
+	out.write((char*)&hdr, sizeof(hdr));
+	out.write(zeros, hdr.db_offset_ - sizeof(hdr));
+	out.write((char*)db_, db_bytes);
+	out.write(zeros, tail);
+	if(!out.good())
+	{
+		std::cerr << "err; while writing binary gridmap" << std::endl;
+		return false;
+	}
+	return true;
 }
 
 void 
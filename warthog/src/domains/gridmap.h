@@ -14,6 +14,12 @@
 // in a one dimensional array and also to avoid range checks when trying to 
 // identify invalid neighbours of tiles on the edge of the map.
 //
+// Besides the ASCII format of the GPPC, a gridmap can be saved in a binary
+// format (cf. gridmap_file_header) that holds the padded bit array as it is
+// in memory. Loading such a file maps it read-only and parses nothing; the
+// pages are shared by every process that maps the same file, until the
+// map is modified (set_label, invert): it is then copied into memory.
+//
 // @author: dharabor
 // @created: 08/08/2012
 // 
@@ -22,19 +28,54 @@
 #include "grid.h"
 #include "gm_parser.h"
 #include "helpers.h"
+#include "mapped_file.h"
 
 #include <climits>
+#include <memory>
+#include <ostream>
 #include "stdint.h"
 
 namespace warthog
 {
 
 const uint32_t GRID_ID_MAX = (uint32_t)warthog::SN_ID_MAX;
+
+// header of a binary gridmap file. the padded bit array (db_size_ dbwords
+// of dbword_bits_ each, little endian) follows at offset db_offset_. the
+// padding is that of a map of height_ x width_ tiles (cf. gridmap::init_db)
+// and the file ends on a cache line.
+struct gridmap_file_header
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t dbword_bits_;
+    uint32_t height_;
+    uint32_t width_;
+    uint32_t padded_height_;
+    uint32_t padded_width_;
+    uint32_t padded_rows_before_first_row_;
+    uint32_t padded_rows_after_last_row_;
+    uint32_t dbwidth_;
+    uint32_t dbheight_;
+    uint32_t db_size_;
+    uint32_t num_traversable_;
+    uint64_t db_offset_;
+    char type_[16];
+};
+
+static const char GRIDMAP_FILE_MAGIC[8] = {'W', 'H', 'G', 'R', 'I', 'D', 'B', 'N'};
+static const uint32_t GRIDMAP_FILE_VERSION = 1;
+
 class gridmap
 {
 	public:
 		gridmap(uint32_t height, uint32_t width);
+
+		// @param filename is a map in the ASCII or in the binary format
 		gridmap(const char* filename);
+
+		// a copy of the tiles of @param other, held in memory
+		gridmap(const warthog::gridmap& other);
 		~gridmap();
 
 		// here we convert from the coordinate space of 
@@ -101,11 +142,24 @@ class gridmap
 			uint32_t pos2 = dbindex;
 			uint32_t pos3 = dbindex + dbwidth_;
 
-			// read from the byte just before node_id and shift down until the
-			// nei adjacent to node_id is in the lowest position
-			tiles[0] = (uint8_t)(*((uint32_t*)(db_+(pos1-1))) >> (bit_offset+7));
-			tiles[1] = (uint8_t)(*((uint32_t*)(db_+(pos2-1))) >> (bit_offset+7));
-			tiles[2] = (uint8_t)(*((uint32_t*)(db_+(pos3-1))) >> (bit_offset+7));
+			if(sizeof(warthog::dbword) == 1)
+			{
+				// read from the byte just before node_id and shift down until
+				// the nei adjacent to node_id is in the lowest position
+				tiles[0] = (uint8_t)(*((uint32_t*)(db_+(pos1-1))) >> (bit_offset+7));
+				tiles[1] = (uint8_t)(*((uint32_t*)(db_+(pos2-1))) >> (bit_offset+7));
+				tiles[2] = (uint8_t)(*((uint32_t*)(db_+(pos3-1))) >> (bit_offset+7));
+				return;
+			}
+
+			// wider dbwords: the nei just before node_id may be in the 
+			// previous dbword; read from the dbword that holds it
+			uint32_t prev_id = grid_id_p - 1;
+			bit_offset = prev_id & warthog::DBWORD_BITS_MASK;
+			pos2 = prev_id >> warthog::LOG2_DBWORD_BITS;
+			tiles[0] = (uint8_t)read_64bit(pos2 - dbwidth_, bit_offset);
+			tiles[1] = (uint8_t)read_64bit(pos2, bit_offset);
+			tiles[2] = (uint8_t)read_64bit(pos2 + dbwidth_, bit_offset);
 		}
 
 		// fetches a contiguous set of tiles from three adjacent rows. each row is
@@ -127,9 +181,53 @@ class gridmap
 
 			// read 32bits of memory; grid_id_p is in the 
 			// lowest bit position of tiles[1]
-			tiles[0] = (uint32_t)(*((uint64_t*)(db_+pos1)) >> (bit_offset));
-			tiles[1] = (uint32_t)(*((uint64_t*)(db_+pos2)) >> (bit_offset));
-			tiles[2] = (uint32_t)(*((uint64_t*)(db_+pos3)) >> (bit_offset));
+			if(sizeof(warthog::dbword) == 1)
+			{
+				tiles[0] = (uint32_t)(*((uint64_t*)(db_+pos1)) >> (bit_offset));
+				tiles[1] = (uint32_t)(*((uint64_t*)(db_+pos2)) >> (bit_offset));
+				tiles[2] = (uint32_t)(*((uint64_t*)(db_+pos3)) >> (bit_offset));
+				return;
+			}
+			tiles[0] = (uint32_t)read_64bit(pos1, bit_offset);
+			tiles[1] = (uint32_t)read_64bit(pos2, bit_offset);
+			tiles[2] = (uint32_t)read_64bit(pos3, bit_offset);
+		}
+
+		// similar to get_neighbours_32bit but reads 64 tiles from each row.
+		// grid_id_p is in the lowest bit position of tiles[1]. the bits
+		// that the shift by bit_offset vacates are filled from the next
+		// dbword along.
+		inline void
+		get_neighbours_64bit(uint32_t grid_id_p, uint64_t tiles[3])
+		{
+			uint32_t bit_offset = (grid_id_p & warthog::DBWORD_BITS_MASK);
+			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+
+			uint32_t pos1 = dbindex - dbwidth_;
+			uint32_t pos2 = dbindex;
+			uint32_t pos3 = dbindex + dbwidth_;
+
+			tiles[0] = read_64bit(pos1, bit_offset);
+			tiles[1] = read_64bit(pos2, bit_offset);
+			tiles[2] = read_64bit(pos3, bit_offset);
+		}
+
+		// similar to get_neighbours_64bit but grid_id_p is placed into the
+		// highest bit position of tiles[1]. the counterpart of
+		// get_neighbours_upper_32bit.
+		inline void
+		get_neighbours_upper_64bit(uint32_t grid_id_p, uint64_t tiles[3])
+		{
+			uint32_t bit_offset = (grid_id_p & warthog::DBWORD_BITS_MASK);
+			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+
+			uint32_t pos1 = dbindex - dbwidth_;
+			uint32_t pos2 = dbindex;
+			uint32_t pos3 = dbindex + dbwidth_;
+
+			tiles[0] = read_upper_64bit(pos1, bit_offset);
+			tiles[1] = read_upper_64bit(pos2, bit_offset);
+			tiles[2] = read_upper_64bit(pos3, bit_offset);
 		}
 
 		// similar to get_neighbours_32bit but grid_id_p is placed into the
@@ -142,6 +240,16 @@ class gridmap
 			// 2. convert grid_id_p into a dbword index.
 			uint32_t bit_offset = (grid_id_p & warthog::DBWORD_BITS_MASK);
 			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
+
+			if(sizeof(warthog::dbword) != 1)
+			{
+				uint32_t pos1 = dbindex - dbwidth_;
+				uint32_t pos3 = dbindex + dbwidth_;
+				tiles[0] = (uint32_t)(read_upper_64bit(pos1, bit_offset) >> 32);
+				tiles[1] = (uint32_t)(read_upper_64bit(dbindex, bit_offset) >> 32);
+				tiles[2] = (uint32_t)(read_upper_64bit(pos3, bit_offset) >> 32);
+				return;
+			}
 			
 			// start reading from a prior index. this way everything
 			// up to grid_id_p is cached.
@@ -171,7 +279,7 @@ class gridmap
 		get_label(uint32_t grid_id_p)
 		{
 			// now we can fetch the label
-			uint32_t bitmask = 1;
+			warthog::dbword bitmask = 1;
 			bitmask <<=  (grid_id_p & warthog::DBWORD_BITS_MASK);
 			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
 			if(dbindex > max_id_) { return 0; }
@@ -198,9 +306,11 @@ class gridmap
 		set_label(uint32_t grid_id_p, bool label)
 		{
 			uint32_t dbindex = grid_id_p >> warthog::LOG2_DBWORD_BITS;
-			uint32_t bitmask = 1u << (grid_id_p & warthog::DBWORD_BITS_MASK);
+			warthog::dbword bitmask = 
+				(warthog::dbword)1 << (grid_id_p & warthog::DBWORD_BITS_MASK);
 
 			if(dbindex > max_id_) { return; }
+			if(file_) { copy_mapped(); }
 
 			if(label)
 			{
@@ -230,6 +340,13 @@ class gridmap
 			return this->padded_width_;
 		}
 
+		// the number of dbwords in each (padded) row
+		inline uint32_t
+		dbwidth() const
+		{
+			return this->dbwidth_;
+		}
+
 		inline uint32_t 
 		header_height()
 		{
@@ -258,6 +375,7 @@ class gridmap
         inline void
         invert()
         {
+            if(file_) { copy_mapped(); }
             for(unsigned int i=0; i < db_size_; i++)
             {
                 db_[i] = (warthog::dbword)~db_[i];
@@ -265,6 +383,14 @@ class gridmap
         }
 
 
+		// save the map in the binary format; @return false on error
+		bool
+		write_binary(std::ostream& out);
+
+		// @return true if the map is backed by a mapped binary file
+		inline bool
+		is_mapped() { return file_ != nullptr; }
+
 		void 
 		print(std::ostream&);
 		
@@ -274,8 +400,9 @@ class gridmap
 		size_t 
 		mem()
 		{
+			// mapped pages are shared, not owned
 			return sizeof(*this) +
-			sizeof(warthog::dbword) * db_size_;
+			(file_ ? 0 : sizeof(warthog::dbword) * db_size_);
 		}
 
 
@@ -295,10 +422,41 @@ class gridmap
 		uint32_t padded_rows_after_last_row_;
 		uint32_t max_id_;
         uint32_t num_traversable_;
+		std::shared_ptr<warthog::util::mapped_file> file_;
+
+		// 64 tiles starting at bit @param bit_offset of dbword @param pos.
+		// shifting in two steps avoids an undefined shift by 64 when
+		// bit_offset is zero.
+		inline uint64_t
+		read_64bit(uint32_t pos, uint32_t bit_offset)
+		{
+			const uint32_t words = sizeof(uint64_t) / sizeof(warthog::dbword);
+			return (*((uint64_t*)(db_+pos)) >> bit_offset) |
+				(((uint64_t)db_[pos+words] << 1) << (63 - bit_offset));
+		}
+
+		// 64 tiles ending at bit @param bit_offset of dbword @param pos
+		inline uint64_t
+		read_upper_64bit(uint32_t pos, uint32_t bit_offset)
+		{
+			const uint32_t words = sizeof(uint64_t) / sizeof(warthog::dbword);
+			const uint32_t word_bits = warthog::DBWORD_BITS_MASK + 1;
+			pos = pos - (words - 1);
+			return (*((uint64_t*)(db_+pos)) << (word_bits - 1 - bit_offset)) |
+				(((uint64_t)db_[pos-1] >> 1) >> bit_offset);
+		}
 
-		gridmap(const warthog::gridmap& other) {}
 		gridmap& operator=(const warthog::gridmap& other) { return *this; }
 		void init_db();
+
+		// the padding of the map, from its width and height
+		void init_layout();
+
+		// replace the mapped tiles with a copy, before they are modified
+		void copy_mapped();
+
+		// load @param filename if it is a binary gridmap file
+		bool load_binary(const char* filename);
 };
 
 }
@@ -0,0 +1,460 @@
+#include "jump_point_db.h"
+#include "subgoal_graph.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+
+// shared by the workers of both passes
+struct preproc_data
+{
+    warthog::subgoal_graph* sg_;
+    warthog::gridmap* map_;
+    const std::vector<uint32_t>* index_;
+    std::vector<uint8_t>* clearance_;
+
+    // the neighbours of the subgoals in each block, and their number for
+    // each subgoal
+    std::vector<std::vector<uint32_t>>* edges_;
+    std::vector<uint32_t>* degree_;
+};
+
+// clearances are counted along a line of tiles, starting from its far end:
+// @param first is the padded id of the last tile in direction c and
+// @param step leads back, away from c, over @param length tiles
+void
+count_clearances(preproc_data* shared, uint32_t first, int32_t step,
+        uint32_t length, uint32_t c)
+{
+    warthog::gridmap* map = shared->map_;
+    uint32_t count = 0;
+    uint32_t id = first;
+    for(uint32_t i = 0; i < length; i++, id += (uint32_t)step)
+    {
+        if(!map->get_label(id) || (*shared->index_)[id] != warthog::INF32)
+        {
+            count = 0;
+            continue;
+        }
+        count++;
+        (*shared->clearance_)[id*4 + c/2] = (uint8_t)
+            (count <= 255 ? count : 0);
+    }
+}
+
+// first pass: each task is a row of the map, for east and west, or a
+// column, for north and south
+void*
+clearance_worker(void* arg)
+{
+    warthog::helpers::thread_params* par =
+        (warthog::helpers::thread_params*)arg;
+    preproc_data* shared = (preproc_data*)par->shared_;
+    warthog::gridmap* map = shared->map_;
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    int32_t pw = (int32_t)map->width();
+
+    for(uint32_t task = par->thread_id_; task < w + h;
+            task += par->max_threads_)
+    {
+        if(task < h)
+        {
+            count_clearances(shared, map->to_padded_id(0, task), 1, w, 6);
+            count_clearances(shared, map->to_padded_id(w - 1, task), -1, w, 2);
+        }
+        else
+        {
+            uint32_t x = task - h;
+            count_clearances(shared, map->to_padded_id(x, 0), pw, h, 0);
+            count_clearances(shared, map->to_padded_id(x, h - 1), -pw, h, 4);
+        }
+        par->nprocessed_++;
+    }
+    return 0;
+}
+
+// second pass: each task is a block of consecutive subgoals
+const uint32_t LINK_BLOCK = 256;
+
+void*
+link_worker(void* arg)
+{
+    warthog::helpers::thread_params* par =
+        (warthog::helpers::thread_params*)arg;
+    preproc_data* shared = (preproc_data*)par->shared_;
+    warthog::subgoal_graph* sg = shared->sg_;
+    uint32_t num_blocks = (uint32_t)shared->edges_->size();
+
+    for(uint32_t task = par->thread_id_; task < num_blocks;
+            task += par->max_threads_)
+    {
+        std::vector<uint32_t>& edges = shared->edges_->at(task);
+        uint32_t first = task * LINK_BLOCK;
+        uint32_t last = std::min(first + LINK_BLOCK, sg->get_num_subgoals());
+        for(uint32_t i = first; i < last; i++)
+        {
+            size_t before = edges.size();
+            sg->direct_h_reachable(sg->subgoal(i), edges);
+            (*shared->degree_)[i] = (uint32_t)(edges.size() - before);
+        }
+        par->nprocessed_++;
+    }
+    return 0;
+}
+
+}
+
+warthog::subgoal_graph::subgoal_graph(warthog::gridmap* map)
+    : map_(map), width_(map->width()), num_subgoals_(0), num_edges_(0),
+      subgoals_(0), offsets_(0), edges_(0)
+{
+    int32_t w = (int32_t)width_;
+    int32_t dx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    int32_t dy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+    for(uint32_t d = 0; d < 8; d++) { delta_[d] = dy[d] * w + dx[d]; }
+
+    identify_subgoals();
+    if(map_->filename()[0] == '\0')
+    {
+        preproc();
+        return;
+    }
+    std::string fname = std::string(map_->filename()) + ".sg";
+    if(load(fname.c_str())) { return; }
+    preproc();
+    save(fname.c_str());
+}
+
+warthog::subgoal_graph::~subgoal_graph()
+{
+}
+
+void
+warthog::subgoal_graph::identify_subgoals()
+{
+    index_.assign(map_->padded_mapsize(), warthog::INF32);
+    owned_.clear();
+    for(uint32_t y = 0; y < map_->header_height(); y++)
+    {
+        for(uint32_t x = 0; x < map_->header_width(); x++)
+        {
+            uint32_t id = map_->to_padded_id(x, y);
+            if(!traversable(id)) { continue; }
+
+            // a corner: a blocked diagonal neighbour, and both cardinal
+            // neighbours next to it traversable
+            for(uint32_t d = 1; d < 8; d += 2)
+            {
+                if(!traversable(id + delta_[d]) &&
+                   traversable(id + delta_[d - 1]) &&
+                   traversable(id + delta_[(d + 1) & 7]))
+                {
+                    index_[id] = (uint32_t)owned_.size();
+                    owned_.push_back(id);
+                    break;
+                }
+            }
+        }
+    }
+    num_subgoals_ = (uint32_t)owned_.size();
+    subgoals_ = owned_.data();
+
+    clearance_.assign(4 * (size_t)map_->padded_mapsize(), 0);
+    preproc_data shared = {this, map_, &index_, &clearance_, 0, 0};
+    warthog::helpers::parallel_compute(clearance_worker, &shared,
+            map_->header_width() + map_->header_height());
+}
+
+void
+warthog::subgoal_graph::preproc()
+{
+    warthog::timer t;
+    t.start();
+
+    std::vector<std::vector<uint32_t>> edges(
+            (num_subgoals_ + LINK_BLOCK - 1) / LINK_BLOCK);
+    std::vector<uint32_t> degree(num_subgoals_);
+    preproc_data shared = {this, map_, &index_, &clearance_, &edges, &degree};
+    warthog::helpers::parallel_compute(link_worker, &shared,
+            (uint32_t)edges.size());
+
+    // subgoals, then offsets, then edges, in one array
+    num_edges_ = 0;
+    for(uint32_t i = 0; i < num_subgoals_; i++) { num_edges_ += degree[i]; }
+    owned_.resize(num_subgoals_);
+    owned_.reserve(2 * (size_t)num_subgoals_ + 1 + num_edges_);
+    uint32_t offset = 0;
+    for(uint32_t i = 0; i < num_subgoals_; i++)
+    {
+        owned_.push_back(offset);
+        offset += degree[i];
+    }
+    owned_.push_back(offset);
+    for(std::vector<uint32_t>& block : edges)
+    {
+        owned_.insert(owned_.end(), block.begin(), block.end());
+    }
+    subgoals_ = owned_.data();
+    offsets_ = subgoals_ + num_subgoals_;
+    edges_ = offsets_ + num_subgoals_ + 1;
+
+    t.stop();
+    std::cerr << "subgoal graph computed in "
+        << t.elapsed_time_micro() / 1e6 << "s; subgoals=" << num_subgoals_
+        << " edges=" << num_edges_ << std::endl;
+}
+
+void
+warthog::subgoal_graph::direct_h_reachable(uint32_t origin,
+        std::vector<uint32_t>& out)
+{
+    // the number of free steps from the origin in each direction; north
+    // is repeated at the end
+    uint32_t clear[9];
+
+    // straight lines, up to the first obstacle or subgoal
+    for(uint32_t c = 0; c < 8; c += 2)
+    {
+        clear[c] = 0;
+        uint32_t id = origin + delta_[c];
+        while(traversable(id) && !is_subgoal(id))
+        {
+            id += delta_[c];
+            clear[c]++;
+        }
+        if(is_subgoal(id)) { out.push_back(id); }
+    }
+    clear[8] = clear[0];
+
+    // diagonal lines, with no corner cutting. the cardinal neighbours
+    // crossed by the step onto id are its neighbours in directions d+3
+    // and d+5
+    for(uint32_t d = 1; d < 8; d += 2)
+    {
+        clear[d] = 0;
+        uint32_t id = origin + delta_[d];
+        while(traversable(id) && !is_subgoal(id) &&
+              traversable(id + delta_[(d + 3) & 7]) &&
+              traversable(id + delta_[(d + 5) & 7]))
+        {
+            id += delta_[d];
+            clear[d]++;
+        }
+        if(is_subgoal(id) &&
+           traversable(id + delta_[(d + 3) & 7]) &&
+           traversable(id + delta_[(d + 5) & 7]))
+        {
+            out.push_back(id);
+        }
+    }
+
+    // the straight and diagonal lines cut the area around the origin into
+    // eight parts. each is swept from the tiles of its diagonal line, in
+    // its cardinal direction; a sweep never goes further than the one
+    // before it
+    for(uint32_t d = 1; d < 8; d += 2)
+    {
+        for(uint32_t c = d - 1; c <= d + 1; c += 2)
+        {
+            uint32_t max_ext = clear[c] + 1;
+            uint32_t id = origin;
+            for(uint32_t i = 1; i <= clear[d]; i++)
+            {
+                id += delta_[d];
+                uint32_t ext = total_clearance(id, c & 7);
+                if(ext < max_ext)
+                {
+                    uint32_t end = id + (uint32_t)(delta_[c & 7] * (int32_t)ext);
+                    if(is_subgoal(end)) { out.push_back(end); }
+                    max_ext = ext;
+                }
+            }
+        }
+    }
+}
+
+bool
+warthog::subgoal_graph::h_reachable(uint32_t from, uint32_t to)
+{
+    int32_t x, y, x2, y2;
+    warthog::helpers::index_to_xy(from, width_, x, y);
+    warthog::helpers::index_to_xy(to, width_, x2, y2);
+    uint32_t dx = (uint32_t)abs(x - x2);
+    uint32_t dy = (uint32_t)abs(y - y2);
+
+    // every octile path makes the same number of moves in one cardinal
+    // and one diagonal direction, in some order
+    uint32_t num_moves = std::max(dx, dy);
+    uint32_t num_diag = std::min(dx, dy);
+    uint32_t num_card = num_moves - num_diag;
+    uint32_t c = dx > dy ? (x < x2 ? 2 : 6) : (y < y2 ? 4 : 0);
+    uint32_t d = x < x2 ? (y < y2 ? 3 : 1) : (y < y2 ? 5 : 7);
+
+    // a depth-first search over the order of the moves; diag[i] is the
+    // number of diagonal moves among the first i, or -1 if the i-th
+    // tile has not been reached. a tile is never entered twice with the
+    // same number of diagonal moves, nor with fewer after backtracking
+    std::vector<int32_t> diag(num_moves + 1, -1);
+    diag[0] = 0;
+    uint32_t id = from;
+    uint32_t i = 0;
+    while(i < num_moves)
+    {
+        if(i - diag[i] < num_card && diag[i + 1] < diag[i] &&
+           traversable(id + delta_[c]))
+        {
+            diag[i + 1] = diag[i];
+            id += delta_[c];
+            i++;
+        }
+        else if((uint32_t)diag[i] < num_diag && diag[i + 1] <= diag[i] &&
+                traversable(id + delta_[d]) &&
+                traversable(id + delta_[d - 1]) &&
+                traversable(id + delta_[(d + 1) & 7]))
+        {
+            diag[i + 1] = diag[i] + 1;
+            id += delta_[d];
+            i++;
+        }
+        else
+        {
+            if(i == 0) { return false; }
+            i--;
+            id -= diag[i] == diag[i + 1] ? delta_[c] : delta_[d];
+        }
+    }
+    return true;
+}
+
+bool
+warthog::subgoal_graph::load(const char* filename)
+{
+    std::cerr << "loading " << filename << "... ";
+    std::shared_ptr<warthog::util::mapped_file> file =
+        std::make_shared<warthog::util::mapped_file>(filename);
+    if(!file->good())
+    {
+        std::cerr << "no dice. oh well. keep going.\n";
+        return false;
+    }
+
+    subgoal_graph_header hdr;
+    if(file->size() < sizeof(hdr))
+    {
+        std::cerr << "not a subgoal graph; rebuilding.\n";
+        return false;
+    }
+    memcpy(&hdr, file->data(), sizeof(hdr));
+    if(memcmp(hdr.magic_, SUBGOAL_GRAPH_MAGIC, sizeof(hdr.magic_)) != 0 ||
+       hdr.version_ != SUBGOAL_GRAPH_VERSION)
+    {
+        std::cerr << "not a subgoal graph of version "
+            << SUBGOAL_GRAPH_VERSION << "; rebuilding.\n";
+        return false;
+    }
+
+    // subgoals and edges are padded ids (cf. jump_point_db::load)
+    if(hdr.dbword_bits_ != warthog::DBWORD_BITS ||
+       hdr.header_height_ != map_->header_height() ||
+       hdr.header_width_ != map_->header_width() ||
+       hdr.padded_height_ != map_->height() ||
+       hdr.padded_width_ != map_->width() ||
+       hdr.map_hash_ != warthog::jump_point_db::hash_map(map_) ||
+       hdr.num_subgoals_ != num_subgoals_)
+    {
+        std::cerr << "graph does not match the map; rebuilding.\n";
+        return false;
+    }
+
+    uint64_t subgoals_bytes = sizeof(uint32_t) * (uint64_t)hdr.num_subgoals_;
+    uint64_t offsets_bytes = subgoals_bytes + sizeof(uint32_t);
+    uint64_t edges_bytes = sizeof(uint32_t) * (uint64_t)hdr.num_edges_;
+    if(hdr.subgoals_offset_ % sizeof(uint64_t) != 0 ||
+       hdr.offsets_offset_ != hdr.subgoals_offset_ + subgoals_bytes ||
+       hdr.edges_offset_ != hdr.offsets_offset_ + offsets_bytes ||
+       hdr.edges_offset_ + edges_bytes > file->size() ||
+       warthog::helpers::fnv64(file->data() + hdr.subgoals_offset_,
+           subgoals_bytes + offsets_bytes + edges_bytes) != hdr.checksum_)
+    {
+        std::cerr << "graph is corrupt; rebuilding.\n";
+        return false;
+    }
+
+    const uint32_t* subgoals =
+        (const uint32_t*)(file->data() + hdr.subgoals_offset_);
+    const uint32_t* offsets =
+        (const uint32_t*)(file->data() + hdr.offsets_offset_);
+    if(memcmp(subgoals, subgoals_, subgoals_bytes) != 0 ||
+       offsets[hdr.num_subgoals_] != hdr.num_edges_)
+    {
+        std::cerr << "graph does not match the map; rebuilding.\n";
+        return false;
+    }
+
+    file_ = file;
+    num_edges_ = hdr.num_edges_;
+    subgoals_ = subgoals;
+    offsets_ = offsets;
+    edges_ = (const uint32_t*)(file->data() + hdr.edges_offset_);
+    std::vector<uint32_t>().swap(owned_);
+    std::cerr << "#subgoals=" << num_subgoals_ << " #edges=" << num_edges_
+        << std::endl;
+    return true;
+}
+
+bool
+warthog::subgoal_graph::save(const char* filename)
+{
+    std::cerr << "saving to file " << filename << "; subgoals="
+        << num_subgoals_ << " edges=" << num_edges_ << std::endl;
+
+    uint64_t subgoals_bytes = sizeof(uint32_t) * (uint64_t)num_subgoals_;
+    uint64_t offsets_bytes = subgoals_bytes + sizeof(uint32_t);
+    uint64_t edges_bytes = sizeof(uint32_t) * (uint64_t)num_edges_;
+
+    subgoal_graph_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic_, SUBGOAL_GRAPH_MAGIC, sizeof(hdr.magic_));
+    hdr.version_ = SUBGOAL_GRAPH_VERSION;
+    hdr.dbword_bits_ = warthog::DBWORD_BITS;
+    hdr.header_height_ = map_->header_height();
+    hdr.header_width_ = map_->header_width();
+    hdr.padded_height_ = map_->height();
+    hdr.padded_width_ = map_->width();
+    hdr.map_hash_ = warthog::jump_point_db::hash_map(map_);
+    hdr.num_subgoals_ = num_subgoals_;
+    hdr.num_edges_ = num_edges_;
+    hdr.subgoals_offset_ = sizeof(hdr);
+    hdr.offsets_offset_ = hdr.subgoals_offset_ + subgoals_bytes;
+    hdr.edges_offset_ = hdr.offsets_offset_ + offsets_bytes;
+
+    // the three arrays are adjacent, in memory as in the file
+    hdr.checksum_ = warthog::helpers::fnv64(subgoals_,
+            subgoals_bytes + offsets_bytes + edges_bytes);
+
+    // write a temporary file and rename it, so that a process loading the
+    // graph never sees it half written
+    std::string tmpname = std::string(filename) + ".tmp";
+    std::ofstream out(tmpname, std::ios_base::out | std::ios_base::binary);
+    out.write((char*)&hdr, sizeof(hdr));
+    out.write((const char*)subgoals_, subgoals_bytes);
+    out.write((const char*)offsets_, offsets_bytes);
+    out.write((const char*)edges_, edges_bytes);
+    out.close();
+    if(!out.good() || rename(tmpname.c_str(), filename) != 0)
+    {
+        std::cerr << "err; cannot write subgoal graph to file "
+            << filename << ". oh well. try to keep going.\n";
+        remove(tmpname.c_str());
+        return false;
+    }
+    std::cerr << "subgoal graph saved to disk. file=" << filename
+        << std::endl;
+    return true;
+}
@@ -0,0 +1,210 @@
+#ifndef WARTHOG_SUBGOAL_GRAPH_H
+#define WARTHOG_SUBGOAL_GRAPH_H
+
+// subgoal_graph.h
+//
+// A simple subgoal graph [Uras, Koenig & Hernandez, 2013] for an 8-connected
+// gridmap with uniform costs. Subgoals are placed at the convex corners of
+// obstacles: every traversable tile with a blocked diagonal neighbour whose
+// two adjacent cardinal neighbours are both traversable. Two subgoals are
+// joined by an edge if they are direct-h-reachable: some shortest path
+// between them on the grid has octile length and passes no other subgoal.
+// The edge costs the octile distance between its ends, and any shortest
+// path on the grid can be found as a path in the graph once the start and
+// the target are joined, in the same way, to the subgoals around them (cf.
+// subgoal_graph_expansion_policy).
+//
+// Subgoals are identified by their padded ids; edges are stored in
+// compressed rows, indexed by the position of the subgoal in the list of
+// subgoals (cf. ::index). To find the direct-h-reachable subgoals of a tile
+// quickly we keep, for each tile and each cardinal direction, the number of
+// steps to the first obstacle or subgoal.
+//
+// The edges are saved next to the map, as [map file].sg, and mapped
+// read-only when loaded; subgoals and clearances take one pass over the map
+// and are always recomputed. As with jump_point_db the file has a versioned
+// header, is checked against the map and its own checksum, and is rebuilt
+// when it does not match. Construction is shared among all cores: each
+// core scans a set of rows and columns for clearances, then finds the
+// neighbours of a set of subgoals.
+//
+// The graph is not pruned: the N-level subgoal graphs of the original
+// implementation (other/gppc-2014/NLevelSubgoalGraphs) are not included.
+//
+// [Uras, Koenig & Hernandez, 2013, Subgoal Graphs for Optimal Pathfinding
+// in Eight-Neighbor Grids, ICAPS]
+//
+
+#include "constants.h"
+#include "gridmap.h"
+#include "helpers.h"
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace warthog
+{
+
+struct subgoal_graph_header
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t dbword_bits_;
+    uint32_t header_height_;
+    uint32_t header_width_;
+    uint32_t padded_height_;
+    uint32_t padded_width_;
+    uint64_t map_hash_;             // cf. jump_point_db::hash_map
+    uint32_t num_subgoals_;
+    uint32_t num_edges_;
+    uint64_t subgoals_offset_;
+    uint64_t offsets_offset_;
+    uint64_t edges_offset_;
+    uint64_t checksum_;             // helpers::fnv64 of the three arrays
+};
+
+static const char SUBGOAL_GRAPH_MAGIC[8] = {'W', 'H', 'S', 'U', 'B', 'G', 'R', 'F'};
+static const uint32_t SUBGOAL_GRAPH_VERSION = 1;
+
+class subgoal_graph
+{
+    public:
+        // loads the graph of @param map from disk or, if there is no valid
+        // one, builds it and saves it. the graph of a map that was not
+        // read from a file is built and kept in memory.
+        subgoal_graph(warthog::gridmap* map);
+        ~subgoal_graph();
+
+        inline warthog::gridmap*
+        get_map() { return map_; }
+
+        inline uint32_t
+        get_num_subgoals() { return num_subgoals_; }
+
+        inline uint32_t
+        get_num_edges() { return num_edges_; }
+
+        // the position of the subgoal at @param padded_id in the list of
+        // subgoals, or INF32 if there is no subgoal there
+        inline uint32_t
+        index(uint32_t padded_id) { return index_[padded_id]; }
+
+        // the padded id of the subgoal at position @param index
+        inline uint32_t
+        subgoal(uint32_t index) { return subgoals_[index]; }
+
+        // the neighbours (padded ids) of the subgoal at @param index are
+        // in [edges_begin, edges_end)
+        inline const uint32_t*
+        edges_begin(uint32_t index) { return edges_ + offsets_[index]; }
+
+        inline const uint32_t*
+        edges_end(uint32_t index) { return edges_ + offsets_[index + 1]; }
+
+        // @return true if the graph is mapped from disk
+        inline bool
+        is_mapped() { return file_ != nullptr; }
+
+        // the octile distance between two padded ids
+        inline double
+        octile(uint32_t id, uint32_t id2)
+        {
+            int32_t x, y, x2, y2;
+            warthog::helpers::index_to_xy(id, width_, x, y);
+            warthog::helpers::index_to_xy(id2, width_, x2, y2);
+            int32_t dx = abs(x - x2);
+            int32_t dy = abs(y - y2);
+            if(dx < dy) { return dx * warthog::DBL_ROOT_TWO + (dy - dx); }
+            return dy * warthog::DBL_ROOT_TWO + (dx - dy);
+        }
+
+        // append to @param out the subgoals (padded ids) direct-h-reachable
+        // from the traversable tile @param padded_id
+        void
+        direct_h_reachable(uint32_t padded_id, std::vector<uint32_t>& out);
+
+        // @return true if there is a path of octile length between the
+        // tiles @param from and @param to
+        bool
+        h_reachable(uint32_t from, uint32_t to);
+
+        // replace the graph with the one in @param filename; @return false
+        // (and leave the graph unchanged) if the file is not a valid graph
+        // for the current map
+        bool
+        load(const char* filename);
+
+        bool
+        save(const char* filename);
+
+        size_t
+        mem()
+        {
+            return sizeof(*this) +
+                (sizeof(uint32_t) + 4) * index_.size() +
+                (file_ ? 0 : sizeof(uint32_t) *
+                 (2 * (size_t)num_subgoals_ + 1 + num_edges_));
+        }
+
+    private:
+        warthog::gridmap* map_;
+        uint32_t width_;
+        int32_t delta_[8];              // N, NE, E, SE, S, SW, W, NW
+
+        uint32_t num_subgoals_;
+        uint32_t num_edges_;
+        const uint32_t* subgoals_;
+        const uint32_t* offsets_;
+        const uint32_t* edges_;
+        std::vector<uint32_t> owned_;   // the three arrays, unless mapped
+        std::shared_ptr<warthog::util::mapped_file> file_;
+
+        // per padded id: the subgoal index (cf. ::index) and the number of
+        // steps to the first obstacle or subgoal in each cardinal
+        // direction, or 0 if it is more than CLEARANCE_LIMIT steps
+        std::vector<uint32_t> index_;
+        std::vector<uint8_t> clearance_;
+        static const uint32_t CLEARANCE_LIMIT = 255;
+
+        inline bool
+        traversable(uint32_t padded_id)
+        { return map_->get_label(padded_id); }
+
+        inline bool
+        is_subgoal(uint32_t padded_id)
+        { return index_[padded_id] != warthog::INF32; }
+
+        // steps from the tile @param padded_id, which is neither an
+        // obstacle nor a subgoal, to the first tile that is, in the
+        // cardinal direction @param c
+        inline uint32_t
+        total_clearance(uint32_t padded_id, uint32_t c)
+        {
+            uint32_t total = 0;
+            while(clearance_[padded_id*4 + c/2] == 0)
+            {
+                padded_id += (uint32_t)(delta_[c] * (int32_t)CLEARANCE_LIMIT);
+                total += CLEARANCE_LIMIT;
+            }
+            return total + clearance_[padded_id*4 + c/2];
+        }
+
+        // find the subgoals and the clearances of the map
+        void
+        identify_subgoals();
+
+        // build the edges of every subgoal
+        void
+        preproc();
+
+        subgoal_graph(const subgoal_graph& other) { }
+        subgoal_graph&
+        operator=(const subgoal_graph& other) { return *this; }
+};
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include "tiled_gridmap.h"
+
+#include <cstdlib>
+#include <cstring>
+
+warthog::tiled_gridmap::tiled_gridmap(uint32_t h, uint32_t w)
+    : header_(h, w, "octile")
+{
+    init_db();
+}
+
+warthog::tiled_gridmap::tiled_gridmap(const char* filename)
+{
+    warthog::gm_parser parser(filename);
+    header_ = parser.get_header();
+    init_db();
+
+    num_traversable_ = 0;
+    for(uint32_t i = 0; i < parser.get_num_tiles(); i++)
+    {
+        switch(parser.get_tile_at(i))
+        {
+            case 'S':
+            case 'W':
+            case 'T':
+            case '@':
+            case 'O': // these terrain types are obstacles
+                break;
+            default: // everything else is traversable
+                set_label(to_tiled_id(i), 1);
+                num_traversable_++;
+                break;
+        }
+    }
+}
+
+warthog::tiled_gridmap::~tiled_gridmap()
+{
+    free(db_);
+}
+
+void
+warthog::tiled_gridmap::init_db()
+{
+    const uint32_t block = 1u << TGM_LOG2_BLOCK;
+    uint32_t blocks_x = (header_.width_ + block - 1) >> TGM_LOG2_BLOCK;
+    uint32_t blocks_y = (header_.height_ + block - 1) >> TGM_LOG2_BLOCK;
+    if(blocks_x == 0) { blocks_x = 1; }
+    if(blocks_y == 0) { blocks_y = 1; }
+    log2_bw_ = 0;
+    while((1u << log2_bw_) < blocks_x) { log2_bw_++; }
+    bw_mask_ = (1u << log2_bw_) - 1;
+
+    // every block is 1024 words, i.e. 8KB; the array starts on a page
+    num_words_ = ((size_t)blocks_y << log2_bw_) * 1024;
+    size_t db_bytes = num_words_ * sizeof(uint64_t);
+    db_ = (uint64_t*)aligned_alloc(4096, db_bytes);
+    memset(db_, 0, db_bytes);
+    num_traversable_ = 0;
+}
+
+void
+warthog::tiled_gridmap::print(std::ostream& out)
+{
+    out << "type " << header_.type_ << std::endl;
+    out << "height " << header_.height_ << std::endl;
+    out << "width " << header_.width_ << std::endl;
+    out << "map" << std::endl;
+    for(uint32_t y = 0; y < header_.height_; y++)
+    {
+        for(uint32_t x = 0; x < header_.width_; x++)
+        {
+            out << (get_label(x, y) ? '.' : '@');
+        }
+        out << std::endl;
+    }
+}
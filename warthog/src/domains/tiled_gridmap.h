@@ -0,0 +1,188 @@
+#ifndef WARTHOG_TILED_GRIDMAP_H
+#define WARTHOG_TILED_GRIDMAP_H
+
+// domains/tiled_gridmap.h
+//
+// A uniform cost gridmap stored in block-linear order, for maps that are
+// too large for warthog::gridmap to be cache friendly. In a row-major
+// gridmap every vertical step touches a different cache line and, on very
+// large maps, a different page.
+//
+// Here the map is cut into tiles of 8x8 cells, each stored in one 64bit
+// word (bit 8*y + x is the cell at (x, y) within the tile). Tiles are
+// grouped into blocks of 256x256 cells (32x32 tiles, 8KB) stored
+// contiguously and in row-major order; blocks are in row-major order too.
+// Seven of every eight vertical steps stay in the same word and all steps
+// of a search confined to a 256x256 region stay in two pages.
+//
+// Node ids follow the same layout, so that the nodes of a search (which
+// are allocated by id) are as local as the map itself:
+//
+//   id = block_y | block_x | tile_y:5 | tile_x:5 | y:3 | x:3
+//
+// The number of blocks per row is rounded up to a power of two, which
+// lets ids be converted to coordinates (and the word holding a cell be
+// found) with shifts and masks only. Cells outside the map are obstacles.
+//
+
+#include "constants.h"
+#include "gm_parser.h"
+
+#include <cstdint>
+
+namespace warthog
+{
+
+// cells per side of a tile and of a block
+const uint32_t TGM_LOG2_TILE = 3;
+const uint32_t TGM_LOG2_BLOCK = 8;
+
+class tiled_gridmap
+{
+    public:
+        tiled_gridmap(uint32_t height, uint32_t width);
+        tiled_gridmap(const char* filename);
+        ~tiled_gridmap();
+
+        inline uint32_t
+        to_tiled_id(uint32_t x, uint32_t y)
+        {
+            return
+                ((y >> TGM_LOG2_BLOCK) << (log2_bw_ + 16)) |
+                ((x >> TGM_LOG2_BLOCK) << 16) |
+                ((y & 0xf8) << 8) | ((x & 0xf8) << 3) |
+                ((y & 7) << 3) | (x & 7);
+        }
+
+        // @param id is row-major in the coordinate space of the map file
+        inline uint32_t
+        to_tiled_id(uint32_t id)
+        {
+            return to_tiled_id(id % header_.width_, id / header_.width_);
+        }
+
+        inline void
+        to_xy(uint32_t tiled_id, uint32_t& x, uint32_t& y)
+        {
+            uint32_t block = tiled_id >> 16;
+            x = ((block & bw_mask_) << TGM_LOG2_BLOCK) |
+                ((tiled_id >> 3) & 0xf8) | (tiled_id & 7);
+            y = ((block >> log2_bw_) << TGM_LOG2_BLOCK) |
+                ((tiled_id >> 8) & 0xf8) | ((tiled_id >> 3) & 7);
+        }
+
+        inline uint32_t
+        to_unpadded_id(uint32_t tiled_id)
+        {
+            uint32_t x, y;
+            to_xy(tiled_id, x, y);
+            return y * header_.width_ + x;
+        }
+
+        inline bool
+        get_label(uint32_t tiled_id)
+        {
+            return (db_[tiled_id >> 6] >> (tiled_id & 63)) & 1;
+        }
+
+        // as above, but (x, y) may be outside the map
+        inline bool
+        get_label(uint32_t x, uint32_t y)
+        {
+            if(x >= header_.width_ || y >= header_.height_) { return false; }
+            return get_label(to_tiled_id(x, y));
+        }
+
+        inline void
+        set_label(uint32_t tiled_id, bool label)
+        {
+            uint64_t mask = (uint64_t)1 << (tiled_id & 63);
+            if(label) { db_[tiled_id >> 6] |= mask; }
+            else { db_[tiled_id >> 6] &= ~mask; }
+        }
+
+        // get the immediately adjacent neighbours of @param tiled_id,
+        // in the same layout as warthog::gridmap::get_neighbours:
+        // neighbours from the row above are in @param tiles[0], from the
+        // same row in tiles[1] and from the row below in tiles[2]; in each
+        // byte, bit 0 is the western nei, bit 1 the middle and bit 2 the
+        // eastern one.
+        inline void
+        get_neighbours(uint32_t tiled_id, uint8_t tiles[3])
+        {
+            uint32_t tx = tiled_id & 7;
+            uint32_t ty = (tiled_id >> 3) & 7;
+
+            // away from the edges of its tile, all 9 cells of the
+            // neighbourhood are in the same word
+            if(tx - 1 < 6 && ty - 1 < 6)
+            {
+                uint64_t rows = db_[tiled_id >> 6] >> ((tiled_id & 63) - 9);
+                tiles[0] = (uint8_t)(rows & 7);
+                tiles[1] = (uint8_t)((rows >> 8) & 7);
+                tiles[2] = (uint8_t)((rows >> 16) & 7);
+                return;
+            }
+
+            uint32_t x, y;
+            to_xy(tiled_id, x, y);
+            tiles[0] = get_row(x, y - 1);
+            tiles[1] = get_row(x, y);
+            tiles[2] = get_row(x, y + 1);
+        }
+
+        inline uint32_t height() { return header_.height_; }
+        inline uint32_t width() { return header_.width_; }
+
+        // one more than the largest id of any cell
+        inline uint32_t
+        id_space() { return (uint32_t)(num_words_ << 6); }
+
+        inline uint32_t
+        get_num_traversable_tiles() { return num_traversable_; }
+
+        void
+        print(std::ostream& out);
+
+        size_t
+        mem()
+        {
+            return sizeof(*this) + sizeof(uint64_t) * num_words_;
+        }
+
+    private:
+        warthog::gm_header header_;
+        uint64_t* db_;
+        size_t num_words_;
+        uint32_t log2_bw_;  // log2 of the (rounded) number of blocks per row
+        uint32_t bw_mask_;
+        uint32_t num_traversable_;
+
+        void
+        init_db();
+
+        // the cells (x-1, y), (x, y) and (x+1, y) in the three lowest bits
+        inline uint8_t
+        get_row(uint32_t x, uint32_t y)
+        {
+            if(y >= header_.height_) { return 0; }
+            uint32_t tx = x & 7;
+            if(tx - 1 < 6)
+            {
+                uint32_t id = to_tiled_id(x, y);
+                return (uint8_t)((db_[id >> 6] >> ((id & 63) - 1)) & 7);
+            }
+            return (uint8_t)(
+                    get_label(x - 1, y) |
+                    (get_label(x, y) << 1) |
+                    (get_label(x + 1, y) << 2));
+        }
+
+        tiled_gridmap(const warthog::tiled_gridmap& other) {}
+        tiled_gridmap& operator=(const warthog::tiled_gridmap& other)
+        { return *this; }
+};
+
+}
+
+#endif
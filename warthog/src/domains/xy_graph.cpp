@@ -1,6 +1,8 @@
 #include "domains/xy_graph.h"
 #include "util/timer.h"
 
+#include <algorithm>
+
 void
 warthog::graph::gridmap_to_xy_graph(
     warthog::gridmap* gm, warthog::graph::xy_graph* g,
@@ -252,3 +254,155 @@ warthog::graph::parse_xy(
     assert(n_added == num_nodes);
     assert(e_added == num_edges);
 }
+
+namespace
+{
+
+struct xy_edge_record
+{
+    uint32_t from_id_;
+    uint32_t to_id_;
+    warthog::graph::edge_cost_t wt_;
+};
+
+const char*
+skip_space(const char* p, const char* end)
+{
+    while(p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+    { p++; }
+    return p;
+}
+
+// group @param records (which are in file order, chunk by chunk) by
+// @param key; @param begin[k] is the first edge of key k in @param edges
+template<class KEY, class EDGE>
+void
+group_edges(const std::vector<std::vector<xy_edge_record>>& records,
+        uint32_t num_nodes, KEY key, EDGE make_edge,
+        std::vector<uint32_t>& begin, std::vector<warthog::graph::edge>& edges)
+{
+    begin.assign((size_t)num_nodes + 1, 0);
+    for(const std::vector<xy_edge_record>& part : records)
+    {
+        for(const xy_edge_record& r : part) { begin[key(r) + 1]++; }
+    }
+    for(uint32_t i = 0; i < num_nodes; i++) { begin[i+1] += begin[i]; }
+
+    std::vector<uint32_t> next(begin.begin(), begin.end() - 1);
+    edges.resize(begin[num_nodes]);
+    for(const std::vector<xy_edge_record>& part : records)
+    {
+        for(const xy_edge_record& r : part)
+        {
+            edges[next[key(r)]++] = make_edge(r);
+        }
+    }
+}
+
+}
+
+bool
+warthog::graph::parse_xy(const char* data, size_t size, bool incoming,
+        warthog::graph::xy_graph_data& graph)
+{
+    const char* end = data + size;
+    graph.num_nodes_ = graph.num_edges_ = 0;
+
+    // header: comments, then "nodes [number] edges [number]"
+    const char* p = skip_space(data, end);
+    while(p < end && *p == '#')
+    {
+        p = skip_space(warthog::util::next_line(p, end), end);
+    }
+    if(p < end && *p == 'n') { p = warthog::util::skip_word(p, end); }
+    if(!warthog::util::parse_number(p, end, graph.num_nodes_)) 
+    { return false; }
+    p = skip_space(p, end);
+    if(p < end && *p == 'e') { p = warthog::util::skip_word(p, end); }
+    if(!warthog::util::parse_number(p, end, graph.num_edges_)) 
+    { return false; }
+    p = warthog::util::next_line(p, end);
+
+    // nodes and edges; the coordinates of each node are written in place
+    // and the edges are kept in file order, chunk by chunk
+    uint32_t num_nodes = graph.num_nodes_;
+    graph.xy_.assign((size_t)num_nodes * 2, INT32_MAX);
+    std::vector<warthog::util::text_chunk> chunks;
+    warthog::util::split_lines(
+            p, end, warthog::util::num_parse_threads(), chunks);
+    std::vector<std::vector<xy_edge_record>> records(chunks.size());
+    std::vector<uint32_t> nodes_read(chunks.size(), 0);
+    std::vector<const char*> bad_line(chunks.size(), nullptr);
+    warthog::util::parallel_for((uint32_t)chunks.size(),
+        [&](uint32_t c)
+        {
+            const char* last = chunks[c].second;
+            for(const char* q = chunks[c].first; q < last;
+                    q = warthog::util::next_line(q, last))
+            {
+                const char* line = q;
+                q = warthog::util::skip_blanks(q, last);
+                if(q == last) { break; }
+                char tag = *q++;
+                if(tag == 'v')
+                {
+                    uint32_t id;
+                    int32_t x, y;
+                    if(!warthog::util::parse_number(q, last, id) ||
+                       !warthog::util::parse_number(q, last, x) ||
+                       !warthog::util::parse_number(q, last, y) ||
+                       id >= num_nodes)
+                    { bad_line[c] = line; return; }
+                    graph.xy_[(size_t)id*2] = x;
+                    graph.xy_[(size_t)id*2+1] = y;
+                    nodes_read[c]++;
+                }
+                else if(tag == 'e')
+                {
+                    xy_edge_record r;
+                    if(!warthog::util::parse_number(q, last, r.from_id_) ||
+                       !warthog::util::parse_number(q, last, r.to_id_) ||
+                       !warthog::util::parse_number(q, last, r.wt_) ||
+                       r.from_id_ >= num_nodes || r.to_id_ >= num_nodes)
+                    { bad_line[c] = line; return; }
+                    records[c].push_back(r);
+                }
+            }
+        });
+
+    uint32_t num_read = 0;
+    size_t num_edges = 0;
+    for(uint32_t c = 0; c < chunks.size(); c++)
+    {
+        if(bad_line[c])
+        {
+            std::cerr << "err; badly formatted xy graph on line "
+                << 1 + std::count(data, bad_line[c], '\n') << "\n";
+            return false;
+        }
+        num_read += nodes_read[c];
+        num_edges += records[c].size();
+    }
+    if(num_read != graph.num_nodes_ || num_edges != graph.num_edges_)
+    {
+        std::cerr << "err; xy graph has " << num_read << " nodes and "
+            << num_edges << " edges; expected " << graph.num_nodes_
+            << " and " << graph.num_edges_ << "\n";
+        return false;
+    }
+
+    group_edges(records, num_nodes,
+        [](const xy_edge_record& r) { return r.from_id_; },
+        [](const xy_edge_record& r) 
+        { return warthog::graph::edge(r.to_id_, r.wt_); },
+        graph.out_begin_, graph.out_edges_);
+    if(incoming)
+    {
+        group_edges(records, num_nodes,
+            [](const xy_edge_record& r) { return r.to_id_; },
+            [](const xy_edge_record& r) 
+            { return warthog::graph::edge(r.from_id_, r.wt_); },
+            graph.in_begin_, graph.in_edges_);
+    }
+    return true;
+}
@@ -13,6 +13,10 @@
 // and uses one to index the other. The graph can contain a maximum of
 // 2^32 nodes and edges.
 //
+// Nodes can be renumbered, for locality, with ::reorder. Queries keep
+// using the ids of the input file (external ids); ::to_graph_id and
+// ::to_external_id translate between the two.
+//
 // @author: dharabor
 // @created: 2016-01-07
 //
@@ -24,6 +28,8 @@
 #include "forward.h"
 #include "graph.h"
 #include "gridmap_expansion_policy.h"
+#include "mapped_file.h"
+#include "text_parser.h"
 #include "util/timer.h"
 #include "cast.h"
 
@@ -46,6 +52,28 @@ parse_xy(
     std::vector<warthog::graph::ECAP_T>& in_degree,
     std::vector<warthog::graph::ECAP_T>& out_degree);
 
+// an xy graph as read by the parse_xy below: the coordinates of each node,
+// as adjacent pairs, and its edges, grouped by tail (incoming edges by
+// head) and in the order of the file within each group
+struct xy_graph_data
+{
+    uint32_t num_nodes_;
+    uint32_t num_edges_;
+    std::vector<int32_t> xy_;
+    std::vector<uint32_t> out_begin_;
+    std::vector<warthog::graph::edge> out_edges_;
+    std::vector<uint32_t> in_begin_;
+    std::vector<warthog::graph::edge> in_edges_;
+};
+
+// read the xy graph in @param data, @param size bytes of a mapped file, by
+// tokenising chunks of lines in parallel; incoming edges are grouped only
+// if @param incoming is set. @return false if the data is not a valid
+// xy graph
+bool
+parse_xy(const char* data, size_t size, bool incoming,
+        warthog::graph::xy_graph_data& graph);
+
 template<class T_NODE, class T_EDGE>
 class xy_graph_base
 {
@@ -69,6 +97,8 @@ class xy_graph_base
             filename_ = other.filename_;
             nodes_ = other.nodes_;
             xy_ = other.xy_;
+            ext_ids_ = other.ext_ids_;
+            graph_ids_ = other.graph_ids_;
             graph_id_ = graph_counter_++;
         }
 
@@ -84,6 +114,8 @@ class xy_graph_base
             filename_ = other.filename_;
             nodes_ = std::move(other.nodes_);
             xy_ = std::move(other.xy_);
+            ext_ids_ = std::move(other.ext_ids_);
+            graph_ids_ = std::move(other.graph_ids_);
             // Technically the same but don't know what you will do with it.
             graph_id_ = graph_counter_++;
 
@@ -121,6 +153,8 @@ class xy_graph_base
         {
             nodes_.clear();
             xy_.clear();
+            ext_ids_.clear();
+            graph_ids_.clear();
         }
 
         // grow the graph so that the number of vertices is equal to
@@ -130,6 +164,12 @@ class xy_graph_base
         grow(size_t num_nodes)
         {
             if(num_nodes <= nodes_.size()) { return; }
+            for(uint32_t id = get_num_nodes(); 
+                    !ext_ids_.empty() && id < num_nodes; id++)
+            {
+                ext_ids_.push_back(id);
+                graph_ids_.push_back(id);
+            }
             nodes_.resize(num_nodes);
             xy_.resize(num_nodes*2, INT32_MAX);
         }
@@ -221,6 +261,30 @@ class xy_graph_base
             return 0;
         }
 
+        // The edges of a node, by internal graph id. Search code that
+        // uses only these calls works on any graph that has them
+        // (cf. csr_graph)
+        typedef T_EDGE edge_type;
+        typedef T_EDGE* edge_iter;
+
+        inline edge_iter
+        outgoing_begin(uint32_t id) { return nodes_[id].outgoing_begin(); }
+
+        inline edge_iter
+        outgoing_end(uint32_t id) { return nodes_[id].outgoing_end(); }
+
+        inline uint32_t
+        out_degree(uint32_t id) const { return nodes_[id].out_degree(); }
+
+        inline edge_iter
+        incoming_begin(uint32_t id) { return nodes_[id].incoming_begin(); }
+
+        inline edge_iter
+        incoming_end(uint32_t id) { return nodes_[id].incoming_end(); }
+
+        inline uint32_t
+        in_degree(uint32_t id) const { return nodes_[id].in_degree(); }
+
         // Add a new node into the graph. If a node already exists in the
         // graph with the same external id as @param ext_id then then nothing
         // is added.
@@ -244,6 +308,11 @@ class xy_graph_base
             nodes_.push_back(T_NODE());
             xy_.push_back(x);
             xy_.push_back(y);
+            if(!ext_ids_.empty())
+            {
+                ext_ids_.push_back(graph_id);
+                graph_ids_.push_back(graph_id);
+            }
             return graph_id;
         }
 
@@ -286,6 +355,7 @@ class xy_graph_base
                 mem += nodes_[i].mem();
             }
             mem += sizeof(int32_t) * xy_.size() * 2;
+            mem += sizeof(uint32_t) * (ext_ids_.size() + graph_ids_.size());
             mem += sizeof(char)*filename_.length() +
                 sizeof(*this);
             return mem;
@@ -302,7 +372,9 @@ class xy_graph_base
         inline uint32_t
         to_graph_id(uint32_t ext_id)
         {
-            return ext_id;
+            if(graph_ids_.empty()) { return ext_id; }
+            return ext_id < graph_ids_.size() ? 
+                graph_ids_[ext_id] : warthog::INF32;
         }
 
         // convert an internal node id (i.e. as used by the current graph
@@ -316,7 +388,53 @@ class xy_graph_base
         inline uint32_t
         to_external_id(uint32_t in_id)  const
         {
-            return in_id;
+            return ext_ids_.empty() ? in_id : ext_ids_[in_id];
+        }
+
+        // renumber the nodes: node @param order[i] gets the id i. edges 
+        // and coordinates move with their nodes and each node keeps the 
+        // order of its edges; external ids are unchanged. edges are copied
+        // into new arrays, allocated in the new order of the nodes.
+        // 
+        // NB: ids held outside the graph (e.g. CH levels) must be 
+        // permuted by the caller, and operator<< writes graph ids
+        void
+        reorder(const std::vector<uint32_t>& order)
+        {
+            uint32_t num_nodes = get_num_nodes();
+            assert(order.size() == num_nodes);
+            std::vector<uint32_t> rank(num_nodes, warthog::INF32);
+            for(uint32_t i = 0; i < num_nodes; i++) { rank.at(order[i]) = i; }
+
+            std::vector<T_NODE> nodes(num_nodes);
+            std::vector<int32_t> xy(num_nodes*2);
+            std::vector<uint32_t> ext_ids(num_nodes);
+            for(uint32_t i = 0; i < num_nodes; i++)
+            {
+                // the old edge arrays are freed as we go
+                T_NODE old(std::move(nodes_[order[i]]));
+                nodes[i] = old;
+                for(T_EDGE* it = nodes[i].outgoing_begin(); 
+                        it != nodes[i].outgoing_end(); it++)
+                { it->node_id_ = rank[it->node_id_]; }
+                for(T_EDGE* it = nodes[i].incoming_begin(); 
+                        it != nodes[i].incoming_end(); it++)
+                { it->node_id_ = rank[it->node_id_]; }
+
+                xy[i*2] = xy_[order[i]*2];
+                xy[i*2+1] = xy_[order[i]*2+1];
+                ext_ids[i] = to_external_id(order[i]);
+            }
+
+            nodes_.swap(nodes);
+            xy_.swap(xy);
+            ext_ids_.swap(ext_ids);
+            graph_ids_.resize(num_nodes);
+            for(uint32_t i = 0; i < num_nodes; i++) 
+            { graph_ids_[ext_ids_[i]] = i; }
+
+            // as for ::perturb; data computed for the old ids is stale
+            graph_id_ = graph_counter_++;
         }
 
         // compute the proportion of bytes allocated to edges with respect
@@ -439,8 +557,9 @@ class xy_graph_base
                     edge_idx < n->out_degree();
                     edge_idx++)
                 {
-                    warthog::graph::edge* e = n->outgoing_begin() + edge_idx;
-                    edges.push_back({i, *e});
+                    warthog::graph::edge e = *(n->outgoing_begin() + edge_idx);
+                    e.node_id_ = g.to_external_id(e.node_id_);
+                    edges.push_back({g.to_external_id(i), e});
                 }
             }
 
@@ -449,7 +568,8 @@ class xy_graph_base
 
         /**
          * Edit the weights of the edges to contain the new costs and save the
-         * original cost in the labels.
+         * original cost in the labels. Both ends of @param edges are external
+         * ids, so the graph may have been reordered.
          */
         void
         perturb(std::vector<std::pair<uint32_t, warthog::graph::edge>>& edges)
@@ -457,9 +577,9 @@ class xy_graph_base
             uint32_t num_modif = 0;
             for(auto e : edges)
             {
-                uint32_t from_id = e.first;
-                node* from = get_node(from_id);
-                edge_iter eit = from->find_edge(e.second.node_id_, 
+                node* from = get_node(to_graph_id(e.first));
+                if(from == 0) { continue; }
+                edge_iter eit = from->find_edge(to_graph_id(e.second.node_id_),
                         from->outgoing_begin(), from->outgoing_end());
 
                 if(eit != from->outgoing_end())
@@ -499,6 +619,71 @@ class xy_graph_base
         //    }
         //}
 
+        // read the graph in @param filename, as operator>> does, but
+        // mapping the file and parsing it with several threads. 
+        // @return false, and leave the graph empty, if the file cannot be
+        // read or is not a valid xy graph
+        bool
+        load(const char* filename)
+        {
+            warthog::timer mytimer;
+            mytimer.start();
+
+            clear();
+            warthog::util::mapped_file file(filename);
+            if(!file.good()) { return false; }
+            file.prefetch();
+
+            warthog::graph::xy_graph_data data;
+            if(!warthog::graph::parse_xy(
+                    file.data(), file.size(), store_incoming_, data))
+            {
+                std::cerr << "err; " << filename << " is not a valid "
+                    << "xy graph\n";
+                return false;
+            }
+            grow(data.num_nodes_);
+            xy_.swap(data.xy_);
+            filename_ = filename;
+
+            // the edges of each node are contiguous, so every thread
+            // allocates and fills its own range of nodes
+            uint32_t num_tasks = warthog::util::num_parse_threads();
+            warthog::util::parallel_for(num_tasks,
+                [this, &data, num_tasks](uint32_t t)
+                {
+                    uint64_t num_nodes = data.num_nodes_;
+                    uint32_t first = (uint32_t)(num_nodes * t / num_tasks);
+                    uint32_t last = (uint32_t)(num_nodes * (t+1) / num_tasks);
+                    for(uint32_t i = first; i < last; i++)
+                    {
+                        T_NODE& n = nodes_[i];
+                        uint32_t out_deg = 
+                            data.out_begin_[i+1] - data.out_begin_[i];
+                        uint32_t in_deg = store_incoming_ ?
+                            data.in_begin_[i+1] - data.in_begin_[i] : 0;
+                        n.capacity((warthog::graph::ECAP_T)in_deg, 
+                                (warthog::graph::ECAP_T)out_deg);
+                        for(uint32_t e = data.out_begin_[i]; 
+                                e < data.out_begin_[i+1]; e++)
+                        { n.add_outgoing(data.out_edges_[e]); }
+                        if(!store_incoming_) { continue; }
+                        for(uint32_t e = data.in_begin_[i]; 
+                                e < data.in_begin_[i+1]; e++)
+                        { n.add_incoming(data.in_edges_[e]); }
+                    }
+                });
+
+            mytimer.stop();
+            std::cerr << "graph, loaded.\n";
+            std::cerr << "read " << data.num_nodes_ << " nodes"
+                    << " and read " << data.num_edges_ << " outgoing edges"
+                    << ". total time "
+                    << (double)mytimer.elapsed_time_nano() / 1e9 << " s"
+                    << std::endl;
+            return true;
+        }
+
         friend std::istream&
         operator>>(
             std::istream& in, warthog::graph::xy_graph_base<T_NODE, T_EDGE>& g)
@@ -582,7 +767,7 @@ class xy_graph_base
             {
                 int32_t x, y;
                 g.get_xy(i, x, y);
-                out << "v " << i << " " << x << " " << y << " " << std::endl;
+                out << "v " << i << " " << x << " " << y << " \n";
             }
 
             for(uint32_t i = 0; i < g.get_num_nodes(); i++)
@@ -592,7 +777,7 @@ class xy_graph_base
                 {
                     warthog::graph::edge* e = n->outgoing_begin() + edge_idx;
                     out << "e " << i << " " << e->node_id_ << " " << e->wt_
-                        << std::endl;
+                        << "\n";
                 }
             }
 
@@ -611,6 +796,11 @@ class xy_graph_base
         // xy coordinates stored as adjacent pairs (x, then y)
         std::vector<int32_t> xy_;
 
+        // the external id of each node and the graph id of each external
+        // id; both empty until the graph is reordered
+        std::vector<uint32_t> ext_ids_;
+        std::vector<uint32_t> graph_ids_;
+
         bool verbose_;
         std::string filename_;
         bool store_incoming_;
@@ -4,6 +4,8 @@
 // euclidean_heuristic.h
 //
 // Straight-line heuristic for measuring distances in the plane.
+// The graph type is a template parameter so that the coordinates of
+// the nodes are read without a check of the graph's type on every call.
 //
 // @author: dharabor
 // @created: 2016-02-11
@@ -13,37 +15,64 @@
 #include "constants.h"
 #include "forward.h"
 
+#include <cmath>
+
 namespace warthog
 {
 
 typedef void (*xyFn)(uint32_t id, int32_t& x, int32_t& y);
-class euclidean_heuristic
+
+template<class G>
+class euclidean_heuristic_base
 {
     public:
-        euclidean_heuristic(warthog::graph::xy_graph* g);
-        ~euclidean_heuristic();
+        euclidean_heuristic_base(G* g) : g_(g), hscale_(1) { }
+        ~euclidean_heuristic_base() { }
 
-        double
-        h(sn_id_t id, sn_id_t id2);
+        inline double
+        h(sn_id_t id, sn_id_t id2)
+        {
+            int32_t x, x2;
+            int32_t y, y2;
+            g_->get_xy((uint32_t)id, x, y);
+            g_->get_xy((uint32_t)id2, x2, y2);
+            return h(x, y, x2, y2) * hscale_;
+        }
 
-        static double
-        h(double x, double y, double x2, double y2);
+        static inline double
+        h(double x, double y, double x2, double y2)
+        {
+            // NB: precision loss when warthog::cost_t is an integer
+            double dx = x-x2;
+            double dy = y-y2;
+            return sqrt(dx*dx + dy*dy);
+        }
 
         void
-        set_hscale(double hscale);
+        set_hscale(double hscale)
+        {
+            if(hscale > 0)
+            {
+                hscale_ = hscale;
+            }
+        }
 
         double
-        get_hscale();
+        get_hscale() { return hscale_; }
 
         size_t
-        mem(); 
+        mem() { return sizeof(this); }
 
-        private:
-        warthog::graph::xy_graph* g_;
+    private:
+        G* g_;
         double hscale_;
-
 };
 
+typedef euclidean_heuristic_base<warthog::graph::xy_graph>
+        euclidean_heuristic;
+typedef euclidean_heuristic_base<warthog::graph::csr_graph>
+        csr_euclidean_heuristic;
+
 }
 
 #endif
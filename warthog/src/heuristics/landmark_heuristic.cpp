@@ -0,0 +1,504 @@
+#include "flexible_astar.h"
+#include "gridmap.h"
+#include "gridmap_expansion_policy.h"
+#include "graph_expansion_policy.h"
+#include "helpers.h"
+#include "jump_point_db.h"
+#include "landmark_heuristic.h"
+#include "problem_instance.h"
+#include "search_node.h"
+#include "solution.h"
+#include "timer.h"
+#include "xy_graph.h"
+#include "zero_heuristic.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace
+{
+
+const uint16_t UNREACHED = 0xffff;
+const uint16_t MAX_LABEL = 0xfffe;
+
+// records the distance, parent and order of every node expanded
+struct lm_search_listener
+{
+    std::vector<double>* dist;
+    std::vector<uint32_t>* parent;
+    std::vector<uint32_t>* order;
+
+    inline void
+    generate_node(warthog::search_node* from,
+                  warthog::search_node* succ,
+                  warthog::cost_t edge_cost,
+                  uint32_t edge_id) { }
+
+    inline void
+    expand_node(warthog::search_node* current)
+    {
+        uint32_t id = (uint32_t)current->get_id();
+        dist->at(id) = current->get_g();
+        if(parent) { parent->at(id) = (uint32_t)current->get_parent(); }
+        if(order) { order->push_back(id); }
+    }
+
+    inline void
+    relax_node(warthog::search_node* current) { }
+};
+
+template<class E>
+void
+run_dijkstra(E* expander, warthog::sn_id_t start, lm_search_listener& listener)
+{
+    warthog::zero_heuristic h;
+    warthog::pqueue_min open;
+    warthog::flexible_astar<
+        warthog::zero_heuristic, E, warthog::pqueue_min, lm_search_listener>
+            dijk(&h, expander, &open, &listener);
+
+    warthog::problem_instance pi(start, warthog::SN_ID_MAX);
+    warthog::solution sol;
+    dijk.get_path(pi, sol);
+}
+
+// writes @param dist into column @param col of @param table, in units of a
+// scale of its own.
+// @return the scale
+double
+quantise(const std::vector<double>& dist, uint16_t* table, uint32_t stride,
+        uint32_t col)
+{
+    double max_dist = 0;
+    for(double d : dist)
+    {
+        if(d != DBL_MAX) { max_dist = std::max(max_dist, d); }
+    }
+    double scale = max_dist > 0 ? max_dist / MAX_LABEL : 1;
+
+    for(size_t i = 0; i < dist.size(); i++)
+    {
+        table[i*stride + col] = dist[i] == DBL_MAX ? UNREACHED :
+            (uint16_t)std::min((double)MAX_LABEL, floor(dist[i] / scale));
+    }
+    return scale;
+}
+
+// rescale column @param col of @param table from @param from to @param to
+// (>= from), again rounding down
+void
+requantise(uint16_t* table, uint32_t num_rows, uint32_t stride,
+        uint32_t col, double from, double to)
+{
+    if(from == to) { return; }
+    for(uint32_t i = 0; i < num_rows; i++)
+    {
+        uint16_t& q = table[i*stride + col];
+        if(q != UNREACHED) { q = (uint16_t)floor(q * from / to); }
+    }
+}
+
+struct shared_data
+{
+    warthog::landmark_heuristic* lh_;
+    const std::vector<uint32_t>* landmarks_;
+    uint16_t* table_;
+    uint32_t num_ids_;
+    uint32_t stride_;
+    std::vector<double>* scales_;
+};
+
+}
+
+warthog::landmark_heuristic::landmark_heuristic(warthog::graph::xy_graph* g)
+    : g_(g), rev_(nullptr), map_(nullptr), directed_(true),
+    symmetric_(false), hscale_(1), scale_(1),
+    num_ids_(g->get_num_nodes()), num_landmarks_(0), stride_(0),
+    fwd_(nullptr), bwd_(nullptr)
+{ }
+
+warthog::landmark_heuristic::landmark_heuristic(warthog::gridmap* map)
+    : g_(nullptr), rev_(nullptr), map_(map), directed_(false),
+    symmetric_(false), hscale_(1), scale_(1),
+    num_ids_(map->height() * map->width()), num_landmarks_(0), stride_(0),
+    fwd_(nullptr), bwd_(nullptr)
+{ }
+
+warthog::landmark_heuristic::~landmark_heuristic()
+{
+    delete rev_;
+}
+
+void
+warthog::landmark_heuristic::dijkstra(uint32_t source, bool backward,
+        std::vector<double>& dist, std::vector<uint32_t>* parent,
+        std::vector<uint32_t>* order)
+{
+    dist.assign(num_ids_, DBL_MAX);
+    if(parent) { parent->assign(num_ids_, warthog::INF32); }
+    if(order) { order->clear(); }
+    lm_search_listener listener = {&dist, parent, order};
+
+    if(map_)
+    {
+        warthog::gridmap_expansion_policy expander(map_);
+        run_dijkstra(&expander, map_->to_unpadded_id(source), listener);
+        return;
+    }
+    warthog::simple_graph_expansion_policy expander(backward ? rev_ : g_);
+    run_dijkstra(&expander, source, listener);
+}
+
+uint32_t
+warthog::landmark_heuristic::random_node(std::mt19937& rng)
+{
+    if(g_) { return (uint32_t)(rng() % num_ids_); }
+    while(true)
+    {
+        uint32_t id = map_->to_padded_id((uint32_t)(rng() %
+                    (map_->header_width() * map_->header_height())));
+        if(map_->get_label(id)) { return id; }
+    }
+}
+
+// grow a shortest path tree from a random root and weigh every node by how
+// much the current heuristic underestimates its distance. descend from the
+// heaviest subtree without landmarks, always into the heaviest child, and
+// return the leaf reached.
+uint32_t
+warthog::landmark_heuristic::avoid(std::mt19937& rng, const uint16_t* fwd,
+        const std::vector<double>& scales)
+{
+    uint32_t root = random_node(rng);
+    std::vector<double> dist;
+    std::vector<uint32_t> parent, order;
+    dijkstra(root, false, dist, &parent, &order);
+
+    std::vector<double> size(num_ids_, 0);
+    std::vector<uint8_t> has_landmark(num_ids_, 0);
+    std::vector<uint32_t> best_child(num_ids_, warthog::INF32);
+    for(uint32_t id : landmarks_) { has_landmark[id] = 1; }
+
+    const uint16_t* fr = fwd + (size_t)root * stride_;
+    uint32_t heaviest = warthog::INF32;
+    for(size_t i = order.size(); i-- > 0; )
+    {
+        uint32_t id = order[i];
+        const uint16_t* fv = fwd + (size_t)id * stride_;
+        double h = 0;
+        for(uint32_t l = 0; l < landmarks_.size(); l++)
+        {
+            if(fr[l] == UNREACHED || fv[l] == UNREACHED) { continue; }
+            double diff = ((double)fv[l] - fr[l]) * scales[l];
+            h = std::max(h, directed_ ? diff : fabs(diff));
+        }
+
+        size[id] = has_landmark[id] ? 0 : size[id] + std::max(0.0, dist[id] - h);
+        if(heaviest == warthog::INF32 || size[id] > size[heaviest])
+        {
+            heaviest = id;
+        }
+
+        uint32_t p = parent[id];
+        if(p == warthog::INF32) { continue; }
+        has_landmark[p] |= has_landmark[id];
+        size[p] += size[id];
+        if(best_child[p] == warthog::INF32 ||
+           size[id] > size[best_child[p]])
+        {
+            best_child[p] = id;
+        }
+    }
+
+    if(heaviest == warthog::INF32 || size[heaviest] <= 0)
+    {
+        return warthog::INF32;
+    }
+    while(best_child[heaviest] != warthog::INF32)
+    {
+        heaviest = best_child[heaviest];
+    }
+    return heaviest;
+}
+
+void
+warthog::landmark_heuristic::precompute(uint32_t num_landmarks,
+        selection sel, uint32_t seed)
+{
+    warthog::timer t;
+    t.start();
+    std::cerr << "computing landmarks\n";
+
+    std::mt19937 rng(seed);
+    stride_ = (num_landmarks + 7) & ~7u;
+    size_t table_size = (size_t)num_ids_ * stride_;
+    std::shared_ptr<uint16_t> fwd(
+            new uint16_t[table_size], std::default_delete<uint16_t[]>());
+    memset(fwd.get(), 0, sizeof(uint16_t) * table_size);
+
+    // every table column gets its own scale, until all are done
+    landmarks_.clear();
+    std::vector<double> scales(2 * stride_, 0);
+    std::vector<double> dist;
+    std::vector<double> nearest(num_ids_, DBL_MAX);
+    auto add_landmark = [&](uint32_t id) -> void
+    {
+        uint32_t col = (uint32_t)landmarks_.size();
+        landmarks_.push_back(id);
+        dijkstra(id, false, dist);
+        scales[col] = quantise(dist, fwd.get(), stride_, col);
+        for(uint32_t i = 0; i < num_ids_; i++)
+        {
+            nearest[i] = std::min(nearest[i], dist[i]);
+        }
+    };
+
+    // the first landmark is far from a random node
+    uint32_t root = random_node(rng);
+    dijkstra(root, false, dist);
+    uint32_t first = root;
+    for(uint32_t i = 0; i < num_ids_; i++)
+    {
+        if(dist[i] != DBL_MAX && dist[i] > dist[first]) { first = i; }
+    }
+    if(num_landmarks > 0) { add_landmark(first); }
+
+    while(landmarks_.size() < num_landmarks)
+    {
+        uint32_t next = warthog::INF32;
+        if(sel == AVOID)
+        {
+            next = avoid(rng, fwd.get(), scales);
+        }
+        else
+        {
+            for(uint32_t i = 0; i < num_ids_; i++)
+            {
+                if(nearest[i] == DBL_MAX || nearest[i] == 0) { continue; }
+                if(next == warthog::INF32 || nearest[i] > nearest[next])
+                {
+                    next = i;
+                }
+            }
+        }
+        if(next == warthog::INF32) { break; } // no node left to choose
+        add_landmark(next);
+        std::cerr << "\rlandmarks: " << landmarks_.size() << " of "
+            << num_landmarks << std::flush;
+    }
+    std::cerr << "\n";
+
+    // distances to the landmarks, one search each on the reversed graph
+    std::shared_ptr<uint16_t> bwd = fwd;
+    if(directed_)
+    {
+        bwd = std::shared_ptr<uint16_t>(
+                new uint16_t[table_size], std::default_delete<uint16_t[]>());
+        memset(bwd.get(), 0, sizeof(uint16_t) * table_size);
+
+        rev_ = new warthog::graph::xy_graph(num_ids_);
+        for(uint32_t i = 0; i < num_ids_; i++)
+        {
+            warthog::graph::node* n = g_->get_node(i);
+            for(warthog::graph::edge_iter it = n->outgoing_begin();
+                    it != n->outgoing_end(); it++)
+            {
+                rev_->get_node(it->node_id_)->add_outgoing(
+                        warthog::graph::edge(i, it->wt_));
+            }
+        }
+
+        void*(*thread_compute_fn)(void*) =
+        [] (void* args_in) -> void*
+        {
+            warthog::helpers::thread_params* par =
+                (warthog::helpers::thread_params*) args_in;
+            shared_data* shared = (shared_data*) par->shared_;
+
+            std::vector<double> dist;
+            for(uint32_t i = par->thread_id_; i < shared->landmarks_->size();
+                    i += par->max_threads_)
+            {
+                shared->lh_->dijkstra(
+                        shared->landmarks_->at(i), true, dist);
+                shared->scales_->at(shared->stride_ + i) =
+                    quantise(dist, shared->table_, shared->stride_, i);
+                par->nprocessed_++;
+            }
+            return 0;
+        };
+
+        shared_data shared = {this, &landmarks_, bwd.get(), num_ids_,
+            stride_, &scales};
+        warthog::helpers::parallel_compute(thread_compute_fn, &shared,
+                (uint32_t)landmarks_.size());
+        delete rev_;
+        rev_ = nullptr;
+    }
+
+    // finally, one scale for all
+    scale_ = *std::max_element(scales.begin(), scales.end());
+    if(scale_ == 0) { scale_ = 1; }
+    for(uint32_t l = 0; l < landmarks_.size(); l++)
+    {
+        requantise(fwd.get(), num_ids_, stride_, l, scales[l], scale_);
+        if(directed_)
+        {
+            requantise(bwd.get(), num_ids_, stride_, l,
+                    scales[stride_ + l], scale_);
+        }
+    }
+
+    num_landmarks_ = (uint32_t)landmarks_.size();
+    file_.reset();
+    fwd_table_ = fwd;
+    bwd_table_ = bwd;
+    fwd_ = fwd_table_.get();
+    bwd_ = bwd_table_.get();
+
+    t.stop();
+    std::cerr << "done. time " << t.elapsed_time_nano() / 1e9 << " s\n";
+}
+
+uint64_t
+warthog::landmark_heuristic::hash_domain()
+{
+    if(map_) { return warthog::jump_point_db::hash_map(map_); }
+
+    uint64_t hash = warthog::helpers::fnv64(&num_ids_, sizeof(num_ids_));
+    for(uint32_t i = 0; i < num_ids_; i++)
+    {
+        warthog::graph::node* n = g_->get_node(i);
+        for(warthog::graph::edge_iter it = n->outgoing_begin();
+                it != n->outgoing_end(); it++)
+        {
+            hash = warthog::helpers::fnv64(
+                    &it->node_id_, sizeof(it->node_id_), hash);
+            hash = warthog::helpers::fnv64(&it->wt_, sizeof(it->wt_), hash);
+        }
+        hash = warthog::helpers::fnv64(&i, sizeof(i), hash);
+    }
+    return hash;
+}
+
+bool
+warthog::landmark_heuristic::load(const char* filename)
+{
+    std::cerr << "loading " << filename << "... ";
+    std::shared_ptr<warthog::util::mapped_file> file =
+        std::make_shared<warthog::util::mapped_file>(filename);
+    if(!file->good())
+    {
+        std::cerr << "no dice. oh well. keep going.\n";
+        return false;
+    }
+
+    warthog::landmark_db_header hdr;
+    if(file->size() < sizeof(hdr))
+    {
+        std::cerr << "not a landmark table.\n";
+        return false;
+    }
+    memcpy(&hdr, file->data(), sizeof(hdr));
+    if(memcmp(hdr.magic_, LANDMARK_DB_MAGIC, sizeof(hdr.magic_)) != 0 ||
+       hdr.version_ != LANDMARK_DB_VERSION)
+    {
+        std::cerr << "not a landmark table of version "
+            << LANDMARK_DB_VERSION << ".\n";
+        return false;
+    }
+
+    if(hdr.directed_ != (directed_ ? 1u : 0u) ||
+       hdr.num_ids_ != num_ids_ ||
+       hdr.domain_hash_ != hash_domain())
+    {
+        std::cerr << "landmark table does not match the input.\n";
+        return false;
+    }
+
+    uint64_t table_bytes =
+        sizeof(uint16_t) * (uint64_t)hdr.num_ids_ * hdr.stride_;
+    uint64_t tables_bytes = table_bytes * (directed_ ? 2 : 1);
+    if(hdr.stride_ % 8 != 0 || hdr.num_landmarks_ > hdr.stride_ ||
+       hdr.scale_ <= 0 ||
+       hdr.landmarks_offset_ + sizeof(uint32_t) * hdr.num_landmarks_ >
+            hdr.tables_offset_ ||
+       hdr.tables_offset_ % sizeof(uint64_t) != 0 ||
+       hdr.tables_offset_ + tables_bytes > file->size() ||
+       warthog::helpers::fnv64(file->data() + hdr.landmarks_offset_,
+           hdr.tables_offset_ + tables_bytes - hdr.landmarks_offset_) !=
+            hdr.checksum_)
+    {
+        std::cerr << "landmark table is corrupt.\n";
+        return false;
+    }
+
+    file_ = file;
+    num_landmarks_ = hdr.num_landmarks_;
+    stride_ = hdr.stride_;
+    scale_ = hdr.scale_;
+    landmarks_.resize(num_landmarks_);
+    memcpy(landmarks_.data(), file->data() + hdr.landmarks_offset_,
+            sizeof(uint32_t) * num_landmarks_);
+
+    const char* tables = file->data() + hdr.tables_offset_;
+    fwd_table_ = std::shared_ptr<const uint16_t>(
+            file, (const uint16_t*)tables);
+    bwd_table_ = directed_ ? std::shared_ptr<const uint16_t>(
+            file, (const uint16_t*)(tables + table_bytes)) : fwd_table_;
+    fwd_ = fwd_table_.get();
+    bwd_ = bwd_table_.get();
+    std::cerr << "#landmarks=" << num_landmarks_ << std::endl;
+    return true;
+}
+
+bool
+warthog::landmark_heuristic::save(const char* filename)
+{
+    std::cerr << "saving to file " << filename << "; landmarks="
+        << num_landmarks_ << std::endl;
+
+    warthog::landmark_db_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic_, LANDMARK_DB_MAGIC, sizeof(hdr.magic_));
+    hdr.version_ = LANDMARK_DB_VERSION;
+    hdr.directed_ = directed_ ? 1 : 0;
+    hdr.num_ids_ = num_ids_;
+    hdr.num_landmarks_ = num_landmarks_;
+    hdr.stride_ = stride_;
+    hdr.scale_ = scale_;
+    hdr.domain_hash_ = hash_domain();
+    hdr.landmarks_offset_ = sizeof(hdr);
+    hdr.tables_offset_ = sizeof(hdr) +
+        ((sizeof(uint32_t) * num_landmarks_ + 7) & ~(uint64_t)7);
+
+    // landmarks, zero padding and tables, as laid out in the file
+    size_t table_bytes = sizeof(uint16_t) * (size_t)num_ids_ * stride_;
+    std::vector<char> body(hdr.tables_offset_ - hdr.landmarks_offset_, 0);
+    memcpy(body.data(), landmarks_.data(), sizeof(uint32_t) * num_landmarks_);
+    uint64_t hash = warthog::helpers::fnv64(body.data(), body.size());
+    hash = warthog::helpers::fnv64(fwd_, table_bytes, hash);
+    if(directed_) { hash = warthog::helpers::fnv64(bwd_, table_bytes, hash); }
+    hdr.checksum_ = hash;
+
+    // write a temporary file and rename it, so that a process loading the
+    // table never sees it half written
+    std::string tmpname = std::string(filename) + ".tmp";
+    std::ofstream out(tmpname, std::ios_base::out | std::ios_base::binary);
+    out.write((char*)&hdr, sizeof(hdr));
+    out.write(body.data(), (std::streamsize)body.size());
+    out.write((const char*)fwd_, (std::streamsize)table_bytes);
+    if(directed_) { out.write((const char*)bwd_, (std::streamsize)table_bytes); }
+    out.close();
+    if(!out.good() || rename(tmpname.c_str(), filename) != 0)
+    {
+        std::cerr << "err; cannot write landmark table to file "
+            << filename << ". oh well. try to keep going.\n";
+        remove(tmpname.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,235 @@
+#ifndef WARTHOG_LANDMARK_HEURISTIC_H
+#define WARTHOG_LANDMARK_HEURISTIC_H
+
+// landmark_heuristic.h
+//
+// Landmark (ALT, also called differential) heuristics for xy-graphs and
+// gridmaps. For a handful of landmark nodes L we store the distance from L
+// to every node and, on directed graphs, from every node to L. By the
+// triangle inequality d(L, t) - d(L, v) and d(v, L) - d(t, L) are lower
+// bounds on d(v, t); h is the largest such bound over all landmarks.
+//
+// Landmarks are chosen one at a time, each far from those chosen before:
+// FARTHEST picks the node whose nearest landmark is farthest away; AVOID
+// [Goldberg & Werneck, 2005] grows a shortest path tree from a random root
+// and descends into the subtree where the current heuristic is worst.
+// Each choice needs the distances from the landmarks before it, so they
+// are computed in turn; the distances to the landmarks (directed graphs
+// only) are independent and computed by all cores at once.
+//
+// Distances are stored as 16-bit multiples of one scale, so that a row of
+// landmarks fits in a few SIMD registers; rows are indexed by node id
+// (by padded id on gridmaps) and padded to a multiple of 8 landmarks.
+// Values are rounded down; h subtracts two units of scale to remain
+// admissible. Nodes a landmark cannot reach are marked with 0xffff, which
+// still gives a valid bound (i.e. there is no path).
+//
+// Tables can be saved with ::save and mapped read-only by ::load. The file
+// has a versioned header and is checked against the graph or map, and its
+// own checksum, before it is used.
+//
+// [Goldberg & Harrelson, 2005, Computing the Shortest Path: A* Search
+// Meets Graph Theory, SODA]
+// [Goldberg & Werneck, 2005, Computing Point-to-Point Shortest Paths from
+// External Memory, ALENEX]
+//
+
+#include "constants.h"
+#include "forward.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace warthog
+{
+
+class gridmap;
+
+struct landmark_db_header
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t directed_;
+    uint32_t num_ids_;
+    uint32_t num_landmarks_;
+    uint32_t stride_;
+    uint32_t padding_;
+    double scale_;
+    uint64_t domain_hash_;          // cf. landmark_heuristic::hash_domain
+    uint64_t landmarks_offset_;
+    uint64_t tables_offset_;
+    uint64_t checksum_;             // helpers::fnv64 of landmarks and tables
+};
+
+static const char LANDMARK_DB_MAGIC[8] = {'W', 'H', 'L', 'M', 'A', 'R', 'K', 'S'};
+static const uint32_t LANDMARK_DB_VERSION = 1;
+
+class landmark_heuristic
+{
+    public:
+        enum selection
+        {
+            FARTHEST,
+            AVOID
+        };
+
+        // a heuristic for the (directed) graph @param g
+        landmark_heuristic(warthog::graph::xy_graph* g);
+
+        // a heuristic for the (undirected) gridmap @param map
+        landmark_heuristic(warthog::gridmap* map);
+
+        ~landmark_heuristic();
+
+        // choose @param num_landmarks landmarks and compute their tables.
+        // @param seed: for the random choices made during selection
+        void
+        precompute(uint32_t num_landmarks,
+                selection sel = AVOID, uint32_t seed = 0);
+
+        // @return false if @param filename is not a valid table for the
+        // current graph or map (the tables are unchanged)
+        bool
+        load(const char* filename);
+
+        bool
+        save(const char* filename);
+
+        // a lower bound on the distance from @param id to @param id2
+        inline double
+        h(warthog::sn_id_t id, warthog::sn_id_t id2)
+        {
+            if(num_landmarks_ == 0) { return 0; }
+            uint32_t bound = bound_to(id, id2);
+            if(symmetric_) { bound = std::min(bound, bound_to(id2, id)); }
+            return bound > 2 ? (bound - 2) * scale_ * hscale_ : 0;
+        }
+
+        // when true, h is a lower bound on the distance in either
+        // direction, as needed by bidirectional_search on directed graphs
+        inline void
+        set_symmetric(bool symmetric) { symmetric_ = symmetric; }
+
+        inline void
+        set_hscale(double hscale) { if(hscale > 0) { hscale_ = hscale; } }
+
+        inline double
+        get_hscale() { return hscale_; }
+
+        inline uint32_t
+        get_num_landmarks() { return num_landmarks_; }
+
+        // landmarks, as node ids (padded ids on gridmaps)
+        inline const std::vector<uint32_t>&
+        get_landmarks() { return landmarks_; }
+
+        inline bool
+        is_mapped() { return file_ != nullptr; }
+
+        size_t
+        mem()
+        {
+            return sizeof(*this) +
+                sizeof(uint32_t) * landmarks_.size() +
+                (file_ ? 0 : sizeof(uint16_t) * (size_t)num_ids_ * stride_ *
+                 (directed_ ? 2 : 1));
+        }
+
+    private:
+        warthog::graph::xy_graph* g_;
+        warthog::graph::xy_graph* rev_;     // g_ reversed, while precomputing
+        warthog::gridmap* map_;
+        bool directed_;
+        bool symmetric_;
+        double hscale_;
+        double scale_;
+
+        uint32_t num_ids_;
+        uint32_t num_landmarks_;
+        uint32_t stride_;
+        std::vector<uint32_t> landmarks_;
+
+        // distances from (fwd) and to (bwd) each landmark, row by row;
+        // bwd_ is fwd_ on undirected domains
+        std::shared_ptr<const uint16_t> fwd_table_;
+        std::shared_ptr<const uint16_t> bwd_table_;
+        const uint16_t* fwd_;
+        const uint16_t* bwd_;
+        std::shared_ptr<warthog::util::mapped_file> file_;
+
+        // the greatest bound on d(@param id, @param id2), in units of scale
+        inline uint32_t
+        bound_to(warthog::sn_id_t id, warthog::sn_id_t id2)
+        {
+            const uint16_t* fv = fwd_ + id * stride_;
+            const uint16_t* ft = fwd_ + id2 * stride_;
+            const uint16_t* bv = bwd_ + id * stride_;
+            const uint16_t* bt = bwd_ + id2 * stride_;
+#ifdef __SSE2__
+            // unsigned 16-bit max, from saturating arithmetic (SSE2 has
+            // only the signed one)
+            auto max_epu16 = [](__m128i a, __m128i b) -> __m128i
+            { return _mm_add_epi16(_mm_subs_epu16(a, b), b); };
+
+            __m128i best = _mm_setzero_si128();
+            for(uint32_t i = 0; i < stride_; i += 8)
+            {
+                __m128i a = _mm_loadu_si128((const __m128i*)(fv + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(ft + i));
+                __m128i c = _mm_loadu_si128((const __m128i*)(bv + i));
+                __m128i d = _mm_loadu_si128((const __m128i*)(bt + i));
+                best = max_epu16(best, _mm_subs_epu16(b, a));
+                best = max_epu16(best, _mm_subs_epu16(c, d));
+            }
+            best = max_epu16(best, _mm_srli_si128(best, 8));
+            best = max_epu16(best, _mm_srli_si128(best, 4));
+            best = max_epu16(best, _mm_srli_si128(best, 2));
+            return (uint32_t)_mm_extract_epi16(best, 0);
+#else
+            uint32_t best = 0;
+            for(uint32_t i = 0; i < stride_; i++)
+            {
+                if(ft[i] > fv[i]) { best = std::max(best, (uint32_t)(ft[i] - fv[i])); }
+                if(bv[i] > bt[i]) { best = std::max(best, (uint32_t)(bv[i] - bt[i])); }
+            }
+            return best;
+#endif
+        }
+
+        // a Dijkstra search from (or, if @param backward, to) the node
+        // @param source: @param dist gets the distance of every node
+        // (DBL_MAX if unreached); if given, @param parent gets the shortest
+        // path tree and @param order the nodes in the order expanded
+        void
+        dijkstra(uint32_t source, bool backward, std::vector<double>& dist,
+                std::vector<uint32_t>* parent = nullptr,
+                std::vector<uint32_t>* order = nullptr);
+
+        uint32_t
+        random_node(std::mt19937& rng);
+
+        // the node chosen by AVOID, or INF32 if there is none
+        uint32_t
+        avoid(std::mt19937& rng, const uint16_t* fwd,
+                const std::vector<double>& scales);
+
+        // a hash of the graph or map
+        uint64_t
+        hash_domain();
+
+        landmark_heuristic(const landmark_heuristic& other) { }
+        landmark_heuristic&
+        operator=(const landmark_heuristic& other) { return *this; }
+};
+
+}
+
+#endif
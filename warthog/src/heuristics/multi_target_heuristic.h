@@ -0,0 +1,61 @@
+#ifndef WARTHOG_MULTI_TARGET_HEURISTIC_H
+#define WARTHOG_MULTI_TARGET_HEURISTIC_H
+
+// multi_target_heuristic.h
+//
+// Goal-set heuristic for one-to-many search: the estimate for a node is
+// the minimum, over all targets, of an underlying point-to-point
+// heuristic H. If H is admissible (resp. consistent) then so is the
+// minimum. Evaluation is linear in the number of targets; for very large
+// goal sets warthog::zero_heuristic may be the cheaper choice.
+//
+
+#include "constants.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+template<class H>
+class multi_target_heuristic
+{
+    public:
+        multi_target_heuristic(H* heuristic) : heuristic_(heuristic) { }
+        ~multi_target_heuristic() { }
+
+        // @param targets internal ids of the goal set
+        inline void
+        set_targets(const std::vector<warthog::sn_id_t>& targets)
+        { targets_ = targets; }
+
+        // @param id2 is ignored; estimates are wrt the whole goal set
+        inline double
+        h(warthog::sn_id_t id, warthog::sn_id_t id2)
+        {
+            if(targets_.empty()) { return 0; }
+
+            double best = DBL_MAX;
+            for(warthog::sn_id_t target : targets_)
+            {
+                double hval = heuristic_->h(id, target);
+                if(hval < best) { best = hval; }
+            }
+            return best;
+        }
+
+        size_t
+        mem()
+        {
+            return sizeof(*this) +
+                sizeof(warthog::sn_id_t) * targets_.capacity();
+        }
+
+    private:
+        H* heuristic_;
+        std::vector<warthog::sn_id_t> targets_;
+};
+
+}
+
+#endif
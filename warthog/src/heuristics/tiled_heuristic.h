@@ -0,0 +1,57 @@
+#ifndef WARTHOG_TILED_HEURISTIC_H
+#define WARTHOG_TILED_HEURISTIC_H
+
+// tiled_heuristic.h
+//
+// Adapts a grid heuristic (e.g. octile_heuristic, manhattan_heuristic) to
+// the node ids of a tiled_gridmap, which are not row-major.
+//
+
+#include "constants.h"
+#include "tiled_gridmap.h"
+
+namespace warthog
+{
+
+template<class H>
+class tiled_heuristic
+{
+    public:
+        tiled_heuristic(warthog::tiled_gridmap* map)
+            : map_(map), h_(map->width(), map->height())
+        { }
+
+        ~tiled_heuristic() { }
+
+        inline double
+        h(int32_t x, int32_t y, int32_t x2, int32_t y2)
+        {
+            return h_.h(x, y, x2, y2);
+        }
+
+        inline double
+        h(warthog::sn_id_t id, warthog::sn_id_t id2)
+        {
+            uint32_t x, y, x2, y2;
+            map_->to_xy((uint32_t)id, x, y);
+            map_->to_xy((uint32_t)id2, x2, y2);
+            return h_.h((int32_t)x, (int32_t)y, (int32_t)x2, (int32_t)y2);
+        }
+
+        inline void
+        set_hscale(double hscale) { h_.set_hscale(hscale); }
+
+        inline double
+        get_hscale() { return h_.get_hscale(); }
+
+        size_t
+        mem() { return sizeof(this); }
+
+    private:
+        warthog::tiled_gridmap* map_;
+        H h_;
+};
+
+}
+
+#endif
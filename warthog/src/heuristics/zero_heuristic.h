@@ -11,6 +11,7 @@
 #include "helpers.h"
 
 #include <cstdlib>
+#include <vector>
 
 namespace warthog
 {
@@ -33,6 +34,10 @@ class zero_heuristic
             return 0;
 		}
 
+        // zero is a lower bound for any goal set (cf. one-to-many search)
+        inline void
+        set_targets(const std::vector<warthog::sn_id_t>& targets) { }
+
         size_t
         mem() { return sizeof(this); } 
 };
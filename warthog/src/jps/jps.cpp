@@ -4,6 +4,13 @@
 #include "online_jump_point_locator2.h"
 #include "xy_graph.h"
 
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WARTHOG_JPS_X86
+#endif
+
 // computes the forced neighbours of a node.
 // for a neighbour to be forced we must check that 
 // (a) the alt path from the parent is blocked and
@@ -317,3 +324,112 @@ warthog::jps::create_corner_map(warthog::gridmap* gm)
 //    assert(dir != warthog::jps::NONE);
 //    return dir;
 //}
+
+// the default is a constant, so that locators created on several threads
+// read the width without any lazy initialisation
+static std::atomic<uint32_t> jump_width_(64);
+
+uint32_t
+warthog::jps::get_jump_width()
+{
+    return jump_width_.load(std::memory_order_relaxed);
+}
+
+void
+warthog::jps::set_jump_width(uint32_t bits)
+{
+    uint32_t width = 32;
+    if(bits >= 256 && warthog::jps::cpu_has_avx2()) { width = 256; }
+    else if(bits >= 64) { width = 64; }
+    jump_width_.store(width, std::memory_order_relaxed);
+}
+
+bool
+warthog::jps::cpu_has_avx2()
+{
+#ifdef WARTHOG_JPS_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+#ifdef WARTHOG_JPS_X86
+
+// true if the 256 tiles in @param tiles are all traversable or all blocked
+__attribute__((target("avx2"))) static inline bool
+uniform_256(__m256i tiles)
+{
+    return _mm256_testc_si256(tiles, _mm256_set1_epi8(-1)) ||
+        _mm256_testz_si256(tiles, tiles);
+}
+
+// a block of 256 tiles, starting at @param p, is skipped if the middle 
+// row has no obstacle (no dead-end) and neither the row above nor the
+// row below changes from obstacle to traversable (no forced neighbour).
+// tiles of the first dbword that precede the current node are tested
+// too; they can only make the test fail.
+__attribute__((target("avx2"))) static inline bool
+skippable_256(const warthog::dbword* p, uint32_t dbwidth)
+{
+    __m256i mid = _mm256_loadu_si256((const __m256i*)p);
+    if(!_mm256_testc_si256(mid, _mm256_set1_epi8(-1))) { return false; }
+    return uniform_256(_mm256_loadu_si256((const __m256i*)(p - dbwidth))) &&
+        uniform_256(_mm256_loadu_si256((const __m256i*)(p + dbwidth)));
+}
+
+__attribute__((target("avx2"))) uint32_t
+warthog::jps::skip_east_256(warthog::gridmap* map, uint32_t node_id)
+{
+    const uint32_t word_bits = warthog::DBWORD_BITS_MASK + 1;
+    const uint32_t block_words = 256 / word_bits;
+    uint32_t dbwidth = map->dbwidth();
+
+    // the last tile read, from the row below, must still be inside the map
+    while(map->get_mem_ptr(node_id + map->width() + 255 + word_bits))
+    {
+        const warthog::dbword* p = map->get_mem_ptr(node_id);
+        if(!skippable_256(p, dbwidth)) { break; }
+
+        // stop on the last tile of the block; the next scan checks it 
+        // against the tiles that follow.
+        uint32_t dbindex = node_id >> warthog::LOG2_DBWORD_BITS;
+        node_id = (dbindex + block_words) * word_bits - 1;
+    }
+    return node_id;
+}
+
+__attribute__((target("avx2"))) uint32_t
+warthog::jps::skip_west_256(warthog::gridmap* map, uint32_t node_id)
+{
+    const uint32_t word_bits = warthog::DBWORD_BITS_MASK + 1;
+    const uint32_t block_words = 256 / word_bits;
+    uint32_t dbwidth = map->dbwidth();
+
+    // the first tile read, from the row above, must still be inside the map
+    while(node_id >= map->width() + 256 + word_bits)
+    {
+        uint32_t dbindex = node_id >> warthog::LOG2_DBWORD_BITS;
+        uint32_t first_id = (dbindex + 1 - block_words) * word_bits;
+        const warthog::dbword* p = map->get_mem_ptr(first_id);
+        if(!skippable_256(p, dbwidth)) { break; }
+        node_id = first_id;
+    }
+    return node_id;
+}
+
+#else
+
+uint32_t
+warthog::jps::skip_east_256(warthog::gridmap* map, uint32_t node_id)
+{
+    return node_id;
+}
+
+uint32_t
+warthog::jps::skip_west_256(warthog::gridmap* map, uint32_t node_id)
+{
+    return node_id;
+}
+
+#endif
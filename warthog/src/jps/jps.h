@@ -175,6 +175,41 @@ compute_successors_4c(warthog::jps::direction d, uint32_t tiles)
     return retval;
 }
 
+// online jump point locators scan the grid for straight jumps one word of
+// tiles at a time. the word is 32 bits (the original scanners), 64 bits or,
+// when the cpu supports AVX2, 64 bits together with an early test of 256
+// tiles from each of the three rows (cf. ::skip_east_256).
+//
+// @return the width used by locators created from now on. unless set, 64:
+// the skip over 256 tiles only pays off on maps with long open runs, and
+// costs time on short jumps.
+uint32_t
+get_jump_width();
+
+// set the width, in bits, used by locators created after this call. widths
+// that are unsupported are rounded down to the next supported one.
+void
+set_jump_width(uint32_t bits);
+
+// @return true if the cpu executing the program supports AVX2
+bool
+cpu_has_avx2();
+
+// starting from @param node_id, skip east (toward larger ids) over blocks
+// of 256 tiles where no straight jump, forward or reversed, can stop:
+// the row of node_id has no obstacles and the rows above and below are each
+// entirely traversable or entirely blocked. requires AVX2.
+//
+// @return the last tile of the last block skipped; @param node_id if none.
+uint32_t
+skip_east_256(warthog::gridmap* map, uint32_t node_id);
+
+// as ::skip_east_256 but toward smaller ids
+//
+// @return the first tile of the last block skipped; @param node_id if none.
+uint32_t
+skip_west_256(warthog::gridmap* map, uint32_t node_id);
+
 // creates a warthog::graph::xy_graph which contains only 
 // nodes that are jump points and edges which represent valid jumps,
 // from one jump point to another.
@@ -31,7 +31,7 @@ warthog::jps2plus_expansion_policy::expand(
 	// get the tiles around the current node c
 	uint32_t c_tiles;
 	uint32_t current_id = (uint32_t)current->get_id();
-	map_->get_neighbours(current_id, (uint8_t*)&c_tiles);
+	jpl_->get_map()->get_neighbours(current_id, (uint8_t*)&c_tiles);
 
 	// look for jump points in the direction of each natural 
 	// and forced neighbour
@@ -68,12 +68,15 @@ warthog::search_node*
 warthog::jps2plus_expansion_policy::generate_start_node(
         warthog::problem_instance* pi)
 { 
+    // every search sees one version of the map and its jump points
+    jpl_->refresh();
+
     uint32_t max_id = map_->header_width() * map_->header_height();
     uint32_t start_id = (uint32_t)pi->start_id_;
 
     if(start_id >= max_id) { return 0; }
     uint32_t padded_id = map_->to_padded_id(start_id);
-    if(map_->get_label(padded_id) == 0) { return 0; }
+    if(jpl_->get_map()->get_label(padded_id) == 0) { return 0; }
     return generate(padded_id);
 }
 
@@ -81,12 +84,16 @@ warthog::search_node*
 warthog::jps2plus_expansion_policy::generate_target_node(
         warthog::problem_instance* pi)
 {
+    // flexible_astar generates the target first; check it against the
+    // latest version too
+    jpl_->refresh();
+
     uint32_t max_id = map_->header_width() * map_->header_height();
     uint32_t target_id = (uint32_t)pi->target_id_;
 
     if(target_id >= max_id) { return 0; }
     uint32_t padded_id = map_->to_padded_id(target_id);
-    if(map_->get_label(padded_id) == 0) { return 0; }
+    if(jpl_->get_map()->get_label(padded_id) == 0) { return 0; }
     return generate(padded_id);
 }
 
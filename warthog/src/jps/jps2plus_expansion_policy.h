@@ -40,6 +40,11 @@ class jps2plus_expansion_policy : public expansion_policy
                 map_->mem() + jpl_->mem();
 		}
 
+        // the jump point database, e.g. to update it when tiles of the map
+        // change (cf. warthog::jump_point_db::update)
+        inline warthog::jump_point_db*
+        get_database() { return jpl_->get_database(); }
+
         virtual void
         get_xy(warthog::sn_id_t node_id, int32_t& x, int32_t& y);
 
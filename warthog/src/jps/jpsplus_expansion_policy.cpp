@@ -25,7 +25,7 @@ warthog::jpsplus_expansion_policy::expand(
 	// get the tiles around the current node c
 	uint32_t c_tiles;
 	uint32_t current_id = (uint32_t)current->get_id();
-	map_->get_neighbours(current_id, (uint8_t*)&c_tiles);
+	jpl_->get_map()->get_neighbours(current_id, (uint8_t*)&c_tiles);
 
 	// look for jump points in the direction of each natural 
 	// and forced neighbour
@@ -59,10 +59,13 @@ warthog::search_node*
 warthog::jpsplus_expansion_policy::generate_start_node(
         warthog::problem_instance* pi)
 { 
+    // every search sees one version of the map and its jump points
+    jpl_->refresh();
+
     uint32_t max_id = map_->header_width() * map_->header_height();
     if((uint32_t)pi->start_id_ >= max_id) { return 0; }
     uint32_t padded_id = map_->to_padded_id((uint32_t)pi->start_id_);
-    if(map_->get_label(padded_id) == 0) { return 0; }
+    if(jpl_->get_map()->get_label(padded_id) == 0) { return 0; }
     return generate(padded_id);
 }
 
@@ -70,9 +73,13 @@ warthog::search_node*
 warthog::jpsplus_expansion_policy::generate_target_node(
         warthog::problem_instance* pi)
 {
+    // flexible_astar generates the target first; check it against the
+    // latest version too
+    jpl_->refresh();
+
     uint32_t max_id = map_->header_width() * map_->header_height();
     if((uint32_t)pi->target_id_ >= max_id) { return 0; }
     uint32_t padded_id = map_->to_padded_id((uint32_t)pi->target_id_);
-    if(map_->get_label(padded_id) == 0) { return 0; }
+    if(jpl_->get_map()->get_label(padded_id) == 0) { return 0; }
     return generate(padded_id);
 }
@@ -0,0 +1,587 @@
+#include "gridmap.h"
+#include "helpers.h"
+#include "jump_point_db.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+
+// shared by the workers of both passes
+struct preproc_data
+{
+    warthog::gridmap* map_;
+    uint16_t* db_;
+};
+
+const uint16_t DEAD_END = 32768;
+
+// where a jump ends, as it is computed: the leading bit of a label, then
+// the number of steps
+const uint32_t G_DEAD_END = 1u << 31;
+
+uint16_t
+make_label(uint32_t g)
+{
+    uint32_t num_steps = g & ~G_DEAD_END;
+    if(num_steps > DEAD_END)
+    {
+        std::cerr << "label overflow; maximum jump distance exceeded. "
+            << "aborting\n";
+        exit(1);
+    }
+
+    // set the leading bit if the jump leads to a dead-end
+    uint16_t label = (uint16_t)num_steps;
+    if(g & G_DEAD_END) { label |= DEAD_END; }
+    return label;
+}
+
+// a straight jump from @param mapid moves @param step ids at a time and
+// @param side is the id offset of the tiles to either side of the jump;
+// where does it end? @param g_next is the answer for the next tile.
+// as in online_jump_point_locator, a jump stops at the first tile with a
+// forced neighbour, or before the first obstacle.
+inline uint32_t
+straight(warthog::gridmap* map, uint32_t mapid, uint32_t step,
+        uint32_t side, uint32_t g_next)
+{
+    uint32_t next = mapid + step;
+    if(!map->get_label(mapid) || !map->get_label(next))
+    {
+        return G_DEAD_END;
+    }
+    if((map->get_label(next - side) && !map->get_label(mapid - side)) ||
+       (map->get_label(next + side) && !map->get_label(mapid + side)))
+    {
+        return 1;
+    }
+    return g_next + 1;
+}
+
+// the diagonal directions, as offsets in x and y. each is indexed as its
+// label (i.e. 4 is NORTHEAST); the straight jumps that end a diagonal jump
+// are the vertical one, then the horizontal one.
+const int32_t DIAG_DX[8] = {0, 0, 0, 0, 1, -1, 1, -1};
+const int32_t DIAG_DY[8] = {0, 0, 0, 0, -1, -1, 1, 1};
+const uint32_t DIAG_VERT[8] = {0, 0, 0, 0, 0, 0, 1, 1};
+const uint32_t DIAG_HORZ[8] = {0, 0, 0, 0, 2, 3, 2, 3};
+
+// the tiles of the 3x3 neighbourhood that must be traversable for the
+// first diagonal step (cf. online_jump_point_locator)
+const uint32_t DIAG_FIRST_STEP[8] = {0, 0, 0, 0, 1542, 771, 394752, 197376};
+
+// a diagonal jump in direction @param i steps onto @param mapid; where
+// does it end? @param g_next is the answer for the next tile on the line.
+uint32_t
+reach(uint16_t* db, uint32_t mapid, uint32_t i, uint32_t g_next)
+{
+    uint16_t vert = db[mapid*8 + DIAG_VERT[i]];
+    uint16_t horz = db[mapid*8 + DIAG_HORZ[i]];
+
+    // a straight jump found a jump point; stop here
+    if(!(vert & DEAD_END) || !(horz & DEAD_END)) { return 1; }
+
+    // no straight move is possible; the diagonal jump is a dead-end
+    if(!(vert & (DEAD_END-1)) || !(horz & (DEAD_END-1)))
+    {
+        return G_DEAD_END | 1;
+    }
+    return g_next + 1;
+}
+
+// the label of a diagonal jump in direction @param i from @param mapid;
+// @return where a diagonal jump that reaches @param mapid ends
+inline uint32_t
+diagonal(warthog::gridmap* map, uint16_t* db, uint32_t mapid, uint32_t i,
+        uint32_t g_next)
+{
+    uint32_t neis = 0;
+    map->get_neighbours(mapid, (uint8_t*)&neis);
+    if((neis & DIAG_FIRST_STEP[i]) != DIAG_FIRST_STEP[i])
+    {
+        db[mapid*8 + i] = DEAD_END;
+    }
+    else
+    {
+        db[mapid*8 + i] = make_label(g_next);
+    }
+    return reach(db, mapid, i, g_next);
+}
+
+// the tiles on which jumps in direction @param i move are on lines of the
+// map: rows (key y) for east and west, columns (key x) for north and south
+// and the diagonal lines (key x - dx*dy*y) for the diagonal directions.
+// the @param r-th tile of a line, in the reverse order of the jumps, is
+// at (@param x, @param y); @return false if it is off the map.
+inline uint32_t
+line_length(warthog::gridmap* map, uint32_t i)
+{
+    return (i == 2 || i == 3) ? map->header_width() : map->header_height();
+}
+
+inline bool
+line_xy(warthog::gridmap* map, uint32_t i, int32_t key, uint32_t r,
+        uint32_t& x, uint32_t& y)
+{
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    switch(i)
+    {
+        case 0: x = (uint32_t)key; y = r; break;
+        case 1: x = (uint32_t)key; y = h - 1 - r; break;
+        case 2: x = w - 1 - r; y = (uint32_t)key; break;
+        case 3: x = r; y = (uint32_t)key; break;
+        default:
+            y = DIAG_DY[i] < 0 ? r : h - 1 - r;
+            x = (uint32_t)(key + DIAG_DX[i] * DIAG_DY[i] * (int32_t)y);
+            break;
+    }
+    return x < w && y < h;
+}
+
+inline int32_t
+line_key(uint32_t i, uint32_t x, uint32_t y)
+{
+    if(i < 2) { return (int32_t)x; }
+    if(i < 4) { return (int32_t)y; }
+    return (int32_t)x - DIAG_DX[i] * DIAG_DY[i] * (int32_t)y;
+}
+
+// recompute the labels of a line. tiles whose straight labels change are
+// appended to @param changed, if given.
+void
+sweep_line(warthog::gridmap* map, uint16_t* db, uint32_t i, int32_t key,
+        std::vector<uint32_t>* changed)
+{
+    uint32_t pw = map->width();
+    uint32_t step = i == 0 ? (uint32_t)-pw : i == 1 ? pw :
+        i == 2 ? 1 : (uint32_t)-1;
+    uint32_t side = i < 2 ? 1 : pw;
+    uint32_t g = G_DEAD_END;
+    for(uint32_t r = 0; r < line_length(map, i); r++)
+    {
+        uint32_t x, y;
+        if(!line_xy(map, i, key, r, x, y)) { continue; }
+        uint32_t mapid = map->to_padded_id(x, y);
+        if(i >= 4)
+        {
+            g = diagonal(map, db, mapid, i, g);
+            continue;
+        }
+
+        g = straight(map, mapid, step, side, g);
+        uint16_t label = make_label(g);
+        if(changed && db[mapid*8 + i] != label) { changed->push_back(mapid); }
+        db[mapid*8 + i] = label;
+    }
+}
+
+// first pass: straight jumps. tiles are visited in the reverse order of
+// the jumps, so that every tile is reached after the next one. each task
+// is a row of the map, for east or west, or a band of adjacent columns,
+// for north or south, walked one row at a time.
+const uint32_t STRAIGHT_BAND = 64;
+
+void*
+straight_worker(void* arg)
+{
+    warthog::helpers::thread_params* par =
+        (warthog::helpers::thread_params*)arg;
+    preproc_data* shared = (preproc_data*)par->shared_;
+    warthog::gridmap* map = shared->map_;
+    uint16_t* db = shared->db_;
+
+    uint32_t w = map->header_width();
+    uint32_t h = map->header_height();
+    uint32_t pw = map->width();
+    uint32_t bands = (w + STRAIGHT_BAND - 1) / STRAIGHT_BAND;
+
+    uint32_t g_next[STRAIGHT_BAND];
+    for(uint32_t task = par->thread_id_; task < 2*h + 2*bands;
+            task += par->max_threads_)
+    {
+        if(task < 2*h)
+        {
+            // east (2) or west (3)
+            sweep_line(map, db, 2 + task / h, (int32_t)(task % h), 0);
+        }
+        else
+        {
+            // north (0) or south (1)
+            uint32_t i = (task - 2*h) / bands;
+            uint32_t first = ((task - 2*h) % bands) * STRAIGHT_BAND;
+            uint32_t step = i == 0 ? (uint32_t)-pw : pw;
+            for(uint32_t j = 0; j < STRAIGHT_BAND; j++)
+            {
+                g_next[j] = G_DEAD_END;
+            }
+            for(uint32_t r = 0; r < h; r++)
+            {
+                uint32_t y = i == 0 ? r : h - 1 - r;
+                for(uint32_t j = 0; j < STRAIGHT_BAND && first + j < w; j++)
+                {
+                    uint32_t mapid = map->to_padded_id(first + j, y);
+                    g_next[j] = straight(map, mapid, step, 1, g_next[j]);
+                    db[mapid*8 + i] = make_label(g_next[j]);
+                }
+            }
+        }
+        par->nprocessed_++;
+    }
+    return 0;
+}
+
+// second pass: diagonal jumps. tiles are visited in the reverse order of
+// the jumps, so that every tile is reached after the tile that follows it
+// on its diagonal line. each task is a band of adjacent lines of the map,
+// for one diagonal direction, walked one row at a time: the tiles of a
+// band in a row are adjacent in memory. the last tile of a line is on the
+// edge of the map and every jump from it is a dead-end, so a line can be
+// started without knowing what lies beyond the map.
+const uint32_t DIAG_BAND = 64;
+
+void*
+diagonal_worker(void* arg)
+{
+    warthog::helpers::thread_params* par =
+        (warthog::helpers::thread_params*)arg;
+    preproc_data* shared = (preproc_data*)par->shared_;
+    warthog::gridmap* map = shared->map_;
+    uint16_t* db = shared->db_;
+
+    int32_t w = (int32_t)map->header_width();
+    int32_t h = (int32_t)map->header_height();
+    int32_t lines = w + h - 1;
+    uint32_t bands = (uint32_t)(lines + DIAG_BAND - 1) / DIAG_BAND;
+
+    uint32_t g_next[DIAG_BAND];
+    for(uint32_t task = par->thread_id_; task < 4*bands;
+            task += par->max_threads_)
+    {
+        uint32_t i = 4 + task / bands;
+        int32_t dx = DIAG_DX[i], dy = DIAG_DY[i];
+
+        // a line is the set of tiles (k + dx*dy*y, y), for some k
+        int32_t first = (int32_t)(task % bands) * DIAG_BAND;
+        if(dx * dy > 0) { first -= h - 1; }
+        for(uint32_t j = 0; j < DIAG_BAND; j++) { g_next[j] = G_DEAD_END; }
+
+        for(int32_t r = 0; r < h; r++)
+        {
+            int32_t y = dy < 0 ? r : h - 1 - r;
+            for(int32_t j = 0; j < (int32_t)DIAG_BAND; j++)
+            {
+                int32_t x = first + j + dx * dy * y;
+                if(x < 0 || x >= w) { continue; }
+
+                uint32_t mapid = map->to_padded_id((uint32_t)x, (uint32_t)y);
+                g_next[j] = diagonal(map, db, mapid, i, g_next[j]);
+            }
+        }
+        par->nprocessed_++;
+    }
+    return 0;
+}
+
+}
+
+warthog::jump_point_db::jump_point_db(warthog::gridmap* map)
+    : map_(map), dbsize_(0), version_(0)
+{
+    if(map_->filename()[0] == '\0')
+    {
+        preproc();
+    }
+    else if(!load(map_->filename()))
+    {
+        preproc();
+        save(map_->filename());
+    }
+
+    // later versions of the map are copies of this one
+    publish(std::make_shared<warthog::gridmap>(*map_));
+}
+
+warthog::jump_point_db::~jump_point_db()
+{
+}
+
+size_t
+warthog::jump_point_db::mem()
+{
+    return sizeof(*this) + current_->map_->mem() +
+        sizeof(uint16_t) * dbsize_ * ((owned_db_ ? 1 : 0) +
+                (spare_db_ ? 1 : 0));
+}
+
+uint64_t
+warthog::jump_point_db::hash_map(warthog::gridmap* map)
+{
+    uint32_t dims[4] = {map->header_height(), map->header_width(),
+        map->height(), map->width()};
+    uint64_t hash = warthog::helpers::fnv64(dims, sizeof(dims));
+    return warthog::helpers::fnv64(
+            map->get_mem_ptr(0), map->padded_mapsize() / 8, hash);
+}
+
+void
+warthog::jump_point_db::preproc()
+{
+    warthog::timer t;
+    t.start();
+
+    dbsize_ = 8*map_->padded_mapsize();
+    owned_db_ = std::shared_ptr<uint16_t>(
+            new uint16_t[dbsize_], std::default_delete<uint16_t[]>());
+    memset(owned_db_.get(), 0, sizeof(uint16_t) * dbsize_);
+    db_ = owned_db_;
+
+    preproc_data shared = {map_, owned_db_.get()};
+    uint32_t columns =
+        (map_->header_width() + STRAIGHT_BAND - 1) / STRAIGHT_BAND;
+    warthog::helpers::parallel_compute(straight_worker, &shared,
+            2 * map_->header_height() + 2 * columns);
+    uint32_t lines = map_->header_width() + map_->header_height() - 1;
+    warthog::helpers::parallel_compute(diagonal_worker, &shared,
+            4 * ((lines + DIAG_BAND - 1) / DIAG_BAND));
+
+    t.stop();
+    std::cerr << "jump point database computed in "
+        << t.elapsed_time_micro() / 1e6 << "s\n";
+}
+
+bool
+warthog::jump_point_db::load(const char* filename)
+{
+    std::string fname = std::string(filename) + ".jps+";
+    std::cerr << "loading " << fname << "... ";
+
+    std::shared_ptr<warthog::util::mapped_file> file =
+        std::make_shared<warthog::util::mapped_file>(fname.c_str());
+    if(!file->good())
+    {
+        std::cerr << "no dice. oh well. keep going.\n";
+        return false;
+    }
+
+    jump_point_db_header hdr;
+    if(file->size() < sizeof(hdr))
+    {
+        std::cerr << "not a jump point database; rebuilding.\n";
+        return false;
+    }
+    memcpy(&hdr, file->data(), sizeof(hdr));
+    if(memcmp(hdr.magic_, JUMP_POINT_DB_MAGIC, sizeof(hdr.magic_)) != 0 ||
+       hdr.version_ != JUMP_POINT_DB_VERSION)
+    {
+        std::cerr << "not a jump point database of version "
+            << JUMP_POINT_DB_VERSION << "; rebuilding.\n";
+        return false;
+    }
+
+    // labels are indexed by padded id; a table made for another map, or
+    // for this map with another padding (e.g. another dbword size), or
+    // for an older version of the map, cannot be used
+    if(hdr.dbword_bits_ != warthog::DBWORD_BITS ||
+       hdr.header_height_ != map_->header_height() ||
+       hdr.header_width_ != map_->header_width() ||
+       hdr.padded_height_ != map_->height() ||
+       hdr.padded_width_ != map_->width() ||
+       hdr.num_labels_ != 8*(uint64_t)map_->padded_mapsize() ||
+       hdr.map_hash_ != hash_map(map_))
+    {
+        std::cerr << "database does not match the map; rebuilding.\n";
+        return false;
+    }
+
+    uint64_t labels_bytes = sizeof(uint16_t) * hdr.num_labels_;
+    if(hdr.labels_offset_ % sizeof(uint64_t) != 0 ||
+       hdr.labels_offset_ + labels_bytes > file->size() ||
+       warthog::helpers::fnv64(file->data() + hdr.labels_offset_,
+           labels_bytes) != hdr.checksum_)
+    {
+        std::cerr << "database is corrupt; rebuilding.\n";
+        return false;
+    }
+
+    file_ = file;
+    dbsize_ = (uint32_t)hdr.num_labels_;
+    db_ = std::shared_ptr<const uint16_t>(
+            file, (const uint16_t*)(file->data() + hdr.labels_offset_));
+    std::cerr << "#labels=" << dbsize_ << std::endl;
+    return true;
+}
+
+bool
+warthog::jump_point_db::save(const char* filename)
+{
+    std::string fname = std::string(filename) + ".jps+";
+    std::cerr << "saving to file " << fname << "; labels=" << dbsize_
+        << std::endl;
+
+    jump_point_db_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic_, JUMP_POINT_DB_MAGIC, sizeof(hdr.magic_));
+    hdr.version_ = JUMP_POINT_DB_VERSION;
+    hdr.dbword_bits_ = warthog::DBWORD_BITS;
+    hdr.header_height_ = map_->header_height();
+    hdr.header_width_ = map_->header_width();
+    hdr.padded_height_ = map_->height();
+    hdr.padded_width_ = map_->width();
+    hdr.map_hash_ = hash_map(map_);
+    hdr.num_labels_ = dbsize_;
+    hdr.labels_offset_ = sizeof(hdr);
+    hdr.checksum_ =
+        warthog::helpers::fnv64(db_.get(), sizeof(uint16_t) * dbsize_);
+
+    // write a temporary file and rename it, so that a process loading the
+    // database never sees it half written
+    std::string tmpname = fname + ".tmp";
+    std::ofstream out(tmpname, std::ios_base::out | std::ios_base::binary);
+    out.write((char*)&hdr, sizeof(hdr));
+    out.write((const char*)db_.get(), sizeof(uint16_t) * dbsize_);
+    out.close();
+    if(!out.good() || rename(tmpname.c_str(), fname.c_str()) != 0)
+    {
+        std::cerr << "err; cannot write jump point database to file "
+            << fname << ". oh well. try to keep going.\n";
+        remove(tmpname.c_str());
+        return false;
+    }
+    std::cerr << "jump point database saved to disk. file=" << fname
+        << std::endl;
+    return true;
+}
+
+void
+warthog::jump_point_db::publish(
+        const std::shared_ptr<warthog::gridmap>& map)
+{
+    std::shared_ptr<version_data> next = std::make_shared<version_data>();
+    next->map_ = map;
+    next->labels_ = db_;
+    std::atomic_store(&current_, std::shared_ptr<const version_data>(next));
+}
+
+void
+warthog::jump_point_db::update(
+        const std::vector<std::pair<uint32_t, bool>>& tiles)
+{
+    if(tiles.empty()) { return; }
+
+    // the tiles of the next version; readers keep the current ones
+    std::shared_ptr<warthog::gridmap> map =
+        std::make_shared<warthog::gridmap>(*current_->map_);
+    std::vector<uint32_t> cells;
+    for(const std::pair<uint32_t, bool>& tile : tiles)
+    {
+        map->set_label(tile.first, tile.second);
+        cells.push_back(tile.first);
+    }
+
+    // the labels to repair: the spare, if no reader holds it any more, or
+    // else a new copy of the current version
+    std::shared_ptr<uint16_t> next;
+    next.swap(spare_db_);
+    if(next && next.use_count() == 1)
+    {
+        // the spare lacks only the lines changed by the last update
+        std::atomic_thread_fence(std::memory_order_acquire);
+        for(const line& l : last_update_)
+        {
+            for(uint32_t r = 0; r < line_length(map_, l.dir_); r++)
+            {
+                uint32_t x, y;
+                if(!line_xy(map_, l.dir_, l.key_, r, x, y)) { continue; }
+                uint32_t label = map_->to_padded_id(x, y)*8 + l.dir_;
+                next.get()[label] = db_.get()[label];
+            }
+        }
+    }
+    else
+    {
+        next = std::shared_ptr<uint16_t>(
+                new uint16_t[dbsize_], std::default_delete<uint16_t[]>());
+        memcpy(next.get(), db_.get(), sizeof(uint16_t) * dbsize_);
+    }
+
+    // straight jumps see the tiles on their own line and on either side
+    uint32_t w = map_->header_width();
+    uint32_t h = map_->header_height();
+    std::vector<line> straight_lines;
+    for(uint32_t cell : cells)
+    {
+        uint32_t cx, cy;
+        map_->to_unpadded_xy(cell, cx, cy);
+        for(int32_t d = -1; d <= 1; d++)
+        {
+            uint32_t x = cx + d, y = cy + d;
+            if(x < w)
+            {
+                straight_lines.push_back({0, (int32_t)x});
+                straight_lines.push_back({1, (int32_t)x});
+            }
+            if(y < h)
+            {
+                straight_lines.push_back({2, (int32_t)y});
+                straight_lines.push_back({3, (int32_t)y});
+            }
+        }
+    }
+    std::sort(straight_lines.begin(), straight_lines.end());
+    straight_lines.erase(std::unique(straight_lines.begin(),
+                straight_lines.end()), straight_lines.end());
+
+    std::vector<uint32_t> changed;
+    for(const line& l : straight_lines)
+    {
+        sweep_line(map.get(), next.get(), l.dir_, l.key_, &changed);
+    }
+
+    // diagonal jumps see the 3x3 neighbourhood of their first step and
+    // the straight jumps from each tile they cross
+    for(uint32_t cell : cells)
+    {
+        for(int32_t d = -1; d <= 1; d++)
+        {
+            changed.push_back(cell + d - map_->width());
+            changed.push_back(cell + d);
+            changed.push_back(cell + d + map_->width());
+        }
+    }
+    std::vector<line> diagonal_lines;
+    for(uint32_t mapid : changed)
+    {
+        uint32_t x, y;
+        map_->to_unpadded_xy(mapid, x, y);
+        if(x >= w || y >= h) { continue; }
+        for(uint32_t i = 4; i < 8; i++)
+        {
+            diagonal_lines.push_back({i, line_key(i, x, y)});
+        }
+    }
+    std::sort(diagonal_lines.begin(), diagonal_lines.end());
+    diagonal_lines.erase(std::unique(diagonal_lines.begin(),
+                diagonal_lines.end()), diagonal_lines.end());
+
+    for(const line& l : diagonal_lines)
+    {
+        sweep_line(map.get(), next.get(), l.dir_, l.key_, 0);
+    }
+
+    // publish the new version; the old one becomes the spare
+    last_update_.swap(straight_lines);
+    last_update_.insert(last_update_.end(),
+            diagonal_lines.begin(), diagonal_lines.end());
+    spare_db_ = owned_db_;
+    owned_db_ = next;
+    db_ = next;
+    publish(map);
+    version_++;
+}
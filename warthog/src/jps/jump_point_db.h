@@ -0,0 +1,164 @@
+#ifndef WARTHOG_JUMP_POINT_DB_H
+#define WARTHOG_JUMP_POINT_DB_H
+
+// jump_point_db.h
+//
+// The table of jump distances used by JPS+ (cf. offline_jump_point_locator
+// and offline_jump_point_locator2): for every tile and each of the eight
+// directions, the number of steps to the next jump point, with the leading
+// bit set if the jump ends in a dead-end. Labels are indexed by padded id:
+// the label for direction 1 << i of tile t is at 8*t + i.
+//
+// The table is saved next to the map, as [map file].jps+, and mapped
+// read-only when loaded. The file has a versioned header that records the
+// dimensions of the padded map, a hash of its tiles and a checksum of the
+// labels; a file that does not match the map, or is corrupt, is never
+// used: the table is rebuilt and the file replaced.
+//
+// Building the table takes two passes, each shared among all cores, and
+// no search: every jump continues as the jump from the next tile, unless
+// that tile is a jump point or an obstacle. The first pass sweeps each row
+// and column of the map against the direction of the straight jumps. The
+// second sweeps each diagonal line of the map the same way; a diagonal
+// jump stops at a tile where a straight jump finds a jump point.
+//
+// When tiles of the map change, ::update recomputes only the lines near
+// them: rows and columns within one tile, then the diagonal lines through
+// the tiles whose labels changed. The database holds its own copy of the
+// map, and every change of a tile goes through ::update, so the tiles and
+// the labels are versioned together. Readers are never blocked: each takes
+// a snapshot of the current version (e.g. once per search) and reads both
+// the tiles and the labels from it, while ::update repairs a spare copy,
+// which it then swaps in as the next version. The spare labels are the
+// previous version, once no reader holds it; neither the map passed to
+// the constructor nor the file on disk is updated.
+//
+
+#include "mapped_file.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace warthog
+{
+
+struct jump_point_db_header
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t dbword_bits_;
+    uint32_t header_height_;
+    uint32_t header_width_;
+    uint32_t padded_height_;
+    uint32_t padded_width_;
+    uint64_t map_hash_;         // cf. jump_point_db::hash_map
+    uint64_t num_labels_;
+    uint64_t labels_offset_;
+    uint64_t checksum_;         // helpers::fnv64 of the labels
+};
+
+static const char JUMP_POINT_DB_MAGIC[8] = {'W', 'H', 'J', 'P', 'S', 'P', 'L', 'S'};
+static const uint32_t JUMP_POINT_DB_VERSION = 1;
+
+class gridmap;
+class jump_point_db
+{
+    public:
+        // loads the table of @param map from disk or, if there is no
+        // valid one, builds it and saves it. the table of a map that was
+        // not read from a file is built and kept in memory.
+        jump_point_db(warthog::gridmap* map);
+        ~jump_point_db();
+
+        // the tiles of the map and their labels, as of one version
+        struct version_data
+        {
+            std::shared_ptr<warthog::gridmap> map_;
+            std::shared_ptr<const uint16_t> labels_;
+        };
+
+        // the current version of the map and the table. neither changes
+        // while the snapshot is held.
+        inline std::shared_ptr<const version_data>
+        snapshot() { return std::atomic_load(&current_); }
+
+        // incremented by every ::update
+        inline uint64_t
+        version() { return version_; }
+
+        inline uint32_t
+        size() { return dbsize_; }
+
+        // @return true if the current labels are mapped from disk
+        inline bool
+        is_mapped() { return file_ != nullptr && !owned_db_; }
+
+        // set each tile of @param tiles (a padded id, and whether it is
+        // traversable) in a copy of the current map, recompute the labels
+        // it affects, and make both the current version. one thread at a
+        // time may call update; snapshots can be taken concurrently.
+        void
+        update(const std::vector<std::pair<uint32_t, bool>>& tiles);
+
+        size_t
+        mem();
+
+        // a hash of the dimensions and tiles of @param map
+        static uint64_t
+        hash_map(warthog::gridmap* map);
+
+    private:
+        // a row, column or diagonal line of the map, cf. jump_point_db.cpp
+        struct line
+        {
+            uint32_t dir_;
+            int32_t key_;
+
+            bool
+            operator<(const line& other) const
+            {
+                return dir_ < other.dir_ ||
+                    (dir_ == other.dir_ && key_ < other.key_);
+            }
+
+            bool
+            operator==(const line& other) const
+            {
+                return dir_ == other.dir_ && key_ == other.key_;
+            }
+        };
+
+        warthog::gridmap* map_;                 // for its dimensions only
+        uint32_t dbsize_;
+        std::atomic<uint64_t> version_;
+        std::shared_ptr<const version_data> current_;
+        std::shared_ptr<const uint16_t> db_;    // current_->labels_
+        std::shared_ptr<uint16_t> owned_db_;    // db_, unless mapped
+        std::shared_ptr<uint16_t> spare_db_;    // the previous version
+        std::vector<line> last_update_;         // lines changed since
+        std::shared_ptr<warthog::util::mapped_file> file_;
+
+        void
+        preproc();
+
+        // make @param map and the labels in db_ the current version
+        void
+        publish(const std::shared_ptr<warthog::gridmap>& map);
+
+        bool
+        load(const char* filename);
+
+        bool
+        save(const char* filename);
+
+        jump_point_db(const jump_point_db& other) { }
+        jump_point_db&
+        operator=(const jump_point_db& other) { return *this; }
+};
+
+}
+
+#endif
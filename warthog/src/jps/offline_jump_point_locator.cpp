@@ -1,6 +1,5 @@
 #define __STDC_FORMAT_MACROS
 #include "gridmap.h"
-#include "online_jump_point_locator.h"
 #include "offline_jump_point_locator.h"
 
 #include <cstring>
@@ -10,120 +9,13 @@
 warthog::offline_jump_point_locator::offline_jump_point_locator(
 		warthog::gridmap* map) : map_(map)
 {
-	preproc();
+	jpdb_ = new warthog::jump_point_db(map_);
+	refresh();
 }
 
 warthog::offline_jump_point_locator::~offline_jump_point_locator()
 {
-	delete [] db_;
-}
-
-void
-warthog::offline_jump_point_locator::preproc()
-{
-	if(load(map_->filename())) { return; }
-
-	dbsize_ = 8*map_->padded_mapsize();
-	db_ = new uint16_t[dbsize_];
-	for(uint32_t i=0; i < dbsize_; i++) db_[i] = 0;
-
-	warthog::online_jump_point_locator jpl(map_);
-	for(uint32_t y = 0; y < map_->header_height(); y++)
-	{
-		for(uint32_t x = 0; x < map_->header_width(); x++)
-		{
-			uint32_t mapid = map_->to_padded_id(x, y);
-//			std::cout << mapid << " ";
-			for(uint32_t i = 0; i < 8; i++)
-			{
-				warthog::jps::direction dir = 
-					(warthog::jps::direction)(1 << i);
-//				std::cout << dir << ": ";
-				uint32_t jumpnode_id;
-				double jumpcost;
-				jpl.jump(dir, mapid,
-						warthog::INF32, jumpnode_id, jumpcost);
-				
-				// convert from cost to number of steps
-				if(dir > 8)
-				{
-					jumpcost = jumpcost / warthog::DBL_ROOT_TWO;
-				}
-				uint32_t num_steps = (uint16_t)floor((jumpcost + 0.5));
-//				std::cout << (jumpnode_id == warthog::INF ? 0 : num_steps) << " ";
-
-				// set the leading bit if the jump leads to a dead-end
-				if(jumpnode_id == warthog::INF32)
-				{
-					db_[mapid*8 + i] |= 32768;
-				}
-
-				// truncate jump cost so we can fit the label into a single byte
-				//if(num_steps > 32767)
-				//{
-				//	num_steps = 32767;
-				//	jumpnode_id = 0; 
-				//}
-
-				db_[mapid*8 + i] |= num_steps;
-
-				if(num_steps > 32768)
-				{
-					std::cerr << "label overflow; maximum jump distance exceeded. aborting\n";
-					exit(1);
-				}
-			}
-//			std::cout << std::endl;
-		}
-	}
-
-	save(map_->filename());
-}
-
-
-bool
-warthog::offline_jump_point_locator::load(const char* filename)
-{
-	char fname[256];
-	strcpy(fname, filename);
-	strcat(fname, ".jps+");
-	FILE* f = fopen(fname, "rb");
-	std::cerr << "loading "<<fname << "... ";
-	if(f == NULL) 
-	{
-		std::cerr << "no dice. oh well. keep going.\n"<<std::endl;
-		return false;
-	}
-	
-	fread(&dbsize_, sizeof(dbsize_), 1, f);
-	std::cerr <<"#labels="<<dbsize_<<std::endl;
-
-	db_ = new uint16_t[dbsize_];
-	fread(db_, sizeof(uint16_t), dbsize_, f);
-	fclose(f);
-	return true;
-}
-
-void 
-warthog::offline_jump_point_locator::save(const char* filename)
-{
-	char fname[256];
-	strcpy(fname, filename);
-	strcat(fname, ".jps+");
-	std::cerr << "saving to file "<<fname<<"; nodes="<<dbsize_<<" size: "<<sizeof(db_[0])<<std::endl;
-
-	FILE* f = fopen(fname, "wb");
-	if(f == NULL) 
-	{
-		std::cerr << "err; cannot write jump-point graph to file "
-			<<fname<<". oh well. try to keep going.\n"<<std::endl;
-		return;
-	}
-
-	fwrite(&dbsize_, sizeof(dbsize_), 1, f);
-	fwrite(db_, sizeof(*db_), dbsize_, f);
-	fclose(f);
-	std::cerr << "jump-point graph saved to disk. file="<<fname<<std::endl;
+	delete jpdb_;
 }
 
 void
@@ -14,6 +14,9 @@
 //
 
 #include "jps.h"
+#include "jump_point_db.h"
+
+#include <memory>
 
 namespace warthog
 {
@@ -32,20 +35,29 @@ class offline_jump_point_locator2
 		uint32_t
 		mem()
 		{
-			return sizeof(this) + sizeof(*db_)*dbsize_;
+			return (uint32_t)(sizeof(this) + jpdb_->mem());
 		}
 
+		// the database of jump points; e.g. to ::update it when the map
+		// changes
+		inline warthog::jump_point_db*
+		get_database() { return jpdb_; }
 
-	private:
+		// jumps use a snapshot of the database; take the latest version.
+		// called at the start of each search.
+		inline void
+		refresh()
+		{
+			snapshot_ = jpdb_->snapshot();
+			db_ = snapshot_->labels_.get();
+		}
 
-		void
-		preproc();
+		// the tiles of the map, as of the snapshot in use
+		inline warthog::gridmap*
+		get_map() { return snapshot_->map_.get(); }
 
-		bool
-		load(const char* filename);
 
-		void 
-		save(const char* filename);
+	private:
 
 		void
 		jump_northwest(uint32_t node_id, uint32_t goal_id, 
@@ -73,8 +85,10 @@ class offline_jump_point_locator2
 				std::vector<uint32_t>& neighbours, std::vector<double>& costs);
 
 		warthog::gridmap* map_;
-		uint32_t dbsize_;
-		uint16_t* db_;	
+		warthog::jump_point_db* jpdb_;
+		std::shared_ptr<const warthog::jump_point_db::version_data>
+			snapshot_;
+		const uint16_t* db_;
 };
 
 }
@@ -9,6 +9,7 @@ warthog::online_jump_point_locator::online_jump_point_locator(warthog::gridmap*
 	: map_(map)//, jumplimit_(UINT32_MAX)
 {
 	rmap_ = create_rmap();
+	set_jump_width(warthog::jps::get_jump_width());
 }
 
 warthog::online_jump_point_locator::~online_jump_point_locator()
@@ -16,6 +17,14 @@ warthog::online_jump_point_locator::~online_jump_point_locator()
 	delete rmap_;
 }
 
+void
+warthog::online_jump_point_locator::set_jump_width(uint32_t bits)
+{
+	if(bits >= 256 && warthog::jps::cpu_has_avx2()) { jump_width_ = 256; }
+	else if(bits >= 64) { jump_width_ = 64; }
+	else { jump_width_ = 32; }
+}
+
 // create a copy of the grid map which is rotated by 90 degrees clockwise.
 // this version will be used when jumping North or South. 
 warthog::gridmap*
@@ -52,48 +61,71 @@ void
 warthog::online_jump_point_locator::jump(warthog::jps::direction d,
 	   	uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
 		warthog::cost_t& jumpcost)
+{
+	switch(jump_width_)
+	{
+		case 256:
+			jump_w<256>(d, node_id, goal_id, jumpnode_id, jumpcost);
+			break;
+		case 64:
+			jump_w<64>(d, node_id, goal_id, jumpnode_id, jumpcost);
+			break;
+		default:
+			jump_w<32>(d, node_id, goal_id, jumpnode_id, jumpcost);
+			break;
+	}
+}
+
+// as ::jump, with straight jumps @tparam W tiles wide
+template<uint32_t W>
+void
+warthog::online_jump_point_locator::jump_w(warthog::jps::direction d,
+	   	uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
+		warthog::cost_t& jumpcost)
 {
 	switch(d)
 	{
 		case warthog::jps::NORTH:
-			jump_north(node_id, goal_id, jumpnode_id, jumpcost);
+			jump_north<W>(node_id, goal_id, jumpnode_id, jumpcost);
 			break;
 		case warthog::jps::SOUTH:
-			jump_south(node_id, goal_id, jumpnode_id, jumpcost);
+			jump_south<W>(node_id, goal_id, jumpnode_id, jumpcost);
 			break;
 		case warthog::jps::EAST:
-			jump_east(node_id, goal_id, jumpnode_id, jumpcost);
+			jump_east<W>(node_id, goal_id, jumpnode_id, jumpcost);
 			break;
 		case warthog::jps::WEST:
-			jump_west(node_id, goal_id, jumpnode_id, jumpcost);
+			jump_west<W>(node_id, goal_id, jumpnode_id, jumpcost);
 			break;
 		case warthog::jps::NORTHEAST:
-			jump_northeast(node_id, goal_id, jumpnode_id, jumpcost);
+			jump_northeast<W>(node_id, goal_id, jumpnode_id, jumpcost);
 			break;
 		case warthog::jps::NORTHWEST:
-			jump_northwest(node_id, goal_id, jumpnode_id, jumpcost);
+			jump_northwest<W>(node_id, goal_id, jumpnode_id, jumpcost);
 			break;
 		case warthog::jps::SOUTHEAST:
-			jump_southeast(node_id, goal_id, jumpnode_id, jumpcost);
+			jump_southeast<W>(node_id, goal_id, jumpnode_id, jumpcost);
 			break;
 		case warthog::jps::SOUTHWEST:
-			jump_southwest(node_id, goal_id, jumpnode_id, jumpcost);
+			jump_southwest<W>(node_id, goal_id, jumpnode_id, jumpcost);
 			break;
 		default:
 			break;
 	}
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::jump_north(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	node_id = this->map_id_to_rmap_id(node_id);
 	goal_id = this->map_id_to_rmap_id(goal_id);
-	__jump_north(node_id, goal_id, jumpnode_id, jumpcost, rmap_);
+	__jump_north<W>(node_id, goal_id, jumpnode_id, jumpcost, rmap_);
 	jumpnode_id = this->rmap_id_to_map_id(jumpnode_id);
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::__jump_north(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
@@ -101,19 +133,21 @@ warthog::online_jump_point_locator::__jump_north(uint32_t node_id,
 {
 	// jumping north in the original map is the same as jumping
 	// east when we use a version of the map rotated 90 degrees.
-	__jump_east(node_id, goal_id, jumpnode_id, jumpcost, rmap_);
+	jump_east_w<W>(node_id, goal_id, jumpnode_id, jumpcost, rmap_);
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::jump_south(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
 	node_id = this->map_id_to_rmap_id(node_id);
 	goal_id = this->map_id_to_rmap_id(goal_id);
-	__jump_south(node_id, goal_id, jumpnode_id, jumpcost, rmap_);
+	__jump_south<W>(node_id, goal_id, jumpnode_id, jumpcost, rmap_);
 	jumpnode_id = this->rmap_id_to_map_id(jumpnode_id);
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::__jump_south(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
@@ -121,14 +155,15 @@ warthog::online_jump_point_locator::__jump_south(uint32_t node_id,
 {
 	// jumping north in the original map is the same as jumping
 	// west when we use a version of the map rotated 90 degrees.
-	__jump_west(node_id, goal_id, jumpnode_id, jumpcost, rmap_);
+	jump_west_w<W>(node_id, goal_id, jumpnode_id, jumpcost, rmap_);
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::jump_east(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	__jump_east(node_id, goal_id, jumpnode_id, jumpcost, map_);
+	jump_east_w<W>(node_id, goal_id, jumpnode_id, jumpcost, map_);
 }
 
 
@@ -199,11 +234,12 @@ warthog::online_jump_point_locator::__jump_east(uint32_t node_id,
 }
 
 // analogous to ::jump_east 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::jump_west(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
 {
-	__jump_west(node_id, goal_id, jumpnode_id, jumpcost, map_);
+	jump_west_w<W>(node_id, goal_id, jumpnode_id, jumpcost, map_);
 }
 
 void
@@ -263,6 +299,7 @@ warthog::online_jump_point_locator::__jump_west(uint32_t node_id,
 	jumpcost = num_steps ;
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::jump_northeast(uint32_t node_id,
 	   	uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
@@ -294,9 +331,9 @@ warthog::online_jump_point_locator::jump_northeast(uint32_t node_id,
 		// (ensures we do not miss any optimal turning points)
 		uint32_t jp_id1, jp_id2;
         warthog::cost_t cost1, cost2;
-		__jump_north(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
+		__jump_north<W>(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
 		if(jp_id1 != warthog::INF32) { break; }
-		__jump_east(next_id, goal_id, jp_id2, cost2, map_);
+		jump_east_w<W>(next_id, goal_id, jp_id2, cost2, map_);
 		if(jp_id2 != warthog::INF32) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
@@ -307,6 +344,7 @@ warthog::online_jump_point_locator::jump_northeast(uint32_t node_id,
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::jump_northwest(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
@@ -337,9 +375,9 @@ warthog::online_jump_point_locator::jump_northwest(uint32_t node_id,
 		// (ensures we do not miss any optimal turning points)
 		uint32_t jp_id1, jp_id2;
         warthog::cost_t cost1, cost2;
-		__jump_north(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
+		__jump_north<W>(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
 		if(jp_id1 != warthog::INF32) { break; }
-		__jump_west(next_id, goal_id, jp_id2, cost2, map_);
+		jump_west_w<W>(next_id, goal_id, jp_id2, cost2, map_);
 		if(jp_id2 != warthog::INF32) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
@@ -349,6 +387,7 @@ warthog::online_jump_point_locator::jump_northwest(uint32_t node_id,
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::jump_southeast(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
@@ -380,9 +419,9 @@ warthog::online_jump_point_locator::jump_southeast(uint32_t node_id,
 		// (ensures we do not miss any optimal turning points)
 		uint32_t jp_id1, jp_id2;
         warthog::cost_t cost1, cost2;
-		__jump_south(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
+		__jump_south<W>(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
 		if(jp_id1 != warthog::INF32) { break; }
-		__jump_east(next_id, goal_id, jp_id2, cost2, map_);
+		jump_east_w<W>(next_id, goal_id, jp_id2, cost2, map_);
 		if(jp_id2 != warthog::INF32) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
@@ -392,6 +431,7 @@ warthog::online_jump_point_locator::jump_southeast(uint32_t node_id,
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
+template<uint32_t W>
 void
 warthog::online_jump_point_locator::jump_southwest(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost)
@@ -422,9 +462,9 @@ warthog::online_jump_point_locator::jump_southwest(uint32_t node_id,
 		// (ensures we do not miss any optimal turning points)
 		uint32_t jp_id1, jp_id2;
         warthog::cost_t cost1, cost2;
-		__jump_south(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
+		__jump_south<W>(rnext_id, rgoal_id, jp_id1, cost1, rmap_);
 		if(jp_id1 != warthog::INF32) { break; }
-		__jump_west(next_id, goal_id, jp_id2, cost2, map_);
+		jump_west_w<W>(next_id, goal_id, jp_id2, cost2, map_);
 		if(jp_id2 != warthog::INF32) { break; }
 
 		// couldn't move in either straight dir; node_id is an obstacle
@@ -434,3 +474,141 @@ warthog::online_jump_point_locator::jump_southwest(uint32_t node_id,
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
+template<uint32_t W>
+void
+warthog::online_jump_point_locator::jump_east_w(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	if(W == 32) { __jump_east(node_id, goal_id, jumpnode_id, jumpcost, mymap); }
+	else
+	{
+		__jump_east64<W == 256>(node_id, goal_id, jumpnode_id, jumpcost, mymap);
+	}
+}
+
+template<uint32_t W>
+void
+warthog::online_jump_point_locator::jump_west_w(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	if(W == 32) { __jump_west(node_id, goal_id, jumpnode_id, jumpcost, mymap); }
+	else
+	{
+		__jump_west64<W == 256>(node_id, goal_id, jumpnode_id, jumpcost, mymap);
+	}
+}
+
+// the functions below are the 64bit counterparts of ::__jump_east and 
+// ::__jump_west. each step reads 64 tiles from each of three rows and moves
+// 63 tiles, so that the last tile read is checked again against the tiles
+// that follow it. with @tparam SKIP, long jumps also skip blocks of 256
+// tiles using AVX2.
+template<bool SKIP>
+void
+warthog::online_jump_point_locator::__jump_east64(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	bool deadend = false;
+	uint64_t neis[3] = {0, 0, 0};
+
+	jumpnode_id = node_id;
+	while(true)
+	{
+		mymap->get_neighbours_64bit(jumpnode_id, neis);
+
+		uint64_t 
+		forced_bits = (~neis[0] << 1) & neis[0];
+		forced_bits |= (~neis[2] << 1) & neis[2];
+		uint64_t 
+		deadend_bits = ~neis[1];
+
+		uint64_t stop_bits = (forced_bits | deadend_bits);
+		if(stop_bits)
+		{
+			uint32_t stop_pos = (uint32_t)__builtin_ctzll(stop_bits);
+			jumpnode_id += stop_pos;
+			deadend = deadend_bits & (1ull << stop_pos);
+			break;
+		}
+		jumpnode_id += 63;
+
+		// a long jump; skip ahead while there is nothing to stop at
+		if(SKIP)
+		{
+			jumpnode_id = warthog::jps::skip_east_256(mymap, jumpnode_id);
+		}
+	}
+
+	uint32_t num_steps = jumpnode_id - node_id;
+	uint32_t goal_dist = goal_id - node_id;
+	if(num_steps > goal_dist)
+	{
+		jumpnode_id = goal_id;
+		jumpcost = goal_dist ;
+		return;
+	}
+
+	if(deadend)
+	{
+		num_steps -= (1 && num_steps);
+		jumpnode_id = warthog::INF32;
+	}
+	jumpcost = num_steps ;
+}
+
+template<bool SKIP>
+void
+warthog::online_jump_point_locator::__jump_west64(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	bool deadend = false;
+	uint64_t neis[3] = {0, 0, 0};
+
+	jumpnode_id = node_id;
+	while(true)
+	{
+		mymap->get_neighbours_upper_64bit(jumpnode_id, neis);
+
+		uint64_t 
+		forced_bits = (~neis[0] >> 1) & neis[0];
+		forced_bits |= (~neis[2] >> 1) & neis[2];
+		uint64_t 
+		deadend_bits = ~neis[1];
+
+		uint64_t stop_bits = (forced_bits | deadend_bits);
+		if(stop_bits)
+		{
+			uint32_t stop_pos = (uint32_t)__builtin_clzll(stop_bits);
+			jumpnode_id -= stop_pos;
+			deadend = deadend_bits & (0x8000000000000000ull >> stop_pos);
+			break;
+		}
+		jumpnode_id -= 63;
+
+		// a long jump; skip ahead while there is nothing to stop at
+		if(SKIP)
+		{
+			jumpnode_id = warthog::jps::skip_west_256(mymap, jumpnode_id);
+		}
+	}
+
+	uint32_t num_steps = node_id - jumpnode_id;
+	uint32_t goal_dist = node_id - goal_id;
+	if(num_steps > goal_dist)
+	{
+		jumpnode_id = goal_id;
+		jumpcost = goal_dist ;
+		return;
+	}
+
+	if(deadend)
+	{
+		num_steps -= (1 && num_steps);
+		jumpnode_id = warthog::INF32;
+	}
+	jumpcost = num_steps ;
+}
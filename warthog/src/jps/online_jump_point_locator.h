@@ -36,28 +36,53 @@ class online_jump_point_locator
 			return sizeof(this) + rmap_->mem();
 		}
 
+		// straight jumps scan @param bits tiles at a time; one of 32, 64 or
+		// 256 (cf. warthog::jps::get_jump_width). the default is 
+		// warthog::jps::get_jump_width().
+		void
+		set_jump_width(uint32_t bits);
+
+		inline uint32_t
+		get_jump_width() { return jump_width_; }
+
 	private:
+		// ::jump for straight jumps @tparam W tiles wide. the width is 
+		// picked once per call to ::jump and the jumps below are compiled 
+		// for each width, so that the scanners can be inlined.
+		template<uint32_t W>
+		void
+		jump_w(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+
+		template<uint32_t W>
 		void
 		jump_northwest(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		template<uint32_t W>
 		void
 		jump_northeast(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		template<uint32_t W>
 		void
 		jump_southwest(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		template<uint32_t W>
 		void
 		jump_southeast(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		template<uint32_t W>
 		void
 		jump_north(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		template<uint32_t W>
 		void
 		jump_south(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		template<uint32_t W>
 		void
 		jump_east(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
+		template<uint32_t W>
 		void
 		jump_west(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost);
@@ -73,10 +98,38 @@ class online_jump_point_locator
 		__jump_west(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
+
+		// as above, but scanning 64 tiles at a time. with @tparam SKIP,
+		// each long jump also skips blocks of 256 tiles using AVX2
+		template<bool SKIP>
+		void
+		__jump_east64(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+		template<bool SKIP>
+		void
+		__jump_west64(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+
+		// the straight jumps of width @tparam W
+		template<uint32_t W>
+		void
+		jump_east_w(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+		template<uint32_t W>
+		void
+		jump_west_w(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+
+		template<uint32_t W>
 		void
 		__jump_north(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
 				warthog::gridmap* mymap);
+		template<uint32_t W>
 		void
 		__jump_south(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
@@ -114,6 +167,8 @@ class online_jump_point_locator
 		warthog::gridmap* map_;
 		warthog::gridmap* rmap_;
 		//uint32_t jumplimit_;
+
+		uint32_t jump_width_;
 };
 
 }
@@ -11,6 +11,7 @@ warthog::jps::online_jump_point_locator2::online_jump_point_locator2(
 	rmap_ = create_rmap();
 	current_node_id_ = current_rnode_id_ = warthog::INF32;
 	current_goal_id_ = current_rgoal_id_ = warthog::INF32;
+	set_jump_width(warthog::jps::get_jump_width());
 }
 
 warthog::jps::online_jump_point_locator2::~online_jump_point_locator2()
@@ -18,6 +19,14 @@ warthog::jps::online_jump_point_locator2::~online_jump_point_locator2()
 	delete rmap_;
 }
 
+void
+warthog::jps::online_jump_point_locator2::set_jump_width(uint32_t bits)
+{
+	if(bits >= 256 && warthog::jps::cpu_has_avx2()) { jump_width_ = 256; }
+	else if(bits >= 64) { jump_width_ = 64; }
+	else { jump_width_ = 32; }
+}
+
 // create a copy of the grid map which is rotated by 90 degrees clockwise.
 // this version will be used when jumping North or South. 
 warthog::gridmap*
@@ -56,49 +65,16 @@ warthog::jps::online_jump_point_locator2::jump(warthog::jps::direction d,
 		std::vector<uint32_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-    __jump_east_fp = &warthog::jps::online_jump_point_locator2::__jump_east;
-    __jump_west_fp = &warthog::jps::online_jump_point_locator2::__jump_west;
-
-	// cache node and goal ids so we don't need to convert all the time
-	if(goal_id != current_goal_id_)
-	{
-		current_goal_id_ = goal_id;
-		current_rgoal_id_ = map_id_to_rmap_id(goal_id);
-	}
-
-	if(node_id != current_node_id_)
-	{
-		current_node_id_ = node_id;
-		current_rnode_id_ = map_id_to_rmap_id(node_id);
-	}
-
-	switch(d)
+	switch(jump_width_)
 	{
-		case warthog::jps::NORTH:
-			jump_north(jpoints, costs);
-			break;
-		case warthog::jps::SOUTH:
-			jump_south(jpoints, costs);
+		case 256:
+			jump_w<256, false>(d, node_id, goal_id, jpoints, costs);
 			break;
-		case warthog::jps::EAST:
-			jump_east(jpoints, costs);
-			break;
-		case warthog::jps::WEST:
-			jump_west(jpoints, costs);
-			break;
-		case warthog::jps::NORTHEAST:
-			jump_northeast(jpoints, costs);
-			break;
-		case warthog::jps::NORTHWEST:
-			jump_northwest(jpoints, costs);
-			break;
-		case warthog::jps::SOUTHEAST:
-			jump_southeast(jpoints, costs);
-			break;
-		case warthog::jps::SOUTHWEST:
-			jump_southwest(jpoints, costs);
+		case 64:
+			jump_w<64, false>(d, node_id, goal_id, jpoints, costs);
 			break;
 		default:
+			jump_w<32, false>(d, node_id, goal_id, jpoints, costs);
 			break;
 	}
 }
@@ -114,9 +90,29 @@ warthog::jps::online_jump_point_locator2::rjump(warthog::jps::direction d,
 		std::vector<uint32_t>& jpoints,
 		std::vector<warthog::cost_t>& costs)
 {
-    __jump_east_fp = &warthog::jps::online_jump_point_locator2::__rjump_east;
-    __jump_west_fp = &warthog::jps::online_jump_point_locator2::__rjump_west;
+	switch(jump_width_)
+	{
+		case 256:
+			jump_w<256, true>(d, node_id, goal_id, jpoints, costs);
+			break;
+		case 64:
+			jump_w<64, true>(d, node_id, goal_id, jpoints, costs);
+			break;
+		default:
+			jump_w<32, true>(d, node_id, goal_id, jpoints, costs);
+			break;
+	}
+}
 
+// straight jumps are @tparam W tiles wide and, if @tparam R, assume a 
+// reversed parent (cf. ::rjump)
+template<uint32_t W, bool R>
+void
+warthog::jps::online_jump_point_locator2::jump_w(warthog::jps::direction d,
+	   	uint32_t node_id, uint32_t goal_id, 
+		std::vector<uint32_t>& jpoints,
+		std::vector<warthog::cost_t>& costs)
+{
 	// cache node and goal ids so we don't need to convert all the time
 	if(goal_id != current_goal_id_)
 	{
@@ -133,34 +129,35 @@ warthog::jps::online_jump_point_locator2::rjump(warthog::jps::direction d,
 	switch(d)
 	{
 		case warthog::jps::NORTH:
-			jump_north(jpoints, costs);
+			jump_north<W, R>(jpoints, costs);
 			break;
 		case warthog::jps::SOUTH:
-			jump_south(jpoints, costs);
+			jump_south<W, R>(jpoints, costs);
 			break;
 		case warthog::jps::EAST:
-			jump_east(jpoints, costs);
+			jump_east<W, R>(jpoints, costs);
 			break;
 		case warthog::jps::WEST:
-			jump_west(jpoints, costs);
+			jump_west<W, R>(jpoints, costs);
 			break;
 		case warthog::jps::NORTHEAST:
-			jump_northeast(jpoints, costs);
+			jump_northeast<W, R>(jpoints, costs);
 			break;
 		case warthog::jps::NORTHWEST:
-			jump_northwest(jpoints, costs);
+			jump_northwest<W, R>(jpoints, costs);
 			break;
 		case warthog::jps::SOUTHEAST:
-			jump_southeast(jpoints, costs);
+			jump_southeast<W, R>(jpoints, costs);
 			break;
 		case warthog::jps::SOUTHWEST:
-			jump_southwest(jpoints, costs);
+			jump_southwest<W, R>(jpoints, costs);
 			break;
 		default:
 			break;
 	}
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::jump_north(
 		std::vector<uint32_t>& jpoints,
@@ -171,7 +168,7 @@ warthog::jps::online_jump_point_locator2::jump_north(
 	uint32_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
-	__jump_north(rnode_id, rgoal_id, jumpnode_id, jumpcost, rmap_);
+	__jump_north<W, R>(rnode_id, rgoal_id, jumpnode_id, jumpcost, rmap_);
 
 	if(jumpnode_id != warthog::INF32)
 	{
@@ -181,6 +178,7 @@ warthog::jps::online_jump_point_locator2::jump_north(
 	}
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::__jump_north(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
@@ -188,9 +186,10 @@ warthog::jps::online_jump_point_locator2::__jump_north(uint32_t node_id,
 {
 	// jumping north in the original map is the same as jumping
 	// east when we use a version of the map rotated 90 degrees.
-	(this->*(__jump_east_fp))(node_id, goal_id, jumpnode_id, jumpcost, mymap);
+	jump_east_w<W, R>(node_id, goal_id, jumpnode_id, jumpcost, mymap);
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::jump_south(
 		std::vector<uint32_t>& jpoints, 
@@ -201,7 +200,7 @@ warthog::jps::online_jump_point_locator2::jump_south(
 	uint32_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
-	__jump_south(rnode_id, rgoal_id, jumpnode_id, jumpcost, rmap_);
+	__jump_south<W, R>(rnode_id, rgoal_id, jumpnode_id, jumpcost, rmap_);
 
 	if(jumpnode_id != warthog::INF32)
 	{
@@ -211,6 +210,7 @@ warthog::jps::online_jump_point_locator2::jump_south(
 	}
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::__jump_south(uint32_t node_id, 
 		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
@@ -218,9 +218,10 @@ warthog::jps::online_jump_point_locator2::__jump_south(uint32_t node_id,
 {
 	// jumping north in the original map is the same as jumping
 	// west when we use a version of the map rotated 90 degrees.
-	(this->*(__jump_west_fp))(node_id, goal_id, jumpnode_id, jumpcost, mymap);
+	jump_west_w<W, R>(node_id, goal_id, jumpnode_id, jumpcost, mymap);
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::jump_east(
 		std::vector<uint32_t>& jpoints, 
@@ -231,7 +232,7 @@ warthog::jps::online_jump_point_locator2::jump_east(
 	uint32_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
-	(this->*(__jump_east_fp))(node_id, goal_id, jumpnode_id, jumpcost, map_);
+	jump_east_w<W, R>(node_id, goal_id, jumpnode_id, jumpcost, map_);
 
 	if(jumpnode_id != warthog::INF32)
 	{
@@ -379,6 +380,7 @@ warthog::jps::online_jump_point_locator2::__rjump_east(uint32_t node_id,
 }
 
 // analogous to ::jump_east 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::jump_west(
 		std::vector<uint32_t>& jpoints, 
@@ -389,7 +391,7 @@ warthog::jps::online_jump_point_locator2::jump_west(
 	uint32_t jumpnode_id;
 	warthog::cost_t jumpcost;
 
-	(this->*(__jump_west_fp))(node_id, goal_id, jumpnode_id, jumpcost, map_);
+	jump_west_w<W, R>(node_id, goal_id, jumpnode_id, jumpcost, map_);
 
 	if(jumpnode_id != warthog::INF32)
 	{
@@ -515,6 +517,280 @@ warthog::jps::online_jump_point_locator2::__rjump_west(uint32_t node_id,
 	jumpcost = num_steps ;
 }
 
+template<uint32_t W, bool R>
+void
+warthog::jps::online_jump_point_locator2::jump_east_w(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	if(W == 32)
+	{
+		if(R) { __rjump_east(node_id, goal_id, jumpnode_id, jumpcost, mymap); }
+		else { __jump_east(node_id, goal_id, jumpnode_id, jumpcost, mymap); }
+	}
+	else if(R)
+	{
+		__rjump_east64<W == 256>(
+				node_id, goal_id, jumpnode_id, jumpcost, mymap);
+	}
+	else
+	{
+		__jump_east64<W == 256>(
+				node_id, goal_id, jumpnode_id, jumpcost, mymap);
+	}
+}
+
+template<uint32_t W, bool R>
+void
+warthog::jps::online_jump_point_locator2::jump_west_w(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	if(W == 32)
+	{
+		if(R) { __rjump_west(node_id, goal_id, jumpnode_id, jumpcost, mymap); }
+		else { __jump_west(node_id, goal_id, jumpnode_id, jumpcost, mymap); }
+	}
+	else if(R)
+	{
+		__rjump_west64<W == 256>(
+				node_id, goal_id, jumpnode_id, jumpcost, mymap);
+	}
+	else
+	{
+		__jump_west64<W == 256>(
+				node_id, goal_id, jumpnode_id, jumpcost, mymap);
+	}
+}
+
+// the functions below are the 64bit counterparts of ::__jump_east, 
+// ::__jump_west, ::__rjump_east and ::__rjump_west. each step reads 64 tiles
+// from each of three rows and moves 63 tiles, so that the last tile read is
+// checked again against the tiles that follow it. with @tparam SKIP, long
+// jumps also skip blocks of 256 tiles using AVX2.
+template<bool SKIP>
+void
+warthog::jps::online_jump_point_locator2::__jump_east64(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	bool deadend = false;
+	uint64_t neis[3] = {0, 0, 0};
+
+	jumpnode_id = node_id;
+	while(true)
+	{
+		mymap->get_neighbours_64bit(jumpnode_id, neis);
+
+		uint64_t 
+		forced_bits = (~neis[0] << 1) & neis[0];
+		forced_bits |= (~neis[2] << 1) & neis[2];
+		uint64_t 
+		deadend_bits = ~neis[1];
+
+		uint64_t stop_bits = (forced_bits | deadend_bits);
+		if(stop_bits)
+		{
+			uint32_t stop_pos = (uint32_t)__builtin_ctzll(stop_bits);
+			jumpnode_id += stop_pos;
+			deadend = deadend_bits & (1ull << stop_pos);
+			break;
+		}
+		jumpnode_id += 63;
+
+		// a long jump; skip ahead while there is nothing to stop at
+		if(SKIP)
+		{
+			jumpnode_id = warthog::jps::skip_east_256(mymap, jumpnode_id);
+		}
+	}
+
+	uint32_t num_steps = jumpnode_id - node_id;
+	uint32_t goal_dist = goal_id - node_id;
+	if(num_steps > goal_dist)
+	{
+		jumpnode_id = goal_id;
+		jumpcost = goal_dist ;
+		return;
+	}
+
+	if(deadend)
+	{
+		num_steps -= (1 && num_steps);
+		jumpnode_id = warthog::INF32;
+	}
+	jumpcost = num_steps ;
+}
+
+template<bool SKIP>
+void
+warthog::jps::online_jump_point_locator2::__jump_west64(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	bool deadend = false;
+	uint64_t neis[3] = {0, 0, 0};
+
+	jumpnode_id = node_id;
+	while(true)
+	{
+		mymap->get_neighbours_upper_64bit(jumpnode_id, neis);
+
+		uint64_t 
+		forced_bits = (~neis[0] >> 1) & neis[0];
+		forced_bits |= (~neis[2] >> 1) & neis[2];
+		uint64_t 
+		deadend_bits = ~neis[1];
+
+		uint64_t stop_bits = (forced_bits | deadend_bits);
+		if(stop_bits)
+		{
+			uint32_t stop_pos = (uint32_t)__builtin_clzll(stop_bits);
+			jumpnode_id -= stop_pos;
+			deadend = deadend_bits & (0x8000000000000000ull >> stop_pos);
+			break;
+		}
+		jumpnode_id -= 63;
+
+		// a long jump; skip ahead while there is nothing to stop at
+		if(SKIP)
+		{
+			jumpnode_id = warthog::jps::skip_west_256(mymap, jumpnode_id);
+		}
+	}
+
+	uint32_t num_steps = node_id - jumpnode_id;
+	uint32_t goal_dist = node_id - goal_id;
+	if(num_steps > goal_dist)
+	{
+		jumpnode_id = goal_id;
+		jumpcost = goal_dist ;
+		return;
+	}
+
+	if(deadend)
+	{
+		num_steps -= (1 && num_steps);
+		jumpnode_id = warthog::INF32;
+	}
+	jumpcost = num_steps ;
+}
+
+template<bool SKIP>
+void
+warthog::jps::online_jump_point_locator2::__rjump_east64(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	bool deadend = false;
+	uint64_t neis[3] = {0, 0, 0};
+
+	jumpnode_id = node_id;
+	while(true)
+	{
+		mymap->get_neighbours_64bit(jumpnode_id, neis);
+
+		uint64_t 
+		forced_bits = (~neis[0] >> 1) & neis[0];
+		forced_bits |= (~neis[2] >> 1) & neis[2];
+		uint64_t 
+		deadend_bits = ~neis[1];
+
+		// as in ::__rjump_east
+		deadend_bits = deadend_bits >> 1;
+
+		uint64_t stop_bits = (forced_bits | deadend_bits);
+		if(stop_bits)
+		{
+			uint32_t stop_pos = (uint32_t)__builtin_ctzll(stop_bits);
+			jumpnode_id += stop_pos;
+			deadend = deadend_bits & (1ull << stop_pos);
+			break;
+		}
+		jumpnode_id += 63;
+
+		// a long jump; skip ahead while there is nothing to stop at
+		if(SKIP)
+		{
+			jumpnode_id = warthog::jps::skip_east_256(mymap, jumpnode_id);
+		}
+	}
+
+	uint32_t num_steps = jumpnode_id - node_id;
+	uint32_t goal_dist = goal_id - node_id;
+	if(num_steps > goal_dist)
+	{
+		jumpnode_id = goal_id;
+		jumpcost = goal_dist ;
+		return;
+	}
+
+	if(deadend)
+	{
+		num_steps -= (1 && num_steps);
+		jumpnode_id = warthog::INF32;
+	}
+	jumpcost = num_steps ;
+}
+
+template<bool SKIP>
+void
+warthog::jps::online_jump_point_locator2::__rjump_west64(uint32_t node_id, 
+		uint32_t goal_id, uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+		warthog::gridmap* mymap)
+{
+	bool deadend = false;
+	uint64_t neis[3] = {0, 0, 0};
+
+	jumpnode_id = node_id;
+	while(true)
+	{
+		mymap->get_neighbours_upper_64bit(jumpnode_id, neis);
+
+		uint64_t 
+		forced_bits = (~neis[0] << 1) & neis[0];
+		forced_bits |= (~neis[2] << 1) & neis[2];
+		uint64_t 
+		deadend_bits = ~neis[1];
+
+		// as in ::__rjump_west
+		deadend_bits = deadend_bits << 1;
+
+		uint64_t stop_bits = (forced_bits | deadend_bits);
+		if(stop_bits)
+		{
+			uint32_t stop_pos = (uint32_t)__builtin_clzll(stop_bits);
+			jumpnode_id -= stop_pos;
+			deadend = deadend_bits & (0x8000000000000000ull >> stop_pos);
+			break;
+		}
+		jumpnode_id -= 63;
+
+		// a long jump; skip ahead while there is nothing to stop at
+		if(SKIP)
+		{
+			jumpnode_id = warthog::jps::skip_west_256(mymap, jumpnode_id);
+		}
+	}
+
+	uint32_t num_steps = node_id - jumpnode_id;
+	uint32_t goal_dist = node_id - goal_id;
+	if(num_steps > goal_dist)
+	{
+		jumpnode_id = goal_id;
+		jumpcost = goal_dist ;
+		return;
+	}
+
+	if(deadend)
+	{
+		num_steps -= (1 && num_steps);
+		jumpnode_id = warthog::INF32;
+	}
+	jumpcost = num_steps ;
+}
+
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::jump_northeast(
 		std::vector<uint32_t>& jpoints,
@@ -541,7 +817,7 @@ warthog::jps::online_jump_point_locator2::jump_northeast(
 
 	while(node_id != warthog::INF32)
 	{
-		__jump_northeast(
+		__jump_northeast<W, R>(
 				node_id, rnode_id,
 				goal_id, rgoal_id,
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
@@ -566,6 +842,7 @@ warthog::jps::online_jump_point_locator2::jump_northeast(
 	}
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::__jump_northeast(
 		uint32_t& node_id, uint32_t& rnode_id, 
@@ -587,8 +864,8 @@ warthog::jps::online_jump_point_locator2::__jump_northeast(
 
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-		__jump_north(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
-		(this->*(__jump_east_fp))(node_id, goal_id, jp_id2, cost2, map_);
+		__jump_north<W, R>(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
+		jump_east_w<W, R>(node_id, goal_id, jp_id2, cost2, map_);
 		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
 
 		// couldn't move in a straight dir; next step is an obstacle
@@ -603,6 +880,7 @@ warthog::jps::online_jump_point_locator2::__jump_northeast(
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::jump_northwest(
 		std::vector<uint32_t>& jpoints,
@@ -629,7 +907,7 @@ warthog::jps::online_jump_point_locator2::jump_northwest(
 
 	while(node_id != warthog::INF32)
 	{
-		__jump_northwest(
+		__jump_northwest<W, R>(
 				node_id, rnode_id,
 				goal_id, rgoal_id,
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
@@ -654,6 +932,7 @@ warthog::jps::online_jump_point_locator2::jump_northwest(
 	}
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::__jump_northwest(
 		uint32_t& node_id, uint32_t& rnode_id, 
@@ -676,8 +955,8 @@ warthog::jps::online_jump_point_locator2::__jump_northwest(
 
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-		__jump_north(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
-		(this->*(__jump_west_fp))(node_id, goal_id, jp_id2, cost2, map_);
+		__jump_north<W, R>(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
+		jump_west_w<W, R>(node_id, goal_id, jp_id2, cost2, map_);
 		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
 
 		// couldn't move in a straight dir; next step is an obstacle
@@ -691,6 +970,7 @@ warthog::jps::online_jump_point_locator2::__jump_northwest(
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::jump_southeast(
 		std::vector<uint32_t>& jpoints,
@@ -717,7 +997,7 @@ warthog::jps::online_jump_point_locator2::jump_southeast(
 
 	while(node_id != warthog::INF32)
 	{
-		__jump_southeast(
+		__jump_southeast<W, R>(
 				node_id, rnode_id,
 				goal_id, rgoal_id,
 				jumpnode_id, jumpcost, jp1_id, jp1_cost, 
@@ -742,6 +1022,7 @@ warthog::jps::online_jump_point_locator2::jump_southeast(
 	}
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::__jump_southeast(
 		uint32_t& node_id, uint32_t& rnode_id, 
@@ -764,8 +1045,8 @@ warthog::jps::online_jump_point_locator2::__jump_southeast(
 
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-		__jump_south(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
-		(this->*(__jump_east_fp))(node_id, goal_id, jp_id2, cost2, map_);
+		__jump_south<W, R>(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
+		jump_east_w<W, R>(node_id, goal_id, jp_id2, cost2, map_);
 		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
 
 		// couldn't move in a straight dir; next step is an obstacle
@@ -779,6 +1060,7 @@ warthog::jps::online_jump_point_locator2::__jump_southeast(
 	jumpcost = num_steps*warthog::DBL_ROOT_TWO;
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::jump_southwest(
 		std::vector<uint32_t>& jpoints,
@@ -804,7 +1086,7 @@ warthog::jps::online_jump_point_locator2::jump_southwest(
 
 	while(node_id != warthog::INF32)
 	{
-		__jump_southwest(
+		__jump_southwest<W, R>(
 				node_id, rnode_id,
 				goal_id, rgoal_id,
 				jumpnode_id, jumpcost, 
@@ -829,6 +1111,7 @@ warthog::jps::online_jump_point_locator2::jump_southwest(
 	}
 }
 
+template<uint32_t W, bool R>
 void
 warthog::jps::online_jump_point_locator2::__jump_southwest(
 		uint32_t& node_id, uint32_t& rnode_id, 
@@ -849,8 +1132,8 @@ warthog::jps::online_jump_point_locator2::__jump_southwest(
 
 		// recurse straight before stepping again diagonally;
 		// (ensures we do not miss any optimal turning points)
-		__jump_south(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
-		(this->*(__jump_west_fp))(node_id, goal_id, jp_id2, cost2, map_);
+		__jump_south<W, R>(rnode_id, rgoal_id, jp_id1, cost1, rmap_);
+		jump_west_w<W, R>(node_id, goal_id, jp_id2, cost2, map_);
 		if((jp_id1 & jp_id2) != warthog::INF32) { break; }
 
 		// couldn't move in a straight dir; next step is an obstacle
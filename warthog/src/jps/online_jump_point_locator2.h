@@ -48,35 +48,62 @@ class online_jump_point_locator2
 			return sizeof(this) + rmap_->mem();
 		}
 
+		// straight jumps scan @param bits tiles at a time; one of 32, 64 or
+		// 256 (cf. warthog::jps::get_jump_width). the default is 
+		// warthog::jps::get_jump_width().
+		void
+		set_jump_width(uint32_t bits);
+
+		inline uint32_t
+		get_jump_width() { return jump_width_; }
+
 	private:
+		// ::jump (or, if @tparam R, ::rjump) for straight jumps @tparam W 
+		// tiles wide. the width is picked once per call and the jumps 
+		// below are compiled for each width and direction of the parent, 
+		// so that the scanners can be inlined.
+		template<uint32_t W, bool R>
+		void
+		jump_w(warthog::jps::direction d, uint32_t node_id, uint32_t goalid, 
+				std::vector<uint32_t>& jpoints,
+				std::vector<warthog::cost_t>& costs);
+
+		template<uint32_t W, bool R>
 		void
 		jump_north(
 				std::vector<uint32_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
+		template<uint32_t W, bool R>
 		void
 		jump_south(
 				std::vector<uint32_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
+		template<uint32_t W, bool R>
 		void
 		jump_east(
 				std::vector<uint32_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
+		template<uint32_t W, bool R>
 		void
 		jump_west(
 				std::vector<uint32_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
+		template<uint32_t W, bool R>
 		void
 		jump_northeast(
 				std::vector<uint32_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
+		template<uint32_t W, bool R>
 		void
 		jump_northwest(
 				std::vector<uint32_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
+		template<uint32_t W, bool R>
 		void
 		jump_southeast(
 				std::vector<uint32_t>& jpoints, 
 				std::vector<warthog::cost_t>& costs);
+		template<uint32_t W, bool R>
 		void
 		jump_southwest(
 				std::vector<uint32_t>& jpoints, 
@@ -85,10 +112,12 @@ class online_jump_point_locator2
 		// these versions can be passed a map parameter to
 		// use when jumping. they allow switching between
 		// map_ and rmap_ (a rotated counterpart).
+		template<uint32_t W, bool R>
 		void
 		__jump_north(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
 				warthog::gridmap* mymap);
+		template<uint32_t W, bool R>
 		void
 		__jump_south(uint32_t node_id, uint32_t goal_id, 
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
@@ -105,6 +134,7 @@ class online_jump_point_locator2
 		// these versions perform a single diagonal jump, returning
 		// the intermediate diagonal jump point and the straight 
 		// jump points that caused the jumping process to stop
+		template<uint32_t W, bool R>
 		void
 		__jump_northeast(
 				uint32_t& node_id, uint32_t& rnode_id, 
@@ -112,6 +142,7 @@ class online_jump_point_locator2
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
 				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
 				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+		template<uint32_t W, bool R>
 		void
 		__jump_northwest(
 				uint32_t& node_id, uint32_t& rnode_id, 
@@ -119,6 +150,7 @@ class online_jump_point_locator2
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
 				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
 				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+		template<uint32_t W, bool R>
 		void
 		__jump_southeast(
 				uint32_t& node_id, uint32_t& rnode_id, 
@@ -126,6 +158,7 @@ class online_jump_point_locator2
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost,
 				uint32_t& jp1_id, warthog::cost_t& jp1_cost,
 				uint32_t& jp2_id, warthog::cost_t& jp2_cost);
+		template<uint32_t W, bool R>
 		void
 		__jump_southwest(
 				uint32_t& node_id, uint32_t& rnode_id, 
@@ -146,6 +179,41 @@ class online_jump_point_locator2
 				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
 				warthog::gridmap* mymap);
 
+		// as above, but scanning 64 tiles at a time. with @tparam SKIP,
+		// each long jump also skips blocks of 256 tiles using AVX2
+		template<bool SKIP>
+		void
+		__jump_east64(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+		template<bool SKIP>
+		void
+		__jump_west64(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+		template<bool SKIP>
+		void
+		__rjump_east64(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+		template<bool SKIP>
+		void
+		__rjump_west64(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+
+		// the straight jumps of width @tparam W, with the parent reversed
+		// if @tparam R
+		template<uint32_t W, bool R>
+		void
+		jump_east_w(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
+		template<uint32_t W, bool R>
+		void
+		jump_west_w(uint32_t node_id, uint32_t goal_id, 
+				uint32_t& jumpnode_id, warthog::cost_t& jumpcost, 
+				warthog::gridmap* mymap);
 
 		// functions to convert map indexes to rmap indexes
 		inline uint32_t
@@ -187,15 +255,7 @@ class online_jump_point_locator2
 		uint32_t current_node_id_;
 		uint32_t current_rnode_id_;
 
-        // these function pointers allow us to switch between forward jumping
-        // and backward jumping (i.e. with the parent direction reversed)
-        void (warthog::jps::online_jump_point_locator2::*__jump_east_fp)
-            (uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
-             warthog::cost_t& jumpcost, warthog::gridmap* mymap);
-
-        void (warthog::jps::online_jump_point_locator2::*__jump_west_fp)
-            (uint32_t node_id, uint32_t goal_id, uint32_t& jumpnode_id, 
-             warthog::cost_t& jumpcost, warthog::gridmap* mymap);
+		uint32_t jump_width_;
 
 };
 }
@@ -0,0 +1,171 @@
+#ifndef WARTHOG_VL_JPS_EXPANSION_POLICY_H
+#define WARTHOG_VL_JPS_EXPANSION_POLICY_H
+
+// vl_jps_expansion_policy.h
+//
+// Jump Point Search for grids with vertex costs (cf.
+// vl_gridmap_expansion_policy). The template parameter is the jump point
+// locator: warthog::vl_jump_point_locator, which scans the grid online, or
+// warthog::vl_offline_jump_point_locator, which reads jumps from a
+// pre-computed database (i.e. JPS+).
+//
+// A node whose 3x3 neighbourhood is uniform (see vl_jump_point_locator.h)
+// has the usual natural and forced successors. Other nodes lie on a
+// boundary between costs and are expanded in every direction.
+//
+
+#include "expansion_policy.h"
+#include "gridmap.h"
+#include "helpers.h"
+#include "jps.h"
+#include "labelled_gridmap.h"
+#include "problem_instance.h"
+#include "search_node.h"
+#include "vl_jump_point_locator.h"
+
+#include "stdint.h"
+
+namespace warthog
+{
+
+template<class JPL>
+class vl_jps_expansion_policy : public expansion_policy
+{
+	public:
+		vl_jps_expansion_policy(warthog::vl_gridmap* map)
+			: expansion_policy(map->height() * map->width()), map_(map)
+		{
+			jpl_ = new JPL(map);
+		}
+
+		virtual ~vl_jps_expansion_policy()
+		{
+			delete jpl_;
+		}
+
+		virtual void
+		expand(warthog::search_node* current,
+				warthog::problem_instance* problem)
+		{
+			reset();
+
+			// compute the direction of travel used to reach the current node.
+			warthog::jps::direction dir_c = this->compute_direction(
+					(uint32_t)current->get_parent(),
+					(uint32_t)current->get_id());
+
+			// get the tiles around the current node c
+			uint32_t c_tiles;
+			uint32_t current_id = (uint32_t)current->get_id();
+			bool uniform =
+				warthog::vl_jps::neighbourhood(map_, current_id, c_tiles);
+
+			// look for jump points in the direction of each natural
+			// and forced neighbour; or in every direction, if the costs
+			// around c differ
+			uint32_t succ_dirs = uniform ?
+				warthog::jps::compute_successors(dir_c, c_tiles) : 0xff;
+			uint32_t goal_id = (uint32_t)problem->target_id_;
+			for(uint32_t i = 0; i < 8; i++)
+			{
+				warthog::jps::direction d = (warthog::jps::direction) (1 << i);
+				if(succ_dirs & d)
+				{
+					double jumpcost;
+					uint32_t succ_id;
+					jpl_->jump(d, current_id, goal_id, succ_id, jumpcost);
+
+					if(succ_id != warthog::INF32)
+					{
+						add_neighbour(this->generate(succ_id), jumpcost);
+					}
+				}
+			}
+		}
+
+		virtual inline size_t
+		mem()
+		{
+			return
+				expansion_policy::mem() +
+				sizeof(*this) +
+				map_->mem() + jpl_->mem();
+		}
+
+		virtual void
+		get_xy(warthog::sn_id_t node_id, int32_t& x, int32_t& y)
+		{
+			map_->to_unpadded_xy(
+					(uint32_t)node_id, (uint32_t&)x, (uint32_t&)y);
+		}
+
+		virtual warthog::search_node*
+		generate_start_node(warthog::problem_instance* pi)
+		{
+			return generate_padded((uint32_t)pi->start_id_);
+		}
+
+		virtual warthog::search_node*
+		generate_target_node(warthog::problem_instance* pi)
+		{
+			return generate_padded((uint32_t)pi->target_id_);
+		}
+
+	private:
+		warthog::vl_gridmap* map_;
+		JPL* jpl_;
+
+		inline warthog::search_node*
+		generate_padded(uint32_t id)
+		{
+			uint32_t max_id = map_->header_width() * map_->header_height();
+			if(id >= max_id) { return 0; }
+			uint32_t padded_id = map_->to_padded_id(id);
+			if(map_->get_label(padded_id) == 0) { return 0; }
+			return generate(padded_id);
+		}
+
+		// computes the direction of travel; from a node n1
+		// to a node n2.
+		inline warthog::jps::direction
+		compute_direction(uint32_t n1_id, uint32_t n2_id)
+		{
+			if(n1_id == warthog::GRID_ID_MAX) { return warthog::jps::NONE; }
+
+			int32_t x, y, x2, y2;
+			warthog::helpers::index_to_xy(n1_id, map_->width(), x, y);
+			warthog::helpers::index_to_xy(n2_id, map_->width(), x2, y2);
+			warthog::jps::direction dir = warthog::jps::NONE;
+			if(y2 == y)
+			{
+				if(x2 > x)
+					dir = warthog::jps::EAST;
+				else
+					dir = warthog::jps::WEST;
+			}
+			else if(y2 < y)
+			{
+				if(x2 == x)
+					dir = warthog::jps::NORTH;
+				else if(x2 < x)
+					dir = warthog::jps::NORTHWEST;
+				else // x2 > x
+					dir = warthog::jps::NORTHEAST;
+			}
+			else // y2 > y
+			{
+				if(x2 == x)
+					dir = warthog::jps::SOUTH;
+				else if(x2 < x)
+					dir = warthog::jps::SOUTHWEST;
+				else // x2 > x
+					dir = warthog::jps::SOUTHEAST;
+			}
+			assert(dir != warthog::jps::NONE);
+			return dir;
+		}
+};
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "vl_jump_point_locator.h"
+
+warthog::vl_jump_point_locator::vl_jump_point_locator(
+		warthog::vl_gridmap* map) : map_(map)
+{
+}
+
+warthog::vl_jump_point_locator::~vl_jump_point_locator()
+{
+}
+
+void
+warthog::vl_jump_point_locator::jump(warthog::jps::direction d,
+		uint32_t node_id, uint32_t goal_id,
+		uint32_t& jumpnode_id, double& jumpcost)
+{
+	uint32_t i = (uint32_t)__builtin_ctz((uint32_t)d);
+	if(i < 4) { jump_straight(i, node_id, goal_id, jumpnode_id, jumpcost); }
+	else { jump_diagonal(i, node_id, goal_id, jumpnode_id, jumpcost); }
+}
+
+// keep stepping until we reach the goal, a tile that is not uniform or a
+// tile with a forced neighbour; or until the next step is blocked, in
+// which case there is no jump point
+void
+warthog::vl_jump_point_locator::jump_straight(uint32_t i,
+		uint32_t node_id, uint32_t goal_id,
+		uint32_t& jumpnode_id, double& jumpcost)
+{
+	if(!warthog::vl_jps::can_step(map_, node_id, i))
+	{
+		jumpnode_id = warthog::INF32;
+		return;
+	}
+
+	// the first step may leave a tile of another cost
+	warthog::jps::direction d = (warthog::jps::direction)(1 << i);
+	int32_t step = warthog::vl_jps::step(map_, i);
+	uint32_t current = node_id + step;
+	uint32_t num_steps = 1;
+	uint32_t tiles;
+	if(current != goal_id &&
+		warthog::vl_jps::neighbourhood(map_, current, tiles) &&
+		!warthog::jps::compute_forced(d, tiles))
+	{
+		// the rest of the way, every tile we leave is uniform and has the
+		// same cost; of the 3x3 around the next tile only the three tiles
+		// ahead of it are new
+		warthog::dbword cost = map_->get_label(current);
+		int32_t side1 = warthog::vl_jps::step(map_, i < 2 ? 2 : 0);
+		int32_t side2 = -side1;
+		while(true)
+		{
+			if(!map_->get_label(current + step))
+			{
+				jumpnode_id = warthog::INF32;
+				return;
+			}
+			current += step;
+			num_steps++;
+			if(current == goal_id) { break; }
+
+			warthog::dbword a0 = map_->get_label(current + step);
+			warthog::dbword a1 = map_->get_label(current + step + side1);
+			warthog::dbword a2 = map_->get_label(current + step + side2);
+			if((a0 && a0 != cost) || (a1 && a1 != cost) || (a2 && a2 != cost))
+			{
+				break;
+			}
+
+			// forced: a side tile is open but the one behind it is not
+			if((map_->get_label(current + side1) &&
+				!map_->get_label(current - step + side1)) ||
+			   (map_->get_label(current + side2) &&
+				!map_->get_label(current - step + side2)))
+			{
+				break;
+			}
+		}
+	}
+	jumpnode_id = current;
+	jumpcost = warthog::vl_jps::jump_cost(map_, node_id, i, num_steps);
+}
+
+// as above, and also stop at any tile from which a straight jump finds a
+// jump point
+void
+warthog::vl_jump_point_locator::jump_diagonal(uint32_t i,
+		uint32_t node_id, uint32_t goal_id,
+		uint32_t& jumpnode_id, double& jumpcost)
+{
+	warthog::jps::direction d = (warthog::jps::direction)(1 << i);
+	uint32_t current = node_id;
+	jumpcost = 0;
+	while(true)
+	{
+		if(!warthog::vl_jps::can_step(map_, current, i))
+		{
+			jumpnode_id = warthog::INF32;
+			return;
+		}
+		jumpcost += warthog::vl_jps::step_cost(map_, current, i);
+		current += warthog::vl_jps::step(map_, i);
+		if(current == goal_id) { break; }
+
+		uint32_t tiles;
+		if(!warthog::vl_jps::neighbourhood(map_, current, tiles) ||
+			warthog::jps::compute_forced(d, tiles))
+		{
+			break;
+		}
+
+		uint32_t straight_id;
+		double straight_cost;
+		jump_straight(warthog::vl_jps::VERT[i], current, goal_id,
+				straight_id, straight_cost);
+		if(straight_id != warthog::INF32) { break; }
+		jump_straight(warthog::vl_jps::HORZ[i], current, goal_id,
+				straight_id, straight_cost);
+		if(straight_id != warthog::INF32) { break; }
+	}
+	jumpnode_id = current;
+}
@@ -0,0 +1,133 @@
+#ifndef WARTHOG_VL_JUMP_POINT_LOCATOR_H
+#define WARTHOG_VL_JUMP_POINT_LOCATOR_H
+
+// vl_jump_point_locator.h
+//
+// Finds, online, jump point successors on grids with vertex costs
+// (cf. vl_gridmap_expansion_policy, whose moves and costs are the same).
+// Tiles with label 0 are obstacles.
+//
+// JPS reasons about the 3x3 neighbourhood of a tile. If every traversable
+// tile there has the same cost, each move inside the neighbourhood costs
+// that much times its cost on a uniform grid, and the pruning rules of JPS
+// hold as they are. Such a tile is "uniform". A tile that is not uniform
+// lies on a boundary between costs; jumps stop there, as at a forced
+// neighbour, and the tile is expanded in every direction, as by A*.
+// Inside a region of one cost, jumps are as long as on a uniform grid.
+//
+
+#include "jps.h"
+#include "labelled_gridmap.h"
+
+namespace warthog
+{
+
+namespace vl_jps
+{
+
+// the id offset of one step in each direction, indexed as the bits of
+// warthog::jps::direction: N, S, E, W, NE, NW, SE, SW
+inline int32_t
+step(warthog::vl_gridmap* map, uint32_t i)
+{
+    int32_t w = (int32_t)map->width();
+    const int32_t dx[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+    const int32_t dy[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    return dy[i] * w + dx[i];
+}
+
+// the straight directions that make up each diagonal one: the vertical,
+// then the horizontal
+const uint32_t VERT[8] = {0, 1, 2, 3, 0, 0, 1, 1};
+const uint32_t HORZ[8] = {0, 1, 2, 3, 2, 3, 2, 3};
+
+// the traversable tiles of the 3x3 neighbourhood of @param id, in the
+// layout of gridmap::get_neighbours.
+// @return true if they all have the cost of @param id
+inline bool
+neighbourhood(warthog::vl_gridmap* map, uint32_t id, uint32_t& tiles)
+{
+    uint32_t w = map->width();
+    warthog::dbword cost = map->get_label(id);
+    bool uniform = true;
+    tiles = 0;
+    for(uint32_t r = 0; r < 3; r++)
+    {
+        warthog::dbword* row = &map->get_label(id + r*w - w - 1);
+        for(uint32_t k = 0; k < 3; k++)
+        {
+            if(row[k] == 0) { continue; }
+            tiles |= 1u << (r*8 + k);
+            uniform &= row[k] == cost;
+        }
+    }
+    return uniform;
+}
+
+// can a move in direction @param i be made from @param id?
+inline bool
+can_step(warthog::vl_gridmap* map, uint32_t id, uint32_t i)
+{
+    if(i < 4) { return map->get_label(id + step(map, i)) != 0; }
+    return map->get_label(id + step(map, i)) != 0 &&
+        map->get_label(id + step(map, VERT[i])) != 0 &&
+        map->get_label(id + step(map, HORZ[i])) != 0;
+}
+
+// the cost of a move in direction @param i from @param id: the average of
+// the labels of the tiles it touches (cf. vl_gridmap_expansion_policy)
+inline double
+step_cost(warthog::vl_gridmap* map, uint32_t id, uint32_t i)
+{
+    uint32_t a = map->get_label(id);
+    uint32_t b = map->get_label(id + step(map, i));
+    if(i < 4) { return (a + b) * 0.5; }
+    uint32_t c = map->get_label(id + step(map, VERT[i]));
+    uint32_t d = map->get_label(id + step(map, HORZ[i]));
+    return (a + b + c + d) * warthog::DBL_ROOT_TWO * 0.25;
+}
+
+// the cost of @param num_steps moves in direction @param i from @param id,
+// where every tile after the first step is uniform
+inline double
+jump_cost(warthog::vl_gridmap* map, uint32_t id, uint32_t i,
+        uint32_t num_steps)
+{
+    double rest = map->get_label(id + step(map, i)) * (num_steps - 1.0);
+    if(i >= 4) { rest *= warthog::DBL_ROOT_TWO; }
+    return step_cost(map, id, i) + rest;
+}
+
+}
+
+class vl_jump_point_locator
+{
+	public:
+		vl_jump_point_locator(warthog::vl_gridmap* map);
+		~vl_jump_point_locator();
+
+		void
+		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid,
+				uint32_t& jumpnode_id, double& jumpcost);
+
+		size_t
+		mem()
+		{
+			return sizeof(this);
+		}
+
+	private:
+		void
+		jump_straight(uint32_t i, uint32_t node_id, uint32_t goal_id,
+				uint32_t& jumpnode_id, double& jumpcost);
+
+		void
+		jump_diagonal(uint32_t i, uint32_t node_id, uint32_t goal_id,
+				uint32_t& jumpnode_id, double& jumpcost);
+
+		warthog::vl_gridmap* map_;
+};
+
+}
+
+#endif
@@ -0,0 +1,182 @@
+#include "timer.h"
+#include "vl_jump_point_locator.h"
+#include "vl_offline_jump_point_locator.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+
+const uint16_t DEAD_END = 32768;
+
+// the x and y offsets of a step in each direction (cf. vl_jps::step)
+const int32_t DX[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+const int32_t DY[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+
+// one more step than the jump from the next tile
+uint16_t
+extend(uint16_t label)
+{
+    if((label & (DEAD_END-1)) == DEAD_END-1)
+    {
+        std::cerr << "label overflow; maximum jump distance exceeded. "
+            << "aborting\n";
+        exit(1);
+    }
+    return (uint16_t)(label + 1);
+}
+
+}
+
+warthog::vl_offline_jump_point_locator::vl_offline_jump_point_locator(
+		warthog::vl_gridmap* map) : map_(map)
+{
+	preproc();
+}
+
+warthog::vl_offline_jump_point_locator::~vl_offline_jump_point_locator()
+{
+}
+
+// labels are computed as by the online locator, but every jump continues
+// as the jump from the next tile; tiles are visited in the reverse order
+// of the jumps, so that the next tile is always done. straight jumps come
+// first: a diagonal jump stops where a straight one finds a jump point.
+void
+warthog::vl_offline_jump_point_locator::preproc()
+{
+	warthog::timer t;
+	t.start();
+
+	db_.assign(8 * (size_t)map_->height() * map_->width(), DEAD_END);
+	uint32_t w = map_->header_width();
+	uint32_t h = map_->header_height();
+	for(uint32_t i = 0; i < 8; i++)
+	{
+		warthog::jps::direction d = (warthog::jps::direction)(1 << i);
+		int32_t step = warthog::vl_jps::step(map_, i);
+		for(uint32_t r = 0; r < h; r++)
+		{
+			uint32_t y = DY[i] < 0 ? r : h - 1 - r;
+			for(uint32_t k = 0; k < w; k++)
+			{
+				uint32_t x = DX[i] > 0 ? w - 1 - k : k;
+				uint32_t id = map_->to_padded_id(x, y);
+				if(!map_->get_label(id) ||
+					!warthog::vl_jps::can_step(map_, id, i))
+				{
+					continue; // dead-end, 0 steps
+				}
+
+				uint32_t next = id + step;
+				uint32_t tiles;
+				bool stop =
+					!warthog::vl_jps::neighbourhood(map_, next, tiles) ||
+					warthog::jps::compute_forced(d, tiles);
+				if(i >= 4)
+				{
+					stop = stop ||
+						!(db_[next*8 + warthog::vl_jps::VERT[i]] & DEAD_END) ||
+						!(db_[next*8 + warthog::vl_jps::HORZ[i]] & DEAD_END);
+				}
+				db_[id*8 + i] = stop ? 1 : extend(db_[next*8 + i]);
+			}
+		}
+	}
+
+	t.stop();
+	std::cerr << "jump point database computed in "
+		<< t.elapsed_time_micro() / 1e6 << "s\n";
+}
+
+void
+warthog::vl_offline_jump_point_locator::jump(warthog::jps::direction d,
+		uint32_t node_id, uint32_t goal_id,
+		uint32_t& jumpnode_id, double& jumpcost)
+{
+	uint32_t i = (uint32_t)__builtin_ctz((uint32_t)d);
+	if(i < 4) { jump_straight(i, node_id, goal_id, jumpnode_id, jumpcost); }
+	else { jump_diagonal(i, node_id, goal_id, jumpnode_id, jumpcost); }
+}
+
+void
+warthog::vl_offline_jump_point_locator::jump_straight(uint32_t i,
+		uint32_t node_id, uint32_t goal_id,
+		uint32_t& jumpnode_id, double& jumpcost)
+{
+	uint16_t label = db_[8*node_id + i];
+	uint32_t num_steps = label & (DEAD_END-1);
+
+	// do not jump over the goal
+	uint32_t nx, ny, gx, gy;
+	map_->to_unpadded_xy(node_id, nx, ny);
+	map_->to_unpadded_xy(goal_id, gx, gy);
+	int32_t along = DX[i] ? DX[i] * (int32_t)(gx - nx) :
+		DY[i] * (int32_t)(gy - ny);
+	bool on_line = DX[i] ? gy == ny : gx == nx;
+	if(on_line && along >= 1 && (uint32_t)along <= num_steps)
+	{
+		jumpnode_id = goal_id;
+		jumpcost = warthog::vl_jps::jump_cost(map_, node_id, i, along);
+		return;
+	}
+
+	if(label & DEAD_END)
+	{
+		jumpnode_id = warthog::INF32;
+		return;
+	}
+	jumpnode_id = node_id + num_steps * warthog::vl_jps::step(map_, i);
+	jumpcost = warthog::vl_jps::jump_cost(map_, node_id, i, num_steps);
+}
+
+void
+warthog::vl_offline_jump_point_locator::jump_diagonal(uint32_t i,
+		uint32_t node_id, uint32_t goal_id,
+		uint32_t& jumpnode_id, double& jumpcost)
+{
+	uint16_t label = db_[8*node_id + i];
+	uint32_t num_steps = label & (DEAD_END-1);
+	int32_t step = warthog::vl_jps::step(map_, i);
+
+	// is the goal reached by a straight jump from a tile on the way?
+	uint32_t nx, ny, gx, gy;
+	map_->to_unpadded_xy(node_id, nx, ny);
+	map_->to_unpadded_xy(goal_id, gx, gy);
+	int32_t ex = DX[i] * (int32_t)(gx - nx);
+	int32_t ey = DY[i] * (int32_t)(gy - ny);
+	if(ex >= 1 && ey >= 1)
+	{
+		uint32_t steps_to_nid = (uint32_t)std::min(ex, ey);
+		if(steps_to_nid <= num_steps)
+		{
+			double diag_cost =
+				warthog::vl_jps::jump_cost(map_, node_id, i, steps_to_nid);
+			if(ex == ey)
+			{
+				jumpnode_id = goal_id;
+				jumpcost = diag_cost;
+				return;
+			}
+
+			uint32_t nid = node_id + steps_to_nid * step;
+			jump_straight(ex < ey ?
+					warthog::vl_jps::VERT[i] : warthog::vl_jps::HORZ[i],
+					nid, goal_id, jumpnode_id, jumpcost);
+			if(jumpnode_id == goal_id)
+			{
+				jumpcost += diag_cost;
+				return;
+			}
+		}
+	}
+
+	if(label & DEAD_END)
+	{
+		jumpnode_id = warthog::INF32;
+		return;
+	}
+	jumpnode_id = node_id + num_steps * step;
+	jumpcost = warthog::vl_jps::jump_cost(map_, node_id, i, num_steps);
+}
@@ -0,0 +1,55 @@
+#ifndef WARTHOG_VL_OFFLINE_JUMP_POINT_LOCATOR_H
+#define WARTHOG_VL_OFFLINE_JUMP_POINT_LOCATOR_H
+
+// vl_offline_jump_point_locator.h
+//
+// Variant of warthog::vl_jump_point_locator that reads jumps from a
+// pre-computed database: for every tile and direction, the number of steps
+// to the next jump point, with the leading bit set if the jump leads to a
+// dead-end (cf. warthog::jump_point_db). The database is built when the
+// locator is created, in time linear in the size of the map.
+//
+
+#include "jps.h"
+#include "labelled_gridmap.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class vl_offline_jump_point_locator
+{
+	public:
+		vl_offline_jump_point_locator(warthog::vl_gridmap* map);
+		~vl_offline_jump_point_locator();
+
+		void
+		jump(warthog::jps::direction d, uint32_t node_id, uint32_t goalid,
+				uint32_t& jumpnode_id, double& jumpcost);
+
+		size_t
+		mem()
+		{
+			return sizeof(this) + sizeof(uint16_t) * db_.size();
+		}
+
+	private:
+		void
+		preproc();
+
+		void
+		jump_straight(uint32_t i, uint32_t node_id, uint32_t goal_id,
+				uint32_t& jumpnode_id, double& jumpcost);
+
+		void
+		jump_diagonal(uint32_t i, uint32_t node_id, uint32_t goal_id,
+				uint32_t& jumpnode_id, double& jumpcost);
+
+		warthog::vl_gridmap* map_;
+		std::vector<uint16_t> db_;
+};
+
+}
+
+#endif
@@ -0,0 +1,230 @@
+#include "domains/gridmap.h"
+#include "heuristics/zero_heuristic.h"
+#include "label/grid_bb_labelling.h"
+#include "search/flexible_astar.h"
+#include "search/gridmap_expansion_policy.h"
+#include "search/problem_instance.h"
+#include "search/search_node.h"
+#include "search/solution.h"
+
+namespace
+{
+
+// equally good paths may not add up to exactly the same cost
+const double TIE_EPSILON = 1e-6;
+
+// the direction of a move, as an index into the labels of a tile:
+// N, S, E, W, NE, NW, SE, SW (cf. warthog::jps::direction)
+uint32_t
+direction_index(int32_t dx, int32_t dy)
+{
+    if(dx == 0) { return dy < 0 ? 0 : 1; }
+    if(dy == 0) { return dx > 0 ? 2 : 3; }
+    if(dy < 0) { return dx > 0 ? 4 : 5; }
+    return dx > 0 ? 6 : 7;
+}
+
+struct shared_data
+{
+    warthog::label::grid_bb_labelling* lab_;
+    const std::vector<uint32_t>* tiles_;
+};
+
+// tracks, for every tile, the set of optimal first moves from the source
+// (as bits 1 << direction_index) and grows the label of each one
+struct gbb_search_listener
+{
+    std::vector<uint8_t>* first_moves;
+    warthog::label::grid_bb_labelling* lab;
+    uint32_t source_id;
+
+    inline void
+    generate_node(warthog::search_node* from,
+                  warthog::search_node* succ,
+                  warthog::cost_t edge_cost,
+                  uint32_t edge_id)
+    {
+        if(from == 0) { return; } // start node
+
+        uint32_t s_id = (uint32_t)succ->get_id();
+        uint32_t f_id = (uint32_t)from->get_id();
+        if(f_id == source_id) // start node successors
+        {
+            uint32_t sx, sy, x, y;
+            lab->get_map()->to_padded_xy(source_id, sx, sy);
+            lab->get_map()->to_padded_xy(s_id, x, y);
+            first_moves->at(s_id) = (uint8_t)(1 << direction_index(
+                        (int32_t)x - (int32_t)sx, (int32_t)y - (int32_t)sy));
+            return;
+        }
+
+        double alt_g = from->get_g() + edge_cost;
+        if(succ->get_search_number() != from->get_search_number() ||
+           alt_g < succ->get_g() - TIE_EPSILON)
+        {
+            first_moves->at(s_id) = first_moves->at(f_id);
+        }
+        else if(alt_g <= succ->get_g() + TIE_EPSILON)
+        {
+            first_moves->at(s_id) |= first_moves->at(f_id);
+        }
+    }
+
+    inline void
+    expand_node(warthog::search_node* current)
+    {
+        uint32_t node_id = (uint32_t)current->get_id();
+        if(node_id == source_id) { return; }
+
+        uint32_t x, y;
+        lab->get_map()->to_unpadded_xy(node_id, x, y);
+        uint8_t moves = first_moves->at(node_id);
+        for(uint32_t i = 0; i < 8; i++)
+        {
+            if(moves & (1 << i))
+            {
+                lab->get_label(source_id, i).bbox_.grow(
+                        (int32_t)x, (int32_t)y);
+            }
+        }
+    }
+
+    inline void
+    relax_node(warthog::search_node* current) { }
+};
+
+}
+
+warthog::label::grid_bb_labelling::grid_bb_labelling(warthog::gridmap* map)
+    : map_(map)
+{
+    rank_.resize(map_->height() * map_->width(), UINT32_MAX);
+    for(uint32_t y = 0; y < map_->header_height(); y++)
+    {
+        for(uint32_t x = 0; x < map_->header_width(); x++)
+        {
+            uint32_t padded_id = map_->to_padded_id(x, y);
+            if(!map_->get_label(padded_id)) { continue; }
+            rank_[padded_id] = (uint32_t)tiles_.size();
+            tiles_.push_back(padded_id);
+        }
+    }
+
+    // every move gets an empty (invalid) label
+    labels_.resize(tiles_.size() * 8);
+}
+
+warthog::label::grid_bb_labelling::~grid_bb_labelling()
+{
+}
+
+void
+warthog::label::grid_bb_labelling::precompute()
+{
+    // one Dijkstra search from every tile; sources are evenly divided
+    // among all threads, each of which has its own search
+    void*(*thread_compute_fn)(void*) =
+    [] (void* args_in) -> void*
+    {
+        warthog::helpers::thread_params* par =
+            (warthog::helpers::thread_params*) args_in;
+        shared_data* shared = (shared_data*) par->shared_;
+        warthog::label::grid_bb_labelling* lab = shared->lab_;
+        warthog::gridmap* map = lab->get_map();
+
+        std::vector<uint8_t> first_moves(map->height() * map->width());
+
+        warthog::zero_heuristic h;
+        warthog::pqueue_min open;
+        gbb_search_listener listener;
+        warthog::gridmap_expansion_policy expander(map);
+
+        warthog::flexible_astar
+            <warthog::zero_heuristic,
+            warthog::gridmap_expansion_policy,
+            warthog::pqueue_min,
+            gbb_search_listener>
+                dijk(&h, &expander, &open, &listener);
+
+        listener.first_moves = &first_moves;
+        listener.lab = lab;
+        for(uint32_t i = par->thread_id_; i < shared->tiles_->size();
+                i += par->max_threads_)
+        {
+            listener.source_id = shared->tiles_->at(i);
+            warthog::problem_instance problem(
+                    map->to_unpadded_id(listener.source_id),
+                    warthog::SN_ID_MAX);
+            warthog::solution sol;
+            dijk.get_path(problem, sol);
+            par->nprocessed_++;
+        }
+        return 0;
+    };
+
+    warthog::timer t;
+    t.start();
+
+    // start from empty labels, e.g. after a failed read
+    labels_.assign(tiles_.size() * 8, bb_label());
+
+    shared_data shared;
+    shared.lab_ = this;
+    shared.tiles_ = &tiles_;
+
+    std::cerr << "computing dijkstra labels\n";
+    warthog::helpers::parallel_compute(
+            thread_compute_fn, &shared, (uint32_t)tiles_.size());
+    t.stop();
+    std::cerr << "done. time " << t.elapsed_time_nano() / 1e9 << " s\n";
+}
+
+std::istream&
+warthog::label::operator>>(
+        std::istream& in, warthog::label::grid_bb_labelling& lab)
+{
+    uint32_t num_tiles = 0;
+    in.read((char*)&num_tiles, sizeof(num_tiles));
+    if(!in.good() || num_tiles != lab.tiles_.size())
+    {
+        std::cerr << "labels do not match the map; expected "
+            << lab.tiles_.size() << " traversable tiles\n";
+        in.setstate(std::ios_base::failbit);
+        return in;
+    }
+
+    for(uint32_t i = 0; i < lab.labels_.size(); i++)
+    {
+        in >> lab.labels_[i];
+        if(!in.good())
+        {
+            std::cerr << "unexpected error while reading labels\n";
+            std::cerr
+                << "[debug info] tile: " << lab.tiles_[i / 8]
+                << " direction-index: " << (i % 8) << "\n";
+            return in;
+        }
+    }
+    return in;
+}
+
+std::ostream&
+warthog::label::operator<<(
+        std::ostream& out, warthog::label::grid_bb_labelling& lab)
+{
+    uint32_t num_tiles = (uint32_t)lab.tiles_.size();
+    out.write((char*)&num_tiles, sizeof(num_tiles));
+    for(uint32_t i = 0; i < lab.labels_.size(); i++)
+    {
+        out << lab.labels_[i];
+        if(!out.good())
+        {
+            std::cerr << "unexpected error while writing labels\n";
+            std::cerr
+                << "[debug info] tile: " << lab.tiles_[i / 8]
+                << " direction-index: " << (i % 8) << "\n";
+            return out;
+        }
+    }
+    return out;
+}
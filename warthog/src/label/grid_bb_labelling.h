@@ -0,0 +1,98 @@
+#ifndef WARTHOG_GRID_BB_LABELLING_H
+#define WARTHOG_GRID_BB_LABELLING_H
+
+// label/grid_bb_labelling.h
+//
+// Geometric containers for octile grids (cf. bb_labelling), also known as
+// goal bounding. For every traversable tile and each of the eight
+// directions of travel we store a rectangular bounding box. Inside the box
+// can be found all tiles reached optimally by a path whose first move is
+// in that direction. Where two first moves are equally good, the tile is
+// in both boxes; a search that prunes moves whose box excludes the target
+// (e.g. jpsplus_bb_expansion_policy) thus keeps every optimal path,
+// including the canonical one that JPS follows.
+//
+// Labels are computed with one Dijkstra search per tile; that is
+// quadratic in the size of the map and meant to be done once per map.
+//
+// [Rabin & Sturtevant, 2016,
+// Combining Bounding Boxes and JPS to Prune Grid Pathfinding,
+// AAAI Conference on Artificial Intelligence]
+//
+
+#include "label/bb_labelling.h"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace warthog
+{
+
+class gridmap;
+
+namespace label
+{
+
+class grid_bb_labelling
+{
+    friend std::ostream&
+    operator<<(std::ostream& out, grid_bb_labelling& lab);
+
+    friend std::istream&
+    operator>>(std::istream& in, warthog::label::grid_bb_labelling& lab);
+
+    public:
+        grid_bb_labelling(warthog::gridmap* map);
+        ~grid_bb_labelling();
+
+        inline warthog::gridmap*
+        get_map()
+        {
+            return map_;
+        }
+
+        // the label of the move from the tile @param padded_id in the
+        // direction 1 << @param dir_idx (cf. warthog::jps::direction)
+        inline bb_label&
+        get_label(uint32_t padded_id, uint32_t dir_idx)
+        {
+            assert(rank_.at(padded_id) != UINT32_MAX && dir_idx < 8);
+            return labels_[rank_[padded_id]*8 + dir_idx];
+        }
+
+        inline size_t
+        mem()
+        {
+            return sizeof(this) +
+                sizeof(bb_label) * labels_.size() +
+                sizeof(uint32_t) * (rank_.size() + tiles_.size());
+        }
+
+        // compute labels for all traversable tiles
+        void
+        precompute();
+
+    private:
+        warthog::gridmap* map_;
+
+        // the traversable tiles, by padded id, and the index of each one
+        // in that list (UINT32_MAX for obstacles)
+        std::vector<uint32_t> tiles_;
+        std::vector<uint32_t> rank_;
+        std::vector<bb_label> labels_;
+};
+
+std::istream&
+operator>>(std::istream& in, warthog::label::grid_bb_labelling& lab);
+
+std::ostream&
+operator<<(std::ostream& out, warthog::label::grid_bb_labelling& lab);
+
+}
+
+}
+
+#endif
+
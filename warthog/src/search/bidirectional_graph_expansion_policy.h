@@ -8,6 +8,8 @@
 // generates all outgoing neighbours as successors.
 // When expanding in the backward direction this policy
 // generates all incoming neighbours as successors.
+// The graph can be an xy_graph or any other type with the same
+// adjacency interface (e.g. a csr_graph).
 //
 // @author: dharabor
 // @created: 2019-08-31
@@ -26,15 +28,14 @@ namespace warthog{
 class problem_instance;
 class search_node;
 
-template< class FILTER >
+template< class FILTER, class G = warthog::graph::xy_graph >
 class bidirectional_expander //: public  expansion_policy
 {
     public:
         // @param g: the input contracted graph
         // @param backward: when true successors are generated by following 
         // incoming arcs rather than outgoing arcs (default is outgoing)
-        bidirectional_expander(warthog::graph::xy_graph* g, 
-                bool backward, FILTER* filter = 0)
+        bidirectional_expander(G* g, bool backward, FILTER* filter = 0)
         {
             g_ = g;
             backward_ = backward;
@@ -43,26 +44,26 @@ class bidirectional_expander //: public  expansion_policy
             if(backward_)
             {
                 fn_begin_iter_ = 
-                    &warthog::bidirectional_expander<FILTER>::get_bwd_begin_iter;
+                    &warthog::bidirectional_expander<FILTER, G>::get_bwd_begin_iter;
                 fn_end_iter_ = 
-                    &warthog::bidirectional_expander<FILTER>::get_bwd_end_iter;
+                    &warthog::bidirectional_expander<FILTER, G>::get_bwd_end_iter;
 
                 fn_rev_end_iter_ = 
-                    &warthog::bidirectional_expander<FILTER>::get_fwd_end_iter;
+                    &warthog::bidirectional_expander<FILTER, G>::get_fwd_end_iter;
                 fn_rev_begin_iter_ = 
-                    &warthog::bidirectional_expander<FILTER>::get_fwd_begin_iter;
+                    &warthog::bidirectional_expander<FILTER, G>::get_fwd_begin_iter;
             }
             else
             {
                 fn_begin_iter_ = 
-                    &warthog::bidirectional_expander<FILTER>::get_fwd_begin_iter;
+                    &warthog::bidirectional_expander<FILTER, G>::get_fwd_begin_iter;
                 fn_end_iter_ = 
-                    &warthog::bidirectional_expander<FILTER>::get_fwd_end_iter;
+                    &warthog::bidirectional_expander<FILTER, G>::get_fwd_end_iter;
 
                 fn_rev_begin_iter_ = 
-                    &warthog::bidirectional_expander<FILTER>::get_bwd_begin_iter;
+                    &warthog::bidirectional_expander<FILTER, G>::get_bwd_begin_iter;
                 fn_rev_end_iter_ = 
-                    &warthog::bidirectional_expander<FILTER>::get_bwd_end_iter;
+                    &warthog::bidirectional_expander<FILTER, G>::get_bwd_end_iter;
             }
 
             nodepool_.resize(g_->get_num_nodes());
@@ -78,9 +79,9 @@ class bidirectional_expander //: public  expansion_policy
         inline void 
         expand(warthog::search_node* current, warthog::problem_instance* pi)
         {
-            warthog::graph::node* n = g_->get_node(current->get_id());
-            begin_ = (this->*fn_begin_iter_)(n);
-            end_ = (this->*fn_end_iter_)(n);
+            uint32_t id = (uint32_t)current->get_id();
+            begin_ = (this->*fn_begin_iter_)(id);
+            end_ = (this->*fn_end_iter_)(id);
         }
 
         inline void
@@ -167,17 +168,18 @@ class bidirectional_expander //: public  expansion_policy
 
     private:
         bool backward_;
-        warthog::graph::xy_graph* g_;
+        G* g_;
 
-        warthog::graph::edge_iter begin_, end_, it_;
+        typedef typename G::edge_iter edge_iter;
+        edge_iter begin_, end_, it_;
         std::vector<warthog::search_node> nodepool_;
         FILTER* filter_;
 
         // we use function pointers to iterate over the right set of
         // neighbours (incoming or outgoing) 
-        typedef warthog::graph::edge_iter
-                (warthog::bidirectional_expander<FILTER>::*chep_get_iter_fn) 
-                (warthog::graph::node* n);
+        typedef edge_iter
+                (warthog::bidirectional_expander<FILTER, G>::*chep_get_iter_fn) 
+                (uint32_t id);
         
         // pointers to the neighbours in the direction of the search
         chep_get_iter_fn fn_begin_iter_;
@@ -187,21 +189,21 @@ class bidirectional_expander //: public  expansion_policy
         chep_get_iter_fn fn_rev_begin_iter_;
         chep_get_iter_fn fn_rev_end_iter_;
 
-        inline warthog::graph::edge_iter
-        get_fwd_begin_iter(warthog::graph::node* n) 
-        { return n->outgoing_begin(); }
+        inline edge_iter
+        get_fwd_begin_iter(uint32_t id) 
+        { return g_->outgoing_begin(id); }
 
-        inline warthog::graph::edge_iter
-        get_fwd_end_iter(warthog::graph::node* n) 
-        { return n->outgoing_end(); }
+        inline edge_iter
+        get_fwd_end_iter(uint32_t id) 
+        { return g_->outgoing_end(id); }
 
-        inline warthog::graph::edge_iter
-        get_bwd_begin_iter(warthog::graph::node* n) 
-        { return n->incoming_begin(); }
+        inline edge_iter
+        get_bwd_begin_iter(uint32_t id) 
+        { return g_->incoming_begin(id); }
 
-        inline warthog::graph::edge_iter
-        get_bwd_end_iter(warthog::graph::node* n) 
-        { return n->incoming_end(); }
+        inline edge_iter
+        get_bwd_end_iter(uint32_t id) 
+        { return g_->incoming_end(id); }
 };
 typedef bidirectional_expander<warthog::apriori_filter> bidirectional_graph_expansion_policy;
 
@@ -48,6 +48,7 @@ class bidirectional_search  : public warthog::search
 
             exp_cutoff_ = warthog::INF32;
             cost_cutoff_ = warthog::COST_MAX;
+            time_cutoff_nanos_ = UINT64_MAX;
         }
 
         ~bidirectional_search()
@@ -260,21 +261,28 @@ class bidirectional_search  : public warthog::search
             uint32_t bwd_instance_id = pi_.instance_id_;
 
             // check for valid start and target
-            if(!bexpander_->generate_start_node(&pi_)  ||
-               !bexpander_->generate_target_node(&pi_) ||
-               !fexpander_->generate_start_node(&pi_)  ||
-               !fexpander_->generate_target_node(&pi_))
+            warthog::search_node* fwd_start =
+                fexpander_->generate_start_node(&pi_);
+            warthog::search_node* fwd_target =
+                fexpander_->generate_target_node(&pi_);
+            warthog::search_node* bwd_start =
+                bexpander_->generate_start_node(&pi_);
+            warthog::search_node* bwd_target =
+                bexpander_->generate_target_node(&pi_);
+            if(!fwd_start || !fwd_target || !bwd_start || !bwd_target)
             { return; } 
+
+            // from here on the search works with internal ids
+            pi_.start_id_ = fwd_start->get_id();
+            pi_.target_id_ = fwd_target->get_id();
             
             // initialise the backward search
             { 
-                bexpander_->generate_target_node(&pi_)->init(
+                bwd_target->init(
                     bwd_instance_id, warthog::NO_PARENT, 0,
-                    heuristic_->h(
-                        bexpander_->generate_target_node(&pi_)->get_id(),
-                        bexpander_->generate_start_node(&pi_)->get_id()));
+                    heuristic_->h(bwd_target->get_id(), bwd_start->get_id()));
                 bopen_->clear();
-                bopen_->push(bexpander_->generate_target_node(&pi_));
+                bopen_->push(bwd_target);
 
             }
 
@@ -282,10 +290,6 @@ class bidirectional_search  : public warthog::search
             // (only dijkstra search is forward resumable)
             if(dijkstra_ && resume)
             { 
-                warthog::search_node* fwd_start = 
-                    fexpander_->generate_start_node(&pi_);
-                warthog::search_node* fwd_target = 
-                    fexpander_->generate_target_node(&pi_);
                 if( fwd_target->get_search_number() == 
                      fwd_start->get_search_number() )
                 {
@@ -298,13 +302,11 @@ class bidirectional_search  : public warthog::search
             }
             else
             {
-                fexpander_->generate_start_node(&pi_)->init(
+                fwd_start->init(
                     fwd_instance_id, warthog::NO_PARENT, 0,
-                    heuristic_->h(
-                        fexpander_->generate_start_node(&pi_)->get_id(), 
-                        fexpander_->generate_target_node(&pi_)->get_id()));
+                    heuristic_->h(fwd_start->get_id(), fwd_target->get_id()));
                 fopen_->clear();
-                fopen_->push(fexpander_->generate_start_node(&pi_));
+                fopen_->push(fwd_start);
             }
 
 
@@ -320,7 +322,7 @@ class bidirectional_search  : public warthog::search
                 if(best_bound >= best_cost_ ||
                    best_bound > cost_cutoff_ || 
                    sol.nodes_expanded_ > exp_cutoff_ ||
-                   (time_cutoff_nanos_ > mytimer.elapsed_time_nano() &&
+                   (mytimer.elapsed_time_nano() > time_cutoff_nanos_ &&
                        best_cost_ <= cost_cutoff_))
                 { 
                     break; 
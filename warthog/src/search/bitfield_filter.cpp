@@ -19,7 +19,7 @@ warthog::bitfield_filter::set_flag_true(sn_id_t node_id)
 {
     size_t index = node_id >> warthog::LOG2_DBWORD_BITS;
     size_t pos = node_id & DBWORD_BITS_MASK;
-    filter_[index] |= (1 << pos);
+    filter_[index] |= ((warthog::dbword)1 << pos);
 }
 
 void
@@ -27,7 +27,7 @@ warthog::bitfield_filter::set_flag_false(sn_id_t node_id)
 {
     size_t index = node_id >> warthog::LOG2_DBWORD_BITS;
     size_t pos = node_id & DBWORD_BITS_MASK;
-    filter_[index] &= ~(1 << pos);
+    filter_[index] &= ~((warthog::dbword)1 << pos);
 }
 
 void 
@@ -50,6 +50,6 @@ warthog::bitfield_filter::get_flag(sn_id_t id)
 {
     size_t index = id >> warthog::LOG2_DBWORD_BITS;
     size_t pos = id & DBWORD_BITS_MASK;
-    return filter_[index] & (1 << pos);
+    return filter_[index] & ((warthog::dbword)1 << pos);
 }
 
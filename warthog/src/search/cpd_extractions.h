@@ -2,6 +2,9 @@
 // Run CPD extractions, it is assumed there exists a path from `start_id` to
 // `target_id`, we have a few (debug) checks but that's all.
 //
+// Moves are followed on any graph with the same nodes and edge order as
+// the one the oracle was built on, e.g. a csr_graph copied from it.
+//
 #ifndef __CPD_EXTRACTIONS_H_
 #define __CPD_EXTRACTIONS_H_
 
@@ -17,15 +20,15 @@
 namespace warthog
 {
 
-template<warthog::cpd::symbol T>
+template<warthog::cpd::symbol T, class G = warthog::graph::xy_graph>
 class cpd_extractions_base : public warthog::search
 {
     public:
-        cpd_extractions_base(warthog::graph::xy_graph *g,
+        cpd_extractions_base(G* g,
                              warthog::cpd::graph_oracle_base<T> *oracle)
             : g_(g), oracle_(oracle)
         {
-            assert(oracle->get_graph() == g);
+            assert(oracle->get_num_nodes() == g->get_num_nodes());
             max_k_moves_ = UINT_MAX;
             time_cutoff_ = DBL_MAX;
         }
@@ -58,10 +61,9 @@ class cpd_extractions_base : public warthog::search
                     break;
                 }
 
-                warthog::graph::node* n = g_->get_node(source_id);
-                assert(n->out_degree() > move);
-
-                warthog::graph::edge* e = (n->outgoing_begin() + move);
+                assert(g_->out_degree((uint32_t)source_id) > move);
+                typename G::edge_iter e =
+                    g_->outgoing_begin((uint32_t)source_id) + move;
                 source_id = e->node_id_;
                 sol.sum_of_edge_costs_ += e->wt_;
                 sol.nodes_touched_++;
@@ -95,10 +97,9 @@ class cpd_extractions_base : public warthog::search
                     break;
                 }
 
-                warthog::graph::node* n = g_->get_node(source_id);
-                assert(n->out_degree() > move);
-
-                warthog::graph::edge* e = (n->outgoing_begin() + move);
+                assert(g_->out_degree((uint32_t)source_id) > move);
+                typename G::edge_iter e =
+                    g_->outgoing_begin((uint32_t)source_id) + move;
                 source_id = e->node_id_;
                 sol.sum_of_edge_costs_ += e->wt_;
                 sol.nodes_touched_++;
@@ -123,7 +124,7 @@ class cpd_extractions_base : public warthog::search
         }
 
     private:
-        warthog::graph::xy_graph* g_;
+        G* g_;
         warthog::cpd::graph_oracle_base<T>* oracle_;
         double time_cutoff_;            // Time limit in nanoseconds
         uint32_t max_k_moves_;          // Max "distance" from target
@@ -55,6 +55,8 @@ class cpd_search : public warthog::search
         quality_cutoff_ = 0.0;
         k_moves_ =
             std::vector<uint32_t>(expander_->get_g()->get_num_nodes(), 0);
+        ub_ = std::vector<warthog::cost_t>(
+            expander_->get_g()->get_num_nodes(), warthog::COST_MAX);
     }
 
     virtual ~cpd_search() { }
@@ -241,6 +243,17 @@ class cpd_search : public warthog::search
     double time_cutoff_;            // Time limit in nanoseconds
     uint32_t max_k_moves_;          // Max "distance" from target
     std::vector<uint32_t> k_moves_; // "Distance" from target
+    // Upper bounds are kept here rather than in the search nodes, which
+    // may be compiled without them (cf. WARTHOG_COMPACT_SEARCH_NODE).
+    std::vector<warthog::cost_t> ub_;
+
+    inline warthog::cost_t
+    get_ub_(warthog::search_node* n)
+    { return ub_.at(n->get_id()); }
+
+    inline void
+    set_ub_(warthog::search_node* n, warthog::cost_t ub)
+    { ub_.at(n->get_id()) = ub; }
     double quality_cutoff_;
 
     // no copy ctor
@@ -264,9 +277,9 @@ class cpd_search : public warthog::search
             warthog::cost_t bound;
 
             // If we have an UB, we need to use it as source-of-truth
-            if (incumbent->get_ub() < warthog::COST_MAX)
+            if (get_ub_(incumbent) < warthog::COST_MAX)
             {
-                bound = incumbent->get_ub();
+                bound = get_ub_(incumbent);
             }
             else
             {
@@ -317,18 +330,18 @@ class cpd_search : public warthog::search
         }
         // Extra early-stopping criteria when we have an upper bound; in
         // CPD terms, we have an "unperturbed path."
-        if (current->get_f() == current->get_ub())
+        if (current->get_f() == get_ub_(current))
         {
             info(pi_.verbose_, "Early stop");
             stop = true;
         }
 
-        if (incumbent != nullptr && incumbent->get_ub() < warthog::COST_MAX)
+        if (incumbent != nullptr && get_ub_(incumbent) < warthog::COST_MAX)
         {
-            if (current->get_f() * (1 + quality_cutoff_) > incumbent->get_ub())
+            if (current->get_f() * (1 + quality_cutoff_) > get_ub_(incumbent))
             {
                 info(pi_.verbose_, "Quality cutoff", current->get_f(), "x",
-                      quality_cutoff_ + 1, ">", incumbent->get_ub());
+                      quality_cutoff_ + 1, ">", get_ub_(incumbent));
                 stop = true;
             }
         }
@@ -374,7 +387,8 @@ class cpd_search : public warthog::search
 
         // Should we check for overflow here?
         n->init(current->get_search_number(), current->get_id(),
-                gval, gval + hval, ub);
+                gval, gval + hval);
+        set_ub_(n, ub);
 
         update_k_(n->get_id(), current->get_id());
     }
@@ -386,22 +400,22 @@ class cpd_search : public warthog::search
         if(expander_->is_target(n, &pi_))
         {
             incumbent = n;
-            incumbent->set_ub(n->get_g());
+            set_ub_(incumbent, n->get_g());
             debug(pi_.verbose_,
                   "New path to target:", n->get_id(), "=", n->get_g());
         }
-        else if (n->get_ub() < warthog::COST_MAX)
+        else if (get_ub_(n) < warthog::COST_MAX)
         {
             // Found a new incumbent
             if (incumbent == nullptr)
             {
-                debug(pi_.verbose_, "Found UB:", n->get_id(), "=", n->get_ub());
+                debug(pi_.verbose_, "Found UB:", n->get_id(), "=", get_ub_(n));
                 incumbent = n;
             }
             // Better incumbent
-            else if (n->get_ub() < incumbent->get_ub())
+            else if (get_ub_(n) < get_ub_(incumbent))
             {
-                debug(pi_.verbose_, "Update UB:", n->get_id(), "=", n->get_ub());
+                debug(pi_.verbose_, "Update UB:", n->get_id(), "=", get_ub_(n));
                 incumbent = n;
             }
         }
@@ -439,7 +453,8 @@ class cpd_search : public warthog::search
         heuristic_->h(pi_.start_id_, pi_.target_id_, start_h, start_ub);
 
         // `hscale` is contained in the heuristic
-        start->init(pi_.instance_id_, warthog::SN_ID_MAX, 0, start_h, start_ub);
+        start->init(pi_.instance_id_, warthog::SN_ID_MAX, 0, start_h);
+        set_ub_(start, start_ub);
 
         // Start node has no parent
         k_moves_.at(start->get_id()) = 0;
@@ -589,7 +604,7 @@ class cpd_search : public warthog::search
                 // We assume that either all nodes have UBs or none do.
                 if (ub < warthog::COST_MAX)
                 {
-                    gval = incumbent->get_ub() - ub;
+                    gval = get_ub_(incumbent) - ub;
                 }
                 else
                 {
@@ -597,7 +612,8 @@ class cpd_search : public warthog::search
                 }
 
                 n->init(incumbent->get_search_number(),
-                        p_id, gval, gval + lb, gval + ub);
+                        p_id, gval, gval + lb);
+                set_ub_(n, gval + ub);
                 debug(pi_.verbose_, "Rebuild", *n);
                 incumbent = n;
             }
@@ -25,6 +25,7 @@
 #include "solution.h"
 #include "timer.h"
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -81,14 +82,7 @@ class flexible_astar: public warthog::search
 
 				// follow backpointers to extract the path
 				assert(expander_->is_target(target, &pi_));
-                warthog::search_node* current = target;
-				while(true)
-                {
-                    sol.path_.push_back(current->get_id());
-                    if(current->get_parent() == warthog::SN_ID_MAX) break;
-                    current = expander_->generate(current->get_parent());
-				}
-                std::reverse(sol.path_.begin(), sol.path_.end());
+                extract_path(target, sol);
 
                 #ifndef NDEBUG
                 if(pi_.verbose_)
@@ -110,6 +104,34 @@ class flexible_astar: public warthog::search
             }
 		}
 
+        // one-to-many search: find a shortest path from instance.start_id_
+        // to every node in @param targets using a single sweep, which stops
+        // once all targets have been expanded. @param sols receives one
+        // solution per target (in the same order); each carries the metrics
+        // of the whole sweep. targets that are invalid or unreachable keep
+        // a cost of warthog::COST_MAX.
+        //
+        // the heuristic must be admissible with respect to every target.
+        // its set_targets method receives the internal target ids; see
+        // warthog::multi_target_heuristic and warthog::zero_heuristic.
+        // expansion policies that prune using the target (e.g. with a
+        // bounding-box filter) are not supported.
+        void
+        get_pathcosts(warthog::problem_instance& instance,
+                std::vector<warthog::sn_id_t>& targets,
+                std::vector<warthog::solution>& sols)
+        {
+            multi_target_search(instance, targets, sols, false);
+        }
+
+        void
+        get_paths(warthog::problem_instance& instance,
+                std::vector<warthog::sn_id_t>& targets,
+                std::vector<warthog::solution>& sols)
+        {
+            multi_target_search(instance, targets, sols, true);
+        }
+
         // return a list of the nodes expanded during the last search
         // @param coll: an empty list
         void
@@ -202,8 +224,77 @@ class flexible_astar: public warthog::search
 		flexible_astar&
 		operator=(const flexible_astar& other) { return *this; }
 
+        void
+        extract_path(warthog::search_node* target, warthog::solution& sol)
+        {
+            warthog::search_node* current = target;
+            while(true)
+            {
+                sol.path_.push_back(current->get_id());
+                if(current->get_parent() == warthog::SN_ID_MAX) break;
+                current = expander_->generate(current->get_parent());
+            }
+            std::reverse(sol.path_.begin(), sol.path_.end());
+        }
+
+        void
+        multi_target_search(warthog::problem_instance& instance,
+                std::vector<warthog::sn_id_t>& targets,
+                std::vector<warthog::solution>& sols, bool extract_paths)
+        {
+            sols.clear();
+            sols.resize(targets.size());
+            pi_ = instance;
+            pi_.target_id_ = warthog::SN_ID_MAX;
+
+            // convert to internal ids; the goal set is kept sorted and
+            // without duplicates
+            std::vector<warthog::sn_id_t> internal_ids(
+                    targets.size(), warthog::SN_ID_MAX);
+            std::vector<warthog::sn_id_t> goal_set;
+            warthog::problem_instance target_pi(pi_);
+            for(size_t i = 0; i < targets.size(); i++)
+            {
+                target_pi.target_id_ = targets.at(i);
+                warthog::search_node* n =
+                    expander_->generate_target_node(&target_pi);
+                if(!n) { continue; }
+                internal_ids.at(i) = n->get_id();
+                goal_set.push_back(n->get_id());
+            }
+            std::sort(goal_set.begin(), goal_set.end());
+            goal_set.erase(
+                    std::unique(goal_set.begin(), goal_set.end()),
+                    goal_set.end());
+            if(goal_set.empty()) { return; }
+
+            heuristic_->set_targets(goal_set);
+            warthog::solution sweep;
+            search(sweep, &goal_set);
+
+            for(size_t i = 0; i < targets.size(); i++)
+            {
+                warthog::solution& sol = sols.at(i);
+                sol = sweep;
+                if(internal_ids.at(i) == warthog::SN_ID_MAX) { continue; }
+
+                warthog::search_node* n =
+                    expander_->generate(internal_ids.at(i));
+                if(n->get_search_number() != pi_.instance_id_ ||
+                        !n->get_expanded())
+                { continue; }
+
+                sol.sum_of_edge_costs_ = n->get_g();
+                if(extract_paths) { extract_path(n, sol); }
+            }
+        }
+
+        // when @param goal_set is given (sorted internal ids), the search
+        // ends once every node in the set has been expanded rather than
+        // when the target of pi_ is reached
 		warthog::search_node*
-		search(warthog::solution& sol)
+		search(warthog::solution& sol,
+                std::vector<warthog::sn_id_t>* goal_set = 0)
 		{
 			warthog::timer mytimer;
 			mytimer.start();
@@ -225,8 +316,8 @@ class flexible_astar: public warthog::search
             // initialise and push the start node
             if(pi_.start_id_ == warthog::SN_ID_MAX) { return 0; }
             start = expander_->generate_start_node(&pi_);
-            assert(start->get_search_number() != pi_.instance_id_);
             if(!start) { return 0; } // invalid start location
+            assert(start->get_search_number() != pi_.instance_id_);
             pi_.start_id_ = start->get_id();
 
 			start->init(pi_.instance_id_, warthog::SN_ID_MAX,
@@ -235,6 +326,7 @@ class flexible_astar: public warthog::search
 			open_->push(start);
             
             listener_->generate_node(0, start, 0, UINT32_MAX);
+            size_t goals_remaining = goal_set ? goal_set->size() : 0;
 
 			#ifndef NDEBUG
 			if(pi_.verbose_) { pi_.print(std::cerr); std:: cerr << "\n";}
@@ -256,7 +348,17 @@ class flexible_astar: public warthog::search
                 listener_->expand_node(current);
 
                 // goal test
-                if(expander_->is_target(current, &pi_))
+                if(goal_set)
+                {
+                    if(std::binary_search(goal_set->begin(),
+                                goal_set->end(), current->get_id()) &&
+                            --goals_remaining == 0)
+                    {
+                        target = current;
+                        break;
+                    }
+                }
+                else if(expander_->is_target(current, &pi_))
                 {
                     target = current;
                     break;
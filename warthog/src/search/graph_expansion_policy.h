@@ -7,7 +7,9 @@
 //
 // an expansion policy for xy graphs. includes support for a node 
 // filtering mechanism (i.e. it can be configured to prune successor
-// nodes that do not match some specified criteria)
+// nodes that do not match some specified criteria). the graph can be
+// an xy_graph or any other type with the same adjacency interface
+// (e.g. a csr_graph)
 //
 // @author: dharabor
 // @created: 2018-05-04
@@ -23,24 +25,24 @@
 namespace warthog
 {
 
-template <class FILTER = warthog::dummy_filter>
+template <class FILTER = warthog::dummy_filter, 
+          class G = warthog::graph::xy_graph>
 class graph_expansion_policy 
 {
     public:
-        graph_expansion_policy(
-                warthog::graph::xy_graph* g, FILTER* filter = 0)
-            :  filter_(filter), g_(g)
+        graph_expansion_policy(G* g, FILTER* filter = 0)
+            :  filter_(filter), g_(g), current_degree_(0)
         {
             assert(g);
             if(filter == 0)
             {
                 fn_generate_successor = &warthog::graph_expansion_policy
-                                        <FILTER>::fn_generate_no_filter;
+                                        <FILTER, G>::fn_generate_no_filter;
             }
             else
             {
                 fn_generate_successor = &warthog::graph_expansion_policy
-                                        <FILTER>::fn_generate_with_filter;
+                                        <FILTER, G>::fn_generate_with_filter;
             }
 
             node_pool_size_ = g_->get_num_nodes();
@@ -56,7 +58,7 @@ class graph_expansion_policy
             delete [] nodepool_;
         }
 
-        warthog::graph::xy_graph*
+        G*
         get_g()
         { return g_; }
 
@@ -65,7 +67,8 @@ class graph_expansion_policy
         {
             edge_index_ = 0;
             current_id_ = (uint32_t)current->get_id();
-            current_graph_node_ = g_->get_node((uint32_t)current->get_id()) ;
+            current_begin_ = g_->outgoing_begin(current_id_);
+            current_degree_ = g_->out_degree(current_id_);
         }
 
 		inline void
@@ -78,10 +81,9 @@ class graph_expansion_policy
 		inline void
 		n(warthog::search_node*& ret, double& cost)
 		{
-            if(edge_index_ < current_graph_node_->out_degree())
+            if(edge_index_ < current_degree_)
             {
-                warthog::graph::edge *e = 
-                    current_graph_node_->outgoing_begin() + edge_index_;
+                edge_iter e = current_begin_ + edge_index_;
                 ret = (this->*fn_generate_successor)
                          (e->node_id_, edge_index_, *e);
                 cost = e->wt_;
@@ -99,10 +101,9 @@ class graph_expansion_policy
         inline void
         get_successor(uint32_t which, warthog::search_node*& ret, double& cost)
         {
-            if(which < current_graph_node_->out_degree())
+            if(which < current_degree_)
             {
-                warthog::graph::edge *e = 
-                    current_graph_node_->outgoing_begin() + which;
+                edge_iter e = current_begin_ + which;
                 ret = (this->*fn_generate_successor)
                          (e->node_id_, edge_index_, *e);
                 cost = e->wt_;
@@ -117,18 +118,14 @@ class graph_expansion_policy
 		inline void
 		next(warthog::search_node*& ret, double& cost)
 		{
-            assert(current_graph_node_);
             ret = 0;
             cost = warthog::INF32;
 
-            warthog::graph::edge_iter begin = 
-                current_graph_node_->outgoing_begin();
-
             for( ++edge_index_;
-                   edge_index_ < current_graph_node_->out_degree(); 
+                   edge_index_ < current_degree_; 
                    edge_index_++)
             {
-                warthog::graph::edge& e = *(begin+edge_index_);
+                const edge_type& e = *(current_begin_+edge_index_);
                 assert(e.node_id_ < g_->get_num_nodes());
                 ret = (this->*fn_generate_successor)
                         (current_id_, edge_index_, e);
@@ -157,7 +154,7 @@ class graph_expansion_policy
             
             // also update the filter with the new target location
             if(filter_)
-            { filter_->set_target((uint32_t)pi->target_id_); }
+            { filter_->set_target(t_graph_id); }
 
             // generate the search node
             return &nodepool_[t_graph_id];
@@ -178,8 +175,7 @@ class graph_expansion_policy
         inline uint32_t 
         get_num_successors() 
         { 
-            return
-                current_graph_node_ ?  current_graph_node_->out_degree() : 0; 
+            return current_degree_; 
         }
 
         void
@@ -200,20 +196,24 @@ class graph_expansion_policy
         }
 
 	private:
+        typedef typename G::edge_type edge_type;
+        typedef typename G::edge_iter edge_iter;
+
         FILTER* filter_;
-        warthog::graph::xy_graph* g_;
+        G* g_;
 
         uint32_t current_id_;
         uint32_t edge_index_;
-        warthog::graph::node* current_graph_node_;
+        edge_iter current_begin_;
+        uint32_t current_degree_;
 
         warthog::search_node* nodepool_;
         size_t node_pool_size_;
 
         typedef 
             warthog::search_node*
-            (warthog::graph_expansion_policy<FILTER>::*generate_fn)
-            (uint32_t current_id, uint32_t edge_idx, warthog::graph::edge& e);
+            (warthog::graph_expansion_policy<FILTER, G>::*generate_fn)
+            (uint32_t current_id, uint32_t edge_idx, const edge_type& e);
 
         generate_fn fn_generate_successor;
 
@@ -221,7 +221,7 @@ class graph_expansion_policy
         fn_generate_with_filter(
                 uint32_t current_id, 
                 uint32_t edge_idx, 
-                warthog::graph::edge& e)
+                const edge_type& e)
         {
             if(!filter_->filter(current_id_, edge_idx))
             {
@@ -234,7 +234,7 @@ class graph_expansion_policy
         fn_generate_no_filter(
                 uint32_t current_id, 
                 uint32_t edge_idx, 
-                warthog::graph::edge& e)
+                const edge_type& e)
         {
             return &nodepool_[e.node_id_];
         }
@@ -3,6 +3,8 @@
 
 #include "search_node.h"
 
+#include <atomic>
+
 namespace warthog
 {
 
@@ -77,7 +79,9 @@ class problem_instance
         void* extra_params_;
 
         private:
-            static uint32_t instance_counter_;
+            // atomic: instances are created concurrently by the
+            // threads of a query_engine
+            static std::atomic<uint32_t> instance_counter_;
 
 };
 
@@ -0,0 +1,155 @@
+#include "query_engine.h"
+
+warthog::query_engine::query_engine(uint32_t num_workers,
+        factory make_search, uint32_t capacity)
+    : tasks_(capacity), queued_(0), pending_(0), sleepers_(0), stop_(false)
+{
+    if(num_workers == 0) { num_workers = 1; }
+
+    // build every search before starting any thread; factories need not
+    // be thread-safe
+    for(uint32_t i = 0; i < num_workers; i++)
+    {
+        worker* w = new worker();
+        w->alg_.reset(make_search(i));
+        w->queries_ = 0;
+        workers_.push_back(std::unique_ptr<worker>(w));
+    }
+
+    for(auto& w : workers_)
+    {
+        w->thread_ = std::thread(&warthog::query_engine::run, this, w.get());
+    }
+}
+
+warthog::query_engine::~query_engine()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+
+    for(auto& w : workers_)
+    {
+        w->thread_.join();
+    }
+}
+
+std::future<warthog::solution>
+warthog::query_engine::submit(const warthog::problem_instance& pi, bool path)
+{
+    // std::function needs a copyable target; promises are move-only
+    std::shared_ptr<std::promise<warthog::solution>> promise =
+        std::make_shared<std::promise<warthog::solution>>();
+
+    task* t = new task{ pi, path,
+        [promise](warthog::solution& sol) { promise->set_value(sol); } };
+    enqueue(t);
+    return promise->get_future();
+}
+
+void
+warthog::query_engine::submit(
+        const std::vector<warthog::problem_instance>& batch,
+        callback cb, bool path)
+{
+    std::shared_ptr<callback> shared_cb = std::make_shared<callback>(cb);
+    for(uint32_t i = 0; i < batch.size(); i++)
+    {
+        task* t = new task{ batch.at(i), path,
+            [shared_cb, i](warthog::solution& sol) { (*shared_cb)(i, sol); } };
+        enqueue(t);
+    }
+}
+
+void
+warthog::query_engine::solve(
+        const std::vector<warthog::problem_instance>& batch,
+        std::vector<warthog::solution>& sols, bool path)
+{
+    sols.clear();
+    sols.resize(batch.size());
+
+    // every query writes to its own slot; no locking required
+    submit(batch,
+        [&sols](uint32_t index, warthog::solution& sol)
+        { sols[index] = sol; },
+        path);
+    wait();
+}
+
+void
+warthog::query_engine::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_.load() == 0; });
+}
+
+size_t
+warthog::query_engine::mem()
+{
+    size_t bytes = sizeof(*this) + tasks_.mem();
+    for(auto& w : workers_)
+    {
+        bytes += sizeof(worker) + w->alg_->mem();
+    }
+    return bytes;
+}
+
+void
+warthog::query_engine::enqueue(task* t)
+{
+    // count the task before it becomes visible, so that a worker never
+    // claims a task that is not yet counted
+    pending_++;
+    queued_++;
+    while(!tasks_.try_push(t))
+    {
+        std::this_thread::yield();
+    }
+
+    // a worker increments sleepers_ before it checks queued_, so either
+    // it sees the new task or we see it sleeping
+    if(sleepers_.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        work_cv_.notify_one();
+    }
+}
+
+void
+warthog::query_engine::run(worker* w)
+{
+    task* t;
+    while(true)
+    {
+        if(tasks_.try_pop(t))
+        {
+            queued_--;
+
+            warthog::solution sol;
+            if(t->path_) { w->alg_->get_path(t->pi_, sol); }
+            else { w->alg_->get_pathcost(t->pi_, sol); }
+            t->done_(sol);
+            delete t;
+            w->queries_.fetch_add(1, std::memory_order_relaxed);
+
+            if(--pending_ == 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_cv_.notify_all();
+            }
+            continue;
+        }
+
+        // nothing to do; sleep until there is
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleepers_++;
+        work_cv_.wait(lock,
+                [this] { return queued_.load() > 0 || stop_.load(); });
+        sleepers_--;
+        if(stop_ && queued_.load() == 0) { return; }
+    }
+}
@@ -0,0 +1,174 @@
+#ifndef WARTHOG_QUERY_ENGINE_H
+#define WARTHOG_QUERY_ENGINE_H
+
+// query_engine.h
+//
+// A pool of worker threads that answer point-to-point queries in parallel.
+// Each worker owns a private search algorithm (and with it an expander,
+// node pool and open list) which is built once, by a user-supplied factory,
+// when the engine is created. The domain itself (gridmap, xy_graph, CH,
+// CPD, ...) is not copied: the factory is expected to point every worker
+// at the same object, which must not be modified while the engine runs.
+//
+// Queries are handed to the workers through a lock-free MPMC queue.
+// Results come back either through a std::future (one query at a time)
+// or a callback (batches); ::solve is a blocking convenience for batches
+// that returns the solutions in input order. Idle workers sleep on a
+// condition variable rather than spin.
+//
+// NB: anything shared between workers must be safe for concurrent reads.
+// this holds for the grid and graph domains and the stateless heuristics
+// (octile, manhattan, euclidean, zero) but not, for example, for
+// heuristics that cache per-target data.
+//
+
+#include "flexible_astar.h"
+#include "mpmc_queue.h"
+#include "problem_instance.h"
+#include "search.h"
+#include "solution.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace warthog
+{
+
+// a flexible_astar that owns its heuristic, expander and open list;
+// a convenient unit of per-worker state for the query engine
+template<class H, class E, class Q = warthog::pqueue_min>
+class astar_worker : public warthog::search
+{
+    public:
+        astar_worker(H* heuristic, E* expander, Q* open)
+            : heuristic_(heuristic), expander_(expander), open_(open),
+              alg_(heuristic, expander, open)
+        { }
+
+        virtual ~astar_worker() { }
+
+        virtual void
+        get_path(warthog::problem_instance& pi, warthog::solution& sol)
+        { alg_.get_path(pi, sol); }
+
+        virtual void
+        get_pathcost(warthog::problem_instance& pi, warthog::solution& sol)
+        { alg_.get_pathcost(pi, sol); }
+
+        virtual size_t
+        mem() { return sizeof(*this) + alg_.mem(); }
+
+        warthog::flexible_astar<H, E, Q>*
+        get_search() { return &alg_; }
+
+    private:
+        std::unique_ptr<H> heuristic_;
+        std::unique_ptr<E> expander_;
+        std::unique_ptr<Q> open_;
+        warthog::flexible_astar<H, E, Q> alg_;
+};
+
+class query_engine
+{
+    public:
+        // builds the search state for worker @param id. the returned
+        // object is used only by that worker and is deleted with the engine
+        typedef std::function<warthog::search*(uint32_t id)> factory;
+
+        // invoked, from a worker thread, once per query in a batch with
+        // the index of the query in the batch and its solution
+        typedef std::function<void(uint32_t index, warthog::solution&)>
+            callback;
+
+        // @param num_workers: number of threads (at least 1)
+        // @param make_search: builds the per-worker search algorithms
+        // @param capacity: size of the task queue. submitting to a full
+        // queue yields until a worker makes room.
+        query_engine(uint32_t num_workers, factory make_search,
+                uint32_t capacity = 4096);
+
+        // stops the workers once every submitted query is answered
+        ~query_engine();
+
+        // solve @param pi; the solution is available from the future.
+        // if @param path is false only the cost of the path is computed.
+        std::future<warthog::solution>
+        submit(const warthog::problem_instance& pi, bool path = true);
+
+        // solve every instance in @param batch and report the results
+        // through @param cb. returns as soon as the batch is queued.
+        void
+        submit(const std::vector<warthog::problem_instance>& batch,
+                callback cb, bool path = true);
+
+        // solve every instance in @param batch and block until done (this
+        // also waits for queries submitted earlier). the i-th solution in
+        // @param sols belongs to the i-th instance.
+        void
+        solve(const std::vector<warthog::problem_instance>& batch,
+                std::vector<warthog::solution>& sols, bool path = true);
+
+        // block until every query submitted so far has been answered
+        void
+        wait();
+
+        inline uint32_t
+        num_workers() { return (uint32_t)workers_.size(); }
+
+        // number of queries answered by worker @param id
+        inline uint64_t
+        get_queries(uint32_t id) { return workers_.at(id)->queries_; }
+
+        size_t
+        mem();
+
+    private:
+        struct task
+        {
+            warthog::problem_instance pi_;
+            bool path_;
+            std::function<void(warthog::solution&)> done_;
+        };
+
+        struct worker
+        {
+            std::unique_ptr<warthog::search> alg_;
+            std::thread thread_;
+            std::atomic<uint64_t> queries_;
+        };
+
+        warthog::mpmc_queue<task*> tasks_;
+        std::vector<std::unique_ptr<worker>> workers_;
+
+        // queued_ counts tasks not yet claimed by a worker; pending_
+        // counts tasks not yet finished
+        std::atomic<uint64_t> queued_;
+        std::atomic<uint64_t> pending_;
+        std::atomic<uint32_t> sleepers_;
+        std::atomic<bool> stop_;
+
+        std::mutex mutex_;
+        std::condition_variable work_cv_;
+        std::condition_variable done_cv_;
+
+        void
+        enqueue(task* t);
+
+        void
+        run(worker* w);
+
+        // no copy
+        query_engine(const query_engine& other) : tasks_(0) { }
+        query_engine&
+        operator=(const query_engine& other) { return *this; }
+};
+
+}
+
+#endif
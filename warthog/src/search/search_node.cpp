@@ -1,6 +1,15 @@
 #include "search_node.h"
 
-unsigned int warthog::search_node::refcount_ = 0;
+std::atomic<uint32_t> warthog::search_node::refcount_(0);
+
+void
+warthog::compact_cost::overflow(warthog::cost_t cost)
+{
+    std::cerr << "err; cost " << cost << " is beyond the range of compact "
+        << "search nodes (" << UINT32_MAX / SCALE << "). rebuild with a "
+        << "smaller COMPACT_COST_SCALE\n";
+    exit(1);
+}
 
 std::ostream& operator<<(std::ostream& str, const warthog::search_node& sn)
 {
@@ -3,6 +3,24 @@
 
 // search_node.h
 //
+// By default each node stores 64-bit identifiers and double-precision
+// costs. Compiling with WARTHOG_COMPACT_SEARCH_NODE selects a 24-byte
+// layout instead:
+//  - identifiers are 32 bits (SN_ID_MAX is mapped to UINT32_MAX).
+//    time-indexed domains (sipp, cbs_ll, ll) need the high 32 bits of
+//    their ids and cannot be used in this mode.
+//  - g and f are 32-bit fixed-point values with WARTHOG_COMPACT_COST_SCALE
+//    units per unit of cost (cf. warthog::compact_cost). the default,
+//    warthog::ONE, keeps the fractional costs of gridmap domains to the
+//    precision of grid2graph, and costs up to UINT32_MAX / ONE (~42949).
+//    larger finite costs stop the program with an error: road networks
+//    have integer weights and long paths, and need a scale of 1.
+//  - the upper bound (ub) is not stored; get_ub always returns COST_MAX
+//    (cpd_search keeps upper bounds in a separate array).
+//  - the expanded flag is kept in the high bit of the priority field.
+// Hot fields (f, g, priority) come first so that pqueue comparisons touch
+// a single 12-byte prefix of each node.
+//
 // @author: dharabor
 // @created: 10/08/2012
 //
@@ -11,14 +29,64 @@
 #include "cpool.h"
 #include "jps.h"
 
+#include <atomic>
+#include <cassert>
 #include <iostream>
 
+#ifndef WARTHOG_COMPACT_COST_SCALE
+#define WARTHOG_COMPACT_COST_SCALE warthog::ONE
+#endif
+
 namespace warthog
 {
 
+// the fixed-point costs of compact search nodes. these are defined in
+// every build, so the rounding can be tested without the compact layout.
+namespace compact_cost
+{
+
+static_assert(WARTHOG_COMPACT_COST_SCALE > 0,
+        "WARTHOG_COMPACT_COST_SCALE must be positive");
+static const warthog::cost_t SCALE = WARTHOG_COMPACT_COST_SCALE;
+
+// report a finite @param cost that does not fit, and exit
+void
+overflow(warthog::cost_t cost);
+
+// COST_MAX is UINT32_MAX; other costs are rounded to the nearest unit
+inline uint32_t
+pack(warthog::cost_t cost)
+{
+    warthog::cost_t fixed = cost * SCALE + 0.5;
+    if(fixed >= UINT32_MAX)
+    {
+        if(cost != warthog::COST_MAX) { overflow(cost); }
+        return UINT32_MAX;
+    }
+    return (uint32_t)fixed;
+}
+
+inline warthog::cost_t
+unpack(uint32_t cost)
+{
+    return cost == UINT32_MAX ?
+        warthog::COST_MAX : (warthog::cost_t)cost / SCALE;
+}
+
+}
+
 class search_node
 {
 	public:
+#ifdef WARTHOG_COMPACT_SEARCH_NODE
+		search_node(warthog::sn_id_t id = warthog::SN_ID_MAX) :
+            f_(UINT32_MAX), g_(UINT32_MAX), priority_(warthog::INF32 & PRIORITY_MASK),
+            search_number_(0), id_(pack_id(id)),
+            parent_id_(pack_id(warthog::SN_ID_MAX))
+		{
+			refcount_++;
+		}
+#else
 		search_node(warthog::sn_id_t id = warthog::SN_ID_MAX) :
             id_(id), parent_id_(warthog::SN_ID_MAX),
             g_(warthog::COST_MAX), f_(warthog::COST_MAX), ub_(warthog::COST_MAX),
@@ -26,10 +94,104 @@ class search_node
 		{
 			refcount_++;
 		}
+#endif
 
 		~search_node()
 		{ refcount_--; }
 
+#ifdef WARTHOG_COMPACT_SEARCH_NODE
+		inline void
+		init(uint32_t search_number,
+             warthog::sn_id_t parent_id,
+             warthog::cost_t g,
+             warthog::cost_t f,
+             warthog::cost_t ub=warthog::COST_MAX)
+		{
+            parent_id_= pack_id(parent_id);
+            f_ = pack_cost(f);
+            g_ = pack_cost(g);
+			search_number_ = search_number;
+            priority_ &= PRIORITY_MASK;
+		}
+
+		inline uint32_t
+		get_search_number() const
+        { return search_number_; }
+
+        inline void
+        set_search_number(uint32_t search_number)
+        { search_number_ = search_number; }
+
+		inline warthog::sn_id_t
+		get_id() const
+        { return unpack_id(id_); }
+
+		inline void
+		set_id(warthog::sn_id_t id)
+		{ id_ = pack_id(id); }
+
+		inline bool
+		get_expanded() const
+        { return priority_ & EXPANDED_BIT; }
+
+		inline void
+		set_expanded(bool expanded)
+		{
+            priority_ = expanded ?
+                (priority_ | EXPANDED_BIT) : (priority_ & PRIORITY_MASK);
+        }
+
+		inline warthog::sn_id_t
+		get_parent() const
+        { return unpack_id(parent_id_); }
+
+		inline void
+		set_parent(warthog::sn_id_t parent_id)
+        { parent_id_ = pack_id(parent_id); }
+
+		inline uint32_t
+		get_priority() const
+        {
+            uint32_t priority = priority_ & PRIORITY_MASK;
+            return priority == PRIORITY_MASK ? warthog::INF32 : priority;
+        }
+
+		inline void
+		set_priority(uint32_t priority)
+        {
+            assert(priority == warthog::INF32 || priority < PRIORITY_MASK);
+            priority_ = (priority_ & EXPANDED_BIT) | (priority & PRIORITY_MASK);
+        }
+
+		inline warthog::cost_t
+		get_g() const { return unpack_cost(g_); }
+
+		inline void
+		set_g(warthog::cost_t g) { g_ = pack_cost(g); }
+
+		inline warthog::cost_t
+		get_f() const { return unpack_cost(f_); }
+
+		inline void
+		set_f(warthog::cost_t f) { f_ = pack_cost(f); }
+
+		inline warthog::cost_t
+		get_ub() const { return warthog::COST_MAX; }
+
+		inline void
+		set_ub(warthog::cost_t ub) { }
+
+		inline void
+		relax(warthog::cost_t g, warthog::sn_id_t parent_id)
+		{
+			assert(g < get_g());
+            uint32_t g_new = pack_cost(g);
+			f_ = (f_ - g_) + g_new;
+			g_ = g_new;
+			parent_id_ = pack_id(parent_id);
+		}
+
+#else
 		inline void
 		init(uint32_t search_number,
              warthog::sn_id_t parent_id,
@@ -111,6 +273,8 @@ class search_node
 			parent_id_ = parent_id;
 		}
 
+#endif
+
 		inline bool
 		operator<(const warthog::search_node& other) const
 		{
@@ -204,8 +368,8 @@ class search_node
 		{
 			out << "search_node id:" << get_id();
             out << " p_id: ";
-            out << parent_id_;
-            out << " g: "<<g_ <<" f: "<<this->get_f() << " ub: " << ub_
+            out << get_parent();
+            out << " g: "<<get_g() <<" f: "<<this->get_f() << " ub: " << get_ub()
                 << " expanded: " << get_expanded() << " "
                 << " search_number_: " << search_number_;
 		}
@@ -220,6 +384,36 @@ class search_node
         get_refcount() { return refcount_; }
 
 	private:
+#ifdef WARTHOG_COMPACT_SEARCH_NODE
+        static const uint32_t EXPANDED_BIT = 1u << 31;
+        static const uint32_t PRIORITY_MASK = ~EXPANDED_BIT;
+
+        uint32_t f_;
+        uint32_t g_;
+		uint32_t priority_; // expansion priority; high bit: open or closed
+		uint32_t search_number_;
+		uint32_t id_;
+        uint32_t parent_id_;
+
+        static inline uint32_t
+        pack_id(warthog::sn_id_t id)
+        {
+            assert(id == warthog::SN_ID_MAX || id < UINT32_MAX);
+            return (uint32_t)id;
+        }
+
+        static inline warthog::sn_id_t
+        unpack_id(uint32_t id)
+        { return id == UINT32_MAX ? warthog::SN_ID_MAX : id; }
+
+        static inline uint32_t
+        pack_cost(warthog::cost_t cost)
+        { return warthog::compact_cost::pack(cost); }
+
+        static inline warthog::cost_t
+        unpack_cost(uint32_t cost)
+        { return warthog::compact_cost::unpack(cost); }
+#else
 		warthog::sn_id_t id_;
         warthog::sn_id_t parent_id_;
 
@@ -232,9 +426,15 @@ class search_node
 		uint32_t priority_; // expansion priority
 
 		uint32_t search_number_;
-        static uint32_t refcount_;
+#endif
+        static std::atomic<uint32_t> refcount_;
 };
 
+#ifdef WARTHOG_COMPACT_SEARCH_NODE
+static_assert(sizeof(warthog::search_node) == 24,
+        "compact search_node should be 24 bytes");
+#endif
+
 struct cmp_less_search_node
 {
     inline bool
@@ -0,0 +1,120 @@
+#include "problem_instance.h"
+#include "subgoal_graph_expansion_policy.h"
+
+#include <algorithm>
+
+warthog::subgoal_graph_expansion_policy::subgoal_graph_expansion_policy(
+		warthog::subgoal_graph* sg)
+: expansion_policy(sg->get_map()->height() * sg->get_map()->width()),
+  sg_(sg), map_(sg->get_map()), start_id_(warthog::INF32),
+  target_id_(warthog::INF32), instance_(0)
+{
+    target_marks_.resize(sg_->get_num_subgoals(), 0);
+}
+
+void
+warthog::subgoal_graph_expansion_policy::expand(
+        warthog::search_node* current, warthog::problem_instance* problem)
+{
+	reset();
+
+    uint32_t id = (uint32_t)current->get_id();
+    uint32_t index = sg_->index(id);
+    if(index != warthog::INF32)
+    {
+        for(const uint32_t* it = sg_->edges_begin(index);
+                it != sg_->edges_end(index); it++)
+        {
+            add_neighbour(this->generate(*it), sg_->octile(id, *it));
+        }
+        if(target_id_ != warthog::INF32 && target_marks_[index] == instance_)
+        {
+            add_neighbour(this->generate(target_id_),
+                    sg_->octile(id, target_id_));
+        }
+    }
+    else if(id == start_id_)
+    {
+        for(uint32_t succ : start_subgoals_)
+        {
+            add_neighbour(this->generate(succ), sg_->octile(id, succ));
+        }
+    }
+
+    // the one edge that does not end at a subgoal
+    if(id == start_id_ && target_id_ != warthog::INF32 &&
+       target_id_ != start_id_ && sg_->h_reachable(start_id_, target_id_))
+    {
+        add_neighbour(this->generate(target_id_),
+                sg_->octile(id, target_id_));
+    }
+}
+
+void
+warthog::subgoal_graph_expansion_policy::get_xy(
+        warthog::sn_id_t node_id, int32_t& x, int32_t& y)
+{
+    map_->to_unpadded_xy((uint32_t)node_id, (uint32_t&)x, (uint32_t&)y);
+}
+
+uint32_t
+warthog::subgoal_graph_expansion_policy::to_padded_tile(warthog::sn_id_t id)
+{
+    uint32_t max_id = map_->header_width() * map_->header_height();
+    if(id >= max_id) { return warthog::INF32; }
+    uint32_t padded_id = map_->to_padded_id((uint32_t)id);
+    if(map_->get_label(padded_id) == 0) { return warthog::INF32; }
+    return padded_id;
+}
+
+warthog::search_node*
+warthog::subgoal_graph_expansion_policy::generate_target_node(
+        warthog::problem_instance* pi)
+{
+    // a new instance; the subgoals marked for the last target are stale
+    instance_++;
+    if(instance_ == 0)
+    {
+        std::fill(target_marks_.begin(), target_marks_.end(), 0);
+        instance_ = 1;
+    }
+
+    target_id_ = to_padded_tile(pi->target_id_);
+    if(target_id_ == warthog::INF32) { return 0; }
+
+    if(sg_->index(target_id_) == warthog::INF32)
+    {
+        // the graph is undirected: the subgoals from which the target is
+        // direct-h-reachable are those direct-h-reachable from it
+        tmp_.clear();
+        sg_->direct_h_reachable(target_id_, tmp_);
+        for(uint32_t succ : tmp_) { target_marks_[sg_->index(succ)] = instance_; }
+    }
+    return generate(target_id_);
+}
+
+warthog::search_node*
+warthog::subgoal_graph_expansion_policy::generate_start_node(
+        warthog::problem_instance* pi)
+{
+    // a search without a target
+    if(pi->target_id_ == warthog::SN_ID_MAX) { target_id_ = warthog::INF32; }
+
+    start_id_ = to_padded_tile(pi->start_id_);
+    if(start_id_ == warthog::INF32) { return 0; }
+
+    start_subgoals_.clear();
+    if(sg_->index(start_id_) == warthog::INF32)
+    {
+        sg_->direct_h_reachable(start_id_, start_subgoals_);
+    }
+    return generate(start_id_);
+}
+
+size_t
+warthog::subgoal_graph_expansion_policy::mem()
+{
+	return expansion_policy::mem() + sizeof(*this) + sg_->mem() +
+        sizeof(uint32_t) * (start_subgoals_.capacity() +
+                target_marks_.capacity() + tmp_.capacity());
+}
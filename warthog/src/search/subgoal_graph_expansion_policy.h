@@ -0,0 +1,70 @@
+#ifndef WARTHOG_SUBGOAL_GRAPH_EXPANSION_POLICY_H
+#define WARTHOG_SUBGOAL_GRAPH_EXPANSION_POLICY_H
+
+// subgoal_graph_expansion_policy.h
+//
+// An expansion policy for searching a warthog::subgoal_graph. Node ids are
+// padded ids of the gridmap, as for JPS, so the octile heuristic can be
+// used as is; the successors of a subgoal are its neighbours in the graph.
+//
+// A start or target tile that is not a subgoal is joined to the graph for
+// the current instance only: the start gets an edge to each subgoal that
+// is direct-h-reachable from it, and each subgoal direct-h-reachable from
+// the target gets an edge to the target. The start also reaches the target
+// directly if the two are h-reachable.
+//
+
+#include "expansion_policy.h"
+#include "search_node.h"
+#include "subgoal_graph.h"
+
+#include <vector>
+
+namespace warthog
+{
+
+class problem_instance;
+class subgoal_graph_expansion_policy : public expansion_policy
+{
+	public:
+		subgoal_graph_expansion_policy(warthog::subgoal_graph* sg);
+		virtual ~subgoal_graph_expansion_policy() { }
+
+		virtual void
+		expand(warthog::search_node*, warthog::problem_instance*);
+
+        virtual void
+        get_xy(sn_id_t node_id, int32_t& x, int32_t& y);
+
+        virtual warthog::search_node*
+        generate_start_node(warthog::problem_instance* pi);
+
+        virtual warthog::search_node*
+        generate_target_node(warthog::problem_instance* pi);
+
+		virtual size_t
+		mem();
+
+	private:
+		warthog::subgoal_graph* sg_;
+		warthog::gridmap* map_;
+
+        // the tiles of the current instance (padded ids), the subgoals
+        // direct-h-reachable from the start and, for each subgoal from
+        // which the target is direct-h-reachable, the instance number
+        uint32_t start_id_;
+        uint32_t target_id_;
+        std::vector<uint32_t> start_subgoals_;
+        std::vector<uint32_t> target_marks_;
+        uint32_t instance_;
+        std::vector<uint32_t> tmp_;
+
+        // the padded id of the unpadded @param id, or INF32 if it is not
+        // a traversable tile
+        uint32_t
+        to_padded_tile(sn_id_t id);
+};
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include "problem_instance.h"
+#include "tiled_gridmap_expansion_policy.h"
+
+warthog::tiled_gridmap_expansion_policy::tiled_gridmap_expansion_policy(
+        warthog::tiled_gridmap* map, bool manhattan)
+    : expansion_policy(map->id_space()), map_(map), manhattan_(manhattan)
+{
+}
+
+void
+warthog::tiled_gridmap_expansion_policy::expand(
+        warthog::search_node* current, warthog::problem_instance* problem)
+{
+    reset();
+
+    // terrain type of each tile in the 3x3 square around the node; same
+    // bit layout as for warthog::gridmap_expansion_policy
+    uint32_t tiles = 0;
+    uint32_t nodeid = (uint32_t)current->get_id();
+    map_->get_neighbours(nodeid, (uint8_t*)&tiles);
+
+    uint32_t x, y;
+    map_->to_xy(nodeid, x, y);
+
+    // NB: no corner cutting or squeezing between obstacles!
+    if((tiles & 514) == 514) // N
+    {
+        add_neighbour(this->generate(map_->to_tiled_id(x, y - 1)), 1);
+    }
+    if((tiles & 1536) == 1536) // E
+    {
+        add_neighbour(this->generate(map_->to_tiled_id(x + 1, y)), 1);
+    }
+    if((tiles & 131584) == 131584) // S
+    {
+        add_neighbour(this->generate(map_->to_tiled_id(x, y + 1)), 1);
+    }
+    if((tiles & 768) == 768) // W
+    {
+        add_neighbour(this->generate(map_->to_tiled_id(x - 1, y)), 1);
+    }
+    if(manhattan_) { return; }
+
+    // generate diagonal moves
+    if((tiles & 1542) == 1542) // NE
+    {
+        add_neighbour(this->generate(
+                    map_->to_tiled_id(x + 1, y - 1)), warthog::DBL_ROOT_TWO);
+    }
+    if((tiles & 394752) == 394752) // SE
+    {
+        add_neighbour(this->generate(
+                    map_->to_tiled_id(x + 1, y + 1)), warthog::DBL_ROOT_TWO);
+    }
+    if((tiles & 197376) == 197376) // SW
+    {
+        add_neighbour(this->generate(
+                    map_->to_tiled_id(x - 1, y + 1)), warthog::DBL_ROOT_TWO);
+    }
+    if((tiles & 771) == 771) // NW
+    {
+        add_neighbour(this->generate(
+                    map_->to_tiled_id(x - 1, y - 1)), warthog::DBL_ROOT_TWO);
+    }
+}
+
+void
+warthog::tiled_gridmap_expansion_policy::get_xy(
+        warthog::sn_id_t nid, int32_t& x, int32_t& y)
+{
+    map_->to_xy((uint32_t)nid, (uint32_t&)x, (uint32_t&)y);
+}
+
+warthog::search_node*
+warthog::tiled_gridmap_expansion_policy::generate_grid_node(
+        warthog::sn_id_t unpadded_id)
+{
+    uint32_t max_id = map_->width() * map_->height();
+    if((uint32_t)unpadded_id >= max_id) { return 0; }
+    uint32_t tiled_id = map_->to_tiled_id((uint32_t)unpadded_id);
+    if(map_->get_label(tiled_id) == 0) { return 0; }
+    return generate(tiled_id);
+}
+
+warthog::search_node*
+warthog::tiled_gridmap_expansion_policy::generate_start_node(
+        warthog::problem_instance* pi)
+{
+    return generate_grid_node(pi->start_id_);
+}
+
+warthog::search_node*
+warthog::tiled_gridmap_expansion_policy::generate_target_node(
+        warthog::problem_instance* pi)
+{
+    return generate_grid_node(pi->target_id_);
+}
+
+size_t
+warthog::tiled_gridmap_expansion_policy::mem()
+{
+    return
+        expansion_policy::mem() +
+        sizeof(*this) +
+        map_->mem();
+}
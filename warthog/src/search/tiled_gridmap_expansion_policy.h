@@ -0,0 +1,52 @@
+#ifndef WARTHOG_TILED_GRIDMAP_EXPANSION_POLICY_H
+#define WARTHOG_TILED_GRIDMAP_EXPANSION_POLICY_H
+
+// search/tiled_gridmap_expansion_policy.h
+//
+// An ExpansionPolicy for square uniform-cost grids stored in block-linear
+// order (cf. tiled_gridmap.h). Same moves and successor order as
+// warthog::gridmap_expansion_policy, including the ban on corner cutting;
+// node ids are tiled ids.
+//
+
+#include "expansion_policy.h"
+#include "search_node.h"
+#include "tiled_gridmap.h"
+
+namespace warthog
+{
+
+class problem_instance;
+class tiled_gridmap_expansion_policy : public expansion_policy
+{
+    public:
+        tiled_gridmap_expansion_policy(
+                warthog::tiled_gridmap* map, bool manhattan = false);
+        virtual ~tiled_gridmap_expansion_policy() { }
+
+        virtual void
+        expand(warthog::search_node*, warthog::problem_instance*);
+
+        virtual void
+        get_xy(sn_id_t node_id, int32_t& x, int32_t& y);
+
+        virtual warthog::search_node*
+        generate_start_node(warthog::problem_instance* pi);
+
+        virtual warthog::search_node*
+        generate_target_node(warthog::problem_instance* pi);
+
+        virtual size_t
+        mem();
+
+    private:
+        warthog::tiled_gridmap* map_;
+        bool manhattan_;
+
+        warthog::search_node*
+        generate_grid_node(sn_id_t unpadded_id);
+};
+
+}
+
+#endif
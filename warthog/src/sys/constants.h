@@ -21,13 +21,31 @@ namespace warthog
 	// each node in a weighted grid map uses sizeof(dbword) memory.
 	// in a uniform-cost grid map each dbword is a contiguous set
 	// of nodes s.t. every bit represents a node.
+	// dbwords are 8 bits unless WARTHOG_DBWORD_BITS says otherwise 
+	// (cf. `make <flavour> DBWORD_BITS=64`).
+#if !defined(WARTHOG_DBWORD_BITS) || WARTHOG_DBWORD_BITS == 8
 	typedef uint8_t dbword;
+#elif WARTHOG_DBWORD_BITS == 32
+	typedef uint32_t dbword;
+#elif WARTHOG_DBWORD_BITS == 64
+	typedef uint64_t dbword;
+#else
+#error "WARTHOG_DBWORD_BITS must be one of 8, 32 or 64"
+#endif
 
 	// gridmap constants
 	static const uint32_t DBWORD_BITS = sizeof(warthog::dbword)*8;
 	static const uint32_t DBWORD_BITS_MASK = (warthog::DBWORD_BITS-1);
 	static const uint32_t LOG2_DBWORD_BITS = static_cast<uint32_t>(ceil(log10(warthog::DBWORD_BITS) / log10(2)));
 
+	// the storage of every gridmap starts on a cache line. rows of 64bit
+	// dbwords are padded to whole cache lines too, so the dbwords of a 
+	// row and of the rows just above and below it sit at the same offset
+	// in their respective lines; otherwise rows are padded to 32 bits.
+	static const uint32_t GRIDMAP_ALIGN = 64;
+	static const uint32_t GRIDMAP_ROW_BITS =
+		warthog::DBWORD_BITS == 64 ? GRIDMAP_ALIGN * 8 : 32;
+
 	// search and sort constants
 	static const double DBL_ONE = 1.0f;
 	static const double DBL_TWO = 2.0f;
@@ -47,6 +65,8 @@ namespace warthog
 	// hashing constants
 	static const uint32_t FNV32_offset_basis = 2166136261;
 	static const uint32_t FNV32_prime = 16777619;
+	static const uint64_t FNV64_offset_basis = 14695981039346656037ULL;
+	static const uint64_t FNV64_prime = 1099511628211ULL;
 
 }
 
@@ -21,7 +21,8 @@ class cbs_ll_heuristic;
 class dummy_filter;
 class dummy_listener;
 class expansion_policy;
-class euclidean_heuristic;
+template<class G>
+class euclidean_heuristic_base;
 class gridmap;
 class gridmap_expansion_policy;
 class problem_instance;
@@ -32,12 +33,13 @@ class zero_heuristic;
 template<typename H, typename E, typename Q, typename L>
 class flexible_astar;
 
-template<typename FILTER>
+template<typename FILTER, typename G>
 class graph_expansion_policy;
 
 namespace graph
 {
 
+class csr_graph;
 class node;
 
 template<typename T_LABEL>
@@ -1,6 +1,9 @@
 #include "constants.h"
 #include "dimacs_parser.h"
+#include "mapped_file.h"
+#include "text_parser.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstdlib>
@@ -46,220 +49,174 @@ warthog::dimacs_parser::init()
     experiments_ = new std::vector<warthog::dimacs_parser::experiment>();
 }
 
+namespace
+{
+
+// read, in parallel, the records in [@param begin, @param end): the lines
+// that start with @param tag, each parsed by @param parse_record. other
+// lines are ignored. @return false, with the records read so far, if a
+// line is badly formatted or another problem line begins
+template<class T, class PARSE>
 bool
-warthog::dimacs_parser::load_graph(const char* filename)
+parse_records(const char* file_begin, const char* begin, const char* end,
+        char tag, const char* record_name, std::vector<T>& records,
+        PARSE parse_record)
 {
-    std::fstream* fdimacs = new std::fstream(filename, std::fstream::in);
-	if(!fdimacs->is_open())
-	{
-		std::cerr << "err; dimacs_parser::dimacs_parser "
-			"cannot open file: "<<filename << std::endl;
-		return false;
-	}
-
-	bool retval = true;
-	char* buf = new char[1024];
-	const char* delim = " \t";
-	uint32_t line = 1;
-	while(fdimacs->good())
-	{
-		fdimacs->getline(buf, 1024);
-		if(buf[0] == 'c')
-            continue;
+    std::vector<warthog::util::text_chunk> chunks;
+    warthog::util::split_lines(begin, end,
+            warthog::util::num_parse_threads(), chunks);
+
+    // each chunk stops at its first bad line or problem line
+    std::vector<std::vector<T>> parts(chunks.size());
+    std::vector<const char*> stop(chunks.size(), nullptr);
+    warthog::util::parallel_for((uint32_t)chunks.size(),
+        [&](uint32_t c)
+        {
+            const char* last = chunks[c].second;
+            for(const char* p = chunks[c].first; p < last;
+                    p = warthog::util::next_line(p, last))
+            {
+                if(*p == 'p') { stop[c] = p; return; }
+                if(*p != tag) { continue; }
 
-		if(buf[0] == 'p')
-		{
-			char* token = strtok(buf, delim); // p char
-			token = strtok(NULL, delim); // file type token
-			if(strcmp(token, "sp") == 0)
-			{
-                char* end;
-                token = strtok(NULL, delim); 
-                uint32_t tmp_num_nodes = (uint32_t)strtol(token, &end, 10);
-                
-                token = strtok(NULL, delim); 
-                uint32_t tmp_num_edges = (uint32_t)strtol(token, &end, 10);
-                if(tmp_num_edges == 0L || tmp_num_nodes == 0L)
-                {
-                    std::cerr 
-                        << "error; invalid graph description on line " 
-                        << line << " of file " << filename << "\n";
-                    delete fdimacs;
-                    delete [] buf;
-                    return 0;
-                }
-                std::cerr 
-                    << "loading " << tmp_num_edges << " arcs "
-                    << "from "<< filename << " ... ";
-                edges_->reserve(tmp_num_edges);
-				retval = load_gr_file(*fdimacs);
-                gr_file_ = filename;
-                assert(tmp_num_edges == get_num_edges());
-                std::cerr << "done\n";
-                break;
-			}
-			else if(strcmp(token, "aux") == 0)
-			{
-                token = strtok(NULL, delim);  
-                if(strcmp(token, "sp") != 0)
-                {
-                    retval = false;
-                }
-                else
-                { 
-                    token = strtok(NULL, delim);  
-                    if(strcmp(token, "co") != 0)
-                    {
-                        std::cerr 
-                            << "error; invalid graph description on line " 
-                            << line <<" of file " << filename << "\n";
-                        delete fdimacs;
-                        delete [] buf;
-                        return 0;
-                    }
-                    else
-                    { 
-                        token = strtok(NULL, delim);  
-                        char* end;
-                        uint32_t tmp_num_nodes = (uint32_t)strtol(token, &end, 10);
-                        if(tmp_num_nodes == 0L) 
-                        { 
-                            std::cerr 
-                                << "error; invalid graph description on line " 
-                                << line <<" of file " << filename << "\n";
-                            delete fdimacs;
-                            delete [] buf;
-                            return 0;
-                        }
-                        std::cerr 
-                            << "loading " << tmp_num_nodes << " nodes "
-                            << "from " << filename << " ... ";
-                        nodes_->reserve(tmp_num_nodes);
-                        retval = load_co_file(*fdimacs);
-                        gr_file_ = filename;
-                        assert(tmp_num_nodes == get_num_nodes());
-                        std::cerr << "done\n";
-                        break;
-                    }
-                }
-			}
-			else
-			{
-				std::cerr << "error; unrecognised problem line in dimacs file\n";
-                delete fdimacs;
-                delete [] buf;
-                return 0;
-			}
-		}
-		line++;
-	}
-
-    delete fdimacs;
-	delete [] buf;
-    return retval;
+                T rec;
+                if(!parse_record(p + 1, last, rec)) { stop[c] = p; return; }
+                parts[c].push_back(rec);
+            }
+        });
+
+    size_t num_records = 0;
+    uint32_t num_parts = 0;
+    bool all_good = true;
+    while(num_parts < chunks.size())
+    {
+        num_records += parts[num_parts].size();
+        const char* p = stop[num_parts++];
+        if(!p) { continue; }
+
+        all_good = false;
+        if(*p != 'p')
+        {
+            std::cerr << "warning; badly formatted " << record_name
+                << " descriptor on line "
+                << 1 + std::count(file_begin, p, '\n') << std::endl;
+        }
+        break;
+    }
+
+    records.resize(num_records);
+    std::vector<size_t> offsets(num_parts + 1, 0);
+    for(uint32_t c = 0; c < num_parts; c++)
+    {
+        offsets[c+1] = offsets[c] + parts[c].size();
+    }
+    warthog::util::parallel_for(num_parts,
+        [&](uint32_t c)
+        {
+            std::copy(parts[c].begin(), parts[c].end(),
+                    records.begin() + (ptrdiff_t)offsets[c]);
+        });
+    return all_good;
 }
 
-bool
-warthog::dimacs_parser::load_co_file(std::istream& fdimacs)
-{
-    nodes_->clear();
-    uint32_t line = 1;
-	char* buf = new char[1024];
-	const char* delim = " \t";
-	bool all_good = true;
-	while(fdimacs.good() && all_good)
-	{
-		char next_char = (char)fdimacs.peek();
-		switch(next_char)
-		{
-			case 'v':
-			{
-				fdimacs.getline(buf, 1024);
-				char* descriptor = strtok(buf, delim);
-				char* id = strtok(NULL, delim);
-				char* x = strtok(NULL, delim);
-				char* y = strtok(NULL, delim);
-				if(!(descriptor && id && x && y))
-				{
-					std::cerr << "warning; badly formatted node descriptor on line "
-                        <<line << std::endl;
-                    all_good = false;
-					break;
-				}
-                warthog::dimacs_parser::node n;
-                n.id_ = (uint32_t)atoi(id);
-                n.x_ = atoi(x);
-                n.y_ = atoi(y);
-                nodes_->push_back(n);
-				break;
-			}
-			case 'p': // stop if we hit another problem line
-				all_good = false;
-				break;
-			default: // ignore non-node, non-problem lines
-				fdimacs.getline(buf, 1024);
-				break;
-		}
-//        if((line % 10000) == 0)
-//        {
-//                std::cerr << "\r co file; K lines read: " << (line / 1000) << " ";
-//        }
-		line++;
-	}
-
-	delete [] buf;
-	return all_good;
 }
 
 bool
-warthog::dimacs_parser::load_gr_file(std::istream& fdimacs)
+warthog::dimacs_parser::load_graph(const char* filename)
 {
+    warthog::util::mapped_file file(filename);
+    if(!file.good())
+    {
+        std::cerr << "err; dimacs_parser::dimacs_parser "
+            "cannot open file: "<<filename << std::endl;
+        return false;
+    }
+    file.prefetch();
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
+    // find the problem line
     uint32_t line = 1;
-	char* buf = new char[1024];
-	const char* delim = " \t";
-	bool all_good = true;
-	while(fdimacs.good() && all_good)
-	{
-		char next_char = (char)fdimacs.peek();
-		switch(next_char)
-		{
-			case 'a':
-			{
-				fdimacs.getline(buf, 1024);
-				char* descriptor = strtok(buf, delim);
-				char* from = strtok(NULL, delim);
-				char* to = strtok(NULL, delim);
-				char* cost = strtok(NULL, delim);
-				if(!(descriptor && from && to && cost))
-				{
-					std::cerr << "warning; badly formatted arc descriptor on line "
-                        <<line << std::endl;
-                    all_good = false;
-					break;
-				}
-                warthog::dimacs_parser::edge e;
-                e.tail_id_ = (uint32_t)atoi(from);
-                e.head_id_ = (uint32_t)atoi(to);
-                e.weight_ = (uint32_t)atoi(cost);
-                edges_->push_back(e);
-				break;
-			}
-			case 'p': // another problem line. stop here
-				all_good = false;
-				break;
-			default: // ignore non-arc, non-problem lines
-				fdimacs.getline(buf, 1024);
-				break;
-		}
-//        if((line % 10000) == 0)
-//        {
-//                std::cerr << "\r gr file; K lines read: " << (line / 1000) << " ";
-//        }
-		line++;
-	}
-
-	delete [] buf;
-	return all_good;
+    const char* p = begin;
+    while(p < end && *p != 'p')
+    {
+        p = warthog::util::next_line(p, end);
+        line++;
+    }
+    if(p == end) { return true; }
+
+    const char* body = warthog::util::next_line(p, end);
+    std::vector<std::string> tokens;
+    for(p = warthog::util::skip_blanks(p, body);
+        p < body && *p != '\n' && *p != '\r';
+        p = warthog::util::skip_blanks(p, body))
+    {
+        const char* word = p;
+        p = warthog::util::skip_word(p, body);
+        tokens.push_back(std::string(word, p));
+    }
+    tokens.resize(std::max<size_t>(tokens.size(), 5));
+
+    if(tokens[1] == "sp")
+    {
+        uint32_t tmp_num_nodes = (uint32_t)strtol(tokens[2].c_str(), 0, 10);
+        uint32_t tmp_num_edges = (uint32_t)strtol(tokens[3].c_str(), 0, 10);
+        if(tmp_num_edges == 0L || tmp_num_nodes == 0L)
+        {
+            std::cerr 
+                << "error; invalid graph description on line " 
+                << line << " of file " << filename << "\n";
+            return false;
+        }
+        std::cerr 
+            << "loading " << tmp_num_edges << " arcs "
+            << "from "<< filename << " ... ";
+        bool retval = parse_records(begin, body, end, 'a', "arc", *edges_,
+            [](const char* p, const char* end,
+               warthog::dimacs_parser::edge& e) -> bool
+            {
+                return
+                    warthog::util::parse_number(p, end, e.tail_id_) &&
+                    warthog::util::parse_number(p, end, e.head_id_) &&
+                    warthog::util::parse_number(p, end, e.weight_);
+            });
+        gr_file_ = filename;
+        assert(!retval || tmp_num_edges == get_num_edges());
+        std::cerr << "done\n";
+        return retval;
+    }
+
+    if(tokens[1] == "aux")
+    {
+        if(tokens[2] != "sp") { return false; }
+        uint32_t tmp_num_nodes = (uint32_t)strtol(tokens[4].c_str(), 0, 10);
+        if(tokens[3] != "co" || tmp_num_nodes == 0L)
+        {
+            std::cerr 
+                << "error; invalid graph description on line " 
+                << line <<" of file " << filename << "\n";
+            return false;
+        }
+        std::cerr 
+            << "loading " << tmp_num_nodes << " nodes "
+            << "from " << filename << " ... ";
+        bool retval = parse_records(begin, body, end, 'v', "node", *nodes_,
+            [](const char* p, const char* end,
+               warthog::dimacs_parser::node& n) -> bool
+            {
+                return
+                    warthog::util::parse_number(p, end, n.id_) &&
+                    warthog::util::parse_number(p, end, n.x_) &&
+                    warthog::util::parse_number(p, end, n.y_);
+            });
+        co_file_ = filename;
+        assert(!retval || tmp_num_nodes == get_num_nodes());
+        std::cerr << "done\n";
+        return retval;
+    }
+
+    std::cerr << "error; unrecognised problem line in dimacs file\n";
+    return false;
 }
 
 void
@@ -68,6 +68,8 @@ class dimacs_parser
         // NB: upon invocation, this operation will discard all current nodes
         // (or edges, depending on the type of file passed for loading) and 
         // THEN attempt to load new data.
+        // the file is mapped and its lines are tokenised in parallel (cf.
+        // text_parser.h); nodes and edges keep the order of the file.
         bool 
         load_graph(const char* dimacs_file);
 
@@ -147,8 +149,6 @@ class dimacs_parser
 
     private:
         void init();
-        bool load_co_file(std::istream& fdimacs);
-        bool load_gr_file(std::istream& fdimacs);
 
        std::vector<warthog::dimacs_parser::node>* nodes_;
        std::vector<warthog::dimacs_parser::edge>* edges_;
@@ -3,6 +3,8 @@
 #include "search.h"
 #include "solution.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
@@ -52,17 +54,21 @@ warthog::helpers::load_integer_labels_dimacs(
 
 void*
 warthog::helpers::parallel_compute(void*(*fn_worker)(void*), 
-        void* shared_data, uint32_t task_total)
+        void* shared_data, uint32_t task_total, uint32_t num_threads,
+        bool verbose)
 {
-    std::cerr << "parallel compute begin. tasks to process: " << task_total << "\n";
+    if(verbose)
+    {
+        std::cerr << "parallel compute begin. tasks to process: " << task_total << "\n";
+    }
     if(task_total == 0) { return 0; }
 
     // OK, let's fork some threads
-    // TODO: detect cores with std::thread::hardware_concurrency();
     #ifdef SINGLE_THREADED
     const uint32_t NUM_THREADS = 1;
     #else
-    const uint32_t NUM_THREADS = (uint32_t)std::thread::hardware_concurrency(); 
+    const uint32_t NUM_THREADS = num_threads ? num_threads :
+        std::max<uint32_t>(1, std::thread::hardware_concurrency());
     #endif
 
     std::vector<pthread_t> threads(NUM_THREADS);
@@ -85,11 +91,17 @@ warthog::helpers::parallel_compute(void*(*fn_worker)(void*),
         task_data[i].nprocessed_ = 0;
         task_data[i].shared_ = shared_data;
         task_data[i].fn_worker_ = fn_worker;
+        task_data[i].thread_finished_ = false;
 
         // gogogogo
         pthread_create(&threads[i], NULL, 
                 fn_task_wrapper, (void*) &task_data[i]);
     }
+    if(!verbose)
+    {
+        for(pthread_t& thread : threads) { pthread_join(thread, NULL); }
+        return 0;
+    }
     std::cerr << "forked " << NUM_THREADS << " threads \n";
 
     std::cerr << "progress: [";
@@ -118,8 +130,10 @@ warthog::helpers::parallel_compute(void*(*fn_worker)(void*),
         }
 
         if(nfinished == NUM_THREADS) { break; }
-        else { sleep(0.5); }
+        // NB: not sleep(0.5), which truncates to sleep(0) and spins
+        else { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }
     }
+    for(pthread_t& thread : threads) { pthread_join(thread, NULL); }
     std::cerr << "\nparallel compute; end\n";
     return 0;
 }
@@ -13,6 +13,7 @@
 #include <vector>
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 
 namespace warthog
 {
@@ -51,6 +52,28 @@ load_integer_labels_dimacs(const char* filename,
 void
 value_index_swap_array(std::vector<uint32_t>& vec);
 
+// a 64bit FNV-1a hash of @param size bytes at @param data, continuing from
+// @param hash. NB: mixes in 8 bytes at a time, so it is quick enough to
+// check large tables; results are not those of the bytewise FNV-1a.
+inline uint64_t
+fnv64(const void* data, size_t size, 
+        uint64_t hash = warthog::FNV64_offset_basis)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * warthog::FNV64_prime;
+    }
+    for( ; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * warthog::FNV64_prime;
+    }
+    return hash;
+}
+
 struct thread_params
 {
     // thread data
@@ -76,10 +99,13 @@ struct thread_params
 //         a pointer to data which will be shared among all worker 
 //         threads
 // @param task_total: the total number of tasks in the workload
+// @param num_threads: the number of worker threads; 0 means one per core
+// @param verbose: print the progress of the workers
 // @return: 0 (the function always succeeds)
 void*
 parallel_compute(void*(*fn_worker)(void*), void* shared_data, 
-                 uint32_t task_total);
+                 uint32_t task_total, uint32_t num_threads = 0,
+                 bool verbose = true);
 }
 }
 
@@ -0,0 +1,93 @@
+#ifndef WARTHOG_MAPPED_FILE_H
+#define WARTHOG_MAPPED_FILE_H
+
+// mapped_file.h
+//
+// A read-only memory mapping of an entire file. Pages are loaded on demand
+// and shared, through the page cache, by every process that maps the same
+// file; nothing is copied or parsed when the file is opened.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace warthog
+{
+
+namespace util
+{
+
+class mapped_file
+{
+    public:
+        mapped_file(const char* filename) : data_(nullptr), size_(0)
+        {
+            int fd = open(filename, O_RDONLY);
+            if(fd < 0)
+            {
+                std::cerr << "err; cannot open " << filename << "\n";
+                return;
+            }
+
+            struct stat st;
+            if(fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+                void* addr = mmap(nullptr, (size_t)st.st_size,
+                        PROT_READ, MAP_SHARED, fd, 0);
+                if(addr != MAP_FAILED)
+                {
+                    data_ = (const char*)addr;
+                    size_ = (size_t)st.st_size;
+                }
+                else
+                {
+                    std::cerr << "err; cannot map " << filename << "\n";
+                }
+            }
+            // the mapping stays valid after the descriptor is closed
+            close(fd);
+        }
+
+        ~mapped_file()
+        {
+            if(data_) { munmap((void*)data_, size_); }
+        }
+
+        // @return false if the file could not be opened or mapped
+        inline bool
+        good() { return data_ != nullptr; }
+
+        inline const char*
+        data() { return data_; }
+
+        inline size_t
+        size() { return size_; }
+
+        // hint that the whole file will be needed soon
+        inline void
+        prefetch()
+        {
+            if(data_) { madvise((void*)data_, size_, MADV_WILLNEED); }
+        }
+
+    private:
+        const char* data_;
+        size_t size_;
+
+        // no copy
+        mapped_file(const mapped_file& other) { }
+        mapped_file&
+        operator=(const mapped_file& other) { return *this; }
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef WARTHOG_MPMC_QUEUE_H
+#define WARTHOG_MPMC_QUEUE_H
+
+// mpmc_queue.h
+//
+// A bounded, lock-free, multi-producer multi-consumer FIFO queue
+// (after Dmitry Vyukov's array-based design). Each slot carries a sequence
+// number which tells producers and consumers whether the slot is free for
+// writing or holds an element ready to read; the head and tail counters
+// are claimed with a single compare-and-swap. Neither operation blocks:
+// try_push fails when the queue is full and try_pop fails when it is
+// empty, leaving the caller to decide whether to spin, yield or sleep.
+//
+// The capacity is rounded up to a power of two.
+//
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace warthog
+{
+
+template<class T>
+class mpmc_queue
+{
+    public:
+        mpmc_queue(size_t capacity = 1024)
+        {
+            size_t size = 2;
+            while(size < capacity) { size <<= 1; }
+            mask_ = size - 1;
+
+            slots_ = new slot[size];
+            for(size_t i = 0; i < size; i++)
+            {
+                slots_[i].seq_.store(i, std::memory_order_relaxed);
+            }
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+        }
+
+        ~mpmc_queue() { delete [] slots_; }
+
+        // append @param val to the queue.
+        // @return false if the queue is full
+        bool
+        try_push(const T& val)
+        {
+            size_t pos = tail_.load(std::memory_order_relaxed);
+            slot* s;
+            while(true)
+            {
+                s = &slots_[pos & mask_];
+                size_t seq = s->seq_.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if(diff == 0)
+                {
+                    if(tail_.compare_exchange_weak(
+                                pos, pos + 1, std::memory_order_relaxed))
+                    { break; }
+                }
+                else if(diff < 0) { return false; }
+                else { pos = tail_.load(std::memory_order_relaxed); }
+            }
+
+            s->val_ = val;
+            s->seq_.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // remove the element at the front of the queue and store it
+        // in @param val.
+        // @return false if the queue is empty
+        bool
+        try_pop(T& val)
+        {
+            size_t pos = head_.load(std::memory_order_relaxed);
+            slot* s;
+            while(true)
+            {
+                s = &slots_[pos & mask_];
+                size_t seq = s->seq_.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if(diff == 0)
+                {
+                    if(head_.compare_exchange_weak(
+                                pos, pos + 1, std::memory_order_relaxed))
+                    { break; }
+                }
+                else if(diff < 0) { return false; }
+                else { pos = head_.load(std::memory_order_relaxed); }
+            }
+
+            val = s->val_;
+            s->seq_.store(pos + mask_ + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t
+        capacity() { return mask_ + 1; }
+
+        size_t
+        mem() { return sizeof(*this) + sizeof(slot) * (mask_ + 1); }
+
+    private:
+        struct slot
+        {
+            std::atomic<size_t> seq_;
+            T val_;
+        };
+
+        slot* slots_;
+        size_t mask_;
+        // head and tail sit on their own cache lines so that producers
+        // and consumers do not invalidate each other
+        alignas(64) std::atomic<size_t> head_;
+        alignas(64) std::atomic<size_t> tail_;
+
+        // no copy
+        mpmc_queue(const mpmc_queue& other) { }
+        mpmc_queue&
+        operator=(const mpmc_queue& other) { return *this; }
+};
+
+}
+
+#endif
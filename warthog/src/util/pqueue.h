@@ -82,7 +82,7 @@ class pqueue
 
             if(queuesize_+1 > maxsize_)
             {
-                resize(maxsize_*2);
+                resize(maxsize_*2 + 1);
             }
             unsigned int priority = queuesize_;
             elts_[priority] = val;
@@ -0,0 +1,290 @@
+#ifndef WARTHOG_RADIX_QUEUE_H
+#define WARTHOG_RADIX_QUEUE_H
+
+// radix_queue.h
+//
+// A monotone min priority queue (radix heap) for searches where f-values
+// come from a small set of distinct values, e.g. 4-connected and octile
+// grids. Each f-value is quantised to an integer key (f * scale) and
+// elements are kept in 65 buckets, according to the most significant bit
+// in which their key differs from the last key extracted. Bucket 0 holds
+// all elements whose key equals the current minimum; ties among these are
+// broken LIFO (i.e. in favour of recently generated nodes) rather than by
+// comparing g-values. An element only ever moves to a strictly lower
+// bucket, so for fixed-width keys all operations are O(1) amortised.
+//
+// Two f-values that differ by less than 1/scale are considered equal.
+// The default scale matches the fixed-point precision of warthog::ONE.
+//
+// Keys smaller than the last extracted key (inconsistent heuristics) are
+// handled by rebuilding the queue around the new minimum; this is correct
+// but not cheap.
+//
+// The interface mirrors warthog::pqueue so the class can be used as the Q
+// parameter of warthog::flexible_astar. The priority field of each
+// search_node stores its bucket (low 7 bits) and offset in that bucket.
+//
+
+#include "constants.h"
+#include "search_node.h"
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+namespace warthog
+{
+
+class radix_queue
+{
+	public:
+        radix_queue(double scale = warthog::ONE, unsigned int size=1024)
+            : scale_(scale), last_(0), queuesize_(0), heap_ops_(0)
+        {
+            buckets_[0].reserve(size);
+        }
+
+        ~radix_queue() { }
+
+		// removes all elements from the queue
+        void
+        clear()
+        {
+            for(uint32_t i = 0; i < NUM_BUCKETS; i++)
+            {
+                buckets_[i].clear();
+            }
+            last_ = 0;
+            queuesize_ = 0;
+            heap_ops_ = 0;
+        }
+
+		// reprioritise the specified element. the f-value of @param val
+        // has already been updated by the caller.
+        void
+        decrease_key(warthog::search_node* val)
+        {
+            assert(contains(val));
+            uint64_t key = to_key(val->get_f());
+            if(key < last_) { rebuild(key); }
+            remove(val);
+            insert(val, key);
+            heap_ops_++;
+        }
+
+        void
+        increase_key(warthog::search_node* val)
+        {
+            decrease_key(val);
+        }
+
+		// add a new element to the queue
+        void
+        push(warthog::search_node* val)
+        {
+            if(contains(val))
+            {
+                return;
+            }
+
+            uint64_t key = to_key(val->get_f());
+            if(key < last_) { rebuild(key); }
+            insert(val, key);
+            queuesize_++;
+            heap_ops_++;
+        }
+
+		// remove the top element from the queue
+        warthog::search_node*
+        pop()
+        {
+            if(queuesize_ == 0)
+            {
+                return 0;
+            }
+
+            refill();
+            warthog::search_node* ans = buckets_[0].back().node_;
+            buckets_[0].pop_back();
+            ans->set_priority(warthog::INF32);
+            queuesize_--;
+            heap_ops_++;
+            return ans;
+        }
+
+		// @return true if the queue contains search node @param n
+		// and return false if it does not
+		inline bool
+		contains(warthog::search_node* n)
+		{
+            uint32_t priority = n->get_priority();
+            uint32_t bucket = priority & BUCKET_MASK;
+            uint32_t index = priority >> BUCKET_BITS;
+            return bucket < NUM_BUCKETS &&
+                index < buckets_[bucket].size() &&
+                buckets_[bucket][index].node_ == n;
+		}
+
+		// retrieve the top element without removing it
+		inline warthog::search_node*
+		peek()
+		{
+			if(queuesize_ == 0)
+			{
+                return 0;
+			}
+            refill();
+            return buckets_[0].back().node_;
+		}
+
+        uint32_t
+        get_heap_ops()
+        { return heap_ops_; }
+
+		inline unsigned int
+		size()
+		{ return queuesize_; }
+
+		inline bool
+		is_minqueue()
+		{ return true; }
+
+        void
+        print(std::ostream& out)
+        {
+            for(uint32_t i = 0; i < NUM_BUCKETS; i++)
+            {
+                for(auto& e : buckets_[i])
+                {
+                    out << "bucket " << i << " key " << e.key_ << " ";
+                    e.node_->print(out);
+                    out << std::endl;
+                }
+            }
+        }
+
+		size_t
+		mem()
+		{
+            size_t bytes = sizeof(*this);
+            for(uint32_t i = 0; i < NUM_BUCKETS; i++)
+            {
+                bytes += buckets_[i].capacity() * sizeof(entry);
+            }
+            return bytes;
+		}
+
+	private:
+        struct entry
+        {
+            uint64_t key_;
+            warthog::search_node* node_;
+        };
+
+        static const uint32_t NUM_BUCKETS = 65;
+        static const uint32_t BUCKET_BITS = 7;
+        static const uint32_t BUCKET_MASK = (1 << BUCKET_BITS) - 1;
+
+        double scale_;
+        uint64_t last_;
+		unsigned int queuesize_;
+        uint32_t heap_ops_;
+        std::vector<entry> buckets_[NUM_BUCKETS];
+
+		// no copy
+		radix_queue(const radix_queue& other) { }
+		radix_queue&
+		operator=(const radix_queue& other) { return *this; }
+
+        inline uint64_t
+        to_key(warthog::cost_t f)
+        {
+            double scaled = f * scale_ + 0.5;
+            if(!(scaled > 0)) { return 0; }
+            if(scaled >= (double)UINT64_MAX) { return UINT64_MAX; }
+            return (uint64_t)scaled;
+        }
+
+        inline uint32_t
+        bucket_index(uint64_t key)
+        {
+            assert(key >= last_);
+            return key == last_ ? 0 : 64 - __builtin_clzll(key ^ last_);
+        }
+
+        inline void
+        insert(warthog::search_node* val, uint64_t key)
+        {
+            uint32_t bucket = bucket_index(key);
+            std::vector<entry>& b = buckets_[bucket];
+            // compact search nodes only have 31 bits of priority
+            assert(b.size() < (1u << (31 - BUCKET_BITS)));
+            val->set_priority(
+                    ((uint32_t)b.size() << BUCKET_BITS) | bucket);
+            b.push_back(entry{key, val});
+        }
+
+        // unlink @param val from its bucket; the last element in the
+        // bucket takes its place
+        inline void
+        remove(warthog::search_node* val)
+        {
+            uint32_t priority = val->get_priority();
+            std::vector<entry>& b = buckets_[priority & BUCKET_MASK];
+            uint32_t index = priority >> BUCKET_BITS;
+            b[index] = b.back();
+            b[index].node_->set_priority(priority);
+            b.pop_back();
+        }
+
+        // make sure bucket 0 is not empty: find the first non-empty
+        // bucket, advance last_ to its smallest key and redistribute
+        void
+        refill()
+        {
+            assert(queuesize_ > 0);
+            if(!buckets_[0].empty()) { return; }
+
+            uint32_t i = 1;
+            while(buckets_[i].empty()) { i++; }
+            assert(i < NUM_BUCKETS);
+
+            std::vector<entry>& b = buckets_[i];
+            uint64_t min_key = b[0].key_;
+            for(auto& e : b)
+            {
+                if(e.key_ < min_key) { min_key = e.key_; }
+            }
+
+            // every element moves to a bucket < i
+            last_ = min_key;
+            for(auto& e : b)
+            {
+                insert(e.node_, e.key_);
+            }
+            b.clear();
+        }
+
+        // redistribute every element relative to a new (smaller) minimum
+        void
+        rebuild(uint64_t key)
+        {
+            std::vector<entry> all;
+            all.reserve(queuesize_);
+            for(uint32_t i = 0; i < NUM_BUCKETS; i++)
+            {
+                all.insert(all.end(), buckets_[i].begin(), buckets_[i].end());
+                buckets_[i].clear();
+            }
+
+            last_ = key;
+            for(auto& e : all)
+            {
+                insert(e.node_, e.key_);
+            }
+        }
+};
+
+}
+
+#endif
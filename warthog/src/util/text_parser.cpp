@@ -0,0 +1,51 @@
+#include "helpers.h"
+#include "text_parser.h"
+
+#include <algorithm>
+#include <thread>
+
+uint32_t
+warthog::util::num_parse_threads()
+{
+    #ifdef SINGLE_THREADED
+    return 1;
+    #else
+    return std::max<uint32_t>(1, std::thread::hardware_concurrency());
+    #endif
+}
+
+void
+warthog::util::split_lines(const char* begin, const char* end,
+        uint32_t max_chunks, std::vector<warthog::util::text_chunk>& chunks)
+{
+    chunks.clear();
+    max_chunks = std::max<uint32_t>(1, max_chunks);
+    size_t chunk_size = (size_t)(end - begin) / max_chunks + 1;
+    const char* first = begin;
+    while(first < end)
+    {
+        const char* last = first + std::min(chunk_size, (size_t)(end - first));
+        if(last < end) { last = next_line(last - 1, end); }
+        chunks.push_back(text_chunk(first, last));
+        first = last;
+    }
+}
+
+void
+warthog::util::parallel_for(uint32_t num_tasks,
+        const std::function<void(uint32_t)>& fn)
+{
+    if(num_tasks == 1) { fn(0); return; }
+
+    void*(*thread_fn)(void*) = [] (void* args_in) -> void*
+    {
+        warthog::helpers::thread_params* par =
+            (warthog::helpers::thread_params*) args_in;
+        (*(const std::function<void(uint32_t)>*) par->shared_)(
+                par->thread_id_);
+        par->nprocessed_++;
+        return 0;
+    };
+    warthog::helpers::parallel_compute(thread_fn, (void*)&fn, num_tasks,
+            num_tasks, false);
+}
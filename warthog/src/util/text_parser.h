@@ -0,0 +1,86 @@
+#ifndef WARTHOG_TEXT_PARSER_H
+#define WARTHOG_TEXT_PARSER_H
+
+// text_parser.h
+//
+// Helpers for reading large line-based text files (DIMACS, xy graphs)
+// quickly: the file is mapped rather than streamed, split into chunks
+// that end on line boundaries, and each chunk is tokenised by its own
+// thread with std::from_chars, which neither allocates nor consults the
+// locale.
+//
+
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace warthog
+{
+
+namespace util
+{
+
+// a range of whole lines, [first, second)
+typedef std::pair<const char*, const char*> text_chunk;
+
+// the number of threads used to tokenise a file
+uint32_t
+num_parse_threads();
+
+// split [@param begin, @param end) into at most @param max_chunks chunks of
+// about equal size, each ending just after a newline (or at @param end)
+void
+split_lines(const char* begin, const char* end, uint32_t max_chunks,
+        std::vector<text_chunk>& chunks);
+
+// call @param fn(i) for every i in [0, @param num_tasks), one thread per
+// task (cf. warthog::helpers::parallel_compute); the calls must not depend
+// on each other
+void
+parallel_for(uint32_t num_tasks, const std::function<void(uint32_t)>& fn);
+
+// the start of the line after the one that contains @param p
+inline const char*
+next_line(const char* p, const char* end)
+{
+    while(p < end && *p != '\n') { p++; }
+    return p < end ? p + 1 : end;
+}
+
+// the first character at or after @param p that is not a space or a tab
+inline const char*
+skip_blanks(const char* p, const char* end)
+{
+    while(p < end && (*p == ' ' || *p == '\t')) { p++; }
+    return p;
+}
+
+// the first character at or after @param p that is not part of a word
+inline const char*
+skip_word(const char* p, const char* end)
+{
+    while(p < end && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r')
+    { p++; }
+    return p;
+}
+
+// read the number that follows @param p, after any blanks, into
+// @param value and move @param p past it. @return false (with @param p
+// unchanged) if there is no such number
+template<class T>
+inline bool
+parse_number(const char*& p, const char* end, T& value)
+{
+    const char* start = skip_blanks(p, end);
+    std::from_chars_result res = std::from_chars(start, end, value);
+    if(res.ec != std::errc()) { return false; }
+    p = res.ptr;
+    return true;
+}
+
+}
+
+}
+
+#endif
@@ -31,11 +31,11 @@ warthog::util::workload_manager::set_flag(uint32_t node_id, bool val)
     if(index >= filter_sz_) { return; }
     if(val)
     {
-        filter_[index] |= (1 << pos);
+        filter_[index] |= ((warthog::dbword)1 << pos);
     }
     else
     {
-        filter_[index] &= ~(1 << pos);
+        filter_[index] &= ~((warthog::dbword)1 << pos);
     }
 }
 
@@ -46,16 +46,16 @@ warthog::util::workload_manager::get_flag(uint32_t id)
    uint32_t word = id / warthog::DBWORD_BITS;
    uint32_t pos = id % warthog::DBWORD_BITS;
    if(word >= filter_sz_) { return false; }
-   return this->filter_[word] & (1 << pos);
+   return this->filter_[word] & ((warthog::dbword)1 << pos);
 }
 
 uint32_t
 warthog::util::workload_manager::num_flags_set()
 {
     uint32_t count = 0;
-    for(size_t i = 0; i < filter_sz_*sizeof(warthog::dbword); i++)
+    for(size_t i = 0; i < filter_sz_; i++)
     {
-        count += (uint32_t)__builtin_popcount(filter_[i]);
+        count += (uint32_t)__builtin_popcountll(filter_[i]);
     }
     return count;
 }
@@ -0,0 +1,156 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "bch_expansion_policy.h"
+#include "bch_search.h"
+#include "catch.hpp"
+#include "cch.h"
+#include "flexible_astar.h"
+#include "graph_expansion_policy.h"
+#include "pqueue.h"
+#include "xy_graph.h"
+#include "zero_heuristic.h"
+
+#include <algorithm>
+#include <random>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+// a grid-like road network: each node links to a few nodes nearby, some
+// of them in one direction only
+void
+fill_graph(warthog::graph::xy_graph& g, uint32_t width, std::mt19937& rng)
+{
+    g.grow(width * width);
+    for(uint32_t i = 0; i < width * width; i++)
+    {
+        g.set_xy(i, (int32_t)((i % width) * 10 + rng() % 5),
+                (int32_t)((i / width) * 10 + rng() % 5));
+    }
+    for(uint32_t i = 0; i < width * width; i++)
+    {
+        for(uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t x = i % width + rng() % 3;
+            uint32_t y = i / width + rng() % 3;
+            if(x >= width || y >= width) { continue; }
+            uint32_t head = y * width + x;
+            warthog::graph::edge_cost_t wt = 10 + rng() % 20;
+            g.get_node(i)->add_outgoing(warthog::graph::edge(head, wt));
+            g.get_node(head)->add_incoming(warthog::graph::edge(i, wt));
+            if(rng() % 4 == 0) { continue; }
+            g.get_node(head)->add_outgoing(warthog::graph::edge(i, wt));
+            g.get_node(i)->add_incoming(warthog::graph::edge(head, wt));
+        }
+    }
+}
+
+// the cost of the shortest path between every pair of @param ids
+template<class SEARCH>
+std::vector<warthog::cost_t>
+costs(SEARCH& alg, const std::vector<uint32_t>& ids)
+{
+    std::vector<warthog::cost_t> result;
+    for(uint32_t i = 0; i + 1 < ids.size(); i += 2)
+    {
+        warthog::problem_instance pi(ids[i], ids[i+1]);
+        warthog::solution sol;
+        alg.get_path(pi, sol);
+        result.push_back(sol.sum_of_edge_costs_);
+    }
+    return result;
+}
+
+void
+require_same_costs(warthog::graph::xy_graph& g, warthog::ch::ch_data* chd,
+        const std::vector<uint32_t>& queries)
+{
+    warthog::zero_heuristic h;
+    warthog::pqueue_min open;
+    warthog::simple_graph_expansion_policy expander(&g);
+    warthog::flexible_astar<
+        warthog::zero_heuristic,
+        warthog::simple_graph_expansion_policy,
+        warthog::pqueue_min> dijkstra(&h, &expander, &open);
+    std::vector<warthog::cost_t> expected = costs(dijkstra, queries);
+
+    warthog::bch_expansion_policy fexp(chd->g_);
+    warthog::bch_expansion_policy bexp(chd->g_, true);
+    warthog::bch_search<
+        warthog::zero_heuristic, warthog::bch_expansion_policy>
+            bch(&fexp, &bexp, &h);
+    std::vector<warthog::cost_t> found = costs(bch, queries);
+    for(uint32_t i = 0; i < found.size(); i++)
+    {
+        // the bidirectional search does not stop when the start is
+        // the target
+        if(queries[i*2] == queries[i*2+1]) { continue; }
+        REQUIRE(found[i] == expected[i]);
+    }
+}
+
+}
+
+SCENARIO("Customise a contraction hierarchy", "[cch]")
+{
+    const uint32_t width = 30;
+    std::mt19937 rng(37);
+    warthog::graph::xy_graph g(0, "", true);
+    fill_graph(g, width, rng);
+
+    std::vector<uint32_t> queries(800);
+    for(uint32_t& id : queries) { id = rng() % (width * width); }
+
+    std::vector<uint32_t> order;
+    warthog::ch::nested_dissection_order(&g, order);
+    REQUIRE(order.size() == g.get_num_nodes());
+    std::vector<uint32_t> sorted(order);
+    std::sort(sorted.begin(), sorted.end());
+    for(uint32_t i = 0; i < sorted.size(); i++) { REQUIRE(sorted[i] == i); }
+
+    warthog::ch::customizable_ch cch(&g, order);
+    warthog::ch::ch_data* chd = cch.get_ch_data();
+
+    THEN("Arcs go up and queries are exact")
+    {
+        for(uint32_t i = 0; i < g.get_num_nodes(); i++)
+        {
+            for(uint32_t j = 0; j < chd->g_->out_degree(i); j++)
+            {
+                uint32_t head = chd->g_->outgoing_begin(i)[j].node_id_;
+                REQUIRE(chd->level_->at(i) < chd->level_->at(head));
+            }
+        }
+        require_same_costs(g, chd, queries);
+    }
+
+    THEN("Queries are exact after perturbations and customisation")
+    {
+        for(uint32_t round = 0; round < 3; round++)
+        {
+            std::vector<std::pair<uint32_t, warthog::graph::edge>> edges;
+            for(uint32_t i = 0; i < g.get_num_nodes(); i++)
+            {
+                for(uint32_t j = 0; j < g.out_degree(i); j++)
+                {
+                    if(rng() % 3 != 0) { continue; }
+                    warthog::graph::edge e = g.outgoing_begin(i)[j];
+                    e.wt_ = e.wt_ * (1 + rng() % 10);
+                    edges.push_back({i, e});
+                }
+            }
+            g.perturb(edges);
+            cch.set_num_threads(1 + round);
+            cch.customize();
+            require_same_costs(g, chd, queries);
+        }
+    }
+}
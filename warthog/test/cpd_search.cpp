@@ -10,6 +10,8 @@
 #include "cpd_extractions.h"
 #include "cast.h"
 
+#include <random>
+
 using namespace std;
 
 int
@@ -425,3 +427,42 @@ SCENARIO("Test table lookup A* on a square matrix", "[table][square][astar]")
         }
     }
 }
+
+SCENARIO("Test the run lookups of CPD rows", "[cpd][runs]")
+{
+    std::mt19937 rng(7);
+
+    GIVEN("Random rows of every length up to 300 runs")
+    {
+        THEN("Every search finds the last run that begins before the column")
+        {
+            for(uint32_t size = 1; size <= 300; size++)
+            {
+                // runs begin at strictly increasing columns, the first at 0
+                std::vector<warthog::cpd::rle_run32> row;
+                uint32_t begin = 0;
+                for(uint32_t i = 0; i < size; i++)
+                {
+                    row.push_back(warthog::cpd::rle_run32{
+                        (begin << 4) | (uint32_t)(rng() % 16) });
+                    begin += 1 + rng() % 5;
+                }
+
+                for(uint32_t index = 0; index < begin + 2; index++)
+                {
+                    uint32_t expected = 0;
+                    while(expected + 1 < size &&
+                          row.at(expected + 1).get_index() <= index)
+                    { expected++; }
+
+                    REQUIRE(warthog::cpd::scan_runs(
+                                index, row.data(), size) == expected);
+                    REQUIRE(warthog::cpd::bisect_runs(
+                                index, row.data(), size) == expected);
+                    REQUIRE(warthog::cpd::find_run(
+                                index, row.data(), size) == expected);
+                }
+            }
+        }
+    }
+}
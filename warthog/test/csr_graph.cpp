@@ -0,0 +1,194 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "bidirectional_graph_expansion_policy.h"
+#include "bidirectional_search.h"
+#include "catch.hpp"
+#include "csr_graph.h"
+#include "flexible_astar.h"
+#include "graph_expansion_policy.h"
+#include "pqueue.h"
+#include "xy_graph.h"
+#include "zero_heuristic.h"
+
+#include <cstdio>
+#include <random>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+// a random sparse directed graph that stores incoming edges; a few edges
+// carry a label
+void
+fill_graph(warthog::graph::xy_graph& g, uint32_t num_nodes, std::mt19937& rng)
+{
+    g.grow(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        g.set_xy(i, (int32_t)(rng() % 1000), (int32_t)(rng() % 1000));
+    }
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        for(uint32_t k = rng() % 5; k > 0; k--)
+        {
+            uint32_t head = (uint32_t)(rng() % num_nodes);
+            warthog::graph::edge e(head, 1 + rng() % 100);
+            if(rng() % 10 == 0) { e.label_ = rng() % 1000; }
+            g.get_node(i)->add_outgoing(e);
+            g.get_node(head)->add_incoming(warthog::graph::edge(i, e.wt_));
+        }
+    }
+}
+
+// @param csr has the nodes and edges of @param g, in the same order
+void
+require_same(warthog::graph::xy_graph& g, warthog::graph::csr_graph& csr)
+{
+    REQUIRE(csr.get_num_nodes() == g.get_num_nodes());
+    REQUIRE(csr.get_num_edges_out() == g.get_num_edges_out());
+    REQUIRE(csr.get_num_edges_in() == g.get_num_edges_in());
+    for(uint32_t i = 0; i < g.get_num_nodes(); i++)
+    {
+        int32_t x, y, cx, cy;
+        g.get_xy(i, x, y);
+        csr.get_xy(i, cx, cy);
+        REQUIRE(cx == x);
+        REQUIRE(cy == y);
+
+        REQUIRE(csr.out_degree(i) == g.out_degree(i));
+        warthog::graph::csr_graph::edge_iter c = csr.outgoing_begin(i);
+        for(warthog::graph::edge_iter it = g.outgoing_begin(i);
+                it != g.outgoing_end(i); it++, c++)
+        {
+            REQUIRE(c->node_id_ == it->node_id_);
+            REQUIRE(c->wt_ == it->wt_);
+            REQUIRE(csr.get_label(c) == it->label_);
+        }
+        REQUIRE(c == csr.outgoing_end(i));
+
+        REQUIRE(csr.in_degree(i) == g.in_degree(i));
+        c = csr.incoming_begin(i);
+        for(warthog::graph::edge_iter it = g.incoming_begin(i);
+                it != g.incoming_end(i); it++, c++)
+        {
+            REQUIRE(c->node_id_ == it->node_id_);
+            REQUIRE(c->wt_ == it->wt_);
+        }
+        REQUIRE(c == csr.incoming_end(i));
+    }
+}
+
+}
+
+SCENARIO("Test csr graphs built from xy graphs", "[csr_graph]")
+{
+    const uint32_t num_nodes = 500;
+    std::mt19937 rng(17);
+    warthog::graph::xy_graph g(0, "", true);
+    fill_graph(g, num_nodes, rng);
+    warthog::graph::csr_graph csr(g);
+
+    THEN("It has the same nodes and edges")
+    {
+        REQUIRE(csr.has_incoming());
+        REQUIRE(csr.has_labels());
+        REQUIRE(!csr.is_mapped());
+        require_same(g, csr);
+    }
+
+    GIVEN("Dijkstra's algorithm on both graphs")
+    {
+        warthog::zero_heuristic h;
+        warthog::simple_graph_expansion_policy expander(&g);
+        warthog::pqueue_min open;
+        warthog::flexible_astar<
+            warthog::zero_heuristic,
+            warthog::simple_graph_expansion_policy,
+            warthog::pqueue_min> dijkstra(&h, &expander, &open);
+
+        typedef warthog::graph_expansion_policy<
+            warthog::dummy_filter, warthog::graph::csr_graph> csr_expander_t;
+        csr_expander_t cexpander(&csr);
+        warthog::pqueue_min copen;
+        warthog::flexible_astar<
+            warthog::zero_heuristic,
+            csr_expander_t,
+            warthog::pqueue_min> cdijkstra(&h, &cexpander, &copen);
+
+        typedef warthog::bidirectional_expander<
+            warthog::apriori_filter, warthog::graph::csr_graph> bi_expander_t;
+        bi_expander_t fexp(&csr, false);
+        bi_expander_t bexp(&csr, true);
+        warthog::bidirectional_search<warthog::zero_heuristic, bi_expander_t>
+            bidijkstra(&fexp, &bexp, &h);
+
+        THEN("Paths have the same cost")
+        {
+            for(uint32_t i = 0; i < 300; i++)
+            {
+                warthog::problem_instance pi(
+                        rng() % num_nodes, rng() % num_nodes);
+                warthog::solution sol, csol, bsol;
+                dijkstra.get_path(pi, sol);
+                cdijkstra.get_path(pi, csol);
+                bidijkstra.get_path(pi, bsol);
+                REQUIRE(csol.sum_of_edge_costs_ == sol.sum_of_edge_costs_);
+                REQUIRE(csol.nodes_expanded_ == sol.nodes_expanded_);
+                // the bidirectional search does not stop when the start
+                // is the target
+                if(pi.start_id_ == pi.target_id_) { continue; }
+                REQUIRE(bsol.sum_of_edge_costs_ == sol.sum_of_edge_costs_);
+            }
+        }
+    }
+}
+
+SCENARIO("Save and load a csr graph", "[csr_graph]")
+{
+    std::mt19937 rng(19);
+    warthog::graph::xy_graph g(0, "", true);
+    fill_graph(g, 300, rng);
+    warthog::graph::csr_graph csr(g);
+
+    const char* filename = "csr_graph.test.csr";
+    REQUIRE(csr.save(filename, 42));
+
+    GIVEN("The same source")
+    {
+        warthog::graph::csr_graph copy;
+        REQUIRE(copy.load(filename, 42));
+
+        THEN("The mapped graph is the same")
+        {
+            REQUIRE(copy.is_mapped());
+            require_same(g, copy);
+        }
+
+        THEN("A mapped graph saves to the same file")
+        {
+            REQUIRE(copy.save(filename, 42));
+            warthog::graph::csr_graph again;
+            REQUIRE(again.load(filename));
+            require_same(g, again);
+        }
+    }
+
+    GIVEN("Another source")
+    {
+        warthog::graph::csr_graph other;
+        THEN("The file is not used")
+        {
+            REQUIRE(!other.load(filename, 43));
+            REQUIRE(!other.is_mapped());
+            REQUIRE(other.get_num_nodes() == 0);
+        }
+    }
+    remove(filename);
+}
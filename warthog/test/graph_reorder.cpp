@@ -0,0 +1,256 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "bidirectional_graph_expansion_policy.h"
+#include "bidirectional_search.h"
+#include "catch.hpp"
+#include "csr_graph.h"
+#include "flexible_astar.h"
+#include "graph_expansion_policy.h"
+#include "graph_reorder.h"
+#include "pqueue.h"
+#include "xy_graph.h"
+#include "zero_heuristic.h"
+
+#include <algorithm>
+#include <random>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+// a random sparse directed graph that stores incoming edges
+void
+fill_graph(warthog::graph::xy_graph& g, uint32_t num_nodes, std::mt19937& rng)
+{
+    g.grow(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        g.set_xy(i, (int32_t)(rng() % 1000), (int32_t)(rng() % 1000));
+    }
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        for(uint32_t k = rng() % 5; k > 0; k--)
+        {
+            uint32_t head = (uint32_t)(rng() % num_nodes);
+            warthog::graph::edge e(head, 1 + rng() % 100);
+            g.get_node(i)->add_outgoing(e);
+            g.get_node(head)->add_incoming(warthog::graph::edge(i, e.wt_));
+        }
+    }
+}
+
+void
+require_permutation(const std::vector<uint32_t>& order, uint32_t num_nodes)
+{
+    REQUIRE(order.size() == num_nodes);
+    std::vector<uint32_t> sorted(order);
+    std::sort(sorted.begin(), sorted.end());
+    for(uint32_t i = 0; i < num_nodes; i++) { REQUIRE(sorted[i] == i); }
+}
+
+// the cost of the shortest path between every pair of @param ids
+template<class SEARCH>
+std::vector<warthog::cost_t>
+costs(SEARCH& alg, const std::vector<uint32_t>& ids)
+{
+    std::vector<warthog::cost_t> result;
+    for(uint32_t i = 0; i + 1 < ids.size(); i += 2)
+    {
+        warthog::problem_instance pi(ids[i], ids[i+1]);
+        warthog::solution sol;
+        alg.get_path(pi, sol);
+        result.push_back(sol.sum_of_edge_costs_);
+    }
+    return result;
+}
+
+}
+
+SCENARIO("Test node orders", "[graph_reorder]")
+{
+    const uint32_t num_nodes = 500;
+    std::mt19937 rng(23);
+    warthog::graph::xy_graph g(0, "", true);
+    fill_graph(g, num_nodes, rng);
+
+    THEN("Every order is a permutation of the nodes")
+    {
+        std::vector<uint32_t> order;
+        warthog::graph::dfs_order(&g, order);
+        require_permutation(order, num_nodes);
+        warthog::graph::bfs_order(&g, order, 7);
+        require_permutation(order, num_nodes);
+        REQUIRE(order.front() == 7);
+        warthog::graph::hilbert_order(&g, order);
+        require_permutation(order, num_nodes);
+    }
+
+    THEN("The level order puts the highest level first")
+    {
+        std::vector<uint32_t> level(num_nodes), order;
+        for(uint32_t i = 0; i < num_nodes; i++) { level[i] = rng() % 50; }
+        warthog::graph::level_order(level, order);
+        require_permutation(order, num_nodes);
+        for(uint32_t i = 1; i < num_nodes; i++)
+        {
+            REQUIRE(level[order[i-1]] >= level[order[i]]);
+        }
+    }
+
+    THEN("Order names are parsed")
+    {
+        REQUIRE(warthog::graph::parse_reorder_type("dfs") ==
+                warthog::graph::REORDER_DFS);
+        REQUIRE(warthog::graph::parse_reorder_type("level") ==
+                warthog::graph::REORDER_LEVEL);
+        REQUIRE(warthog::graph::parse_reorder_type("foo") ==
+                warthog::graph::REORDER_NONE);
+    }
+}
+
+SCENARIO("Search a reordered graph with external ids", "[graph_reorder]")
+{
+    const uint32_t num_nodes = 400;
+    std::mt19937 rng(29);
+    warthog::graph::xy_graph g(0, "", true);
+    fill_graph(g, num_nodes, rng);
+
+    std::vector<uint32_t> queries(600);
+    for(uint32_t& id : queries) { id = rng() % num_nodes; }
+
+    warthog::zero_heuristic h;
+    warthog::pqueue_min open;
+    warthog::simple_graph_expansion_policy expander(&g);
+    warthog::flexible_astar<
+        warthog::zero_heuristic,
+        warthog::simple_graph_expansion_policy,
+        warthog::pqueue_min> dijkstra(&h, &expander, &open);
+    std::vector<warthog::cost_t> expected = costs(dijkstra, queries);
+
+    warthog::graph::xy_graph r(g);
+    std::vector<uint32_t> order;
+    warthog::graph::hilbert_order(&r, order);
+    r.reorder(order);
+    for(uint32_t i = 0; i < 2; i++)
+    {
+        // a second pass composes the renumberings
+        warthog::graph::dfs_order(&r, order, 3);
+        r.reorder(order);
+    }
+
+    THEN("Ids map back and forth")
+    {
+        REQUIRE(r.get_num_nodes() == num_nodes);
+        REQUIRE(r.get_num_edges_out() == g.get_num_edges_out());
+        for(uint32_t ext = 0; ext < num_nodes; ext++)
+        {
+            uint32_t id = r.to_graph_id(ext);
+            REQUIRE(r.to_external_id(id) == ext);
+            int32_t x, y, rx, ry;
+            g.get_xy(ext, x, y);
+            r.get_xy(id, rx, ry);
+            REQUIRE(rx == x);
+            REQUIRE(ry == y);
+            REQUIRE(r.out_degree(id) == g.out_degree(ext));
+            REQUIRE(r.in_degree(id) == g.in_degree(ext));
+        }
+        REQUIRE(r.to_graph_id(num_nodes) == warthog::INF32);
+    }
+
+    THEN("Paths have the same cost")
+    {
+        warthog::simple_graph_expansion_policy rexpander(&r);
+        warthog::flexible_astar<
+            warthog::zero_heuristic,
+            warthog::simple_graph_expansion_policy,
+            warthog::pqueue_min> rdijkstra(&h, &rexpander, &open);
+        REQUIRE(costs(rdijkstra, queries) == expected);
+    }
+
+    THEN("Perturbations use the external ids")
+    {
+        // edges of the input graph, as read from a perturbation file
+        std::vector<std::pair<uint32_t, warthog::graph::edge>> edges;
+        for(uint32_t i = 0; i < num_nodes; i++)
+        {
+            for(uint32_t j = 0; j < g.out_degree(i); j++)
+            {
+                if(rng() % 2 != 0) { continue; }
+                warthog::graph::edge e = g.outgoing_begin(i)[j];
+                e.wt_ = e.wt_ * (2 + rng() % 10);
+                edges.push_back({i, e});
+            }
+        }
+        warthog::graph::xy_graph copy(r);
+        g.perturb(edges);
+        r.perturb(edges);
+        copy.perturb(g);
+
+        warthog::simple_graph_expansion_policy gexpander(&g);
+        warthog::flexible_astar<
+            warthog::zero_heuristic,
+            warthog::simple_graph_expansion_policy,
+            warthog::pqueue_min> gdijkstra(&h, &gexpander, &open);
+        std::vector<warthog::cost_t> perturbed = costs(gdijkstra, queries);
+        REQUIRE(perturbed != expected);
+
+        for(warthog::graph::xy_graph* rg : {&r, &copy})
+        {
+            warthog::simple_graph_expansion_policy rexpander(rg);
+            warthog::flexible_astar<
+                warthog::zero_heuristic,
+                warthog::simple_graph_expansion_policy,
+                warthog::pqueue_min> rdijkstra(&h, &rexpander, &open);
+            REQUIRE(costs(rdijkstra, queries) == perturbed);
+        }
+    }
+
+    THEN("Bidirectional paths have the same cost")
+    {
+        warthog::bidirectional_expander<warthog::apriori_filter> fexp(&r, false);
+        warthog::bidirectional_expander<warthog::apriori_filter> bexp(&r, true);
+        warthog::bidirectional_search<
+            warthog::zero_heuristic,
+            warthog::bidirectional_expander<warthog::apriori_filter>>
+                bidijkstra(&fexp, &bexp, &h);
+        std::vector<warthog::cost_t> bcosts = costs(bidijkstra, queries);
+        for(uint32_t i = 0; i < bcosts.size(); i++)
+        {
+            // the bidirectional search does not stop when the start is
+            // the target
+            if(queries[i*2] == queries[i*2+1]) { continue; }
+            REQUIRE(bcosts[i] == expected[i]);
+        }
+    }
+
+    THEN("A csr graph keeps the external ids")
+    {
+        warthog::graph::csr_graph csr(r);
+        typedef warthog::graph_expansion_policy<
+            warthog::dummy_filter, warthog::graph::csr_graph> csr_expander_t;
+        csr_expander_t cexpander(&csr);
+        warthog::flexible_astar<
+            warthog::zero_heuristic,
+            csr_expander_t,
+            warthog::pqueue_min> cdijkstra(&h, &cexpander, &open);
+        REQUIRE(costs(cdijkstra, queries) == expected);
+
+        const char* filename = "graph_reorder.test.csr";
+        REQUIRE(csr.save(filename));
+        warthog::graph::csr_graph copy;
+        REQUIRE(copy.load(filename));
+        for(uint32_t ext = 0; ext < num_nodes; ext++)
+        {
+            REQUIRE(copy.to_graph_id(ext) == r.to_graph_id(ext));
+            REQUIRE(copy.to_external_id(ext) == r.to_external_id(ext));
+        }
+        remove(filename);
+    }
+}
@@ -0,0 +1,73 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "flexible_astar.h"
+#include "grid_bb_labelling.h"
+#include "grid_fixture.h"
+#include "gridmap.h"
+#include "jpsplus_bb_expansion_policy.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+SCENARIO("Test JPS+ with bounding boxes against A*", "[jps][bb]")
+{
+    // a random map with 25% obstacles; many optimal paths tie
+    const uint32_t width = 48, height = 36;
+    warthog::gridmap map(height, width);
+    std::mt19937 rng(3);
+    std::vector<uint32_t> open_cells = grid_fixture::fill_map(map, 25, rng);
+
+    warthog::label::grid_bb_labelling lab(&map);
+    lab.precompute();
+
+    GIVEN("Labels written to a stream")
+    {
+        std::stringstream ss;
+        ss << lab;
+        warthog::label::grid_bb_labelling copy(&map);
+        ss >> copy;
+
+        THEN("They read back the same")
+        {
+            REQUIRE(ss.good());
+            for(uint32_t id : open_cells)
+            {
+                uint32_t padded_id = map.to_padded_id(id);
+                for(uint32_t i = 0; i < 8; i++)
+                {
+                    bool same = copy.get_label(padded_id, i).bbox_ ==
+                        lab.get_label(padded_id, i).bbox_;
+                    REQUIRE(same);
+                }
+            }
+        }
+    }
+
+    GIVEN("A* and JPS+ with bounding boxes")
+    {
+        warthog::octile_heuristic h(map.width(), map.height());
+        warthog::jpsplus_bb_expansion_policy bexpander(&lab);
+        warthog::pqueue_min bopen;
+        warthog::flexible_astar<
+            warthog::octile_heuristic,
+            warthog::jpsplus_bb_expansion_policy,
+            warthog::pqueue_min> jpsbb(&h, &bexpander, &bopen);
+
+        THEN("Both find paths of the same cost")
+        {
+            grid_fixture::compare_with_astar(map, jpsbb, open_cells, 500, rng);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef WARTHOG_TEST_GRID_FIXTURE_H
+#define WARTHOG_TEST_GRID_FIXTURE_H
+
+// test/grid_fixture.h
+//
+// Random maps for the tests of grid search algorithms, and a check of the
+// paths they find against A* with the octile heuristic. Include after
+// catch.hpp.
+//
+
+#include "catch.hpp"
+#include "flexible_astar.h"
+#include "gridmap.h"
+#include "gridmap_expansion_policy.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace grid_fixture
+{
+
+// fill @param map with @param percent obstacles at random; @return its
+// traversable tiles (unpadded ids)
+inline std::vector<uint32_t>
+fill_map(warthog::gridmap& map, uint32_t percent, std::mt19937& rng)
+{
+    std::vector<uint32_t> open_cells;
+    for(uint32_t y = 0; y < map.header_height(); y++)
+    {
+        for(uint32_t x = 0; x < map.header_width(); x++)
+        {
+            bool traversable = rng() % 100 >= percent;
+            map.set_label(map.to_padded_id(x, y), traversable);
+            if(traversable)
+            {
+                open_cells.push_back(y * map.header_width() + x);
+            }
+        }
+    }
+    return open_cells;
+}
+
+// a search between two of @param open_cells
+inline warthog::problem_instance
+random_instance(const std::vector<uint32_t>& open_cells, std::mt19937& rng)
+{
+    uint32_t start = open_cells.at(rng() % open_cells.size());
+    uint32_t target = open_cells.at(rng() % open_cells.size());
+    return warthog::problem_instance(start, target);
+}
+
+// @param search finds paths of the same cost as A* on @param map, for
+// @param num instances between @param open_cells. @param check, if given,
+// is called with each instance, the solution of A* and that of @param
+// search.
+template<class SEARCH>
+void
+compare_with_astar(warthog::gridmap& map, SEARCH& search,
+        const std::vector<uint32_t>& open_cells, uint32_t num,
+        std::mt19937& rng,
+        std::function<void(warthog::problem_instance&,
+            warthog::solution&, warthog::solution&)> check = nullptr)
+{
+    warthog::octile_heuristic h(map.width(), map.height());
+    warthog::gridmap_expansion_policy expander(&map);
+    warthog::pqueue_min open;
+    warthog::flexible_astar<
+        warthog::octile_heuristic,
+        warthog::gridmap_expansion_policy,
+        warthog::pqueue_min> astar(&h, &expander, &open);
+
+    for(uint32_t i = 0; i < num; i++)
+    {
+        warthog::problem_instance pi = random_instance(open_cells, rng);
+        warthog::solution expected, found;
+        astar.get_path(pi, expected);
+        search.get_path(pi, found);
+        REQUIRE(found.sum_of_edge_costs_ ==
+                Approx(expected.sum_of_edge_costs_));
+        if(check) { check(pi, expected, found); }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,105 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "gridmap.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+bool
+same_tiles(warthog::gridmap& map1, warthog::gridmap& map2)
+{
+    if(map1.header_width() != map2.header_width() ||
+       map1.header_height() != map2.header_height() ||
+       map1.padded_mapsize() != map2.padded_mapsize())
+    { return false; }
+
+    for(uint32_t i = 0; i < map1.padded_mapsize(); i++)
+    {
+        if(map1.get_label(i) != map2.get_label(i)) { return false; }
+    }
+    return true;
+}
+
+}
+
+SCENARIO("Save and load a binary gridmap", "[gridmap]")
+{
+    // the width is not a multiple of any padding
+    const uint32_t width = 77, height = 41;
+    warthog::gridmap map(height, width);
+    std::mt19937 rng(5);
+    for(uint32_t y = 0; y < height; y++)
+    {
+        for(uint32_t x = 0; x < width; x++)
+        {
+            map.set_label(map.to_padded_id(x, y), rng() % 100 >= 25);
+        }
+    }
+    REQUIRE(map.width() % warthog::GRIDMAP_ROW_BITS == 0);
+    REQUIRE(map.width() > width);
+
+    const char* filename = "gridmap.test.bin";
+    std::ofstream out(filename, std::ios_base::out | std::ios_base::binary);
+    REQUIRE(map.write_binary(out));
+    out.close();
+
+    GIVEN("The mapped file")
+    {
+        warthog::gridmap copy(filename);
+        REQUIRE(copy.is_mapped());
+
+        THEN("It has the same padding and tiles")
+        {
+            REQUIRE(copy.width() == map.width());
+            REQUIRE(copy.height() == map.height());
+            REQUIRE(copy.dbwidth() == map.dbwidth());
+            REQUIRE(same_tiles(map, copy));
+        }
+
+        THEN("Changing a tile copies the map and leaves the file as it is")
+        {
+            uint32_t id = copy.to_padded_id(3, 4);
+            bool label = copy.get_label(id);
+            copy.set_label(id, !label);
+            REQUIRE(!copy.is_mapped());
+            REQUIRE((bool)copy.get_label(id) == !label);
+
+            warthog::gridmap again(filename);
+            REQUIRE(again.is_mapped());
+            REQUIRE(same_tiles(map, again));
+
+            copy.set_label(id, label);
+            REQUIRE(same_tiles(map, copy));
+        }
+
+        THEN("Inverting it does too")
+        {
+            copy.invert();
+            REQUIRE(!copy.is_mapped());
+            copy.invert();
+            REQUIRE(same_tiles(map, copy));
+        }
+    }
+
+    GIVEN("A copy of the mapped map")
+    {
+        warthog::gridmap mapped(filename);
+        warthog::gridmap copy(mapped);
+        REQUIRE(!copy.is_mapped());
+        REQUIRE(same_tiles(map, copy));
+    }
+    remove(filename);
+}
@@ -0,0 +1,230 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "flexible_astar.h"
+#include "grid_fixture.h"
+#include "gridmap.h"
+#include "gridmap_expansion_policy.h"
+#include "jpsplus_expansion_policy.h"
+#include "jump_point_db.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+// the labels of @param db agree with those of a database built from
+// scratch for @param map, and so does its copy of the map
+bool
+same_as_rebuilt(warthog::jump_point_db& db, warthog::gridmap& map)
+{
+    warthog::jump_point_db rebuilt(&map);
+    std::shared_ptr<const warthog::jump_point_db::version_data> current =
+        db.snapshot();
+    const uint16_t* labels = current->labels_.get();
+    const uint16_t* expected = rebuilt.snapshot()->labels_.get();
+    for(uint32_t i = 0; i < db.size(); i++)
+    {
+        if(labels[i] != expected[i]) { return false; }
+    }
+    for(uint32_t i = 0; i < map.padded_mapsize(); i++)
+    {
+        if(current->map_->get_label(i) != map.get_label(i)) { return false; }
+    }
+    return true;
+}
+
+// flip the tile @param id of @param map and record the change in
+// @param tiles
+void
+flip(warthog::gridmap& map, uint32_t id,
+        std::vector<std::pair<uint32_t, bool>>& tiles)
+{
+    bool traversable = !map.get_label(id);
+    map.set_label(id, traversable);
+    tiles.push_back(std::make_pair(id, traversable));
+}
+
+// the straight labels of a snapshot agree with its tiles: a jump east or
+// west from a tile is a dead-end of zero steps exactly when it cannot
+// take a step
+bool
+consistent(const warthog::jump_point_db::version_data& v, uint32_t id)
+{
+    warthog::gridmap* map = v.map_.get();
+    const uint16_t* labels = v.labels_.get();
+    const uint16_t DEAD_END = 32768;
+    bool here = map->get_label(id);
+    return
+        (labels[8*id + 2] == DEAD_END) == !(here && map->get_label(id + 1)) &&
+        (labels[8*id + 3] == DEAD_END) == !(here && map->get_label(id - 1));
+}
+
+}
+
+SCENARIO("Update a jump point database as the map changes", "[jps][jump_point_db]")
+{
+    // a random map with 20% obstacles, wider than it is high, so that
+    // diagonal lines are cut by both edges
+    const uint32_t width = 130, height = 70;
+    warthog::gridmap map(height, width);
+    std::mt19937 rng(11);
+    grid_fixture::fill_map(map, 20, rng);
+
+    warthog::jump_point_db db(&map);
+    REQUIRE(db.size() == 8 * map.padded_mapsize());
+    REQUIRE(!db.is_mapped());
+
+    GIVEN("Batches of tiles that open and close")
+    {
+        THEN("Every update agrees with a database built from scratch")
+        {
+            const uint32_t batches[] = {1, 1, 3, 10, 1, 50, 2, 200, 1, 5};
+            for(uint32_t batch : batches)
+            {
+                std::vector<std::pair<uint32_t, bool>> tiles;
+                for(uint32_t i = 0; i < batch; i++)
+                {
+                    // include the edges of the map
+                    uint32_t x = rng() % 8 == 0 ? width - 1 : rng() % width;
+                    uint32_t y = rng() % 8 == 0 ? 0 : rng() % height;
+                    flip(map, map.to_padded_id(x, y), tiles);
+                }
+                uint64_t version = db.version();
+                db.update(tiles);
+                REQUIRE(db.version() == version + 1);
+                REQUIRE(same_as_rebuilt(db, map));
+            }
+        }
+
+        THEN("A snapshot does not change while it is held")
+        {
+            std::shared_ptr<const warthog::jump_point_db::version_data> held =
+                db.snapshot();
+            const uint16_t* labels = held->labels_.get();
+            std::vector<uint16_t> before(labels, labels + db.size());
+            std::vector<bool> tiles_before;
+            for(uint32_t i = 0; i < map.padded_mapsize(); i++)
+            {
+                tiles_before.push_back(held->map_->get_label(i));
+            }
+            for(uint32_t i = 0; i < 3; i++)
+            {
+                std::vector<std::pair<uint32_t, bool>> tiles;
+                flip(map, map.to_padded_id(rng() % width, rng() % height),
+                        tiles);
+                db.update(tiles);
+            }
+            REQUIRE(db.snapshot() != held);
+            for(uint32_t i = 0; i < db.size(); i++)
+            {
+                REQUIRE(labels[i] == before[i]);
+            }
+            for(uint32_t i = 0; i < map.padded_mapsize(); i++)
+            {
+                REQUIRE((bool)held->map_->get_label(i) == tiles_before[i]);
+            }
+            REQUIRE(same_as_rebuilt(db, map));
+        }
+
+        THEN("Readers see consistent versions while the map changes")
+        {
+            std::atomic<bool> done(false);
+            std::atomic<uint32_t> bad(0);
+            std::atomic<uint32_t> reads(0);
+            auto reader = [&db, &map, &done, &bad, &reads](uint32_t seed)
+            {
+                std::mt19937 rrng(seed);
+                while(!done)
+                {
+                    std::shared_ptr<const
+                        warthog::jump_point_db::version_data> v =
+                            db.snapshot();
+                    for(uint32_t i = 0; i < 64; i++)
+                    {
+                        uint32_t id = map.to_padded_id(
+                                rrng() % width, rrng() % height);
+                        if(!consistent(*v, id)) { bad++; }
+                    }
+                    reads++;
+                }
+            };
+
+            std::vector<std::thread> readers;
+            for(uint32_t t = 0; t < 3; t++)
+            {
+                readers.push_back(std::thread(reader, 100 + t));
+            }
+            for(uint32_t i = 0; i < 300; i++)
+            {
+                std::vector<std::pair<uint32_t, bool>> tiles;
+                for(uint32_t j = 0; j < 4; j++)
+                {
+                    flip(map, map.to_padded_id(
+                                rng() % width, rng() % height), tiles);
+                }
+                db.update(tiles);
+            }
+            while(reads < 100) { std::this_thread::yield(); }
+            done = true;
+            for(std::thread& t : readers) { t.join(); }
+
+            REQUIRE(bad == 0);
+            REQUIRE(same_as_rebuilt(db, map));
+        }
+    }
+
+    GIVEN("JPS+ on a map that changes between searches")
+    {
+        warthog::octile_heuristic h(map.width(), map.height());
+        warthog::gridmap_expansion_policy expander(&map);
+        warthog::pqueue_min open;
+        warthog::flexible_astar<
+            warthog::octile_heuristic,
+            warthog::gridmap_expansion_policy,
+            warthog::pqueue_min> astar(&h, &expander, &open);
+
+        warthog::jpsplus_expansion_policy jexpander(&map);
+        warthog::pqueue_min jopen;
+        warthog::flexible_astar<
+            warthog::octile_heuristic,
+            warthog::jpsplus_expansion_policy,
+            warthog::pqueue_min> jpsplus(&h, &jexpander, &jopen);
+
+        THEN("It finds paths as short as those of A*")
+        {
+            for(uint32_t i = 0; i < 100; i++)
+            {
+                std::vector<std::pair<uint32_t, bool>> tiles;
+                for(uint32_t j = 0; j < 4; j++)
+                {
+                    flip(map, map.to_padded_id(
+                                rng() % width, rng() % height), tiles);
+                }
+                jexpander.get_database()->update(tiles);
+
+                warthog::problem_instance pi(
+                        rng() % (width * height), rng() % (width * height));
+                warthog::solution sol, jsol;
+                astar.get_path(pi, sol);
+                jpsplus.get_path(pi, jsol);
+                REQUIRE(jsol.sum_of_edge_costs_ ==
+                        Approx(sol.sum_of_edge_costs_));
+            }
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "flexible_astar.h"
+#include "graph_expansion_policy.h"
+#include "grid_fixture.h"
+#include "gridmap.h"
+#include "gridmap_expansion_policy.h"
+#include "landmark_heuristic.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+#include "xy_graph.h"
+#include "zero_heuristic.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+SCENARIO("Test landmark heuristics on a gridmap", "[landmarks][grid]")
+{
+    // a random map with 25% obstacles
+    const uint32_t width = 48, height = 36;
+    warthog::gridmap map(height, width);
+    std::mt19937 rng(7);
+    std::vector<uint32_t> open_cells = grid_fixture::fill_map(map, 25, rng);
+
+    warthog::landmark_heuristic lm(&map);
+    lm.precompute(12, warthog::landmark_heuristic::AVOID, 1);
+    REQUIRE(lm.get_num_landmarks() == 12);
+
+    GIVEN("A* with octile and with landmark heuristics")
+    {
+        warthog::gridmap_expansion_policy lexpander(&map);
+        warthog::pqueue_min lopen;
+        warthog::flexible_astar<
+            warthog::landmark_heuristic,
+            warthog::gridmap_expansion_policy,
+            warthog::pqueue_min> lastar(&lm, &lexpander, &lopen);
+
+        THEN("Both find paths of the same cost and h never overestimates")
+        {
+            grid_fixture::compare_with_astar(map, lastar, open_cells, 300, rng,
+                [&map, &lm](warthog::problem_instance& pi,
+                    warthog::solution& sol, warthog::solution&)
+                {
+                    if(sol.sum_of_edge_costs_ == warthog::COST_MAX) { return; }
+                    REQUIRE(lm.h(map.to_padded_id((uint32_t)pi.start_id_),
+                                 map.to_padded_id((uint32_t)pi.target_id_)) <=
+                            sol.sum_of_edge_costs_ + 1e-6);
+                });
+        }
+    }
+
+    GIVEN("Tables saved to a file")
+    {
+        const char* filename = "landmark_heuristic.test.lm";
+        REQUIRE(lm.save(filename));
+
+        THEN("They map back the same")
+        {
+            warthog::landmark_heuristic copy(&map);
+            REQUIRE(copy.load(filename));
+            REQUIRE(copy.is_mapped());
+            REQUIRE(copy.get_landmarks() == lm.get_landmarks());
+            for(uint32_t i = 0; i < 500; i++)
+            {
+                uint32_t v = map.to_padded_id(
+                        open_cells.at(rng() % open_cells.size()));
+                uint32_t t = map.to_padded_id(
+                        open_cells.at(rng() % open_cells.size()));
+                REQUIRE(copy.h(v, t) == lm.h(v, t));
+            }
+        }
+
+        THEN("They are not used for another map")
+        {
+            warthog::gridmap other(height, width);
+            warthog::landmark_heuristic copy(&other);
+            REQUIRE(!copy.load(filename));
+        }
+        remove(filename);
+    }
+}
+
+SCENARIO("Test landmark heuristics on a directed graph", "[landmarks][graph]")
+{
+    // a random sparse graph; most arcs have no reverse, or a reverse of
+    // another cost
+    const uint32_t num_nodes = 400;
+    std::mt19937 rng(11);
+    warthog::graph::xy_graph g(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        for(uint32_t k = 0; k < 3; k++)
+        {
+            g.get_node(i)->add_outgoing(warthog::graph::edge(
+                        (uint32_t)(rng() % num_nodes), 1 + rng() % 100));
+        }
+    }
+
+    // exact distances, by Dijkstra search
+    warthog::simple_graph_expansion_policy expander(&g);
+    warthog::zero_heuristic zero;
+    warthog::pqueue_min open;
+    warthog::flexible_astar<
+        warthog::zero_heuristic,
+        warthog::simple_graph_expansion_policy,
+        warthog::pqueue_min> dijkstra(&zero, &expander, &open);
+
+    warthog::landmark_heuristic::selection selections[2] = {
+        warthog::landmark_heuristic::FARTHEST,
+        warthog::landmark_heuristic::AVOID};
+    for(warthog::landmark_heuristic::selection sel : selections)
+    {
+        warthog::landmark_heuristic lm(&g);
+        lm.precompute(8, sel, 2);
+        REQUIRE(lm.get_num_landmarks() == 8);
+
+        // h is a lower bound in the forward direction; a symmetric h is a
+        // lower bound in both
+        for(uint32_t i = 0; i < 300; i++)
+        {
+            uint32_t s = (uint32_t)(rng() % num_nodes);
+            uint32_t t = (uint32_t)(rng() % num_nodes);
+            warthog::problem_instance pi(s, t), rpi(t, s);
+            warthog::solution sol, rsol;
+            dijkstra.get_path(pi, sol);
+            dijkstra.get_path(rpi, rsol);
+
+            lm.set_symmetric(false);
+            REQUIRE(lm.h(s, t) <= sol.sum_of_edge_costs_ + 1e-6);
+            lm.set_symmetric(true);
+            REQUIRE(lm.h(s, t) <= sol.sum_of_edge_costs_ + 1e-6);
+            REQUIRE(lm.h(s, t) <= rsol.sum_of_edge_costs_ + 1e-6);
+        }
+    }
+}
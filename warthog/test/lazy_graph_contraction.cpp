@@ -0,0 +1,104 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "ch_data.h"
+#include "lazy_graph_contraction.h"
+#include "xy_graph.h"
+
+#include <random>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+// a grid-like road network, as in the cch test
+void
+fill_graph(warthog::graph::xy_graph& g, uint32_t width, std::mt19937& rng)
+{
+    g.grow(width * width);
+    for(uint32_t i = 0; i < width * width; i++)
+    {
+        g.set_xy(i, (int32_t)((i % width) * 10 + rng() % 5),
+                (int32_t)((i / width) * 10 + rng() % 5));
+    }
+    for(uint32_t i = 0; i < width * width; i++)
+    {
+        for(uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t x = i % width + rng() % 3;
+            uint32_t y = i / width + rng() % 3;
+            if(x >= width || y >= width) { continue; }
+            uint32_t head = y * width + x;
+            warthog::graph::edge_cost_t wt = 10 + rng() % 20;
+            g.get_node(i)->add_outgoing(warthog::graph::edge(head, wt));
+            g.get_node(head)->add_incoming(warthog::graph::edge(i, wt));
+            if(rng() % 4 == 0) { continue; }
+            g.get_node(head)->add_outgoing(warthog::graph::edge(i, wt));
+            g.get_node(i)->add_incoming(warthog::graph::edge(head, wt));
+        }
+    }
+}
+
+// contract the graph generated from @param seed with @param threads
+// (0 is the sequential contraction)
+void
+contract(warthog::ch::ch_data& chd, uint32_t width, uint32_t seed,
+        uint32_t threads)
+{
+    std::mt19937 rng(seed);
+    fill_graph(*chd.g_, width, rng);
+    chd.up_degree_->resize(chd.g_->get_num_nodes(), 0);
+
+    warthog::ch::lazy_graph_contraction contractor;
+    contractor.set_num_threads(threads);
+    contractor.contract(&chd);
+}
+
+void
+require_same_hierarchy(warthog::ch::ch_data& chd1, warthog::ch::ch_data& chd2)
+{
+    REQUIRE(*chd1.level_ == *chd2.level_);
+    REQUIRE(chd1.g_->get_num_nodes() == chd2.g_->get_num_nodes());
+    REQUIRE(chd1.g_->get_num_edges_out() == chd2.g_->get_num_edges_out());
+    for(uint32_t i = 0; i < chd1.g_->get_num_nodes(); i++)
+    {
+        warthog::graph::node* n1 = chd1.g_->get_node(i);
+        warthog::graph::node* n2 = chd2.g_->get_node(i);
+        REQUIRE(n1->out_degree() == n2->out_degree());
+        for(uint32_t j = 0; j < n1->out_degree(); j++)
+        {
+            warthog::graph::edge& e1 = *(n1->outgoing_begin() + j);
+            warthog::graph::edge& e2 = *(n2->outgoing_begin() + j);
+            REQUIRE(e1.node_id_ == e2.node_id_);
+            REQUIRE(e1.wt_ == e2.wt_);
+        }
+    }
+}
+
+}
+
+SCENARIO("Contraction in rounds does not depend on the number of threads",
+        "[contraction]")
+{
+    const uint32_t width = 24;
+    for(uint32_t seed : {17u, 18u})
+    {
+        warthog::ch::ch_data one(true);
+        contract(one, width, seed, 1);
+        REQUIRE(one.level_->size() == width * width);
+
+        for(uint32_t threads : {2u, 4u, 7u})
+        {
+            warthog::ch::ch_data many(true);
+            contract(many, width, seed, threads);
+            require_same_hierarchy(one, many);
+        }
+    }
+}
@@ -0,0 +1,245 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "bidirectional_graph_expansion_policy.h"
+#include "catch.hpp"
+#include "cch.h"
+#include "constants.h"
+#include "flexible_astar.h"
+#include "graph_oracle.h"
+#include "oracle_listener.h"
+#include "phast.h"
+#include "pqueue.h"
+#include "xy_graph.h"
+#include "zero_heuristic.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <random>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+// a grid-like road network, as in the cch test, but without loops or
+// parallel edges: the oracle listeners keep one move of parallel edges
+void
+fill_graph(warthog::graph::xy_graph& g, uint32_t width, std::mt19937& rng)
+{
+    g.grow(width * width);
+    for(uint32_t i = 0; i < width * width; i++)
+    {
+        g.set_xy(i, (int32_t)((i % width) * 10 + rng() % 5),
+                (int32_t)((i / width) * 10 + rng() % 5));
+    }
+
+    auto add = [&g](uint32_t from, uint32_t to,
+            warthog::graph::edge_cost_t wt)
+    {
+        warthog::graph::node* n = g.get_node(from);
+        if(from == to ||
+           n->find_edge(to, n->outgoing_begin(), n->outgoing_end()) !=
+                n->outgoing_end())
+        { return; }
+        n->add_outgoing(warthog::graph::edge(to, wt));
+        g.get_node(to)->add_incoming(warthog::graph::edge(from, wt));
+    };
+
+    for(uint32_t i = 0; i < width * width; i++)
+    {
+        for(uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t x = i % width + rng() % 3;
+            uint32_t y = i / width + rng() % 3;
+            if(x >= width || y >= width) { continue; }
+            uint32_t head = y * width + x;
+            warthog::graph::edge_cost_t wt = 10 + rng() % 20;
+            add(i, head, wt);
+            if(rng() % 4 == 0) { continue; }
+            add(head, i, wt);
+        }
+    }
+}
+
+// @param num distinct nodes of @param g
+std::vector<uint32_t>
+pick_sources(warthog::graph::xy_graph& g, uint32_t num, std::mt19937& rng)
+{
+    std::vector<uint32_t> ids(g.get_num_nodes());
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    ids.resize(num);
+    return ids;
+}
+
+// the distance from (or, if @param backward, to) @param source
+std::vector<warthog::cost_t>
+dijkstra(warthog::graph::xy_graph& g, uint32_t source, bool backward)
+{
+    typedef std::pair<warthog::cost_t, uint32_t> entry;
+    std::vector<warthog::cost_t> dist(g.get_num_nodes(), warthog::COST_MAX);
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> open;
+    dist[source] = 0;
+    open.push(entry(0, source));
+    while(!open.empty())
+    {
+        entry top = open.top();
+        open.pop();
+        if(top.first > dist[top.second]) { continue; }
+
+        warthog::graph::node* n = g.get_node(top.second);
+        warthog::graph::edge_iter begin =
+            backward ? n->incoming_begin() : n->outgoing_begin();
+        warthog::graph::edge_iter end =
+            backward ? n->incoming_end() : n->outgoing_end();
+        for(warthog::graph::edge_iter it = begin; it != end; it++)
+        {
+            warthog::cost_t alt = top.first + it->wt_;
+            if(alt < dist[it->node_id_])
+            {
+                dist[it->node_id_] = alt;
+                open.push(entry(alt, it->node_id_));
+            }
+        }
+    }
+    return dist;
+}
+
+// the rows of @param sources, computed by Dijkstra as make_cpd does and
+// from PHAST sweeps, must be the same
+template<warthog::cpd::symbol S, class LISTENER>
+void
+require_same_rows(warthog::graph::xy_graph& g, warthog::ch::phast& ph,
+        const std::vector<uint32_t>& sources, bool reverse)
+{
+    warthog::cpd::graph_oracle_base<S> expected(&g);
+    warthog::cpd::graph_oracle_base<S> found(&g);
+    expected.compute_dfs_preorder();
+    found.compute_dfs_preorder();
+
+    warthog::sn_id_t source_id;
+    std::vector<warthog::cpd::fm_coll> s_row(g.get_num_nodes());
+    warthog::bidirectional_graph_expansion_policy expander(&g, reverse);
+    warthog::zero_heuristic h;
+    warthog::pqueue_min queue;
+    LISTENER listener(&expected);
+    warthog::flexible_astar<
+        warthog::zero_heuristic,
+        warthog::bidirectional_graph_expansion_policy,
+        warthog::pqueue_min,
+        warthog::cpd::oracle_listener>
+        dijk(&h, &expander, &queue);
+    listener.set_run(&source_id, &s_row);
+    dijk.set_listener(&listener);
+    for(uint32_t source : sources)
+    {
+        source_id = source;
+        expected.compute_row(source, &dijk, s_row);
+    }
+
+    std::vector<std::vector<warthog::cost_t>> dist;
+    std::vector<std::vector<warthog::cpd::fm_coll>> rows;
+    found.compute_rows(sources, &ph, dist, rows);
+
+    for(uint32_t source : sources)
+    {
+        uint32_t size1, size2;
+        const warthog::cpd::rle_run32* runs1 =
+            expected.get_runs(source, size1);
+        const warthog::cpd::rle_run32* runs2 =
+            found.get_runs(source, size2);
+        REQUIRE(size1 == size2);
+        for(uint32_t i = 0; i < size1; i++)
+        {
+            REQUIRE(runs1[i].data_ == runs2[i].data_);
+        }
+    }
+}
+
+}
+
+SCENARIO("One-to-all sweeps over a contraction hierarchy", "[phast]")
+{
+    const uint32_t width = 30;
+    std::mt19937 rng(41);
+    warthog::graph::xy_graph g(0, "", true);
+    fill_graph(g, width, rng);
+
+    std::vector<uint32_t> order;
+    warthog::ch::nested_dissection_order(&g, order);
+    warthog::ch::customizable_ch cch(&g, order);
+    cch.customize();
+
+    std::vector<uint32_t> sources = pick_sources(g, 21, rng);
+
+    for(bool backward : {false, true})
+    {
+        warthog::ch::phast ph(cch.get_ch_data(), backward);
+        REQUIRE(ph.get_num_nodes() == g.get_num_nodes());
+        REQUIRE(ph.is_backward() == backward);
+
+        GIVEN(std::string(backward ? "A backward" : "A forward") + " sweep")
+        {
+            THEN("One source at a time gives Dijkstra's distances")
+            {
+                std::vector<warthog::cost_t> dist;
+                for(uint32_t source : sources)
+                {
+                    ph.one_to_all(source, dist);
+                    REQUIRE(dist == dijkstra(g, source, backward));
+                }
+            }
+
+            THEN("Batches of sources give the same distances")
+            {
+                std::vector<std::vector<warthog::cost_t>> dist;
+                warthog::ch::phast copy(ph);
+                copy.many_to_all(sources, dist);
+                REQUIRE(dist.size() == sources.size());
+                for(uint32_t i = 0; i < sources.size(); i++)
+                {
+                    REQUIRE(dist[i] == dijkstra(g, sources[i], backward));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("CPD rows from PHAST sweeps", "[phast][cpd]")
+{
+    const uint32_t width = 20;
+    std::mt19937 rng(43);
+    warthog::graph::xy_graph g(0, "", true);
+    fill_graph(g, width, rng);
+
+    std::vector<uint32_t> order;
+    warthog::ch::nested_dissection_order(&g, order);
+    warthog::ch::customizable_ch cch(&g, order);
+    cch.customize();
+
+    std::vector<uint32_t> sources = pick_sources(g, 19, rng);
+
+    GIVEN("A forward CPD")
+    {
+        warthog::ch::phast ph(cch.get_ch_data());
+        require_same_rows<warthog::cpd::FORWARD,
+            warthog::cpd::graph_oracle_listener<warthog::cpd::FORWARD>>(
+                    g, ph, sources, false);
+    }
+
+    GIVEN("A reverse CPD")
+    {
+        warthog::ch::phast ph(cch.get_ch_data(), true);
+        require_same_rows<warthog::cpd::REVERSE,
+            warthog::cpd::reverse_oracle_listener<warthog::cpd::REVERSE>>(
+                    g, ph, sources, true);
+    }
+}
@@ -0,0 +1,153 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "gridmap.h"
+#include "gridmap_expansion_policy.h"
+#include "mpmc_queue.h"
+#include "octile_heuristic.h"
+#include "query_engine.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+SCENARIO("Test the MPMC queue", "[mpmc][queue]")
+{
+    GIVEN("A queue shared by several producers and consumers")
+    {
+        const uint32_t num_threads = 4;
+        const uint32_t per_thread = 20000;
+        warthog::mpmc_queue<uint32_t> queue(64);
+        std::vector<std::vector<uint32_t>> popped(num_threads);
+
+        std::vector<std::thread> threads;
+        for(uint32_t t = 0; t < num_threads; t++)
+        {
+            threads.push_back(std::thread([&queue, t, per_thread] {
+                for(uint32_t i = 0; i < per_thread; i++)
+                {
+                    while(!queue.try_push(t * per_thread + i))
+                    { std::this_thread::yield(); }
+                }
+            }));
+            threads.push_back(std::thread([&queue, &popped, t, per_thread] {
+                uint32_t val;
+                while(popped[t].size() < per_thread)
+                {
+                    if(queue.try_pop(val)) { popped[t].push_back(val); }
+                    else { std::this_thread::yield(); }
+                }
+            }));
+        }
+        for(auto& th : threads) { th.join(); }
+
+        THEN("Every element is popped exactly once")
+        {
+            std::vector<uint32_t> seen(num_threads * per_thread, 0);
+            for(auto& vals : popped)
+            {
+                for(uint32_t val : vals) { seen.at(val)++; }
+            }
+            for(uint32_t count : seen) { REQUIRE(count == 1); }
+
+            uint32_t val;
+            REQUIRE(!queue.try_pop(val));
+        }
+    }
+}
+
+SCENARIO("Test the query engine against a serial search", "[query][engine]")
+{
+    // a random map with 20% obstacles
+    const uint32_t width = 64, height = 64;
+    warthog::gridmap map(height, width);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> dist(0, 99);
+    std::vector<uint32_t> open_cells;
+    for(uint32_t y = 0; y < height; y++)
+    {
+        for(uint32_t x = 0; x < width; x++)
+        {
+            bool traversable = dist(rng) >= 20;
+            map.set_label(map.to_padded_id(x, y), traversable);
+            if(traversable) { open_cells.push_back(y * width + x); }
+        }
+    }
+
+    std::vector<warthog::problem_instance> batch;
+    for(uint32_t i = 0; i < 200; i++)
+    {
+        batch.push_back(warthog::problem_instance(
+                open_cells.at(rng() % open_cells.size()),
+                open_cells.at(rng() % open_cells.size())));
+    }
+
+    typedef warthog::astar_worker<
+        warthog::octile_heuristic,
+        warthog::gridmap_expansion_policy> worker;
+
+    GIVEN("An engine with four workers sharing one map")
+    {
+        warthog::query_engine engine(4,
+            [&map](uint32_t id) -> warthog::search*
+            {
+                return new worker(
+                    new warthog::octile_heuristic(map.width(), map.height()),
+                    new warthog::gridmap_expansion_policy(&map),
+                    new warthog::pqueue_min());
+            });
+
+        worker serial(
+                new warthog::octile_heuristic(map.width(), map.height()),
+                new warthog::gridmap_expansion_policy(&map),
+                new warthog::pqueue_min());
+
+        THEN("Batches are solved in input order with optimal costs")
+        {
+            std::vector<warthog::solution> sols;
+            engine.solve(batch, sols);
+            REQUIRE(sols.size() == batch.size());
+
+            for(uint32_t i = 0; i < batch.size(); i++)
+            {
+                warthog::solution sol;
+                serial.get_path(batch.at(i), sol);
+                REQUIRE(sols.at(i).sum_of_edge_costs_ ==
+                        Approx(sol.sum_of_edge_costs_));
+                REQUIRE(sols.at(i).path_.size() == sol.path_.size());
+            }
+
+            uint64_t answered = 0;
+            for(uint32_t i = 0; i < engine.num_workers(); i++)
+            {
+                answered += engine.get_queries(i);
+            }
+            REQUIRE(answered == batch.size());
+        }
+
+        THEN("Futures return the same costs as a serial search")
+        {
+            std::vector<std::future<warthog::solution>> futures;
+            for(auto& pi : batch)
+            {
+                futures.push_back(engine.submit(pi, false));
+            }
+
+            for(uint32_t i = 0; i < batch.size(); i++)
+            {
+                warthog::solution sol;
+                serial.get_pathcost(batch.at(i), sol);
+                REQUIRE(futures.at(i).get().sum_of_edge_costs_ ==
+                        Approx(sol.sum_of_edge_costs_));
+            }
+        }
+    }
+}
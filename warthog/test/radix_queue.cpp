@@ -0,0 +1,124 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "pqueue.h"
+#include "radix_queue.h"
+#include "search_node.h"
+
+#include <random>
+#include <vector>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+SCENARIO("Test the radix queue against the binary heap", "[radix][queue]")
+{
+    const uint32_t num_nodes = 1000;
+    std::vector<warthog::search_node> nodes(num_nodes);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> dist(0, 200);
+
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        nodes[i].set_id(i);
+    }
+
+    GIVEN("Nodes with octile-like f-values")
+    {
+        warthog::radix_queue open;
+
+        for(auto& n : nodes)
+        {
+            warthog::cost_t f =
+                dist(rng) * warthog::DBL_ONE + dist(rng) * warthog::DBL_ROOT_TWO;
+            n.init(0, warthog::SN_ID_MAX, 0, f);
+            open.push(&n);
+        }
+
+        THEN("They are popped in non-decreasing order of f")
+        {
+            REQUIRE(open.size() == num_nodes);
+            warthog::cost_t last = 0;
+            while(open.size())
+            {
+                warthog::search_node* n = open.pop();
+                REQUIRE(n->get_f() >= last);
+                REQUIRE(!open.contains(n));
+                last = n->get_f();
+            }
+        }
+    }
+
+    GIVEN("Interleaved push, decrease_key and pop operations")
+    {
+        warthog::radix_queue open;
+        warthog::pqueue_min heap;
+
+        // a monotone sequence of operations, as generated by A* with a
+        // consistent heuristic
+        warthog::cost_t fmin = 0;
+        for(uint32_t i = 0; i < num_nodes; i++)
+        {
+            warthog::search_node& n = nodes[i];
+            n.init(0, warthog::SN_ID_MAX, 0, fmin + dist(rng));
+            open.push(&n);
+            REQUIRE(open.contains(&n));
+
+            // decrease some random node still on open
+            warthog::search_node& m = nodes[dist(rng) % (i+1)];
+            if(open.contains(&m) && m.get_f() > fmin + 1)
+            {
+                m.set_f(m.get_f() - 1);
+                open.decrease_key(&m);
+                REQUIRE(open.contains(&m));
+            }
+
+            if(i % 3 == 0)
+            {
+                warthog::search_node* top = open.pop();
+                REQUIRE(top->get_f() >= fmin);
+                fmin = top->get_f();
+            }
+        }
+
+        THEN("The remaining nodes come out in the same f-order as a heap")
+        {
+            std::vector<warthog::search_node*> remaining;
+            while(open.size()) { remaining.push_back(open.pop()); }
+            for(auto n : remaining) { heap.push(n); }
+
+            for(auto n : remaining)
+            {
+                REQUIRE(heap.pop()->get_f() == n->get_f());
+            }
+        }
+    }
+
+    GIVEN("A key below the last extracted minimum")
+    {
+        warthog::radix_queue open;
+        nodes[0].init(0, warthog::SN_ID_MAX, 0, 10);
+        nodes[1].init(0, warthog::SN_ID_MAX, 0, 20);
+        nodes[2].init(0, warthog::SN_ID_MAX, 0, 30);
+        open.push(&nodes[0]);
+        open.push(&nodes[1]);
+        open.push(&nodes[2]);
+        REQUIRE(open.pop() == &nodes[0]);
+
+        nodes[3].init(0, warthog::SN_ID_MAX, 0, 5);
+        open.push(&nodes[3]);
+
+        THEN("The queue is rebuilt and the new node is popped first")
+        {
+            REQUIRE(open.pop() == &nodes[3]);
+            REQUIRE(open.pop() == &nodes[1]);
+            REQUIRE(open.pop() == &nodes[2]);
+            REQUIRE(open.pop() == 0);
+        }
+    }
+}
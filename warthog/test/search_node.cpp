@@ -0,0 +1,58 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "constants.h"
+#include "search_node.h"
+
+#include <cmath>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+SCENARIO("Rounding of compact search node costs", "[search_node]")
+{
+    namespace cc = warthog::compact_cost;
+
+    GIVEN("The default scale")
+    {
+        REQUIRE(cc::SCALE == warthog::ONE);
+
+        THEN("Unit and diagonal moves keep their fractions")
+        {
+            REQUIRE(cc::unpack(cc::pack(1)) == 1);
+            REQUIRE(cc::pack(warthog::DBL_ROOT_TWO) == 141421);
+            REQUIRE(std::fabs(cc::unpack(cc::pack(warthog::DBL_ROOT_TWO)) -
+                        warthog::DBL_ROOT_TWO) <= 0.5 / cc::SCALE);
+            REQUIRE(cc::pack(warthog::DBL_ROOT_TWO) > cc::pack(1));
+        }
+
+        THEN("Octile paths are ordered by length")
+        {
+            // a scale of 1 rounds both pairs to the same cost
+            warthog::cost_t two_diagonal = 2 * warthog::DBL_ROOT_TWO;
+            warthog::cost_t five_diagonal = 5 * warthog::DBL_ROOT_TWO;
+            REQUIRE(cc::pack(two_diagonal) < cc::pack(3));
+            REQUIRE(cc::pack(five_diagonal) > cc::pack(7));
+            REQUIRE(std::fabs(cc::unpack(cc::pack(five_diagonal)) -
+                        five_diagonal) <= 0.5 / cc::SCALE);
+        }
+
+        THEN("COST_MAX stays infinite")
+        {
+            REQUIRE(cc::pack(warthog::COST_MAX) == UINT32_MAX);
+            REQUIRE(cc::unpack(UINT32_MAX) == warthog::COST_MAX);
+        }
+
+        THEN("The largest cost that fits round trips")
+        {
+            warthog::cost_t max = std::floor(UINT32_MAX / cc::SCALE) - 1;
+            REQUIRE(cc::pack(max) < UINT32_MAX);
+            REQUIRE(cc::unpack(cc::pack(max)) == max);
+        }
+    }
+}
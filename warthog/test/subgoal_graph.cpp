@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "flexible_astar.h"
+#include "grid_fixture.h"
+#include "gridmap.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+#include "subgoal_graph.h"
+#include "subgoal_graph_expansion_policy.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+// A* on the grid and on the subgoal graph agree on @param num instances
+void
+compare_with_astar(warthog::gridmap& map, warthog::subgoal_graph& sg,
+        std::vector<uint32_t>& open_cells, uint32_t num, std::mt19937& rng)
+{
+    warthog::octile_heuristic h(map.width(), map.height());
+    warthog::subgoal_graph_expansion_policy sexpander(&sg);
+    warthog::pqueue_min sopen;
+    warthog::flexible_astar<
+        warthog::octile_heuristic,
+        warthog::subgoal_graph_expansion_policy,
+        warthog::pqueue_min> sgsearch(&h, &sexpander, &sopen);
+    grid_fixture::compare_with_astar(map, sgsearch, open_cells, num, rng);
+}
+
+}
+
+SCENARIO("Test subgoal graphs against A*", "[subgoal_graph]")
+{
+    std::mt19937 rng(3);
+
+    GIVEN("A map with many obstacles")
+    {
+        warthog::gridmap map(50, 70);
+        std::vector<uint32_t> open_cells = grid_fixture::fill_map(map, 30, rng);
+        warthog::subgoal_graph sg(&map);
+        REQUIRE(sg.get_num_subgoals() > 0);
+        REQUIRE(!sg.is_mapped());
+
+        THEN("Every subgoal is in the graph and its edges are valid")
+        {
+            for(uint32_t i = 0; i < sg.get_num_subgoals(); i++)
+            {
+                uint32_t id = sg.subgoal(i);
+                REQUIRE(sg.index(id) == i);
+                for(const uint32_t* it = sg.edges_begin(i);
+                        it != sg.edges_end(i); it++)
+                {
+                    REQUIRE(sg.index(*it) != warthog::INF32);
+                    REQUIRE(sg.h_reachable(id, *it));
+                }
+            }
+        }
+
+        THEN("Paths have the same cost as on the grid")
+        {
+            compare_with_astar(map, sg, open_cells, 1000, rng);
+        }
+    }
+
+    GIVEN("A map with few obstacles and long clearances")
+    {
+        warthog::gridmap map(30, 700);
+        std::vector<uint32_t> open_cells = grid_fixture::fill_map(map, 1, rng);
+        warthog::subgoal_graph sg(&map);
+
+        THEN("Paths have the same cost as on the grid")
+        {
+            compare_with_astar(map, sg, open_cells, 300, rng);
+        }
+    }
+}
+
+SCENARIO("Save and load a subgoal graph", "[subgoal_graph]")
+{
+    std::mt19937 rng(5);
+    warthog::gridmap map(40, 40);
+    std::vector<uint32_t> open_cells = grid_fixture::fill_map(map, 25, rng);
+    warthog::subgoal_graph sg(&map);
+
+    const char* filename = "subgoal_graph.test.sg";
+    REQUIRE(sg.save(filename));
+
+    GIVEN("The same map")
+    {
+        warthog::subgoal_graph copy(&map);
+        REQUIRE(copy.load(filename));
+        REQUIRE(copy.is_mapped());
+
+        THEN("The mapped graph is the same")
+        {
+            REQUIRE(copy.get_num_edges() == sg.get_num_edges());
+            for(uint32_t i = 0; i < sg.get_num_subgoals(); i++)
+            {
+                REQUIRE(copy.subgoal(i) == sg.subgoal(i));
+                std::vector<uint32_t> edges(sg.edges_begin(i), sg.edges_end(i));
+                std::vector<uint32_t> copied(
+                        copy.edges_begin(i), copy.edges_end(i));
+                REQUIRE(copied == edges);
+            }
+            compare_with_astar(map, copy, open_cells, 300, rng);
+        }
+    }
+
+    GIVEN("Another map")
+    {
+        map.set_label(map.to_padded_id(open_cells.at(0)), false);
+        warthog::subgoal_graph other(&map);
+        THEN("The file is not used")
+        {
+            REQUIRE(!other.load(filename));
+            REQUIRE(!other.is_mapped());
+        }
+    }
+    remove(filename);
+}
@@ -0,0 +1,187 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "dimacs_parser.h"
+#include "text_parser.h"
+#include "xy_graph.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+namespace
+{
+
+// @param g and @param other have the same nodes and edges, in the same order
+void
+require_same(warthog::graph::xy_graph& g, warthog::graph::xy_graph& other)
+{
+    REQUIRE(other.get_num_nodes() == g.get_num_nodes());
+    REQUIRE(other.get_num_edges_out() == g.get_num_edges_out());
+    REQUIRE(other.get_num_edges_in() == g.get_num_edges_in());
+    for(uint32_t i = 0; i < g.get_num_nodes(); i++)
+    {
+        int32_t x, y, ox, oy;
+        g.get_xy(i, x, y);
+        other.get_xy(i, ox, oy);
+        REQUIRE(ox == x);
+        REQUIRE(oy == y);
+
+        REQUIRE(other.out_degree(i) == g.out_degree(i));
+        for(uint32_t j = 0; j < g.out_degree(i); j++)
+        {
+            REQUIRE(other.outgoing_begin(i)[j].node_id_ ==
+                    g.outgoing_begin(i)[j].node_id_);
+            REQUIRE(other.outgoing_begin(i)[j].wt_ == g.outgoing_begin(i)[j].wt_);
+        }
+        REQUIRE(other.in_degree(i) == g.in_degree(i));
+        for(uint32_t j = 0; j < g.in_degree(i); j++)
+        {
+            REQUIRE(other.incoming_begin(i)[j].node_id_ ==
+                    g.incoming_begin(i)[j].node_id_);
+            REQUIRE(other.incoming_begin(i)[j].wt_ == g.incoming_begin(i)[j].wt_);
+        }
+    }
+}
+
+}
+
+SCENARIO("Split text into chunks of lines", "[text_parser]")
+{
+    std::string text;
+    for(uint32_t i = 0; i < 1000; i++) { text += std::to_string(i) + "\n"; }
+    text += "no newline";
+
+    for(uint32_t max_chunks : {1, 3, 16, 5000})
+    {
+        std::vector<warthog::util::text_chunk> chunks;
+        warthog::util::split_lines(text.data(), text.data() + text.size(),
+                max_chunks, chunks);
+        REQUIRE(chunks.size() <= max_chunks);
+        REQUIRE(chunks.front().first == text.data());
+        REQUIRE(chunks.back().second == text.data() + text.size());
+        for(uint32_t c = 1; c < chunks.size(); c++)
+        {
+            REQUIRE(chunks[c].first == chunks[c-1].second);
+            REQUIRE(chunks[c].first[-1] == '\n');
+        }
+    }
+
+    const char* number = " \t-42 1.5e3";
+    const char* p = number;
+    int32_t i;
+    double d;
+    REQUIRE(warthog::util::parse_number(p, number + strlen(number), i));
+    REQUIRE(i == -42);
+    REQUIRE(warthog::util::parse_number(p, number + strlen(number), d));
+    REQUIRE(d == 1500);
+    REQUIRE(!warthog::util::parse_number(p, number + strlen(number), d));
+}
+
+SCENARIO("Load xy graphs from mapped files", "[text_parser]")
+{
+    std::mt19937 rng(31);
+    const uint32_t num_nodes = 2000;
+    warthog::graph::xy_graph g(0, "", true);
+    g.grow(num_nodes);
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        g.set_xy(i, (int32_t)(rng() % 100000) - 50000, (int32_t)(rng() % 1000));
+    }
+    for(uint32_t i = 0; i < num_nodes; i++)
+    {
+        for(uint32_t k = rng() % 6; k > 0; k--)
+        {
+            uint32_t head = (uint32_t)(rng() % num_nodes);
+            double wt = (double)(rng() % 100000) / 7;
+            g.get_node(i)->add_outgoing(warthog::graph::edge(head, wt));
+            g.get_node(head)->add_incoming(warthog::graph::edge(i, wt));
+        }
+    }
+
+    const char* filename = "text_parser.test.xy";
+    {
+        std::ofstream ofs(filename);
+        ofs << g;
+    }
+
+    THEN("It loads the same as with operator>>")
+    {
+        for(bool incoming : {false, true})
+        {
+            warthog::graph::xy_graph streamed(0, "", incoming);
+            std::ifstream ifs(filename);
+            ifs >> streamed;
+
+            warthog::graph::xy_graph loaded(0, "", incoming);
+            REQUIRE(loaded.load(filename));
+            require_same(streamed, loaded);
+        }
+    }
+
+    GIVEN("A file that is not an xy graph")
+    {
+        std::ofstream ofs(filename);
+        ofs << "nodes 2 edges 1\nv 0 1 1\nv 1 2 2\ne 0 7 1\n";
+        ofs.close();
+
+        warthog::graph::xy_graph loaded;
+        THEN("It is not loaded")
+        {
+            REQUIRE(!loaded.load(filename));
+            REQUIRE(loaded.get_num_nodes() == 0);
+        }
+    }
+    remove(filename);
+}
+
+SCENARIO("Load DIMACS files", "[text_parser]")
+{
+    const char* co_file = "text_parser.test.co";
+    const char* gr_file = "text_parser.test.gr";
+    {
+        std::ofstream co(co_file);
+        co << "c a comment\np aux sp co 3\nv 1 -10 20\nv 2 30 -40\n"
+            << "c another comment\nv 3 50 60";
+        std::ofstream gr(gr_file);
+        gr << "c a comment\np sp 3 4\na 1 2 7\na 2 3 8\n\na 3 1 9\n"
+            << "a 1 3 10\n";
+    }
+
+    warthog::dimacs_parser parser(co_file, gr_file);
+    THEN("Nodes and edges are in file order")
+    {
+        REQUIRE(parser.get_num_nodes() == 3);
+        REQUIRE(parser.get_num_edges() == 4);
+        warthog::dimacs_parser::node n = *(parser.nodes_begin() + 1);
+        REQUIRE(n.id_ == 2);
+        REQUIRE(n.x_ == 30);
+        REQUIRE(n.y_ == -40);
+        warthog::dimacs_parser::edge e = *(parser.edges_begin() + 3);
+        REQUIRE(e.tail_id_ == 1);
+        REQUIRE(e.head_id_ == 3);
+        REQUIRE(e.weight_ == 10);
+    }
+
+    THEN("A badly formatted arc stops the parser")
+    {
+        {
+            std::ofstream gr(gr_file);
+            gr << "p sp 3 2\na 1 2 7\na 2 x 8\n";
+        }
+        warthog::dimacs_parser bad;
+        REQUIRE(!bad.load_graph(gr_file));
+        REQUIRE(bad.get_num_edges() == 1);
+    }
+    remove(co_file);
+    remove(gr_file);
+}
@@ -0,0 +1,97 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "flexible_astar.h"
+#include "grid_fixture.h"
+#include "gridmap.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+#include "tiled_gridmap.h"
+#include "tiled_gridmap_expansion_policy.h"
+#include "tiled_heuristic.h"
+
+#include <random>
+#include <vector>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+SCENARIO("Test the tiled gridmap against a gridmap", "[tiled][gridmap]")
+{
+    // a random map with 25% obstacles, spanning several blocks in each
+    // direction, neither dimension a multiple of the block size
+    const uint32_t width = 600, height = 300;
+    warthog::gridmap map(height, width);
+    warthog::tiled_gridmap tmap(height, width);
+    std::mt19937 rng(7);
+    std::vector<uint32_t> open_cells = grid_fixture::fill_map(map, 25, rng);
+    for(uint32_t y = 0; y < height; y++)
+    {
+        for(uint32_t x = 0; x < width; x++)
+        {
+            tmap.set_label(tmap.to_tiled_id(x, y),
+                    map.get_label(map.to_padded_id(x, y)));
+        }
+    }
+
+    GIVEN("Every cell of the map")
+    {
+        THEN("Ids convert back to the same coordinates")
+        {
+            for(uint32_t y = 0; y < height; y++)
+            {
+                for(uint32_t x = 0; x < width; x++)
+                {
+                    uint32_t id = tmap.to_tiled_id(x, y);
+                    uint32_t tx, ty;
+                    tmap.to_xy(id, tx, ty);
+                    REQUIRE(tx == x);
+                    REQUIRE(ty == y);
+                    REQUIRE(id < tmap.id_space());
+                    REQUIRE(tmap.to_unpadded_id(id) == y * width + x);
+                }
+            }
+        }
+
+        THEN("Neighbourhoods are the same as in the gridmap")
+        {
+            for(uint32_t y = 0; y < height; y++)
+            {
+                for(uint32_t x = 0; x < width; x++)
+                {
+                    uint8_t expected[3], tiles[3];
+                    map.get_neighbours(map.to_padded_id(x, y), expected);
+                    tmap.get_neighbours(tmap.to_tiled_id(x, y), tiles);
+                    for(uint32_t i = 0; i < 3; i++)
+                    {
+                        REQUIRE((expected[i] & 7) == tiles[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("A* on each map")
+    {
+        warthog::tiled_heuristic<warthog::octile_heuristic> th(&tmap);
+        warthog::tiled_gridmap_expansion_policy texpander(&tmap);
+        warthog::pqueue_min topen;
+        warthog::flexible_astar<
+            warthog::tiled_heuristic<warthog::octile_heuristic>,
+            warthog::tiled_gridmap_expansion_policy,
+            warthog::pqueue_min> tastar(&th, &texpander, &topen);
+
+        THEN("Both find paths of the same cost")
+        {
+            grid_fixture::compare_with_astar(map, tastar, open_cells, 100, rng,
+                [](warthog::problem_instance&, warthog::solution& sol,
+                    warthog::solution& tsol)
+                { REQUIRE(tsol.path_.size() == sol.path_.size()); });
+        }
+    }
+}
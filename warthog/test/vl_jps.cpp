@@ -0,0 +1,114 @@
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+#include "flexible_astar.h"
+#include "labelled_gridmap.h"
+#include "octile_heuristic.h"
+#include "pqueue.h"
+#include "vl_gridmap_expansion_policy.h"
+#include "vl_jps_expansion_policy.h"
+#include "vl_jump_point_locator.h"
+#include "vl_offline_jump_point_locator.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+int
+main(int argv, char* args[])
+{
+    Catch::Session session;
+    int res = session.run(argv, args);
+    return res;
+}
+
+SCENARIO("Test JPS on weighted grids against A*", "[jps][wgm]")
+{
+    // a random map of rectangular patches with a few different costs,
+    // and 15% obstacles
+    const uint32_t width = 64, height = 48;
+    const warthog::dbword costs[4] = {'.', '.', 'S', 'W'};
+    warthog::vl_gridmap map(height, width);
+    std::mt19937 rng(5);
+    for(uint32_t y = 0; y < height; y++)
+    {
+        for(uint32_t x = 0; x < width; x++)
+        {
+            map.set_label(map.to_padded_id(x, y), costs[0]);
+        }
+    }
+    for(uint32_t i = 0; i < 40; i++)
+    {
+        uint32_t x0 = rng() % width, y0 = rng() % height;
+        uint32_t x1 = std::min(width, x0 + 1 + (uint32_t)(rng() % 16));
+        uint32_t y1 = std::min(height, y0 + 1 + (uint32_t)(rng() % 16));
+        warthog::dbword cost = costs[rng() % 4];
+        for(uint32_t y = y0; y < y1; y++)
+        {
+            for(uint32_t x = x0; x < x1; x++)
+            {
+                map.set_label(map.to_padded_id(x, y), cost);
+            }
+        }
+    }
+
+    std::vector<uint32_t> open_cells;
+    for(uint32_t id = 0; id < width * height; id++)
+    {
+        if(rng() % 100 < 15)
+        {
+            map.set_label(map.to_padded_id(id), (warthog::dbword)0);
+            continue;
+        }
+        open_cells.push_back(id);
+    }
+
+    warthog::octile_heuristic h(map.width(), map.height());
+    h.set_hscale('.');
+
+    warthog::vl_gridmap_expansion_policy expander(&map);
+    warthog::pqueue_min open;
+    warthog::flexible_astar<
+        warthog::octile_heuristic,
+        warthog::vl_gridmap_expansion_policy,
+        warthog::pqueue_min> astar(&h, &expander, &open);
+
+    typedef warthog::vl_jps_expansion_policy
+        <warthog::vl_jump_point_locator> jps_expansion_policy;
+    jps_expansion_policy jexpander(&map);
+    warthog::pqueue_min jopen;
+    warthog::flexible_astar<
+        warthog::octile_heuristic,
+        jps_expansion_policy,
+        warthog::pqueue_min> jps(&h, &jexpander, &jopen);
+
+    typedef warthog::vl_jps_expansion_policy
+        <warthog::vl_offline_jump_point_locator> jpsplus_expansion_policy;
+    jpsplus_expansion_policy pexpander(&map);
+    warthog::pqueue_min popen;
+    warthog::flexible_astar<
+        warthog::octile_heuristic,
+        jpsplus_expansion_policy,
+        warthog::pqueue_min> jpsplus(&h, &pexpander, &popen);
+
+    GIVEN("Random instances")
+    {
+        THEN("A*, JPS and JPS+ find paths of the same cost")
+        {
+            for(uint32_t i = 0; i < 500; i++)
+            {
+                warthog::problem_instance pi(
+                        open_cells.at(rng() % open_cells.size()),
+                        open_cells.at(rng() % open_cells.size()));
+                warthog::solution sol, jsol, psol;
+                astar.get_path(pi, sol);
+                jps.get_path(pi, jsol);
+                jpsplus.get_path(pi, psol);
+                REQUIRE(jsol.sum_of_edge_costs_ ==
+                        Approx(sol.sum_of_edge_costs_));
+                REQUIRE(psol.sum_of_edge_costs_ ==
+                        Approx(sol.sum_of_edge_costs_));
+            }
+        }
+    }
+}